@@ -0,0 +1,763 @@
+/**
+ * @file dts_benchmarks.cpp
+ * @brief Micro and macro benchmarks for hashing, logging, adapters and verification
+ *
+ * Usage: dts_benchmarks [--quick] [--filter TEXT]
+ *
+ * Every benchmark reports wall-clock ns/op, heap allocations/op (counted by
+ * the replacement operator new below, across all threads) and output
+ * bytes/op (input bytes for hashing). Macro workloads replay the PACS,
+ * SCADA and BMS event mixes of the examples into file-backed chains.
+ * --quick runs 1% of the operations, for smoke-testing the build.
+ */
+
+#include <dts/adapters/building_automation_adapter.hpp>
+#include <dts/adapters/clinical_trial_adapter.hpp>
+#include <dts/adapters/dicom_adapter.hpp>
+#include <dts/adapters/industrial_adapter.hpp>
+#include <dts/adapters/medtech_adapter.hpp>
+#include <dts/audit_chain.hpp>
+#include <dts/binary_record.hpp>
+#include <dts/chain_registry.hpp>
+#include <dts/chain_verifier.hpp>
+#include <dts/concurrent_audit_chain.hpp>
+#include <dts/epoch_chain.hpp>
+#include <dts/log_sink.hpp>
+#include <dts/replay.hpp>
+#include <dts/sha256.hpp>
+#include <dts/signed_checkpoint.hpp>
+#include <dts/upload_pipeline.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+
+static std::atomic<uint64_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// ---------------------------------------------------------------------------
+// Harness
+
+namespace {
+
+/// Body runs @p ops operations and returns the bytes they produced
+using BenchBody = std::function<uint64_t(uint64_t ops)>;
+/// Untimed preparation of the data a body with @p ops operations needs
+using BenchSetup = std::function<void(uint64_t ops)>;
+
+class Runner {
+public:
+    Runner(bool quick, std::string filter) : quick_(quick), filter_(std::move(filter)) {
+        std::printf("%-44s %12s %12s %12s %12s\n", "benchmark", "ops", "ns/op", "allocs/op",
+                    "bytes/op");
+    }
+
+    void run(const std::string& name, uint64_t ops, const BenchBody& body,
+             const BenchSetup& setup = nullptr) {
+        if (!filter_.empty() && name.find(filter_) == std::string::npos) return;
+        if (quick_) ops = ops / 100 ? ops / 100 : 1;
+        const uint64_t warm_up = ops / 10 ? ops / 10 : 1;
+        if (setup) setup(warm_up);
+        body(warm_up);                      // buffers, caches, page faults
+        if (setup) setup(ops);
+
+        const uint64_t allocations = g_allocations.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t bytes = body(ops);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const uint64_t allocated = g_allocations.load(std::memory_order_relaxed) - allocations;
+
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        std::printf("%-44s %12llu %12.1f %12.2f %12.1f\n", name.c_str(),
+                    static_cast<unsigned long long>(ops), ns / static_cast<double>(ops),
+                    static_cast<double>(allocated) / static_cast<double>(ops),
+                    static_cast<double>(bytes) / static_cast<double>(ops));
+        std::fflush(stdout);
+    }
+
+private:
+    bool quick_;
+    std::string filter_;
+};
+
+/// Discards entries; measures the chain without I/O
+class NullSink : public dts::LogSink {
+public:
+    void write(std::string_view entry, const dts::EntryInfo&) override { bytes += entry.size(); }
+
+    uint64_t bytes = 0;
+};
+
+/// Acknowledges every frame at once; measures the upload pipeline without a network
+class AckTransport : public dts::Transport {
+public:
+    bool connect(uint64_t& acknowledged) override {
+        acknowledged = last;
+        return true;
+    }
+
+    bool send(const dts::UploadBatch& batch, uint64_t& acknowledged) override {
+        last = acknowledged = batch.first_sequence + batch.entries - 1;
+        return true;
+    }
+
+    uint64_t last = 0;
+};
+
+std::string temp_path(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("dts_bench_" + name);
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+std::string message_of_size(size_t size) {
+    std::string message = "Telemetry | Sensor:TS-104 | Value:";
+    while (message.size() < size) message.push_back(static_cast<char>('a' + message.size() % 26));
+    message.resize(size);
+    return message;
+}
+
+// ---------------------------------------------------------------------------
+// Microbenchmarks
+
+void bench_hashing(Runner& runner) {
+    for (size_t size : {64, 256, 1024, 4096}) {
+        const std::string data(size, 'x');
+        runner.run("sha256/hash/" + std::to_string(size), 200000, [&data](uint64_t ops) {
+            uint64_t checksum = 0;
+            for (uint64_t i = 0; i < ops; ++i) checksum += dts::SHA256::hash(data)[0];
+            return ops * data.size() + (checksum & 0);
+        });
+    }
+
+    const std::vector<std::string> messages(8, std::string(256, 'y'));
+    runner.run("sha256/hash_many/x8/256", 50000, [&messages](uint64_t ops) {
+        const uint8_t* data[8];
+        size_t lens[8];
+        dts::SHA256::Hash out[8];
+        for (size_t i = 0; i < 8; ++i) {
+            data[i] = reinterpret_cast<const uint8_t*>(messages[i].data());
+            lens[i] = messages[i].size();
+        }
+        for (uint64_t i = 0; i < ops; ++i) dts::SHA256::hash_many(data, lens, 8, out);
+        return ops * 8 * 256;
+    });
+
+    // One op is one signed checkpoint payload
+    dts::ed25519::Seed seed;
+    for (size_t i = 0; i < seed.size(); ++i) seed[i] = static_cast<uint8_t>(i * 7 + 1);
+    const dts::ed25519::SigningKey key(seed);
+    const dts::SHA256::Hash chain_hash = dts::SHA256::hash("bench");
+    std::vector<std::string> payloads(64);
+    std::vector<dts::ed25519::Signature> signatures(payloads.size());
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        dts::detail::signed_checkpoint_payload("BENCH-DEVICE-001", 1000 * (i + 1), chain_hash,
+                                               payloads[i]);
+        signatures[i] = key.sign(payloads[i]);
+    }
+    runner.run("ed25519/sign", 2000, [&key, &payloads](uint64_t ops) {
+        uint64_t checksum = 0;
+        for (uint64_t i = 0; i < ops; ++i) checksum += key.sign(payloads[i % 64])[0];
+        return ops * payloads[0].size() + (checksum & 0);
+    });
+    runner.run("ed25519/verify", 2000, [&key, &payloads, &signatures](uint64_t ops) {
+        uint64_t valid = 0;
+        for (uint64_t i = 0; i < ops; ++i) {
+            valid += dts::ed25519::verify(key.public_key(), payloads[i % 64], signatures[i % 64]);
+        }
+        return ops * payloads[0].size() + (valid & 0);
+    });
+    runner.run("ed25519/verify_batch_64", 2048, [&key, &payloads, &signatures](uint64_t ops) {
+        std::vector<dts::ed25519::SignedMessage> items;
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            items.push_back({key.public_key(), signatures[i], payloads[i]});
+        }
+        uint64_t valid = 0;
+        for (uint64_t done = 0; done < ops; done += items.size()) {
+            valid += dts::ed25519::verify_batch(items.data(), items.size());
+        }
+        return ops * payloads[0].size() + (valid & 0);
+    });
+}
+
+void bench_logging(Runner& runner) {
+    for (size_t size : {32, 128, 512, 2048}) {
+        const std::string message = message_of_size(size);
+        runner.run("audit_chain/log_into/" + std::to_string(size), 200000,
+                   [&message](uint64_t ops) {
+            dts::AuditChain chain("BENCH-DEVICE-001");
+            std::string entry;
+            uint64_t bytes = 0;
+            for (uint64_t i = 0; i < ops; ++i) bytes += chain.log(entry, message);
+            return bytes;
+        });
+    }
+
+    const std::string message = message_of_size(128);
+    runner.run("audit_chain/log_returning/128", 200000, [&message](uint64_t ops) {
+        dts::AuditChain chain("BENCH-DEVICE-001");
+        uint64_t bytes = 0;
+        for (uint64_t i = 0; i < ops; ++i) bytes += chain.log(message).size();
+        return bytes;
+    });
+
+    runner.run("audit_chain/log_buffer/128", 200000, [&message](uint64_t ops) {
+        dts::AuditChain chain("BENCH-DEVICE-001");
+        char buffer[1024];
+        uint64_t bytes = 0;
+        for (uint64_t i = 0; i < ops; ++i) bytes += chain.log(buffer, sizeof(buffer), message);
+        return bytes;
+    });
+
+    // One op is one entry; entries are logged 64 per log_batch() call
+    runner.run("audit_chain/log_batch_64/128", 200000, [&message](uint64_t ops) {
+        dts::AuditChain chain("BENCH-DEVICE-001");
+        const std::vector<dts::LogEvent> events(64, dts::LogEvent{message});
+        std::string out;
+        uint64_t bytes = 0;
+        for (uint64_t done = 0; done < ops; done += events.size()) {
+            chain.log_batch(out, events.data(), std::min<uint64_t>(events.size(), ops - done));
+            bytes += out.size();
+        }
+        return bytes;
+    });
+
+    // Epochs of 4096 entries, hashed on 1 lane and on one lane per core
+    for (unsigned threads : {1u, 0u}) {
+        const std::string name = threads ? "1" : "hw";
+        runner.run("epoch_chain/lanes_" + name + "/4096/128", 200000,
+                   [&message, threads](uint64_t ops) {
+            dts::EpochOptions options;
+            options.threads = threads;
+            dts::EpochChain chain("BENCH-DEVICE-001", options);
+            const std::vector<dts::LogEvent> events(4096, dts::LogEvent{message});
+            std::string out;
+            uint64_t bytes = 0;
+            for (uint64_t done = 0; done < ops; done += events.size()) {
+                chain.log_epoch(out, events.data(), std::min<uint64_t>(events.size(), ops - done));
+                bytes += out.size();
+            }
+            return bytes;
+        });
+    }
+
+    runner.run("audit_chain/checkpoints_64/128", 200000, [&message](uint64_t ops) {
+        dts::AuditChain chain("BENCH-DEVICE-001");
+        chain.set_checkpoint_interval(64);
+        std::string entry;
+        std::string checkpoint;
+        uint64_t bytes = 0;
+        for (uint64_t i = 0; i < ops; ++i) {
+            bytes += chain.log(entry, message);
+            if (chain.take_checkpoint(checkpoint)) bytes += checkpoint.size();
+        }
+        return bytes;
+    });
+
+    // Signatures are computed off the logging thread
+    runner.run("audit_chain/signed_1024/128", 200000, [&message](uint64_t ops) {
+        dts::AuditChain chain("BENCH-DEVICE-001");
+        dts::ed25519::Seed seed{};
+        chain.set_checkpoint_signer(std::make_shared<dts::Ed25519CheckpointSigner>(seed), 1024);
+        std::string entry;
+        std::string checkpoint;
+        uint64_t bytes = 0;
+        for (uint64_t i = 0; i < ops; ++i) {
+            bytes += chain.log(entry, message);
+            if (chain.take_checkpoint(checkpoint)) bytes += checkpoint.size();
+        }
+        return bytes;
+    });
+}
+
+void bench_sinks(Runner& runner) {
+    const std::string message = message_of_size(128);
+    auto with_sink = [&message](const std::function<std::shared_ptr<dts::LogSink>()>& make) {
+        return [&message, make](uint64_t ops) {
+            uint64_t bytes = 0;
+            {
+                dts::AuditChain chain("BENCH-DEVICE-002");
+                auto sink = make();
+                chain.set_sink(sink);
+                std::string entry;
+                for (uint64_t i = 0; i < ops; ++i) bytes += chain.log(entry, message);
+                sink->flush();
+            }
+            return bytes;
+        };
+    };
+
+    runner.run("sink/null/128", 200000, with_sink([] { return std::make_shared<NullSink>(); }));
+
+    const std::string path = temp_path("sink.log");
+    dts::DurabilityPolicy write_only;
+    write_only.sync_batches = false;
+    runner.run("sink/file/128", 100000, with_sink([&path, write_only] {
+        std::filesystem::remove(path);
+        return std::make_shared<dts::FileSink>(path, write_only);
+    }));
+    runner.run("sink/file_batch_64/128", 100000, [&message, &path, write_only](uint64_t ops) {
+        std::filesystem::remove(path);
+        uint64_t bytes = 0;
+        dts::AuditChain chain("BENCH-DEVICE-002");
+        auto sink = std::make_shared<dts::FileSink>(path, write_only);
+        chain.set_sink(sink);
+        const std::vector<dts::LogEvent> events(64, dts::LogEvent{message});
+        std::string out;
+        for (uint64_t done = 0; done < ops; done += events.size()) {
+            chain.log_batch(out, events.data(), std::min<uint64_t>(events.size(), ops - done));
+            bytes += out.size();
+        }
+        sink->flush();
+        return bytes;
+    });
+    runner.run("sink/async_file/128", 100000, with_sink([&path, write_only] {
+        std::filesystem::remove(path);
+        return std::make_shared<dts::AsyncFileSink>(path, write_only);
+    }));
+    runner.run("sink/async_file_synced/128", 100000, with_sink([&path] {
+        std::filesystem::remove(path);
+        return std::make_shared<dts::AsyncFileSink>(path);
+    }));
+    runner.run("sink/binary_file/128", 100000, with_sink([&path, write_only] {
+        std::filesystem::remove(path);
+        return std::make_shared<dts::BinaryFileSink>(path, write_only);
+    }));
+    std::filesystem::remove(path);
+
+    dts::UploadOptions raw;
+    raw.compress = false;
+    runner.run("sink/upload/128", 100000, with_sink([] {
+        return std::make_shared<dts::UploadPipeline>(std::make_shared<AckTransport>());
+    }));
+    runner.run("sink/upload_raw/128", 100000, with_sink([raw] {
+        return std::make_shared<dts::UploadPipeline>(std::make_shared<AckTransport>(), raw);
+    }));
+}
+
+void bench_threads(Runner& runner) {
+    const std::string message = message_of_size(128);
+    for (unsigned threads : {1u, 2u, 4u}) {
+        runner.run("concurrent/threads_" + std::to_string(threads) + "/128", 200000,
+                   [&message, threads](uint64_t ops) {
+            auto sink = std::make_shared<NullSink>();
+            dts::ConcurrentAuditChain::Options options;
+            options.sink = sink;
+            dts::ConcurrentAuditChain chain("BENCH-DEVICE-003", nullptr, options);
+            std::vector<std::thread> producers;
+            for (unsigned t = 0; t < threads; ++t) {
+                producers.emplace_back([&chain, &message, ops, threads] {
+                    for (uint64_t i = 0; i < ops / threads; ++i) chain.log(message);
+                });
+            }
+            for (auto& producer : producers) producer.join();
+            chain.flush();
+            chain.stop();
+            return sink->bytes;
+        });
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        runner.run("registry/devices_1000/threads_" + std::to_string(threads) + "/128", 200000,
+                   [&message, threads](uint64_t ops) {
+            std::vector<std::shared_ptr<NullSink>> sinks;
+            dts::ChainRegistry::Options options;
+            options.sink_factory = [&sinks](size_t) {
+                sinks.push_back(std::make_shared<NullSink>());
+                return sinks.back();
+            };
+            uint64_t bytes = 0;
+            {
+                dts::ChainRegistry registry(options);
+                std::vector<dts::DeviceHandle> devices;
+                for (int i = 0; i < 1000; ++i) {
+                    devices.push_back(registry.add_device("GW-DEVICE-" + std::to_string(i)));
+                }
+                std::vector<std::thread> producers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    producers.emplace_back([&, t] {
+                        for (uint64_t i = t; i < ops; i += threads) {
+                            registry.log(devices[i % devices.size()], message);
+                        }
+                    });
+                }
+                for (auto& producer : producers) producer.join();
+                registry.flush();
+            }
+            for (const auto& sink : sinks) bytes += sink->bytes;
+            return bytes;
+        });
+    }
+}
+
+/// Runs one adapter call per op on a fresh adapter and reports entry bytes
+template <typename Adapter, typename Call>
+BenchBody adapter_bench(std::function<Adapter()> make, Call call) {
+    return [make, call](uint64_t ops) {
+        Adapter adapter = make();
+        uint64_t bytes = 0;
+        for (uint64_t i = 0; i < ops; ++i) bytes += call(adapter, i).size();
+        return bytes;
+    };
+}
+
+void bench_adapters(Runner& runner) {
+    using namespace dts::adapters;
+    const uint64_t ops = 100000;
+
+    std::function<IndustrialAdapter()> plc = [] {
+        return IndustrialAdapter("PLC-AB-1756-L75-001", "ASSET-001", "LINE-A");
+    };
+    runner.run("adapter/industrial/io_change", ops, adapter_bench(plc,
+        [](IndustrialAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_io_change("FILL_VALVE_OUT", i & 1 ? "1" : "0", i & 1 ? "0" : "1", true);
+        }));
+    runner.run("adapter/industrial/plc_event", ops, adapter_bench(plc,
+        [](IndustrialAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_plc_event("MainRoutine", static_cast<int>(i % 500), "Scan complete");
+        }));
+    runner.run("adapter/industrial/scada_alarm", ops, adapter_bench(plc,
+        [](IndustrialAdapter& a, uint64_t) -> const std::string& {
+            return a.log_scada_alarm("ALM-TANK-01-HIGH", "Tank level high", dts::Severity::Warning);
+        }));
+    runner.run("adapter/industrial/production_event", ops, adapter_bench(plc,
+        [](IndustrialAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_production_event(ProductionEventType::BatchCompleted,
+                                          "BATCH-2025-001234", "PRODUCT-ABC-500ML",
+                                          static_cast<int>(i % 10000));
+        }));
+    runner.run("adapter/industrial/protocol_event", ops, adapter_bench(plc,
+        [](IndustrialAdapter& a, uint64_t) -> const std::string& {
+            return a.log_protocol_event(ProtocolType::Modbus, "192.168.1.10:502",
+                                        "192.168.1.20:502", "Function 03");
+        }));
+    runner.run("adapter/industrial/safety_interlock", ops, adapter_bench(plc,
+        [](IndustrialAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_safety_interlock("IL-GUARD-DOOR-3", i & 1, "Guard door opened");
+        }));
+
+    std::function<BuildingAutomationAdapter()> bas = [] {
+        return BuildingAutomationAdapter("BAS-CONTROLLER-001", "BUILDING-A", "ZONE-3F-01");
+    };
+    runner.run("adapter/building/hvac_event", ops, adapter_bench(bas,
+        [](BuildingAutomationAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_hvac_event("Setpoint Change", "ZONE-3F-01",
+                                    20.0 + static_cast<double>(i % 50) / 10.0, "C");
+        }));
+    runner.run("adapter/building/access_control", ops, adapter_bench(bas,
+        [](BuildingAutomationAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_access_control("DOOR-MAIN-ENTRANCE", "BADGE-12345", i % 10 != 0,
+                                        "Unauthorized access level");
+        }));
+    runner.run("adapter/building/energy_consumption", ops, adapter_bench(bas,
+        [](BuildingAutomationAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_energy_consumption("METER-MAIN-01", 1500.0 + static_cast<double>(i),
+                                            250.5);
+        }));
+    runner.run("adapter/building/knx_event", ops, adapter_bench(bas,
+        [](BuildingAutomationAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_knx_event("1/2/3", i & 1 ? "ON" : "OFF", "DPT1.001");
+        }));
+    runner.run("adapter/building/bacnet_event", ops, adapter_bench(bas,
+        [](BuildingAutomationAdapter& a, uint64_t i) -> const std::string& {
+            return a.log_bacnet_event("analog-input", 3, "present-value",
+                                      i & 1 ? "21.5" : "21.6");
+        }));
+
+    std::function<DICOMAdapter()> pacs = [] { return DICOMAdapter("PACS-SERVER-001", "PACS_AE"); };
+    runner.run("adapter/dicom/study_created", ops, adapter_bench(pacs,
+        [](DICOMAdapter& a, uint64_t) -> const std::string& {
+            return a.log_study_created("1.2.840.113619.2.55.3.604688119.868.1234567890.123",
+                                       "ANON-7f3a9c21", "CT");
+        }));
+    runner.run("adapter/dicom/instance_stored", ops, adapter_bench(pacs,
+        [](DICOMAdapter& a, uint64_t) -> const std::string& {
+            return a.log_instance_stored("1.2.840.113619.2.55.3.604688119.868.1234567890.123",
+                                         "1.2.840.113619.2.55.3.604688119.868.1234567890.124",
+                                         "1.2.840.10008.5.1.4.1.1.2");
+        }));
+    // One op is one instance of a 2,000-instance series
+    runner.run("adapter/dicom/instances_stored_batch_2000", ops, [](uint64_t count) {
+        DICOMAdapter adapter("PACS-SERVER-001", "PACS_AE");
+        const std::vector<StoredInstance> series(
+            2000, StoredInstance{"1.2.840.113619.2.55.3.604688119.868.1234567890.124",
+                                 "1.2.840.10008.5.1.4.1.1.2"});
+        uint64_t bytes = 0;
+        for (uint64_t done = 0; done < count; done += series.size()) {
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(series.size(), count - done));
+            bytes += adapter.log_instances_stored(
+                "1.2.840.113619.2.55.3.604688119.868.1234567890.123", series.data(), n).size();
+        }
+        return bytes;
+    });
+    runner.run("adapter/dicom/ai_inference_completed", ops, adapter_bench(pacs,
+        [](DICOMAdapter& a, uint64_t) -> const std::string& {
+            return a.log_ai_inference_completed("1.2.840.113619.2.55.3.604688119.868.1",
+                                                "LungNoduleDetector", "INF-2025-000123",
+                                                "2 nodules detected, max 8mm");
+        }));
+
+    std::function<MedTechAdapter()> pump = [] {
+        return MedTechAdapter("INFUSION-PUMP-789012", "Infusion Pump");
+    };
+    runner.run("adapter/medtech/medication_event", ops, adapter_bench(pump,
+        [](MedTechAdapter& a, uint64_t) -> const std::string& {
+            return a.log_medication_event(MedicationEventType::Started, "Insulin", "100U/mL",
+                                          "2.5 mL/hr", 60);
+        }));
+    runner.run("adapter/medtech/safety_alarm", ops, adapter_bench(pump,
+        [](MedTechAdapter& a, uint64_t) -> const std::string& {
+            return a.log_safety_alarm("Occlusion", AlarmPriority::High,
+                                      "Pressure threshold exceeded", "Infusion paused");
+        }));
+
+    std::function<ClinicalTrialAdapter()> trial = [] {
+        return ClinicalTrialAdapter("TRIAL-DEVICE-001", "PROTOCOL-2025-001");
+    };
+    runner.run("adapter/clinical/patient_enrolled", ops, adapter_bench(trial,
+        [](ClinicalTrialAdapter& a, uint64_t) -> const std::string& {
+            return a.log_patient_enrolled("PATIENT-12345", "SITE-001");
+        }));
+    runner.run("adapter/clinical/data_collected", ops, adapter_bench(trial,
+        [](ClinicalTrialAdapter& a, uint64_t) -> const std::string& {
+            return a.log_data_collected("PATIENT-12345", "Vital Signs", "FORM-VS-01", 12);
+        }));
+}
+
+void bench_verification(Runner& runner) {
+    const uint64_t count = 100000;
+    std::vector<std::string> all;
+    std::vector<size_t> ends;       // log offset after each entry
+    std::string log;
+    {
+        dts::AuditChain chain("BENCH-DEVICE-004");
+        const std::string message = message_of_size(128);
+        for (uint64_t i = 0; i < count; ++i) {
+            all.push_back(chain.log(message));
+            log += all.back();
+            log.push_back('\n');
+            ends.push_back(log.size());
+        }
+    }
+
+    // One op verifies one entry of a chain that is ops entries long
+    std::vector<std::string> entries;
+    const BenchSetup take_entries = [&all, &entries](uint64_t ops) {
+        entries.assign(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(ops));
+    };
+    auto over_entries = [&entries](bool recompute) {
+        return [&entries, recompute](uint64_t) {
+            if (!dts::AuditChain::verify_chain(entries, recompute)) std::abort();
+            uint64_t bytes = 0;
+            for (const auto& entry : entries) bytes += entry.size() + 1;
+            return bytes;
+        };
+    };
+    runner.run("verify/verify_chain/links", count, over_entries(false), take_entries);
+    runner.run("verify/verify_chain/recompute", count, over_entries(true), take_entries);
+
+    auto over_buffer = [&log, &ends](unsigned threads, bool recompute) {
+        return [&log, &ends, threads, recompute](uint64_t ops) {
+            dts::VerifyOptions options;
+            options.threads = threads;
+            options.recompute = recompute;
+            options.min_segment_bytes = 1024 * 1024;
+            const std::string_view prefix(log.data(), ends[ops - 1]);
+            if (!dts::verify_buffer(prefix, options).ok()) std::abort();
+            return static_cast<uint64_t>(prefix.size());
+        };
+    };
+    runner.run("verify/buffer/threads_1/links", count, over_buffer(1, false));
+    runner.run("verify/buffer/threads_1/recompute", count, over_buffer(1, true));
+    runner.run("verify/buffer/threads_all/recompute", count, over_buffer(0, true));
+
+    // Replay regenerates every entry of the same log and compares the bytes
+    auto over_replay = [&log, &ends](unsigned threads) {
+        return [&log, &ends, threads](uint64_t ops) {
+            dts::ReplayOptions options;
+            options.threads = threads;
+            options.min_segment_bytes = 1024 * 1024;
+            const std::string_view prefix(log.data(), ends[ops - 1]);
+            if (!dts::replay_log(prefix, options).ok()) std::abort();
+            return static_cast<uint64_t>(prefix.size());
+        };
+    };
+    runner.run("replay/log/threads_1", count, over_replay(1));
+    runner.run("replay/log/threads_all", count, over_replay(0));
+
+    std::vector<dts::RecordedEvent> events(count);
+    const std::string message = message_of_size(128);
+    for (uint64_t i = 0; i < count; ++i) {
+        events[i].timestamp_ms = 1700000000000 + static_cast<int64_t>(i);
+        events[i].message = message;
+    }
+    runner.run("replay/engine/128", count, [&events](uint64_t ops) {
+        dts::ReplayEngine engine("BENCH-DEVICE-005");
+        std::string out;
+        out.reserve(ops * 320);
+        engine.replay(out, events.data(), ops);
+        return static_cast<uint64_t>(out.size());
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Macro workloads: event mixes modeled on the examples, into an AsyncFileSink
+
+template <typename Adapter, typename Step>
+BenchBody workload(const std::string& name, std::function<Adapter()> make, Step step,
+                   bool coalesce = false) {
+    return [name, make, step, coalesce](uint64_t ops) {
+        const std::string path = temp_path(name + ".log");
+        uint64_t bytes = 0;
+        {
+            Adapter adapter = make();
+            adapter.get_chain().set_sink(std::make_shared<dts::AsyncFileSink>(path));
+            if constexpr (std::is_same<Adapter, dts::adapters::IndustrialAdapter>::value ||
+                          std::is_same<Adapter, dts::adapters::BuildingAutomationAdapter>::value) {
+                if (coalesce) adapter.enable_coalescing();
+            }
+            for (uint64_t i = 0; i < ops; ++i) step(adapter, i);
+        }
+        bytes = std::filesystem::file_size(path);
+        std::filesystem::remove(path);
+        return bytes;
+    };
+}
+
+void bench_workloads(Runner& runner) {
+    using namespace dts::adapters;
+    const uint64_t ops = 100000;
+
+    // PACS: a study, a series of stored instances, AI inference and routing
+    std::function<DICOMAdapter()> pacs = [] { return DICOMAdapter("PACS-SERVER-001", "PACS_AE"); };
+    runner.run("workload/pacs", ops, workload("pacs", pacs, [](DICOMAdapter& a, uint64_t i) {
+        const uint64_t step = i % 40;
+        const std::string study = "1.2.840.113619.2.55.3." + std::to_string(i / 40);
+        if (step == 0) {
+            a.log_study_created(study, "ANON-7f3a9c21", "CT");
+        } else if (step < 35) {
+            a.log_instance_stored(study, study + "." + std::to_string(step),
+                                  "1.2.840.10008.5.1.4.1.1.2");
+        } else if (step == 35) {
+            a.log_ai_inference_request(study, "LungNoduleDetector", "v2.1.0", 34);
+        } else if (step == 36) {
+            a.log_ai_inference_completed(study, "LungNoduleDetector", "INF-000123",
+                                         "No findings");
+        } else if (step == 37) {
+            a.log_transfer_initiated(study, "ARCHIVE_AE", "1.2.840.10008.1.2.4.90");
+        } else {
+            a.log_access_event(study, dts::UserID::Operator, step == 38, "No consent");
+        }
+    }));
+
+    // SCADA: mostly I/O scans, with protocol traffic, alarms and batches
+    std::function<IndustrialAdapter()> plc = [] {
+        return IndustrialAdapter("PLC-AB-1756-L75-001", "ASSET-001", "LINE-A");
+    };
+    auto scada = [](IndustrialAdapter& a, uint64_t i) {
+        const uint64_t step = i % 100;
+        if (step < 70) {
+            static const char* const points[] = {"FILL_VALVE_OUT", "PUMP_RUN", "LEVEL_HI",
+                                                 "MIXER_ON"};
+            a.log_io_change(points[step % 4], i & 1 ? "1" : "0", i & 1 ? "0" : "1", step % 2);
+        } else if (step < 90) {
+            a.log_protocol_event(ProtocolType::Modbus, "192.168.1.10:502", "192.168.1.20:502",
+                                 "Function 03");
+        } else if (step < 96) {
+            a.log_scada_alarm("ALM-TANK-01-HIGH", "Tank level high");
+        } else if (step < 99) {
+            a.log_production_event(ProductionEventType::BatchStarted, "BATCH-2025-001234",
+                                   "PRODUCT-ABC-500ML");
+        } else {
+            a.log_safety_interlock("IL-GUARD-DOOR-3", true, "Guard door opened");
+        }
+    };
+    runner.run("workload/scada", ops, workload("scada", plc, scada));
+    runner.run("workload/scada_coalesced", ops, workload("scada_c", plc, scada, true));
+
+    // BMS: meter and bus telemetry dominate, with HVAC, lighting and doors
+    std::function<BuildingAutomationAdapter()> bms = [] {
+        return BuildingAutomationAdapter("BAS-CONTROLLER-001", "BUILDING-A", "ZONE-3F-01");
+    };
+    auto building = [](BuildingAutomationAdapter& a, uint64_t i) {
+        const uint64_t step = i % 100;
+        if (step < 30) {
+            a.log_knx_event("1/2/" + std::to_string(step % 8), i & 1 ? "ON" : "OFF", "DPT1.001");
+        } else if (step < 60) {
+            a.log_bacnet_event("analog-input", static_cast<uint32_t>(step % 6), "present-value",
+                               std::to_string(20 + (i % 7)));
+        } else if (step < 80) {
+            a.log_energy_consumption("METER-" + std::to_string(step % 3),
+                                     1500.0 + static_cast<double>(i), 250.5);
+        } else if (step < 90) {
+            a.log_hvac_event("Setpoint Change", "ZONE-3F-01", 22.5, "C");
+        } else if (step < 95) {
+            a.log_lighting_event("ZONE-3F-01", 0, 75, "schedule");
+        } else if (step < 99) {
+            a.log_access_control("DOOR-MAIN-ENTRANCE", "BADGE-12345", step != 98,
+                                 "Unauthorized access level");
+        } else {
+            a.log_fire_safety_event("Smoke Detector Activation", "ZONE-3F-01");
+        }
+    };
+    runner.run("workload/bms", ops, workload("bms", bms, building));
+    runner.run("workload/bms_coalesced", ops, workload("bms_c", bms, building, true));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--filter TEXT]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("SHA-256 backend: %s\n\n", dts::SHA256::backend_name(dts::SHA256::backend()));
+    Runner runner(quick, filter);
+    bench_hashing(runner);
+    bench_logging(runner);
+    bench_sinks(runner);
+    bench_threads(runner);
+    bench_adapters(runner);
+    bench_verification(runner);
+    bench_workloads(runner);
+    return 0;
+}
@@ -15,8 +15,13 @@
 #define DTS_BUILDING_AUTOMATION_ADAPTER_HPP
 
 #include "../audit_chain.hpp"
+#include "../event_coalescer.hpp"
+#include "../event_schema.hpp"
+#include "../message_builder.hpp"
+#include "../string_pool.hpp"
+#include <memory>
 #include <string>
-#include <sstream>
+#include <string_view>
 
 namespace dts {
 namespace adapters {
@@ -35,18 +40,92 @@ enum class BuildingSystemType : uint8_t {
     Other = 255
 };
 
+/**
+ * @brief Message schemas of BuildingAutomationAdapter events
+ */
+namespace building_events {
+
+struct Hvac {
+    static constexpr std::string_view name = "HVAC Event";
+    static constexpr std::string_view fields[] = {"Type", "Zone", "Value", "ZoneID"};
+};
+
+struct Lighting {
+    static constexpr std::string_view name = "Lighting Control";
+    static constexpr std::string_view fields[] = {"Zone", "From", "To", "Source"};
+};
+
+struct AccessControl {
+    static constexpr std::string_view name = "Access Control";
+    static constexpr std::string_view fields[] = {"Door", "User", "Granted", "Reason"};
+};
+
+struct FireSafety {
+    static constexpr std::string_view name = "Fire Safety Event";
+    static constexpr std::string_view fields[] = {"Type", "Location"};
+};
+
+struct EnergyConsumption {
+    static constexpr std::string_view name = "Energy Consumption";
+    static constexpr std::string_view fields[] = {"Meter", "Consumption", "Peak"};
+};
+
+struct Knx {
+    static constexpr std::string_view name = "KNX Event";
+    static constexpr std::string_view fields[] = {"GroupAddress", "Value", "DPT"};
+};
+
+struct Bacnet {
+    static constexpr std::string_view name = "BACnet Event";
+    static constexpr std::string_view fields[] = {"ObjectType", "Instance", "Property", "Value"};
+};
+
+struct Schedule {
+    static constexpr std::string_view name = "Schedule Event";
+    static constexpr std::string_view fields[] = {"Schedule", "Action", "Zone"};
+};
+
+struct Elevator {
+    static constexpr std::string_view name = "Elevator Event";
+    static constexpr std::string_view fields[] = {"Elevator", "Type", "Floor"};
+};
+
+struct Security {
+    static constexpr std::string_view name = "Security Event";
+    static constexpr std::string_view fields[] = {"Type", "Location"};
+};
+
+} // namespace building_events
+
 /**
  * @brief Building automation audit logger
  * 
  * Extends AuditChain with building automation-specific logging
  * for KNX, BACnet, and other BAS protocols.
+ *
+ * Messages follow the schemas in building_events; the building and zone
+ * trailers are rendered once at construction. Entries are written into a
+ * reusable buffer; each returned entry stays valid until the next log_*
+ * call on the same adapter.
  */
 class BuildingAutomationAdapter {
 public:
-    explicit BuildingAutomationAdapter(const std::string& device_id,
-                                      const std::string& building_id = "",
-                                      const std::string& zone_id = "")
-        : chain_(device_id), building_id_(building_id), zone_id_(zone_id) {}
+    explicit BuildingAutomationAdapter(std::string_view device_id,
+                                      std::string_view building_id = "",
+                                      std::string_view zone_id = "")
+        : chain_(device_id), zone_id_(intern(zone_id)),
+          fire_safety_(constant_field("Zone", zone_id)),
+          energy_(constant_field("Building", building_id)),
+          elevator_(constant_field("Building", building_id)),
+          security_(constant_field("Zone", zone_id)) {}
+    
+    BuildingAutomationAdapter(BuildingAutomationAdapter&&) = default;
+    // Assigning over a live adapter would drop the events its coalescer holds
+    BuildingAutomationAdapter& operator=(BuildingAutomationAdapter&&) = delete;
+    
+    ~BuildingAutomationAdapter() {
+        flush_coalesced();
+    }
     
     /**
      * @brief Log HVAC event (temperature, humidity, airflow)
@@ -55,24 +134,14 @@ public:
      * @param value Value (temperature, humidity %, etc.)
      * @param unit Unit of measurement
      */
-    std::string log_hvac_event(const std::string& event_type,
-                              const std::string& zone,
-                              double value,
-                              const std::string& unit = "") {
-        std::ostringstream msg;
-        msg << "HVAC Event | "
-            << "Type:" << event_type << " | "
-            << "Zone:" << zone << " | "
-            << "Value:" << value;
-        
-        if (!unit.empty()) {
-            msg << " " << unit;
-        }
-        if (!zone_id_.empty() && zone_id_ != zone) {
-            msg << " | ZoneID:" << zone_id_;
-        }
-        
-        return chain_.log(msg.str(), UserID::Operator, Severity::Info);
+    const std::string& log_hvac_event(std::string_view event_type,
+                                      std::string_view zone,
+                                      double value,
+                                      std::string_view unit = {}) {
+        const std::string_view zone_id = zone_id_;
+        hvac_.render(msg_, event_type, zone, with_unit(value, unit, ' '),
+                     optional_field(zone_id, !zone_id.empty() && zone_id != zone));
+        return emit(UserID::Operator, Severity::Info);
     }
     
     /**
@@ -82,18 +151,13 @@ public:
      * @param new_level New brightness level (0-100%)
      * @param control_source Source of control (manual, schedule, sensor)
      */
-    std::string log_lighting_event(const std::string& zone,
-                                  int old_level,
-                                  int new_level,
-                                  const std::string& control_source = "manual") {
-        std::ostringstream msg;
-        msg << "Lighting Control | "
-            << "Zone:" << zone << " | "
-            << "From:" << old_level << "% | "
-            << "To:" << new_level << "% | "
-            << "Source:" << control_source;
-        
-        return chain_.log(msg.str(), UserID::Operator, Severity::Info);
+    const std::string& log_lighting_event(std::string_view zone,
+                                          int old_level,
+                                          int new_level,
+                                          std::string_view control_source = "manual") {
+        lighting_.render(msg_, zone, with_unit(old_level, "%"), with_unit(new_level, "%"),
+                         control_source);
+        return emit(UserID::Operator, Severity::Info);
     }
     
     /**
@@ -103,22 +167,13 @@ public:
      * @param granted Whether access was granted
      * @param reason Reason for denial (if denied)
      */
-    std::string log_access_control(const std::string& door_id,
-                                  const std::string& user_id,
-                                  bool granted,
-                                  const std::string& reason = "") {
-        std::ostringstream msg;
-        msg << "Access Control | "
-            << "Door:" << door_id << " | "
-            << "User:" << user_id << " | "
-            << "Granted:" << (granted ? "Yes" : "No");
-        
-        if (!granted && !reason.empty()) {
-            msg << " | Reason:" << reason;
-        }
-        
-        return chain_.log(msg.str(), UserID::System,
-                         granted ? Severity::Info : Severity::Warning);
+    const std::string& log_access_control(std::string_view door_id,
+                                          std::string_view user_id,
+                                          bool granted,
+                                          std::string_view reason = {}) {
+        access_control_.render(msg_, door_id, user_id, granted ? "Yes" : "No",
+                               optional_field(reason, !granted && !reason.empty()));
+        return emit(UserID::System, granted ? Severity::Info : Severity::Warning);
     }
     
     /**
@@ -127,19 +182,11 @@ public:
      * @param location Location/zone identifier
      * @param severity Event severity
      */
-    std::string log_fire_safety_event(const std::string& event_type,
-                                    const std::string& location,
-                                    Severity severity = Severity::Critical) {
-        std::ostringstream msg;
-        msg << "Fire Safety Event | "
-            << "Type:" << event_type << " | "
-            << "Location:" << location;
-        
-        if (!zone_id_.empty()) {
-            msg << " | Zone:" << zone_id_;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, severity);
+    const std::string& log_fire_safety_event(std::string_view event_type,
+                                             std::string_view location,
+                                             Severity severity = Severity::Critical) {
+        fire_safety_.render(msg_, event_type, location);
+        return emit(UserID::System, severity);
     }
     
     /**
@@ -148,22 +195,14 @@ public:
      * @param consumption_kwh Energy consumption in kWh
      * @param peak_demand_kw Peak demand in kW (if applicable)
      */
-    std::string log_energy_consumption(const std::string& meter_id,
-                                     double consumption_kwh,
-                                     double peak_demand_kw = 0.0) {
-        std::ostringstream msg;
-        msg << "Energy Consumption | "
-            << "Meter:" << meter_id << " | "
-            << "Consumption:" << consumption_kwh << " kWh";
-        
-        if (peak_demand_kw > 0.0) {
-            msg << " | Peak:" << peak_demand_kw << " kW";
-        }
-        if (!building_id_.empty()) {
-            msg << " | Building:" << building_id_;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_energy_consumption(std::string_view meter_id,
+                                              double consumption_kwh,
+                                              double peak_demand_kw = 0.0) {
+        energy_.render(msg_, meter_id, with_unit(consumption_kwh, "kWh", ' '),
+                       optional_field(with_unit(peak_demand_kw, "kW", ' '),
+                                      peak_demand_kw > 0.0));
+        return emit_coalesced(building_events::EnergyConsumption::name, meter_id,
+                              consumption_kwh, UserID::System, Severity::Info);
     }
     
     /**
@@ -172,19 +211,12 @@ public:
      * @param data_value Data value sent/received
      * @param data_type Data type (DPT - Datapoint Type)
      */
-    std::string log_knx_event(const std::string& group_address,
-                             const std::string& data_value,
-                             const std::string& data_type = "") {
-        std::ostringstream msg;
-        msg << "KNX Event | "
-            << "GroupAddress:" << group_address << " | "
-            << "Value:" << data_value;
-        
-        if (!data_type.empty()) {
-            msg << " | DPT:" << data_type;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_knx_event(std::string_view group_address,
+                                     std::string_view data_value,
+                                     std::string_view data_type = {}) {
+        knx_.render(msg_, group_address, data_value, if_not_empty(data_type));
+        return emit_coalesced(building_events::Knx::name, group_address, data_value,
+                              UserID::System, Severity::Info);
     }
     
     /**
@@ -194,18 +226,14 @@ public:
      * @param property_name Property name
      * @param value Property value
      */
-    std::string log_bacnet_event(const std::string& object_type,
-                                uint32_t object_instance,
-                                const std::string& property_name,
-                                const std::string& value) {
-        std::ostringstream msg;
-        msg << "BACnet Event | "
-            << "ObjectType:" << object_type << " | "
-            << "Instance:" << object_instance << " | "
-            << "Property:" << property_name << " | "
-            << "Value:" << value;
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_bacnet_event(std::string_view object_type,
+                                        uint32_t object_instance,
+                                        std::string_view property_name,
+                                        std::string_view value) {
+        bacnet_.render(msg_, object_type, object_instance, property_name, value);
+        if (coalescer_) key_.begin(object_type) << ':' << object_instance << ':' << property_name;
+        return emit_coalesced(building_events::Bacnet::name, key_.view(), value,
+                              UserID::System, Severity::Info);
     }
     
     /**
@@ -214,19 +242,11 @@ public:
      * @param action Action taken (on, off, setpoint change, etc.)
      * @param zone Zone affected
      */
-    std::string log_schedule_event(const std::string& schedule_name,
-                                  const std::string& action,
-                                  const std::string& zone = "") {
-        std::ostringstream msg;
-        msg << "Schedule Event | "
-            << "Schedule:" << schedule_name << " | "
-            << "Action:" << action;
-        
-        if (!zone.empty()) {
-            msg << " | Zone:" << zone;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_schedule_event(std::string_view schedule_name,
+                                          std::string_view action,
+                                          std::string_view zone = {}) {
+        schedule_.render(msg_, schedule_name, action, if_not_empty(zone));
+        return emit(UserID::System, Severity::Info);
     }
     
     /**
@@ -235,22 +255,11 @@ public:
      * @param event_type Event type (call, arrival, door open/close, etc.)
      * @param floor Floor number
      */
-    std::string log_elevator_event(const std::string& elevator_id,
-                                  const std::string& event_type,
-                                  int floor = -1) {
-        std::ostringstream msg;
-        msg << "Elevator Event | "
-            << "Elevator:" << elevator_id << " | "
-            << "Type:" << event_type;
-        
-        if (floor >= 0) {
-            msg << " | Floor:" << floor;
-        }
-        if (!building_id_.empty()) {
-            msg << " | Building:" << building_id_;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_elevator_event(std::string_view elevator_id,
+                                          std::string_view event_type,
+                                          int floor = -1) {
+        elevator_.render(msg_, elevator_id, event_type, optional_field(floor, floor >= 0));
+        return emit(UserID::System, Severity::Info);
     }
     
     /**
@@ -259,19 +268,40 @@ public:
      * @param location Location/zone identifier
      * @param severity Event severity
      */
-    std::string log_security_event(const std::string& event_type,
-                                  const std::string& location,
-                                  Severity severity = Severity::Warning) {
-        std::ostringstream msg;
-        msg << "Security Event | "
-            << "Type:" << event_type << " | "
-            << "Location:" << location;
-        
-        if (!zone_id_.empty()) {
-            msg << " | Zone:" << zone_id_;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, severity);
+    const std::string& log_security_event(std::string_view event_type,
+                                          std::string_view location,
+                                          Severity severity = Severity::Warning) {
+        security_.render(msg_, event_type, location);
+        return emit(UserID::System, severity);
+    }
+    
+    /**
+     * @brief Coalesce repeated telemetry before it is chained
+     *
+     * While enabled, log_energy_consumption() (per meter), log_knx_event()
+     * (per group address) and log_bacnet_event() (per object property)
+     * return an empty entry for events held in an open window. Records
+     * chained when a window closes go to the chain's LogSink, so attach one
+     * first (see EventCoalescer). Calling it again chains the events held
+     * so far before the new options apply.
+     */
+    void enable_coalescing(EventCoalescer::Options options = EventCoalescer::Options()) {
+        flush_coalesced();
+        coalescer_ = std::make_unique<EventCoalescer>(std::move(options));
+    }
+    
+    /**
+     * @brief Chain held events whose window has expired
+     */
+    void poll_coalesced() {
+        if (coalescer_) coalescer_->poll(chain_);
+    }
+    
+    /**
+     * @brief Chain all held events (also done on destruction)
+     */
+    void flush_coalesced() {
+        if (coalescer_) coalescer_->flush(chain_);
     }
     
     /**
@@ -289,8 +319,35 @@ public:
 
 private:
     AuditChain chain_;
-    std::string building_id_;
-    std::string zone_id_;
+    std::string_view zone_id_;
+    MessageBuilder msg_;
+    std::string entry_;
+    
+    EventFormat<building_events::Hvac> hvac_;
+    EventFormat<building_events::Lighting> lighting_;
+    EventFormat<building_events::AccessControl> access_control_;
+    EventFormat<building_events::FireSafety> fire_safety_;
+    EventFormat<building_events::EnergyConsumption> energy_;
+    EventFormat<building_events::Knx> knx_;
+    EventFormat<building_events::Bacnet> bacnet_;
+    EventFormat<building_events::Schedule> schedule_;
+    EventFormat<building_events::Elevator> elevator_;
+    EventFormat<building_events::Security> security_;
+    std::unique_ptr<EventCoalescer> coalescer_;
+    MessageBuilder key_;
+    
+    const std::string& emit(UserID user_id, Severity severity) {
+        chain_.log(entry_, msg_.view(), user_id, severity);
+        return entry_;
+    }
+    
+    template <typename Value>
+    const std::string& emit_coalesced(std::string_view event, std::string_view key,
+                                      const Value& value, UserID user_id, Severity severity) {
+        if (!coalescer_) return emit(user_id, severity);
+        coalescer_->submit(chain_, entry_, event, key, value, msg_.view(), user_id, severity);
+        return entry_;
+    }
 };
 
 } // namespace adapters
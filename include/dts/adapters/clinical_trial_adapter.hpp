@@ -12,11 +12,16 @@
 #ifndef DTS_CLINICAL_TRIAL_ADAPTER_HPP
 #define DTS_CLINICAL_TRIAL_ADAPTER_HPP
 
+#include "../anonymizer.hpp"
 #include "../audit_chain.hpp"
-#include <string>
+#include "../event_schema.hpp"
+#include "../message_builder.hpp"
+#include "../string_pool.hpp"
 #include <functional>
-#include <sstream>
-#include <iomanip>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace dts {
 namespace adapters {
@@ -35,11 +40,53 @@ enum class TrialEventType : uint8_t {
     DataAnonymized = 8
 };
 
+/**
+ * @brief Message schemas of ClinicalTrialAdapter events
+ */
+namespace trial_events {
+
+struct PatientEnrolled {
+    static constexpr std::string_view name = "Patient Enrolled";
+    static constexpr std::string_view fields[] = {"PatientID", "SiteID", "Protocol", "Date"};
+};
+
+/// Named "Visit Started" or "Visit Completed"
+struct Visit {
+    static constexpr std::string_view name = "Visit";
+    static constexpr std::string_view fields[] = {"PatientID", "VisitNumber", "VisitType"};
+};
+
+struct DataCollected {
+    static constexpr std::string_view name = "Data Collected";
+    static constexpr std::string_view fields[] = {"PatientID", "DataType", "CRF", "Points"};
+};
+
+struct ProtocolDeviation {
+    static constexpr std::string_view name = "Protocol Deviation";
+    static constexpr std::string_view fields[] = {"PatientID", "Type", "Description"};
+};
+
+struct AdverseEvent {
+    static constexpr std::string_view name = "Adverse Event";
+    static constexpr std::string_view fields[] = {"PatientID", "Type", "Severity", "Related"};
+};
+
+struct DataExported {
+    static constexpr std::string_view name = "Data Exported";
+    static constexpr std::string_view fields[] = {"Type", "Destination", "Records", "Anonymized"};
+};
+
+} // namespace trial_events
+
 /**
  * @brief Clinical trial audit logger
  * 
  * Extends AuditChain with clinical trial-specific logging, including
  * automatic patient ID anonymization and protocol compliance tracking.
+ *
+ * Messages follow the schemas in trial_events. Entries are written into a
+ * reusable buffer; each returned entry stays valid until the next log_*
+ * call on the same adapter.
  */
 class ClinicalTrialAdapter {
 public:
@@ -49,25 +96,17 @@ public:
      */
     using AnonymizerFunc = std::function<std::string(const std::string&)>;
     
-    explicit ClinicalTrialAdapter(const std::string& device_id,
-                                 const std::string& protocol_id = "",
+    /**
+     * @param anonymizer Custom anonymizer; nullptr selects the default
+     *        "ANON-" + first 8 bytes of SHA-256 (hex), computed in place
+     *        (see set_anonymizer_key() for a keyed form)
+     */
+    explicit ClinicalTrialAdapter(std::string_view device_id,
+                                 std::string_view protocol_id = "",
                                  AnonymizerFunc anonymizer = nullptr)
-        : chain_(device_id), protocol_id_(protocol_id) {
-        if (anonymizer) {
-            anonymizer_ = anonymizer;
-        } else {
-            // Default: use SHA-256 hash (first 16 chars for readability)
-            anonymizer_ = [](const std::string& id) {
-                auto hash = dts::SHA256::hash(id);
-                std::ostringstream ss;
-                for (size_t i = 0; i < 8; ++i) {
-                    ss << std::hex << std::setfill('0') << std::setw(2)
-                       << static_cast<int>(hash[i]);
-                }
-                return "ANON-" + ss.str();
-            };
-        }
-    }
+        : chain_(device_id), protocol_id_(intern(protocol_id)),
+          anonymizer_(std::move(anonymizer)),
+          protocol_deviation_(constant_field("Protocol", protocol_id)) {}
     
     /**
      * @brief Log patient enrollment event
@@ -75,24 +114,12 @@ public:
      * @param site_id Clinical site identifier
      * @param enrollment_date Enrollment date/time
      */
-    std::string log_patient_enrolled(const std::string& patient_id,
-                                    const std::string& site_id,
-                                    const std::string& enrollment_date = "") {
-        std::string anon_id = anonymizer_(patient_id);
-        
-        std::ostringstream msg;
-        msg << "Patient Enrolled | "
-            << "PatientID:" << anon_id << " | "
-            << "SiteID:" << site_id;
-        
-        if (!protocol_id_.empty()) {
-            msg << " | Protocol:" << protocol_id_;
-        }
-        if (!enrollment_date.empty()) {
-            msg << " | Date:" << enrollment_date;
-        }
-        
-        return chain_.log(msg.str(), UserID::Operator, Severity::Info);
+    const std::string& log_patient_enrolled(std::string_view patient_id,
+                                            std::string_view site_id,
+                                            std::string_view enrollment_date = {}) {
+        patient_enrolled_.render(msg_, anonymize(patient_id), site_id,
+                                 if_not_empty(protocol_id_), if_not_empty(enrollment_date));
+        return emit(UserID::Operator, Severity::Info);
     }
     
     /**
@@ -102,23 +129,14 @@ public:
      * @param visit_number Visit number
      * @param visit_type Visit type (e.g., "Screening", "Baseline", "Follow-up")
      */
-    std::string log_visit_event(TrialEventType event_type,
-                               const std::string& patient_id,
-                               int visit_number,
-                               const std::string& visit_type = "") {
-        std::string anon_id = anonymizer_(patient_id);
-        
-        std::ostringstream msg;
-        msg << (event_type == TrialEventType::VisitStarted 
-                ? "Visit Started" : "Visit Completed") << " | "
-            << "PatientID:" << anon_id << " | "
-            << "VisitNumber:" << visit_number;
-        
-        if (!visit_type.empty()) {
-            msg << " | VisitType:" << visit_type;
-        }
-        
-        return chain_.log(msg.str(), UserID::Operator, Severity::Info);
+    const std::string& log_visit_event(TrialEventType event_type,
+                                       std::string_view patient_id,
+                                       int visit_number,
+                                       std::string_view visit_type = {}) {
+        visit_.render_as(msg_, event_type == TrialEventType::VisitStarted
+                               ? "Visit Started" : "Visit Completed",
+                         anonymize(patient_id), visit_number, if_not_empty(visit_type));
+        return emit(UserID::Operator, Severity::Info);
     }
     
     /**
@@ -128,25 +146,13 @@ public:
      * @param form_id Case Report Form (CRF) identifier
      * @param data_point_count Number of data points collected
      */
-    std::string log_data_collected(const std::string& patient_id,
-                                  const std::string& data_type,
-                                  const std::string& form_id = "",
-                                  int data_point_count = 0) {
-        std::string anon_id = anonymizer_(patient_id);
-        
-        std::ostringstream msg;
-        msg << "Data Collected | "
-            << "PatientID:" << anon_id << " | "
-            << "DataType:" << data_type;
-        
-        if (!form_id.empty()) {
-            msg << " | CRF:" << form_id;
-        }
-        if (data_point_count > 0) {
-            msg << " | Points:" << data_point_count;
-        }
-        
-        return chain_.log(msg.str(), UserID::Operator, Severity::Info);
+    const std::string& log_data_collected(std::string_view patient_id,
+                                          std::string_view data_type,
+                                          std::string_view form_id = {},
+                                          int data_point_count = 0) {
+        data_collected_.render(msg_, anonymize(patient_id), data_type, if_not_empty(form_id),
+                               optional_field(data_point_count, data_point_count > 0));
+        return emit(UserID::Operator, Severity::Info);
     }
     
     /**
@@ -156,23 +162,12 @@ public:
      * @param description Deviation description
      * @param severity Deviation severity
      */
-    std::string log_protocol_deviation(const std::string& patient_id,
-                                      const std::string& deviation_type,
-                                      const std::string& description,
-                                      Severity severity = Severity::Warning) {
-        std::string anon_id = anonymizer_(patient_id);
-        
-        std::ostringstream msg;
-        msg << "Protocol Deviation | "
-            << "PatientID:" << anon_id << " | "
-            << "Type:" << deviation_type << " | "
-            << "Description:" << description;
-        
-        if (!protocol_id_.empty()) {
-            msg << " | Protocol:" << protocol_id_;
-        }
-        
-        return chain_.log(msg.str(), UserID::Operator, severity);
+    const std::string& log_protocol_deviation(std::string_view patient_id,
+                                              std::string_view deviation_type,
+                                              std::string_view description,
+                                              Severity severity = Severity::Warning) {
+        protocol_deviation_.render(msg_, anonymize(patient_id), deviation_type, description);
+        return emit(UserID::Operator, severity);
     }
     
     /**
@@ -182,22 +177,44 @@ public:
      * @param severity AE severity (mild/moderate/severe)
      * @param relatedness Whether AE is related to investigational product
      */
-    std::string log_adverse_event(const std::string& patient_id,
-                                 const std::string& ae_type,
-                                 const std::string& severity,
-                                 bool relatedness = false) {
-        std::string anon_id = anonymizer_(patient_id);
-        
-        std::ostringstream msg;
-        msg << "Adverse Event | "
-            << "PatientID:" << anon_id << " | "
-            << "Type:" << ae_type << " | "
-            << "Severity:" << severity << " | "
-            << "Related:" << (relatedness ? "Yes" : "No");
-        
-        return chain_.log(msg.str(), UserID::Operator, Severity::Error);
+    const std::string& log_adverse_event(std::string_view patient_id,
+                                         std::string_view ae_type,
+                                         std::string_view severity,
+                                         bool relatedness = false) {
+        adverse_event_.render(msg_, anonymize(patient_id), ae_type, severity,
+                              relatedness ? "Yes" : "No");
+        return emit(UserID::Operator, Severity::Error);
+    }
+    
+    /**
+     * @brief Derive default pseudonyms from a secret key
+     *
+     * Replaces the bare SHA-256 form with "ANON-" + first 8 bytes of
+     * HMAC-SHA256(key, patient_id). Ignored while a custom anonymizer is
+     * set. Clears an attached cache.
+     */
+    void set_anonymizer_key(std::string_view key) {
+        hmac_ = std::make_shared<HmacAnonymizer>(key);
+        if (cache_) cache_->clear();
+    }
+    
+    /**
+     * @brief Remember the last @p capacity pseudonyms (opt-in)
+     */
+    void enable_anonymizer_cache(size_t capacity = 1024) {
+        cache_ = std::make_shared<AnonymizerCache>(capacity);
+    }
+    
+    /**
+     * @brief Use a cache shared with other adapters that anonymize the same way
+     */
+    void set_anonymizer_cache(std::shared_ptr<AnonymizerCache> cache) {
+        cache_ = std::move(cache);
     }
     
+    /// Attached cache, or nullptr
+    const std::shared_ptr<AnonymizerCache>& anonymizer_cache() const { return cache_; }
+    
     /**
      * @brief Log data export event (for data transfer audit)
      * @param export_type Type of export (e.g., "CRF", "Lab Data", "Imaging")
@@ -205,18 +222,13 @@ public:
      * @param record_count Number of records exported
      * @param anonymized Whether data was anonymized before export
      */
-    std::string log_data_export(const std::string& export_type,
-                               const std::string& destination,
-                               int record_count,
-                               bool anonymized = true) {
-        std::ostringstream msg;
-        msg << "Data Exported | "
-            << "Type:" << export_type << " | "
-            << "Destination:" << destination << " | "
-            << "Records:" << record_count << " | "
-            << "Anonymized:" << (anonymized ? "Yes" : "No");
-        
-        return chain_.log(msg.str(), UserID::Admin, Severity::Info);
+    const std::string& log_data_export(std::string_view export_type,
+                                       std::string_view destination,
+                                       int record_count,
+                                       bool anonymized = true) {
+        data_exported_.render(msg_, export_type, destination, record_count,
+                              anonymized ? "Yes" : "No");
+        return emit(UserID::Admin, Severity::Info);
     }
     
     /**
@@ -234,8 +246,49 @@ public:
 
 private:
     AuditChain chain_;
-    std::string protocol_id_;
+    std::string_view protocol_id_;
     AnonymizerFunc anonymizer_;
+    std::shared_ptr<const HmacAnonymizer> hmac_;
+    std::shared_ptr<AnonymizerCache> cache_;
+    MessageBuilder msg_;
+    std::string entry_;
+    std::string patient_id_;    ///< Argument buffer for a custom anonymizer
+    std::string anon_id_;       ///< Anonymized ID of the current message
+    
+    EventFormat<trial_events::PatientEnrolled> patient_enrolled_;
+    EventFormat<trial_events::Visit> visit_;
+    EventFormat<trial_events::DataCollected> data_collected_;
+    EventFormat<trial_events::ProtocolDeviation> protocol_deviation_;
+    EventFormat<trial_events::AdverseEvent> adverse_event_;
+    EventFormat<trial_events::DataExported> data_exported_;
+    
+    const std::string& emit(UserID user_id, Severity severity) {
+        chain_.log(entry_, msg_.view(), user_id, severity);
+        return entry_;
+    }
+    
+    std::string_view anonymize(std::string_view patient_id) {
+        if (cache_) {
+            cache_->get(patient_id, anon_id_, [this](std::string_view id, std::string& out) {
+                compute_anonymized(id, out);
+            });
+        } else {
+            compute_anonymized(patient_id, anon_id_);
+        }
+        return anon_id_;
+    }
+    
+    void compute_anonymized(std::string_view patient_id, std::string& out) {
+        if (anonymizer_) {
+            patient_id_.assign(patient_id.data(), patient_id.size());
+            out = anonymizer_(patient_id_);
+            detail::secure_wipe(patient_id_);
+        } else if (hmac_) {
+            (*hmac_)(patient_id, out);
+        } else {
+            sha256_anonymize(patient_id, out);
+        }
+    }
 };
 
 } // namespace adapters
@@ -13,8 +13,12 @@
 #define DTS_DICOM_ADAPTER_HPP
 
 #include "../audit_chain.hpp"
+#include "../event_schema.hpp"
+#include "../message_builder.hpp"
+#include "../string_pool.hpp"
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <vector>
 
 namespace dts {
 namespace adapters {
@@ -35,17 +39,73 @@ enum class DICOMEventType : uint8_t {
     AccessDenied = 10
 };
 
+/**
+ * @brief Message schemas of DICOMAdapter events
+ */
+namespace dicom_events {
+
+struct StudyCreated {
+    static constexpr std::string_view name = "DICOM Study Created";
+    static constexpr std::string_view fields[] = {"StudyInstanceUID", "PatientID", "Modality"};
+};
+
+struct AiInferenceRequest {
+    static constexpr std::string_view name = "AI Inference Request";
+    static constexpr std::string_view fields[] = {"StudyInstanceUID", "Model", "Version",
+                                                  "InputInstances"};
+};
+
+struct AiInferenceCompleted {
+    static constexpr std::string_view name = "AI Inference Completed";
+    static constexpr std::string_view fields[] = {"StudyInstanceUID", "Model", "InferenceID",
+                                                  "Result"};
+};
+
+struct InstanceStored {
+    static constexpr std::string_view name = "DICOM Instance Stored";
+    static constexpr std::string_view fields[] = {"StudyInstanceUID", "SOPInstanceUID",
+                                                  "SOPClassUID"};
+};
+
+struct TransferInitiated {
+    static constexpr std::string_view name = "DICOM Transfer Initiated";
+    static constexpr std::string_view fields[] = {"StudyInstanceUID", "Destination",
+                                                  "TransferSyntax"};
+};
+
+/// Named "DICOM Access Granted" or "DICOM Access Denied"
+struct Access {
+    static constexpr std::string_view name = "DICOM Access";
+    static constexpr std::string_view fields[] = {"StudyInstanceUID", "Reason"};
+};
+
+} // namespace dicom_events
+
+/**
+ * @brief One instance of DICOMAdapter::log_instances_stored()
+ */
+struct StoredInstance {
+    std::string_view sop_instance_uid;
+    std::string_view sop_class_uid;
+};
+
 /**
  * @brief DICOM-specific audit logger
  * 
  * Extends AuditChain with DICOM-aware event logging, automatically
  * extracting and logging relevant DICOM tags for compliance.
+ *
+ * Messages follow the schemas in dicom_events; the AE title trailer is
+ * rendered once at construction. Entries are written into a reusable
+ * buffer; each returned entry stays valid until the next log_* call on the
+ * same adapter.
  */
 class DICOMAdapter {
 public:
-    explicit DICOMAdapter(const std::string& device_id, 
-                         const std::string& ae_title = "")
-        : chain_(device_id), ae_title_(ae_title) {}
+    explicit DICOMAdapter(std::string_view device_id, 
+                         std::string_view ae_title = "")
+        : chain_(device_id), ae_title_(intern(ae_title)),
+          study_created_(constant_field("AETitle", ae_title)) {}
     
     /**
      * @brief Log DICOM study creation event
@@ -54,21 +114,12 @@ public:
      * @param modality Modality (0008,0060)
      * @param user_id User who created the study
      */
-    std::string log_study_created(const std::string& study_instance_uid,
-                                   const std::string& patient_id,
-                                   const std::string& modality,
-                                   UserID user_id = UserID::Operator) {
-        std::ostringstream msg;
-        msg << "DICOM Study Created | "
-            << "StudyInstanceUID:" << study_instance_uid << " | "
-            << "PatientID:" << patient_id << " | "
-            << "Modality:" << modality;
-        
-        if (!ae_title_.empty()) {
-            msg << " | AETitle:" << ae_title_;
-        }
-        
-        return chain_.log(msg.str(), user_id, Severity::Info);
+    const std::string& log_study_created(std::string_view study_instance_uid,
+                                         std::string_view patient_id,
+                                         std::string_view modality,
+                                         UserID user_id = UserID::Operator) {
+        study_created_.render(msg_, study_instance_uid, patient_id, modality);
+        return emit(user_id, Severity::Info);
     }
     
     /**
@@ -78,18 +129,13 @@ public:
      * @param model_version Model version
      * @param input_instances Number of DICOM instances in input
      */
-    std::string log_ai_inference_request(const std::string& study_instance_uid,
-                                         const std::string& model_name,
-                                         const std::string& model_version,
-                                         int input_instances = 1) {
-        std::ostringstream msg;
-        msg << "AI Inference Request | "
-            << "StudyInstanceUID:" << study_instance_uid << " | "
-            << "Model:" << model_name << " | "
-            << "Version:" << model_version << " | "
-            << "InputInstances:" << input_instances;
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Warning);
+    const std::string& log_ai_inference_request(std::string_view study_instance_uid,
+                                                std::string_view model_name,
+                                                std::string_view model_version,
+                                                int input_instances = 1) {
+        ai_inference_request_.render(msg_, study_instance_uid, model_name, model_version,
+                                     input_instances);
+        return emit(UserID::System, Severity::Warning);
     }
     
     /**
@@ -99,18 +145,13 @@ public:
      * @param inference_id Unique inference identifier
      * @param result_summary Summary of AI output (e.g., "Priority: HIGH")
      */
-    std::string log_ai_inference_completed(const std::string& study_instance_uid,
-                                           const std::string& model_name,
-                                           const std::string& inference_id,
-                                           const std::string& result_summary) {
-        std::ostringstream msg;
-        msg << "AI Inference Completed | "
-            << "StudyInstanceUID:" << study_instance_uid << " | "
-            << "Model:" << model_name << " | "
-            << "InferenceID:" << inference_id << " | "
-            << "Result:" << result_summary;
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_ai_inference_completed(std::string_view study_instance_uid,
+                                                  std::string_view model_name,
+                                                  std::string_view inference_id,
+                                                  std::string_view result_summary) {
+        ai_inference_completed_.render(msg_, study_instance_uid, model_name, inference_id,
+                                       result_summary);
+        return emit(UserID::System, Severity::Info);
     }
     
     /**
@@ -119,16 +160,35 @@ public:
      * @param sop_instance_uid SOP Instance UID (0008,0018)
      * @param sop_class_uid SOP Class UID (0008,0016)
      */
-    std::string log_instance_stored(const std::string& study_instance_uid,
-                                    const std::string& sop_instance_uid,
-                                    const std::string& sop_class_uid) {
-        std::ostringstream msg;
-        msg << "DICOM Instance Stored | "
-            << "StudyInstanceUID:" << study_instance_uid << " | "
-            << "SOPInstanceUID:" << sop_instance_uid << " | "
-            << "SOPClassUID:" << sop_class_uid;
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_instance_stored(std::string_view study_instance_uid,
+                                           std::string_view sop_instance_uid,
+                                           std::string_view sop_class_uid) {
+        instance_stored_.render(msg_, study_instance_uid, sop_instance_uid, sop_class_uid);
+        return emit(UserID::System, Severity::Info);
+    }
+    
+    /**
+     * @brief Log a whole series of stored instances as one batch
+     *
+     * Same entries as log_instance_stored() per instance, chained with
+     * AuditChain::log_batch(): one timestamp and one sink write.
+     * @return The entries, each followed by '\n'
+     */
+    const std::string& log_instances_stored(std::string_view study_instance_uid,
+                                            const StoredInstance* instances, size_t count) {
+        batch_.clear();
+        for (size_t i = 0; i < count; ++i) {
+            instance_stored_.render(msg_, study_instance_uid, instances[i].sop_instance_uid,
+                                    instances[i].sop_class_uid);
+            batch_.add(msg_.view(), UserID::System, Severity::Info);
+        }
+        chain_.log_batch(entry_, batch_);
+        return entry_;
+    }
+    
+    const std::string& log_instances_stored(std::string_view study_instance_uid,
+                                            const std::vector<StoredInstance>& instances) {
+        return log_instances_stored(study_instance_uid, instances.data(), instances.size());
     }
     
     /**
@@ -137,19 +197,12 @@ public:
      * @param destination Destination AE Title or endpoint
      * @param transfer_syntax Transfer syntax UID
      */
-    std::string log_transfer_initiated(const std::string& study_instance_uid,
-                                      const std::string& destination,
-                                      const std::string& transfer_syntax = "") {
-        std::ostringstream msg;
-        msg << "DICOM Transfer Initiated | "
-            << "StudyInstanceUID:" << study_instance_uid << " | "
-            << "Destination:" << destination;
-        
-        if (!transfer_syntax.empty()) {
-            msg << " | TransferSyntax:" << transfer_syntax;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_transfer_initiated(std::string_view study_instance_uid,
+                                              std::string_view destination,
+                                              std::string_view transfer_syntax = {}) {
+        transfer_initiated_.render(msg_, study_instance_uid, destination,
+                                   if_not_empty(transfer_syntax));
+        return emit(UserID::System, Severity::Info);
     }
     
     /**
@@ -159,20 +212,13 @@ public:
      * @param granted Whether access was granted
      * @param reason Reason for denial (if denied)
      */
-    std::string log_access_event(const std::string& study_instance_uid,
-                                 UserID user_id,
-                                 bool granted,
-                                 const std::string& reason = "") {
-        std::ostringstream msg;
-        msg << "DICOM Access " << (granted ? "Granted" : "Denied") << " | "
-            << "StudyInstanceUID:" << study_instance_uid;
-        
-        if (!granted && !reason.empty()) {
-            msg << " | Reason:" << reason;
-        }
-        
-        return chain_.log(msg.str(), user_id, 
-                         granted ? Severity::Info : Severity::Warning);
+    const std::string& log_access_event(std::string_view study_instance_uid,
+                                        UserID user_id,
+                                        bool granted,
+                                        std::string_view reason = {}) {
+        access_.render_as(msg_, granted ? "DICOM Access Granted" : "DICOM Access Denied",
+                          study_instance_uid, optional_field(reason, !granted && !reason.empty()));
+        return emit(user_id, granted ? Severity::Info : Severity::Warning);
     }
     
     /**
@@ -190,7 +236,22 @@ public:
 
 private:
     AuditChain chain_;
-    std::string ae_title_;
+    std::string_view ae_title_;
+    MessageBuilder msg_;
+    std::string entry_;
+    EventBatch batch_;
+    
+    EventFormat<dicom_events::StudyCreated> study_created_;
+    EventFormat<dicom_events::AiInferenceRequest> ai_inference_request_;
+    EventFormat<dicom_events::AiInferenceCompleted> ai_inference_completed_;
+    EventFormat<dicom_events::InstanceStored> instance_stored_;
+    EventFormat<dicom_events::TransferInitiated> transfer_initiated_;
+    EventFormat<dicom_events::Access> access_;
+    
+    const std::string& emit(UserID user_id, Severity severity) {
+        chain_.log(entry_, msg_.view(), user_id, severity);
+        return entry_;
+    }
 };
 
 } // namespace adapters
@@ -16,8 +16,13 @@
 #define DTS_INDUSTRIAL_ADAPTER_HPP
 
 #include "../audit_chain.hpp"
+#include "../event_coalescer.hpp"
+#include "../event_schema.hpp"
+#include "../message_builder.hpp"
+#include <memory>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <vector>
 
 namespace dts {
 namespace adapters {
@@ -51,18 +56,132 @@ enum class ProductionEventType : uint8_t {
     QualityCheckFailed = 7
 };
 
+/**
+ * @brief Message schemas of IndustrialAdapter events
+ */
+namespace industrial_events {
+
+struct PlcEvent {
+    static constexpr std::string_view name = "PLC Event";
+    static constexpr std::string_view fields[] = {"Program", "Rung", ""};
+};
+
+struct InputChange {
+    static constexpr std::string_view name = "I/O Change";
+    static constexpr std::string_view fields[] = {"Input", "From", "To"};
+};
+
+struct OutputChange {
+    static constexpr std::string_view name = "I/O Change";
+    static constexpr std::string_view fields[] = {"Output", "From", "To"};
+};
+
+struct ScadaAlarm {
+    static constexpr std::string_view name = "SCADA Alarm";
+    static constexpr std::string_view fields[] = {"ID", "Message", "Acknowledged"};
+};
+
+/// Named after its ProductionEventType ("Batch Started", ...)
+struct Production {
+    static constexpr std::string_view name = "Production Event";
+    static constexpr std::string_view fields[] = {"BatchID", "Product", "Quantity"};
+};
+
+/// The first field is the protocol name
+struct ProtocolEvent {
+    static constexpr std::string_view name = "Protocol Event";
+    static constexpr std::string_view fields[] = {"", "From", "To", "Function", "Status"};
+};
+
+/// Named "Safety Interlock TRIGGERED" or "Safety Interlock RESET"
+struct SafetyInterlock {
+    static constexpr std::string_view name = "Safety Interlock";
+    static constexpr std::string_view fields[] = {"ID", "Reason"};
+};
+
+struct EquipmentStatus {
+    static constexpr std::string_view name = "Equipment Status Change";
+    static constexpr std::string_view fields[] = {"Equipment", "From", "To"};
+};
+
+struct ParameterChange {
+    static constexpr std::string_view name = "Parameter Changed";
+    static constexpr std::string_view fields[] = {"Parameter", "From", "To"};
+};
+
+struct Maintenance {
+    static constexpr std::string_view name = "Maintenance";
+    static constexpr std::string_view fields[] = {"Type", "Technician", "Description"};
+};
+
+} // namespace industrial_events
+
+/**
+ * @brief One change of IndustrialAdapter::log_io_changes()
+ */
+struct IoChange {
+    std::string_view io_address;
+    std::string_view old_value;
+    std::string_view new_value;
+    bool is_output = false;
+};
+
+static constexpr EnumNames<ProtocolType> protocol_names({
+    {ProtocolType::Modbus, "Modbus"},
+    {ProtocolType::OPCUA, "OPC UA"},
+    {ProtocolType::EtherNetIP, "EtherNet/IP"},
+    {ProtocolType::Profinet, "Profinet"},
+    {ProtocolType::DNP3, "DNP3"},
+    {ProtocolType::IEC61850, "IEC 61850"},
+    {ProtocolType::BACnet, "BACnet"},
+    {ProtocolType::KNX, "KNX"},
+    {ProtocolType::MQTT, "MQTT"},
+}, "Other");
+
+static constexpr EnumNames<ProductionEventType> production_event_names({
+    {ProductionEventType::BatchStarted, "Batch Started"},
+    {ProductionEventType::BatchCompleted, "Batch Completed"},
+    {ProductionEventType::BatchAborted, "Batch Aborted"},
+    {ProductionEventType::RecipeLoaded, "Recipe Loaded"},
+    {ProductionEventType::RecipeChanged, "Recipe Changed"},
+    {ProductionEventType::QualityCheckPassed, "Quality Check Passed"},
+    {ProductionEventType::QualityCheckFailed, "Quality Check Failed"},
+}, "");
+
 /**
  * @brief Industrial/OT audit logger
  * 
  * Extends AuditChain with industrial control system-specific logging
  * for PLCs, SCADA, MES, and manufacturing equipment.
+ *
+ * Messages follow the schemas in industrial_events; the asset tag and line
+ * ID trailers are rendered once at construction. Entries are written into
+ * a reusable buffer; each returned entry stays valid until the next log_*
+ * call on the same adapter.
  */
 class IndustrialAdapter {
 public:
-    explicit IndustrialAdapter(const std::string& device_id,
-                             const std::string& asset_tag = "",
-                             const std::string& line_id = "")
-        : chain_(device_id), asset_tag_(asset_tag), line_id_(line_id) {}
+    explicit IndustrialAdapter(std::string_view device_id,
+                             std::string_view asset_tag = "",
+                             std::string_view line_id = "")
+        : chain_(device_id),
+          plc_event_(constant_field("Asset", asset_tag)),
+          input_change_(constant_field("Asset", asset_tag)),
+          output_change_(constant_field("Asset", asset_tag)),
+          scada_alarm_(constant_field("Asset", asset_tag)),
+          production_(constant_field("Line", line_id)),
+          safety_interlock_(constant_field("Asset", asset_tag)),
+          equipment_status_(constant_field("Line", line_id)),
+          parameter_change_(constant_field("Asset", asset_tag)),
+          maintenance_(constant_field("Asset", asset_tag)) {}
+    
+    IndustrialAdapter(IndustrialAdapter&&) = default;
+    // Assigning over a live adapter would drop the events its coalescer holds
+    IndustrialAdapter& operator=(IndustrialAdapter&&) = delete;
+    
+    ~IndustrialAdapter() {
+        flush_coalesced();
+    }
     
     /**
      * @brief Log PLC program execution event
@@ -70,23 +189,12 @@ public:
      * @param rung_number Ladder logic rung number (if applicable)
      * @param event_description Event description
      */
-    std::string log_plc_event(const std::string& program_name,
-                             int rung_number = -1,
-                             const std::string& event_description = "") {
-        std::ostringstream msg;
-        msg << "PLC Event | Program:" << program_name;
-        
-        if (rung_number >= 0) {
-            msg << " | Rung:" << rung_number;
-        }
-        if (!event_description.empty()) {
-            msg << " | " << event_description;
-        }
-        if (!asset_tag_.empty()) {
-            msg << " | Asset:" << asset_tag_;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_plc_event(std::string_view program_name,
+                                     int rung_number = -1,
+                                     std::string_view event_description = {}) {
+        plc_event_.render(msg_, program_name, optional_field(rung_number, rung_number >= 0),
+                          if_not_empty(event_description));
+        return emit(UserID::System, Severity::Info);
     }
     
     /**
@@ -96,21 +204,55 @@ public:
      * @param new_value New value
      * @param io_type Input or Output
      */
-    std::string log_io_change(const std::string& io_address,
-                              const std::string& old_value,
-                              const std::string& new_value,
-                              bool is_output = false) {
-        std::ostringstream msg;
-        msg << "I/O Change | "
-            << (is_output ? "Output" : "Input") << ":" << io_address << " | "
-            << "From:" << old_value << " | "
-            << "To:" << new_value;
-        
-        if (!asset_tag_.empty()) {
-            msg << " | Asset:" << asset_tag_;
+    const std::string& log_io_change(std::string_view io_address,
+                                     std::string_view old_value,
+                                     std::string_view new_value,
+                                     bool is_output = false) {
+        if (is_output) {
+            output_change_.render(msg_, io_address, old_value, new_value);
+        } else {
+            input_change_.render(msg_, io_address, old_value, new_value);
         }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+        return emit_coalesced(industrial_events::InputChange::name, io_address, new_value,
+                              UserID::System, Severity::Info);
+    }
+    
+    /**
+     * @brief Log a scan's worth of I/O changes as one batch
+     *
+     * Same entries as log_io_change() per change, chained with
+     * AuditChain::log_batch(): one timestamp and one sink write. With
+     * coalescing enabled each change is submitted to the coalescer instead,
+     * and only the entries it releases are returned.
+     * @return The entries, each followed by '\n'
+     */
+    const std::string& log_io_changes(const IoChange* changes, size_t count) {
+        if (coalescer_) {
+            batch_entries_.clear();
+            for (size_t i = 0; i < count; ++i) {
+                const IoChange& change = changes[i];
+                const std::string& entry = log_io_change(change.io_address, change.old_value,
+                                                         change.new_value, change.is_output);
+                if (!entry.empty()) batch_entries_.append(entry).push_back('\n');
+            }
+            return batch_entries_;
+        }
+        batch_.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const IoChange& change = changes[i];
+            if (change.is_output) {
+                output_change_.render(msg_, change.io_address, change.old_value, change.new_value);
+            } else {
+                input_change_.render(msg_, change.io_address, change.old_value, change.new_value);
+            }
+            batch_.add(msg_.view(), UserID::System, Severity::Info);
+        }
+        chain_.log_batch(batch_entries_, batch_);
+        return batch_entries_;
+    }
+    
+    const std::string& log_io_changes(const std::vector<IoChange>& changes) {
+        return log_io_changes(changes.data(), changes.size());
     }
     
     /**
@@ -120,21 +262,12 @@ public:
      * @param severity Alarm severity
      * @param acknowledged Whether alarm was acknowledged
      */
-    std::string log_scada_alarm(const std::string& alarm_id,
-                               const std::string& alarm_message,
-                               Severity severity = Severity::Warning,
-                               bool acknowledged = false) {
-        std::ostringstream msg;
-        msg << "SCADA Alarm | "
-            << "ID:" << alarm_id << " | "
-            << "Message:" << alarm_message << " | "
-            << "Acknowledged:" << (acknowledged ? "Yes" : "No");
-        
-        if (!asset_tag_.empty()) {
-            msg << " | Asset:" << asset_tag_;
-        }
-        
-        return chain_.log(msg.str(), UserID::Operator, severity);
+    const std::string& log_scada_alarm(std::string_view alarm_id,
+                                       std::string_view alarm_message,
+                                       Severity severity = Severity::Warning,
+                                       bool acknowledged = false) {
+        scada_alarm_.render(msg_, alarm_id, alarm_message, acknowledged ? "Yes" : "No");
+        return emit(UserID::Operator, severity);
     }
     
     /**
@@ -144,53 +277,18 @@ public:
      * @param product_code Product code/SKU
      * @param quantity Quantity produced (if applicable)
      */
-    std::string log_production_event(ProductionEventType event_type,
-                                    const std::string& batch_id,
-                                    const std::string& product_code = "",
-                                    int quantity = 0) {
-        std::ostringstream msg;
-        
-        switch (event_type) {
-            case ProductionEventType::BatchStarted:
-                msg << "Batch Started";
-                break;
-            case ProductionEventType::BatchCompleted:
-                msg << "Batch Completed";
-                break;
-            case ProductionEventType::BatchAborted:
-                msg << "Batch Aborted";
-                break;
-            case ProductionEventType::RecipeLoaded:
-                msg << "Recipe Loaded";
-                break;
-            case ProductionEventType::RecipeChanged:
-                msg << "Recipe Changed";
-                break;
-            case ProductionEventType::QualityCheckPassed:
-                msg << "Quality Check Passed";
-                break;
-            case ProductionEventType::QualityCheckFailed:
-                msg << "Quality Check Failed";
-                break;
-        }
-        
-        msg << " | BatchID:" << batch_id;
-        
-        if (!product_code.empty()) {
-            msg << " | Product:" << product_code;
-        }
-        if (quantity > 0) {
-            msg << " | Quantity:" << quantity;
-        }
-        if (!line_id_.empty()) {
-            msg << " | Line:" << line_id_;
-        }
+    const std::string& log_production_event(ProductionEventType event_type,
+                                            std::string_view batch_id,
+                                            std::string_view product_code = {},
+                                            int quantity = 0) {
+        production_.render_as(msg_, production_event_names[event_type], batch_id,
+                              if_not_empty(product_code), optional_field(quantity, quantity > 0));
         
         Severity sev = (event_type == ProductionEventType::QualityCheckFailed ||
                        event_type == ProductionEventType::BatchAborted)
                       ? Severity::Error : Severity::Info;
         
-        return chain_.log(msg.str(), UserID::Operator, sev);
+        return emit(UserID::Operator, sev);
     }
     
     /**
@@ -201,56 +299,15 @@ public:
      * @param function_code Function code/operation (e.g., Modbus function code)
      * @param success Whether operation succeeded
      */
-    std::string log_protocol_event(ProtocolType protocol,
-                                  const std::string& source_address,
-                                  const std::string& destination_address,
-                                  const std::string& function_code = "",
-                                  bool success = true) {
-        std::ostringstream msg;
-        msg << "Protocol Event | ";
-        
-        switch (protocol) {
-            case ProtocolType::Modbus:
-                msg << "Modbus";
-                break;
-            case ProtocolType::OPCUA:
-                msg << "OPC UA";
-                break;
-            case ProtocolType::EtherNetIP:
-                msg << "EtherNet/IP";
-                break;
-            case ProtocolType::Profinet:
-                msg << "Profinet";
-                break;
-            case ProtocolType::DNP3:
-                msg << "DNP3";
-                break;
-            case ProtocolType::IEC61850:
-                msg << "IEC 61850";
-                break;
-            case ProtocolType::BACnet:
-                msg << "BACnet";
-                break;
-            case ProtocolType::KNX:
-                msg << "KNX";
-                break;
-            case ProtocolType::MQTT:
-                msg << "MQTT";
-                break;
-            default:
-                msg << "Other";
-                break;
-        }
-        
-        msg << " | From:" << source_address << " | To:" << destination_address;
-        
-        if (!function_code.empty()) {
-            msg << " | Function:" << function_code;
-        }
-        msg << " | Status:" << (success ? "Success" : "Failed");
-        
-        return chain_.log(msg.str(), UserID::System,
-                         success ? Severity::Info : Severity::Warning);
+    const std::string& log_protocol_event(ProtocolType protocol,
+                                          std::string_view source_address,
+                                          std::string_view destination_address,
+                                          std::string_view function_code = {},
+                                          bool success = true) {
+        protocol_event_.render(msg_, protocol_names[protocol], source_address,
+                               destination_address, if_not_empty(function_code),
+                               success ? "Success" : "Failed");
+        return emit(UserID::System, success ? Severity::Info : Severity::Warning);
     }
     
     /**
@@ -259,22 +316,13 @@ public:
      * @param triggered Whether interlock was triggered
      * @param reason Reason for trigger/reset
      */
-    std::string log_safety_interlock(const std::string& interlock_id,
-                                    bool triggered,
-                                    const std::string& reason = "") {
-        std::ostringstream msg;
-        msg << "Safety Interlock " << (triggered ? "TRIGGERED" : "RESET") << " | "
-            << "ID:" << interlock_id;
-        
-        if (!reason.empty()) {
-            msg << " | Reason:" << reason;
-        }
-        if (!asset_tag_.empty()) {
-            msg << " | Asset:" << asset_tag_;
-        }
-        
-        return chain_.log(msg.str(), UserID::System,
-                         triggered ? Severity::Critical : Severity::Info);
+    const std::string& log_safety_interlock(std::string_view interlock_id,
+                                            bool triggered,
+                                            std::string_view reason = {}) {
+        safety_interlock_.render_as(msg_, triggered ? "Safety Interlock TRIGGERED"
+                                                    : "Safety Interlock RESET",
+                                    interlock_id, if_not_empty(reason));
+        return emit(UserID::System, triggered ? Severity::Critical : Severity::Info);
     }
     
     /**
@@ -283,20 +331,11 @@ public:
      * @param old_status Previous status
      * @param new_status New status
      */
-    std::string log_equipment_status(const std::string& equipment_id,
-                                     const std::string& old_status,
-                                     const std::string& new_status) {
-        std::ostringstream msg;
-        msg << "Equipment Status Change | "
-            << "Equipment:" << equipment_id << " | "
-            << "From:" << old_status << " | "
-            << "To:" << new_status;
-        
-        if (!line_id_.empty()) {
-            msg << " | Line:" << line_id_;
-        }
-        
-        return chain_.log(msg.str(), UserID::System, Severity::Info);
+    const std::string& log_equipment_status(std::string_view equipment_id,
+                                            std::string_view old_status,
+                                            std::string_view new_status) {
+        equipment_status_.render(msg_, equipment_id, old_status, new_status);
+        return emit(UserID::System, Severity::Info);
     }
     
     /**
@@ -306,21 +345,12 @@ public:
      * @param new_value New value
      * @param user_id User who made the change
      */
-    std::string log_parameter_change(const std::string& parameter_name,
-                                    const std::string& old_value,
-                                    const std::string& new_value,
-                                    UserID user_id = UserID::Operator) {
-        std::ostringstream msg;
-        msg << "Parameter Changed | "
-            << "Parameter:" << parameter_name << " | "
-            << "From:" << old_value << " | "
-            << "To:" << new_value;
-        
-        if (!asset_tag_.empty()) {
-            msg << " | Asset:" << asset_tag_;
-        }
-        
-        return chain_.log(msg.str(), user_id, Severity::Warning);
+    const std::string& log_parameter_change(std::string_view parameter_name,
+                                            std::string_view old_value,
+                                            std::string_view new_value,
+                                            UserID user_id = UserID::Operator) {
+        parameter_change_.render(msg_, parameter_name, old_value, new_value);
+        return emit(user_id, Severity::Warning);
     }
     
     /**
@@ -329,22 +359,38 @@ public:
      * @param technician_id Technician identifier
      * @param description Maintenance description
      */
-    std::string log_maintenance(const std::string& maintenance_type,
-                               const std::string& technician_id,
-                               const std::string& description = "") {
-        std::ostringstream msg;
-        msg << "Maintenance | "
-            << "Type:" << maintenance_type << " | "
-            << "Technician:" << technician_id;
-        
-        if (!description.empty()) {
-            msg << " | Description:" << description;
-        }
-        if (!asset_tag_.empty()) {
-            msg << " | Asset:" << asset_tag_;
-        }
-        
-        return chain_.log(msg.str(), UserID::Service, Severity::Info);
+    const std::string& log_maintenance(std::string_view maintenance_type,
+                                       std::string_view technician_id,
+                                       std::string_view description = {}) {
+        maintenance_.render(msg_, maintenance_type, technician_id, if_not_empty(description));
+        return emit(UserID::Service, Severity::Info);
+    }
+    
+    /**
+     * @brief Coalesce repeated I/O changes per address before they are chained
+     *
+     * While enabled, log_io_change() returns an empty entry for events held
+     * in an open window. Records chained when a window closes go to the
+     * chain's LogSink, so attach one first (see EventCoalescer). Calling it
+     * again chains the events held so far before the new options apply.
+     */
+    void enable_coalescing(EventCoalescer::Options options = EventCoalescer::Options()) {
+        flush_coalesced();
+        coalescer_ = std::make_unique<EventCoalescer>(std::move(options));
+    }
+    
+    /**
+     * @brief Chain held events whose window has expired
+     */
+    void poll_coalesced() {
+        if (coalescer_) coalescer_->poll(chain_);
+    }
+    
+    /**
+     * @brief Chain all held events (also done on destruction)
+     */
+    void flush_coalesced() {
+        if (coalescer_) coalescer_->flush(chain_);
     }
     
     /**
@@ -362,8 +408,35 @@ public:
 
 private:
     AuditChain chain_;
-    std::string asset_tag_;
-    std::string line_id_;
+    MessageBuilder msg_;
+    std::string entry_;
+    std::string batch_entries_;
+    EventBatch batch_;
+    
+    EventFormat<industrial_events::PlcEvent> plc_event_;
+    EventFormat<industrial_events::InputChange> input_change_;
+    EventFormat<industrial_events::OutputChange> output_change_;
+    EventFormat<industrial_events::ScadaAlarm> scada_alarm_;
+    EventFormat<industrial_events::Production> production_;
+    EventFormat<industrial_events::ProtocolEvent> protocol_event_;
+    EventFormat<industrial_events::SafetyInterlock> safety_interlock_;
+    EventFormat<industrial_events::EquipmentStatus> equipment_status_;
+    EventFormat<industrial_events::ParameterChange> parameter_change_;
+    EventFormat<industrial_events::Maintenance> maintenance_;
+    std::unique_ptr<EventCoalescer> coalescer_;
+    
+    const std::string& emit(UserID user_id, Severity severity) {
+        chain_.log(entry_, msg_.view(), user_id, severity);
+        return entry_;
+    }
+    
+    template <typename Value>
+    const std::string& emit_coalesced(std::string_view event, std::string_view key,
+                                      const Value& value, UserID user_id, Severity severity) {
+        if (!coalescer_) return emit(user_id, severity);
+        coalescer_->submit(chain_, entry_, event, key, value, msg_.view(), user_id, severity);
+        return entry_;
+    }
 };
 
 } // namespace adapters
@@ -13,61 +13,41 @@
 #define DTS_MEDTECH_ADAPTER_HPP
 
 #include "../audit_chain.hpp"
+#include "../event_schema.hpp"
+#include "medtech_events.hpp"
+#include "../message_builder.hpp"
+#include "../string_pool.hpp"
 #include <string>
-#include <sstream>
+#include <string_view>
 
 namespace dts {
 namespace adapters {
 
-/**
- * @brief Alarm priority levels (IEC 60601-1-8)
- */
-enum class AlarmPriority : uint8_t {
-    Low = 1,
-    Medium = 2,
-    High = 3,
-    Critical = 4
-};
-
-/**
- * @brief Medication administration event types
- */
-enum class MedicationEventType : uint8_t {
-    Loaded = 1,
-    Started = 2,
-    Paused = 3,
-    Stopped = 4,
-    Completed = 5,
-    Error = 6
-};
-
 /**
  * @brief MedTech device audit logger
  * 
  * Extends AuditChain with medical device-specific event logging
  * for infusion pumps, ventilators, and other safety-critical devices.
+ *
+ * Messages follow the schemas in medtech_events. Entries are written into
+ * a reusable buffer; each returned entry stays valid until the next log_*
+ * call on the same adapter.
  */
 class MedTechAdapter {
 public:
-    explicit MedTechAdapter(const std::string& device_id,
-                           const std::string& device_type = "")
-        : chain_(device_id), device_type_(device_type) {}
+    explicit MedTechAdapter(std::string_view device_id,
+                           std::string_view device_type = "")
+        : chain_(device_id), device_type_(intern(device_type)) {}
     
     /**
      * @brief Log power-on self-test (POST) result
      * @param passed Whether POST passed
      * @param details POST details or failure reason
      */
-    std::string log_post_result(bool passed, const std::string& details = "") {
-        std::ostringstream msg;
-        msg << "POST " << (passed ? "PASSED" : "FAILED");
-        
-        if (!details.empty()) {
-            msg << " | " << details;
-        }
-        
-        return chain_.log(msg.str(), UserID::System,
-                         passed ? Severity::Info : Severity::Critical);
+    const std::string& log_post_result(bool passed, std::string_view details = {}) {
+        post_result_.render_as(msg_, passed ? "POST PASSED" : "POST FAILED",
+                               if_not_empty(details));
+        return emit(UserID::System, passed ? Severity::Info : Severity::Critical);
     }
     
     /**
@@ -78,51 +58,16 @@ public:
      * @param rate Infusion rate (e.g., "2.5 mL/hr")
      * @param duration Duration in minutes (if applicable)
      */
-    std::string log_medication_event(MedicationEventType event_type,
-                                    const std::string& drug_name,
-                                    const std::string& concentration = "",
-                                    const std::string& rate = "",
-                                    int duration = 0) {
-        std::ostringstream msg;
-        
-        switch (event_type) {
-            case MedicationEventType::Loaded:
-                msg << "Medication Loaded";
-                break;
-            case MedicationEventType::Started:
-                msg << "Infusion Started";
-                break;
-            case MedicationEventType::Paused:
-                msg << "Infusion Paused";
-                break;
-            case MedicationEventType::Stopped:
-                msg << "Infusion Stopped";
-                break;
-            case MedicationEventType::Completed:
-                msg << "Infusion Completed";
-                break;
-            case MedicationEventType::Error:
-                msg << "Medication Error";
-                break;
-        }
-        
-        msg << " | Drug:" << drug_name;
+    const std::string& log_medication_event(MedicationEventType event_type,
+                                            std::string_view drug_name,
+                                            std::string_view concentration = {},
+                                            std::string_view rate = {},
+                                            int duration = 0) {
+        medication_.render_as(msg_, medication_event_names[event_type], drug_name,
+                              if_not_empty(concentration), if_not_empty(rate),
+                              optional_field(with_unit(duration, "min"), duration > 0));
         
-        if (!concentration.empty()) {
-            msg << " | Concentration:" << concentration;
-        }
-        if (!rate.empty()) {
-            msg << " | Rate:" << rate;
-        }
-        if (duration > 0) {
-            msg << " | Duration:" << duration << "min";
-        }
-        
-        Severity sev = (event_type == MedicationEventType::Error) 
-                      ? Severity::Error 
-                      : Severity::Info;
-        
-        return chain_.log(msg.str(), UserID::Operator, sev);
+        return emit(UserID::Operator, medication_severity(event_type));
     }
     
     /**
@@ -132,27 +77,14 @@ public:
      * @param description Alarm description
      * @param action_taken Action taken in response
      */
-    std::string log_safety_alarm(const std::string& alarm_type,
-                                AlarmPriority priority,
-                                const std::string& description,
-                                const std::string& action_taken = "") {
-        std::ostringstream msg;
-        msg << "Safety Alarm | "
-            << "Type:" << alarm_type << " | "
-            << "Priority:" << static_cast<int>(priority) << " | "
-            << "Description:" << description;
-        
-        if (!action_taken.empty()) {
-            msg << " | Action:" << action_taken;
-        }
+    const std::string& log_safety_alarm(std::string_view alarm_type,
+                                        AlarmPriority priority,
+                                        std::string_view description,
+                                        std::string_view action_taken = {}) {
+        safety_alarm_.render(msg_, alarm_type, static_cast<int>(priority), description,
+                             if_not_empty(action_taken));
         
-        Severity sev = (priority == AlarmPriority::Critical) 
-                      ? Severity::Critical
-                      : (priority == AlarmPriority::High)
-                      ? Severity::Error
-                      : Severity::Warning;
-        
-        return chain_.log(msg.str(), UserID::System, sev);
+        return emit(UserID::System, alarm_severity(priority));
     }
     
     /**
@@ -161,16 +93,12 @@ public:
      * @param technician_id Service technician identifier
      * @param result Calibration result (pass/fail)
      */
-    std::string log_calibration(const std::string& calibration_type,
-                               const std::string& technician_id,
-                               bool result) {
-        std::ostringstream msg;
-        msg << "Calibration " << (result ? "PASSED" : "FAILED") << " | "
-            << "Type:" << calibration_type << " | "
-            << "Technician:" << technician_id;
-        
-        return chain_.log(msg.str(), UserID::Service,
-                         result ? Severity::Info : Severity::Warning);
+    const std::string& log_calibration(std::string_view calibration_type,
+                                       std::string_view technician_id,
+                                       bool result) {
+        calibration_.render_as(msg_, result ? "Calibration PASSED" : "Calibration FAILED",
+                               calibration_type, technician_id);
+        return emit(UserID::Service, result ? Severity::Info : Severity::Warning);
     }
     
     /**
@@ -179,16 +107,13 @@ public:
      * @param new_version New firmware version
      * @param success Whether update succeeded
      */
-    std::string log_firmware_update(const std::string& old_version,
-                                    const std::string& new_version,
-                                    bool success) {
-        std::ostringstream msg;
-        msg << "Firmware Update " << (success ? "SUCCESS" : "FAILED") << " | "
-            << "From:" << old_version << " | "
-            << "To:" << new_version;
-        
-        return chain_.log(msg.str(), UserID::Admin,
-                         success ? Severity::Info : Severity::Error);
+    const std::string& log_firmware_update(std::string_view old_version,
+                                           std::string_view new_version,
+                                           bool success) {
+        firmware_update_.render_as(msg_, success ? "Firmware Update SUCCESS"
+                                                 : "Firmware Update FAILED",
+                                   old_version, new_version);
+        return emit(UserID::Admin, success ? Severity::Info : Severity::Error);
     }
     
     /**
@@ -197,19 +122,11 @@ public:
      * @param technician_id Service technician
      * @param notes Maintenance notes
      */
-    std::string log_maintenance(const std::string& maintenance_type,
-                               const std::string& technician_id,
-                               const std::string& notes = "") {
-        std::ostringstream msg;
-        msg << "Maintenance | "
-            << "Type:" << maintenance_type << " | "
-            << "Technician:" << technician_id;
-        
-        if (!notes.empty()) {
-            msg << " | Notes:" << notes;
-        }
-        
-        return chain_.log(msg.str(), UserID::Service, Severity::Info);
+    const std::string& log_maintenance(std::string_view maintenance_type,
+                                       std::string_view technician_id,
+                                       std::string_view notes = {}) {
+        maintenance_.render(msg_, maintenance_type, technician_id, if_not_empty(notes));
+        return emit(UserID::Service, Severity::Info);
     }
     
     /**
@@ -227,7 +144,21 @@ public:
 
 private:
     AuditChain chain_;
-    std::string device_type_;
+    std::string_view device_type_;
+    MessageBuilder msg_;
+    std::string entry_;
+    
+    EventFormat<medtech_events::PostResult> post_result_;
+    EventFormat<medtech_events::Medication> medication_;
+    EventFormat<medtech_events::SafetyAlarm> safety_alarm_;
+    EventFormat<medtech_events::Calibration> calibration_;
+    EventFormat<medtech_events::FirmwareUpdate> firmware_update_;
+    EventFormat<medtech_events::Maintenance> maintenance_;
+    
+    const std::string& emit(UserID user_id, Severity severity) {
+        chain_.log(entry_, msg_.view(), user_id, severity);
+        return entry_;
+    }
 };
 
 } // namespace adapters
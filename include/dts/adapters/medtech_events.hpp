@@ -0,0 +1,110 @@
+/**
+ * @file medtech_events.hpp
+ * @brief Event types and message schemas of the MedTech adapters
+ *
+ * Shared by MedTechAdapter and StaticMedTechAdapter, so both render the
+ * same messages with the same severities. Allocation-free.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_MEDTECH_EVENTS_HPP
+#define DTS_MEDTECH_EVENTS_HPP
+
+#include "../entry_format.hpp"
+#include "../event_fields.hpp"
+#include <cstdint>
+#include <string_view>
+
+namespace dts {
+namespace adapters {
+
+/**
+ * @brief Alarm priority levels (IEC 60601-1-8)
+ */
+enum class AlarmPriority : uint8_t {
+    Low = 1,
+    Medium = 2,
+    High = 3,
+    Critical = 4
+};
+
+/**
+ * @brief Medication administration event types
+ */
+enum class MedicationEventType : uint8_t {
+    Loaded = 1,
+    Started = 2,
+    Paused = 3,
+    Stopped = 4,
+    Completed = 5,
+    Error = 6
+};
+
+/**
+ * @brief Message schemas of MedTechAdapter events
+ */
+namespace medtech_events {
+
+/// Named "POST PASSED" or "POST FAILED"; the field is the free-text detail
+struct PostResult {
+    static constexpr std::string_view name = "POST";
+    static constexpr std::string_view fields[] = {""};
+};
+
+/// Named after its MedicationEventType ("Infusion Started", ...)
+struct Medication {
+    static constexpr std::string_view name = "Medication Event";
+    static constexpr std::string_view fields[] = {"Drug", "Concentration", "Rate", "Duration"};
+};
+
+struct SafetyAlarm {
+    static constexpr std::string_view name = "Safety Alarm";
+    static constexpr std::string_view fields[] = {"Type", "Priority", "Description", "Action"};
+};
+
+/// Named "Calibration PASSED" or "Calibration FAILED"
+struct Calibration {
+    static constexpr std::string_view name = "Calibration";
+    static constexpr std::string_view fields[] = {"Type", "Technician"};
+};
+
+/// Named "Firmware Update SUCCESS" or "Firmware Update FAILED"
+struct FirmwareUpdate {
+    static constexpr std::string_view name = "Firmware Update";
+    static constexpr std::string_view fields[] = {"From", "To"};
+};
+
+struct Maintenance {
+    static constexpr std::string_view name = "Maintenance";
+    static constexpr std::string_view fields[] = {"Type", "Technician", "Notes"};
+};
+
+} // namespace medtech_events
+
+static constexpr EnumNames<MedicationEventType> medication_event_names({
+    {MedicationEventType::Loaded, "Medication Loaded"},
+    {MedicationEventType::Started, "Infusion Started"},
+    {MedicationEventType::Paused, "Infusion Paused"},
+    {MedicationEventType::Stopped, "Infusion Stopped"},
+    {MedicationEventType::Completed, "Infusion Completed"},
+    {MedicationEventType::Error, "Medication Error"},
+}, "");
+
+/// Entry severity of a medication event
+inline Severity medication_severity(MedicationEventType event_type) {
+    return event_type == MedicationEventType::Error ? Severity::Error : Severity::Info;
+}
+
+/// Entry severity of a safety alarm
+inline Severity alarm_severity(AlarmPriority priority) {
+    return priority == AlarmPriority::Critical ? Severity::Critical
+         : priority == AlarmPriority::High     ? Severity::Error
+                                               : Severity::Warning;
+}
+
+} // namespace adapters
+} // namespace dts
+
+#endif // DTS_MEDTECH_EVENTS_HPP
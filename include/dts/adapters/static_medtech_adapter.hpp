@@ -0,0 +1,111 @@
+/**
+ * @file static_medtech_adapter.hpp
+ * @brief MedTech audit logging on a fixed-capacity chain (no heap)
+ *
+ * StaticMedTechAdapter offers the log_* calls of MedTechAdapter on top of
+ * StaticAuditChain, for boards that cannot use the heap. Messages are
+ * rendered into an inline buffer from the medtech_events schemas. The
+ * same inputs and timestamps therefore give the same entries as
+ * MedTechAdapter. Each call returns the entry length, or 0 if the message
+ * or entry did not fit or the ring was full.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_STATIC_MEDTECH_ADAPTER_HPP
+#define DTS_STATIC_MEDTECH_ADAPTER_HPP
+
+#include "../static_audit_chain.hpp"
+#include "../static_message.hpp"
+#include "medtech_events.hpp"
+#include <cstddef>
+#include <string_view>
+
+namespace dts {
+namespace adapters {
+
+/**
+ * @brief Allocation-free MedTech device audit logger
+ * @tparam SlotBytes, Slots See StaticAuditChain
+ * @tparam MessageBytes Capacity of the message buffer
+ */
+template <size_t SlotBytes = 512, size_t Slots = 8, size_t MessageBytes = 256>
+class StaticMedTechAdapter {
+public:
+    using Chain = StaticAuditChain<SlotBytes, Slots>;
+
+    explicit StaticMedTechAdapter(std::string_view device_id, StaticClock clock = nullptr)
+        : chain_(device_id, clock) {}
+
+    size_t log_post_result(bool passed, std::string_view details = {}) {
+        render_event<medtech_events::PostResult>(msg_, passed ? "POST PASSED" : "POST FAILED",
+                                                 if_not_empty(details));
+        return emit(UserID::System, passed ? Severity::Info : Severity::Critical);
+    }
+
+    size_t log_medication_event(MedicationEventType event_type, std::string_view drug_name,
+                                std::string_view concentration = {}, std::string_view rate = {},
+                                int duration = 0) {
+        render_event<medtech_events::Medication>(
+            msg_, medication_event_names[event_type], drug_name, if_not_empty(concentration),
+            if_not_empty(rate), optional_field(with_unit(duration, "min"), duration > 0));
+        return emit(UserID::Operator, medication_severity(event_type));
+    }
+
+    size_t log_safety_alarm(std::string_view alarm_type, AlarmPriority priority,
+                            std::string_view description, std::string_view action_taken = {}) {
+        render_event<medtech_events::SafetyAlarm>(msg_, medtech_events::SafetyAlarm::name,
+                                                  alarm_type, static_cast<int>(priority),
+                                                  description, if_not_empty(action_taken));
+        return emit(UserID::System, alarm_severity(priority));
+    }
+
+    size_t log_calibration(std::string_view calibration_type, std::string_view technician_id,
+                           bool result) {
+        render_event<medtech_events::Calibration>(
+            msg_, result ? "Calibration PASSED" : "Calibration FAILED", calibration_type,
+            technician_id);
+        return emit(UserID::Service, result ? Severity::Info : Severity::Warning);
+    }
+
+    size_t log_firmware_update(std::string_view old_version, std::string_view new_version,
+                               bool success) {
+        render_event<medtech_events::FirmwareUpdate>(
+            msg_, success ? "Firmware Update SUCCESS" : "Firmware Update FAILED", old_version,
+            new_version);
+        return emit(UserID::Admin, success ? Severity::Info : Severity::Error);
+    }
+
+    size_t log_maintenance(std::string_view maintenance_type, std::string_view technician_id,
+                           std::string_view notes = {}) {
+        render_event<medtech_events::Maintenance>(msg_, medtech_events::Maintenance::name,
+                                                  maintenance_type, technician_id,
+                                                  if_not_empty(notes));
+        return emit(UserID::Service, Severity::Info);
+    }
+
+    Chain& get_chain() { return chain_; }
+    const Chain& get_chain() const { return chain_; }
+
+    /// Messages refused, not logged, because they did not fit MessageBytes
+    uint64_t rejected() const { return rejected_; }
+
+private:
+    Chain chain_;
+    StaticMessageBuilder<MessageBytes> msg_;
+    uint64_t rejected_ = 0;
+
+    size_t emit(UserID user_id, Severity severity) {
+        if (msg_.overflowed()) {
+            ++rejected_;
+            return 0;
+        }
+        return chain_.log(msg_.view(), user_id, severity);
+    }
+};
+
+} // namespace adapters
+} // namespace dts
+
+#endif // DTS_STATIC_MEDTECH_ADAPTER_HPP
@@ -0,0 +1,207 @@
+/**
+ * @file anonymizer.hpp
+ * @brief Pseudonymous patient IDs: SHA-256 / HMAC-SHA256 forms and an LRU cache
+ *
+ * Clinical systems log many events per patient, so the same identifiers are
+ * pseudonymized over and over. AnonymizerCache remembers recent results in
+ * a bounded, thread-safe LRU table. Cached plaintext IDs are overwritten
+ * with zeros when evicted, when the cache is cleared and when it is
+ * destroyed, so they do not linger in freed memory.
+ *
+ * HmacAnonymizer derives IDs from a secret key instead of a bare hash, so
+ * an attacker who knows the ID format cannot confirm a guess by hashing it.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_ANONYMIZER_HPP
+#define DTS_ANONYMIZER_HPP
+
+#include "format.hpp"
+#include "hmac.hpp"
+#include "sha256.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dts {
+
+/// Length of "ANON-" + 16 hex digits
+constexpr size_t anonymized_id_length = 21;
+
+namespace detail {
+
+/// Write "ANON-" + hex of the first 8 bytes of @p digest
+inline void format_anonymized_id(const SHA256::Hash& digest, char* out) {
+    std::memcpy(out, "ANON-", 5);
+    hex_encode(digest.data(), 8, out + 5);
+}
+
+} // namespace detail
+
+/**
+ * @brief "ANON-" + first 8 bytes of SHA-256(id), hex (ClinicalTrialAdapter's default)
+ */
+inline void sha256_anonymize(std::string_view id, std::string& out) {
+    const auto digest = SHA256::hash(reinterpret_cast<const uint8_t*>(id.data()), id.size());
+    out.resize(anonymized_id_length);
+    detail::format_anonymized_id(digest, &out[0]);
+}
+
+/**
+ * @brief Keyed pseudonyms: "ANON-" + first 8 bytes of HMAC-SHA256(key, id), hex
+ */
+class HmacAnonymizer {
+public:
+    explicit HmacAnonymizer(std::string_view key) : hmac_(key) {}
+
+    void operator()(std::string_view id, std::string& out) const {
+        out.resize(anonymized_id_length);
+        detail::format_anonymized_id(hmac_.mac(id), &out[0]);
+    }
+
+private:
+    HmacSha256 hmac_;
+};
+
+/**
+ * @brief Bounded, thread-safe LRU cache from plaintext IDs to pseudonyms
+ *
+ * A cache is only valid for a single anonymization function; share one
+ * instance only among adapters that anonymize the same way.
+ */
+class AnonymizerCache {
+public:
+    explicit AnonymizerCache(size_t capacity = 1024) : capacity_(capacity ? capacity : 1) {
+        // Fixed node storage: index_ holds views of the node keys
+        nodes_.reserve(capacity_);
+        index_.reserve(capacity_);
+    }
+
+    ~AnonymizerCache() { clear(); }
+
+    AnonymizerCache(const AnonymizerCache&) = delete;
+    AnonymizerCache& operator=(const AnonymizerCache&) = delete;
+
+    /**
+     * @brief Pseudonym of @p id into @p out, calling compute(id, out) on a miss
+     * @return true on a cache hit
+     */
+    template <typename Compute>
+    bool get(std::string_view id, std::string& out, Compute&& compute) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(id);
+        if (it != index_.end()) {
+            const uint32_t node = it->second;
+            touch(node);
+            out.assign(nodes_[node].value);
+            ++hits_;
+            return true;
+        }
+        ++misses_;
+        compute(id, out);
+
+        uint32_t node;
+        if (nodes_.size() < capacity_) {
+            node = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        } else {
+            node = tail_;
+            unlink(node);
+            index_.erase(nodes_[node].key);
+            detail::secure_wipe(nodes_[node].key);
+            ++evictions_;
+        }
+        Node& entry = nodes_[node];
+        entry.key.assign(id.data(), id.size());
+        entry.value = out;
+        push_front(node);
+        index_.emplace(entry.key, node);
+        return false;
+    }
+
+    /// Forget and wipe every cached ID
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        for (Node& node : nodes_) {
+            detail::secure_wipe(node.key);
+        }
+        nodes_.clear();
+        head_ = tail_ = none;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return nodes_.size();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    uint64_t hits() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+
+    uint64_t misses() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+
+    uint64_t evictions() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return evictions_;
+    }
+
+private:
+    static constexpr uint32_t none = ~uint32_t{0};
+
+    struct Node {
+        std::string key;
+        std::string value;
+        uint32_t prev = none;
+        uint32_t next = none;
+    };
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::vector<Node> nodes_;
+    std::unordered_map<std::string_view, uint32_t> index_;
+    uint32_t head_ = none;      ///< Most recently used
+    uint32_t tail_ = none;      ///< Next to evict
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+
+    void unlink(uint32_t node) {
+        Node& n = nodes_[node];
+        if (n.prev != none) nodes_[n.prev].next = n.next; else head_ = n.next;
+        if (n.next != none) nodes_[n.next].prev = n.prev; else tail_ = n.prev;
+        n.prev = n.next = none;
+    }
+
+    void push_front(uint32_t node) {
+        Node& n = nodes_[node];
+        n.prev = none;
+        n.next = head_;
+        if (head_ != none) nodes_[head_].prev = node;
+        head_ = node;
+        if (tail_ == none) tail_ = node;
+    }
+
+    void touch(uint32_t node) {
+        if (node == head_) return;
+        unlink(node);
+        push_front(node);
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_ANONYMIZER_HPP
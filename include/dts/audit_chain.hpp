@@ -13,165 +13,190 @@
 #ifndef DTS_AUDIT_CHAIN_HPP
 #define DTS_AUDIT_CHAIN_HPP
 
+#include "chain_state.hpp"
+#include "entry_format.hpp"
+#include "entry_parser.hpp"
+#include "format.hpp"
+#include "merkle.hpp"
+#include "metrics.hpp"
+#include "sha256.hpp"
+#include "string_pool.hpp"
+#include "timestamp.hpp"
+
 #include <array>
 #include <cstdint>
 #include <string>
-#include <sstream>
-#include <iomanip>
+#include <string_view>
 #include <chrono>
 #include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace dts {
 
 /**
- * @brief SHA-256 hash implementation (lightweight, header-only)
+ * @brief Metadata describing one chained entry
  */
-class SHA256 {
+struct EntryInfo {
+    uint64_t sequence;          ///< 1-based position in the chain
+    int64_t timestamp_ms;       ///< Milliseconds since the Unix epoch
+    UserID user_id;
+    Severity severity;
+    SHA256::Hash chain_hash;    ///< Hash of this entry
+    SHA256::Hash previous_hash; ///< Hash of the entry before it
+    std::string_view device_id; ///< Valid only during LogSink::write()
+    std::string_view message;   ///< Raw (unescaped) message; valid only during LogSink::write()
+};
+
+/**
+ * @brief One event of a batch (see AuditChain::log_batch())
+ */
+struct LogEvent {
+    std::string_view message;
+    UserID user_id = UserID::System;
+    Severity severity = Severity::Info;
+};
+
+/**
+ * @brief Reusable list of events whose messages are copied into one buffer
+ *
+ * Lets callers build a batch from temporaries (e.g., MessageBuilder output)
+ * without allocating per event once the buffers have grown.
+ */
+class EventBatch {
 public:
-    using Hash = std::array<uint8_t, 32>;
-    
-    static Hash hash(const uint8_t* data, size_t len) {
-        SHA256 ctx;
-        ctx.update(data, len);
-        return ctx.finalize();
+    void add(std::string_view message, UserID user_id = UserID::System,
+             Severity severity = Severity::Info) {
+        text_.append(message.data(), message.size());
+        // Re-pointed by events(): text_ may move as it grows
+        events_.push_back({std::string_view(text_.data() + text_.size() - message.size(),
+                                            message.size()), user_id, severity});
     }
-    
-    static Hash hash(const std::string& str) {
-        return hash(reinterpret_cast<const uint8_t*>(str.data()), str.size());
-    }
-    
-    void update(const uint8_t* data, size_t len) {
-        for (size_t i = 0; i < len; ++i) {
-            buffer[buffer_len++] = data[i];
-            if (buffer_len == 64) {
-                transform();
-                buffer_len = 0;
-            }
-        }
-        bit_len += len * 8;
+
+    void clear() {
+        events_.clear();
+        text_.clear();
     }
-    
-    Hash finalize() {
-        uint64_t bit_len_be = swap_endian(bit_len);
-        uint8_t pad_len = (buffer_len < 56) ? (56 - buffer_len) : (120 - buffer_len);
-        update(padding, pad_len);
-        update(reinterpret_cast<const uint8_t*>(&bit_len_be), 8);
-        
-        Hash result;
-        for (int i = 0; i < 8; ++i) {
-            result[i * 4 + 0] = (h[i] >> 24) & 0xFF;
-            result[i * 4 + 1] = (h[i] >> 16) & 0xFF;
-            result[i * 4 + 2] = (h[i] >> 8) & 0xFF;
-            result[i * 4 + 3] = (h[i] >> 0) & 0xFF;
+
+    size_t size() const { return events_.size(); }
+    bool empty() const { return events_.empty(); }
+
+    /// Events with views into the batch; valid until the next add() or clear()
+    const LogEvent* events() {
+        size_t offset = 0;
+        for (LogEvent& event : events_) {
+            event.message = std::string_view(text_.data() + offset, event.message.size());
+            offset += event.message.size();
         }
-        return result;
+        return events_.data();
     }
-    
+
 private:
-    static constexpr uint8_t padding[64] = {0x80};
-    
-    uint32_t h[8] = {
-        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
-    };
+    std::vector<LogEvent> events_;
+    std::string text_;
+};
+
+/**
+ * @brief Destination for chained entries
+ *
+ * Attached with AuditChain::set_sink(); write() is called on the logging
+ * thread after every entry, with a view that is only valid for the call.
+ */
+class LogSink {
+public:
+    virtual ~LogSink() = default;
     
-    uint8_t buffer[64] = {0};
-    uint8_t buffer_len = 0;
-    uint64_t bit_len = 0;
-    
-    static constexpr uint32_t k[64] = {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-        0x3956c25c, 0x59f111f1, 0x923f82e4, 0xab1c5ed5,
-        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-        0x72be5d8d, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-        0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-        0x983e5152, 0xa831c66b, 0xb00327c8, 0xbf597fc7,
-        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-        0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-        0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-        0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-    };
+    /**
+     * @brief Accept one JSON entry (without a trailing newline)
+     */
+    virtual void write(std::string_view entry, const EntryInfo& info) = 0;
     
-    void transform() {
-        uint32_t w[64];
-        for (int i = 0; i < 16; ++i) {
-            w[i] = (buffer[i * 4] << 24) | (buffer[i * 4 + 1] << 16) |
-                   (buffer[i * 4 + 2] << 8) | buffer[i * 4 + 3];
-        }
-        for (int i = 16; i < 64; ++i) {
-            uint32_t s0 = right_rotate(w[i-15], 7) ^ right_rotate(w[i-15], 18) ^ (w[i-15] >> 3);
-            uint32_t s1 = right_rotate(w[i-2], 17) ^ right_rotate(w[i-2], 19) ^ (w[i-2] >> 10);
-            w[i] = w[i-16] + s0 + w[i-7] + s1;
-        }
-        
-        uint32_t a = h[0], b = h[1], c = h[2], d = h[3],
-                 e = h[4], f = h[5], g = h[6], h_val = h[7];
-        
-        for (int i = 0; i < 64; ++i) {
-            uint32_t S1 = right_rotate(e, 6) ^ right_rotate(e, 11) ^ right_rotate(e, 25);
-            uint32_t ch = (e & f) ^ (~e & g);
-            uint32_t temp1 = h_val + S1 + ch + k[i] + w[i];
-            uint32_t S0 = right_rotate(a, 2) ^ right_rotate(a, 13) ^ right_rotate(a, 22);
-            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
-            uint32_t temp2 = S0 + maj;
-            
-            h_val = g;
-            g = f;
-            f = e;
-            e = d + temp1;
-            d = c;
-            c = b;
-            b = a;
-            a = temp1 + temp2;
+    /**
+     * @brief Accept the entries of one AuditChain::log_batch() call
+     *
+     * @p entries holds @p count JSON entries back to back, each followed by
+     * '\n'; infos[i] describes the i-th. Views are only valid for the call.
+     * The default passes each entry to write().
+     */
+    virtual void write_batch(std::string_view entries, const EntryInfo* infos, size_t count) {
+        size_t pos = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t end = entries.find('\n', pos);
+            write(entries.substr(pos, end - pos), infos[i]);
+            pos = end + 1;
         }
-        
-        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
-        h[4] += e; h[5] += f; h[6] += g; h[7] += h_val;
-    }
-    
-    static uint32_t right_rotate(uint32_t value, uint32_t amount) {
-        return (value >> amount) | (value << (32 - amount));
     }
     
-    static uint64_t swap_endian(uint64_t value) {
-        return ((value & 0xFF00000000000000ULL) >> 56) |
-               ((value & 0x00FF000000000000ULL) >> 40) |
-               ((value & 0x0000FF0000000000ULL) >> 24) |
-               ((value & 0x000000FF00000000ULL) >> 8) |
-               ((value & 0x00000000FF000000ULL) << 8) |
-               ((value & 0x0000000000FF0000ULL) << 24) |
-               ((value & 0x000000000000FF00ULL) << 40) |
-               ((value & 0x00000000000000FFULL) << 56);
-    }
+    /**
+     * @brief Make everything written so far durable
+     */
+    virtual void flush() {}
 };
 
 /**
- * @brief User identifier enum for audit logging
+ * @brief Source of signed checkpoint messages (see signed_checkpoint.hpp)
+ *
+ * Attached with AuditChain::set_checkpoint_signer(). request() and
+ * take_message() are called on the logging thread and must not wait for
+ * a signature to be computed.
  */
-enum class UserID : uint8_t {
-    System = 0,
-    Admin = 1,
-    Operator = 2,
-    Service = 3,
-    Unauthorized = 255
+class CheckpointSigner {
+public:
+    virtual ~CheckpointSigner() = default;
+
+    /**
+     * @brief Ask for a signature over entry @p sequence, whose hash is @p chain_hash
+     *
+     * A request that has not been signed yet may be replaced by a later
+     * one; a signature over a later hash covers every earlier entry.
+     */
+    virtual void request(std::string_view device_id, uint64_t sequence,
+                         const SHA256::Hash& chain_hash) = 0;
+
+    /**
+     * @brief Move the message of a finished signature into @p message
+     * @return false if none is ready
+     */
+    virtual bool take_message(std::string& message) = 0;
+
+    /**
+     * @brief Finish the outstanding request, if any
+     */
+    virtual void flush() {}
 };
 
+namespace detail {
+
 /**
- * @brief Event severity levels
+ * @brief Rebuild the hashed payload of a parsed entry
+ *
+ * Replaces @p payload with device_id|timestamp|user|severity|message|previous_hash
+ * using the unescaped field values, i.e. exactly the bytes AuditChain hashed.
+ * @return false if a field is malformed
  */
-enum class Severity : uint8_t {
-    Debug = 0,
-    Info = 1,
-    Warning = 2,
-    Error = 3,
-    Critical = 4
-};
+inline bool chain_payload(const EntryView& view, std::string& payload) {
+    if (view.timestamp.size() != timestamp_length || view.user_id > 0xFF ||
+        view.severity > 0xFF) {
+        return false;
+    }
+    payload.clear();
+    if (!unescape_json(view.device_id, payload)) return false;
+    payload.push_back('|');
+    payload.append(view.timestamp.data(), view.timestamp.size());
+    char digits[8];
+    payload.push_back('|');
+    payload.append(digits, format_uint(view.user_id, digits));
+    payload.push_back('|');
+    payload.append(digits, format_uint(view.severity, digits));
+    payload.push_back('|');
+    if (!unescape_json(view.message, payload)) return false;
+    payload.push_back('|');
+    payload.append(view.previous_hash.data(), view.previous_hash.size());
+    return true;
+}
+
+} // namespace detail
 
 /**
  * @brief Tamper-evident audit chain logger
@@ -185,68 +210,375 @@ class AuditChain {
 public:
     /**
      * @brief Initialize audit chain with device identifier
-     * @param device_id Unique device identifier (e.g., serial number)
+     * @param device_id Unique device identifier (e.g., serial number); interned
+     *        in StringPool::shared() with its JSON form
+     * @param clock Timestamp source (default: std::chrono::system_clock)
+     */
+    explicit AuditChain(std::string_view device_id, ClockSource clock = nullptr)
+        : device_id_(&StringPool::shared().intern(device_id)),
+          previous_hash_(detail::chain_init_hash()), clock_(std::move(clock)) {
+        detail::hex_encode(previous_hash_.data(), previous_hash_.size(), previous_hex_.data());
+        // The payload always starts with "device_id|"; absorb it once
+        prefix_state_ = detail::chain_prefix(device_id_->text);
+    }
+    
+    /**
+     * @brief Continue a chain from a saved state
+     *
+     * The next entry links to @p state's last hash and takes sequence
+     * number state.sequence + 1, so the log continues without a break.
+     * @see recover_chain_state() in chain_recovery.hpp
      */
-    explicit AuditChain(const std::string& device_id)
-        : device_id_(device_id), previous_hash_(SHA256::hash("DTS_INIT")) {}
+    explicit AuditChain(const ChainState& state, ClockSource clock = nullptr)
+        : AuditChain(state.device_id, std::move(clock)) {
+        previous_hash_ = state.last_hash;
+        detail::hex_encode(previous_hash_.data(), previous_hash_.size(), previous_hex_.data());
+        sequence_number_ = state.sequence;
+        window_first_ = state.window_first;
+        window_ = state.window;
+        checkpoints_ = state.checkpoints;
+        last_info_.sequence = state.sequence;
+        last_info_.timestamp_ms = state.timestamp_ms;
+        last_info_.chain_hash = state.last_hash;
+    }
+    
+    /**
+     * @brief Snapshot of the chain position (log_offset is left 0)
+     */
+    ChainState state() const {
+        ChainState state;
+        state.device_id = std::string(device_id_->text);
+        state.sequence = sequence_number_;
+        state.last_hash = previous_hash_;
+        state.timestamp_ms = last_info_.timestamp_ms;
+        state.window_first = window_first_;
+        state.window = window_;
+        state.checkpoints = checkpoints_;
+        return state;
+    }
     
     /**
      * @brief Log an audit event
      * @param message Event description
      * @param user_id User who triggered the event
      * @param severity Event severity level
-     * @return JSON-formatted log entry with embedded integrity hash
+     * @return JSON-formatted log entry with embedded integrity hash (empty
+     *         if the message is reserved)
      */
-    std::string log(const std::string& message, 
+    std::string log(std::string_view message, 
                     UserID user_id = UserID::System,
                     Severity severity = Severity::Info) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
-        
-        std::ostringstream json;
-        json << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%S");
-        json << "." << std::setfill('0') << std::setw(3) << ms.count() << "Z";
-        
-        std::string timestamp = json.str();
-        
-        // Build payload for hashing
-        std::ostringstream payload;
-        payload << device_id_ << "|"
-                << timestamp << "|"
-                << static_cast<int>(user_id) << "|"
-                << static_cast<int>(severity) << "|"
-                << message << "|"
-                << hash_to_hex(previous_hash_);
-        
-        // Compute chain hash
-        auto current_hash = SHA256::hash(payload.str());
-        
-        // Build JSON log entry
-        std::ostringstream log_entry;
-        log_entry << "{"
-                  << "\"device_id\":\"" << device_id_ << "\","
-                  << "\"timestamp\":\"" << timestamp << "\","
-                  << "\"user_id\":" << static_cast<int>(user_id) << ","
-                  << "\"severity\":" << static_cast<int>(severity) << ","
-                  << "\"message\":\"" << escape_json(message) << "\","
-                  << "\"previous_hash\":\"" << hash_to_hex(previous_hash_) << "\","
-                  << "\"chain_hash\":\"" << hash_to_hex(current_hash) << "\""
-                  << "}";
-        
-        // Update chain state
-        previous_hash_ = current_hash;
-        sequence_number_++;
+        std::string entry;
+        log(entry, message, user_id, severity);
+        return entry;
+    }
+    
+    /**
+     * @brief Log an audit event into a reusable string
+     *
+     * Replaces the contents of @p out with the JSON entry. Once @p out has
+     * grown to fit typical entries, no heap allocation takes place.
+     * @return Length of the entry, or 0 (and @p out cleared) if the message
+     *         is reserved (see is_reserved())
+     */
+    size_t log(std::string& out,
+               std::string_view message,
+               UserID user_id = UserID::System,
+               Severity severity = Severity::Info) {
+        if (is_reserved(message, user_id)) {
+            out.clear();
+            return 0;
+        }
+        const size_t escaped_len = detail::json_escaped_length(message.data(), message.size());
+        out.resize(entry_length(escaped_len, user_id, severity));
+        const int64_t timestamp_ms = now_ms();
+        write_entry(&out[0], timestamp_ms, message, escaped_len, user_id, severity);
+        deliver(out, message);
+        after_entry(timestamp_ms);
+        return out.size();
+    }
+    
+    /**
+     * @brief Log an audit event with an explicit timestamp
+     *
+     * For front ends that capture the event time before the entry is
+     * sequenced (queues, batches, replay).
+     * @param timestamp_ms Milliseconds since the Unix epoch
+     * @return Length of the entry, or 0 (and @p out cleared) if the message
+     *         is reserved
+     */
+    size_t log_at(std::string& out,
+                  int64_t timestamp_ms,
+                  std::string_view message,
+                  UserID user_id = UserID::System,
+                  Severity severity = Severity::Info) {
+        if (is_reserved(message, user_id)) {
+            out.clear();
+            return 0;
+        }
+        return replay_at(out, timestamp_ms, message, user_id, severity);
+    }
+    
+    /**
+     * @brief log_at() for entries read back from an existing chain
+     *
+     * Reserved messages are accepted, so recorded checkpoints are chained
+     * byte for byte as they were written. Their contents are not checked
+     * against this chain; only replay should use this.
+     */
+    size_t replay_at(std::string& out,
+                     int64_t timestamp_ms,
+                     std::string_view message,
+                     UserID user_id = UserID::System,
+                     Severity severity = Severity::Info) {
+        const size_t escaped_len = detail::json_escaped_length(message.data(), message.size());
+        out.resize(entry_length(escaped_len, user_id, severity));
+        write_entry(&out[0], timestamp_ms, message, escaped_len, user_id, severity);
+        deliver(out, message);
+        after_entry(timestamp_ms);
+        return out.size();
+    }
+    
+    /**
+     * @brief Log an audit event into a caller-provided buffer
+     *
+     * The entry is not NUL-terminated. If it does not fit, nothing is
+     * written and the chain is not advanced.
+     * @return Bytes written, or 0 if @p capacity is too small or the message
+     *         is reserved
+     */
+    size_t log(char* buffer,
+               size_t capacity,
+               std::string_view message,
+               UserID user_id = UserID::System,
+               Severity severity = Severity::Info) {
+        if (is_reserved(message, user_id)) return 0;
+        const size_t escaped_len = detail::json_escaped_length(message.data(), message.size());
+        const size_t len = entry_length(escaped_len, user_id, severity);
+        if (len > capacity) return 0;
+        const int64_t timestamp_ms = now_ms();
+        write_entry(buffer, timestamp_ms, message, escaped_len, user_id, severity);
+        deliver(std::string_view(buffer, len), message);
+        after_entry(timestamp_ms);
+        return len;
+    }
+    
+    /**
+     * @brief Log many events in one pass
+     *
+     * Replaces the contents of @p out with one JSON entry per event, each
+     * followed by '\n', chained exactly as if log() had been called for
+     * each event in turn. The clock is read once and every entry carries
+     * that timestamp; the sink receives the whole buffer in one
+     * write_batch() call. Checkpoints that fall due are placed in @p out
+     * after the entry that completed their window. If any event carries a
+     * reserved message, the whole batch is refused and the chain is not
+     * advanced.
+     * @return Number of entries in @p out (events plus checkpoints), or 0
+     */
+    size_t log_batch(std::string& out, const LogEvent* events, size_t count) {
+        return log_batch_at(out, now_ms(), events, count);
+    }
+    
+    size_t log_batch(std::string& out, const std::vector<LogEvent>& events) {
+        return log_batch(out, events.data(), events.size());
+    }
+    
+    size_t log_batch(std::string& out, EventBatch& batch) {
+        return log_batch(out, batch.events(), batch.size());
+    }
+    
+    /**
+     * @brief log_batch() with an explicit timestamp for every entry
+     * @param timestamp_ms Milliseconds since the Unix epoch
+     */
+    size_t log_batch_at(std::string& out, int64_t timestamp_ms,
+                        const LogEvent* events, size_t count) {
+        out.clear();
+        batch_infos_.clear();
+        batch_checkpoints_.clear();
+        batch_escaped_.resize(count);
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const LogEvent& event = events[i];
+            if (is_reserved(event.message, event.user_id)) return 0;
+            batch_escaped_[i] = detail::json_escaped_length(event.message.data(),
+                                                            event.message.size());
+            total += entry_length(batch_escaped_[i], event.user_id, event.severity) + 1;
+        }
+        out.reserve(total);
         
-        return log_entry.str();
+        char timestamp[detail::timestamp_length];
+        timestamp_formatter_.format(timestamp_ms, timestamp);
+        batching_ = true;
+        for (size_t i = 0; i < count; ++i) {
+            const LogEvent& event = events[i];
+            const size_t pos = out.size();
+            const size_t len = entry_length(batch_escaped_[i], event.user_id, event.severity);
+            out.resize(pos + len + 1);
+            write_entry(&out[pos], timestamp_ms, timestamp, event.message, batch_escaped_[i],
+                        event.user_id, event.severity);
+            out[pos + len] = '\n';
+            batch_infos_.push_back(last_info_);
+            batch_infos_.back().device_id = device_id_->text;
+            batch_infos_.back().message = event.message;
+            after_entry(timestamp_ms);
+            if (checkpoint_pending_) {
+                // Already part of the batch; nothing for take_checkpoint()
+                checkpoint_pending_ = false;
+                const size_t at = out.size();
+                out.append(checkpoint_entry_).push_back('\n');
+                batch_infos_.push_back(last_info_);
+                batch_infos_.back().device_id = device_id_->text;
+                const size_t message_len = checkpoint_entry_.size() -
+                                           detail::json_entry_tail_length -
+                                           checkpoint_message_start_;
+                batch_checkpoints_.push_back({batch_infos_.size() - 1,
+                                              at + checkpoint_message_start_, message_len});
+            }
+        }
+        batching_ = false;
+        // Checkpoint messages point into out, which may have moved while growing
+        for (const auto& checkpoint : batch_checkpoints_) {
+            batch_infos_[checkpoint.info].message =
+                std::string_view(out.data() + checkpoint.offset, checkpoint.length);
+        }
+        if (sink_ && !batch_infos_.empty()) {
+            DTS_METRICS_TIME(SinkWrite);
+            sink_->write_batch(out, batch_infos_.data(), batch_infos_.size());
+        }
+        return batch_infos_.size();
+    }
+    
+    /**
+     * @brief Whether @p message is reserved for entries the chain writes itself
+     *
+     * ChainState::apply() and build_inclusion_proof() take any System entry
+     * whose message starts "Merkle Checkpoint | " for a checkpoint, so the
+     * log entry points refuse such messages.
+     */
+    static bool is_reserved(std::string_view message, UserID user_id) {
+        const std::string_view prefix(detail::checkpoint_prefix);
+        return user_id == UserID::System && message.substr(0, prefix.size()) == prefix;
+    }
+    
+    /**
+     * @brief Upper bound on the entry size for a message of @p message_len bytes
+     */
+    size_t max_entry_length(size_t message_len) const {
+        return entry_length(message_len * 6, UserID::Unauthorized, Severity::Critical);
+    }
+    
+    /**
+     * @brief Attach a sink that receives every subsequent entry (nullptr detaches)
+     */
+    void set_sink(std::shared_ptr<LogSink> sink) {
+        sink_ = std::move(sink);
+    }
+    
+    /**
+     * @brief Currently attached sink, if any
+     */
+    const std::shared_ptr<LogSink>& get_sink() const {
+        return sink_;
+    }
+    
+    /**
+     * @brief Metadata of the most recent entry
+     */
+    const EntryInfo& last_entry_info() const {
+        return last_info_;
+    }
+    
+    /**
+     * @brief Emit a Merkle checkpoint entry after every @p entries entries
+     *
+     * The checkpoint is an ordinary chained entry (System/Info) whose message
+     * records the RFC 6962 root over the chain hashes of the covered
+     * entries and the root over all checkpoint roots so far; it consumes a
+     * sequence number. It is delivered to the sink right after the entry
+     * that completed the window; callers without a sink must store it via
+     * take_checkpoint() before the next log() or the stored chain will have
+     * a gap. 0 (the default) disables checkpoints. An open window already
+     * at least @p entries long closes with the next entry.
+     */
+    void set_checkpoint_interval(uint64_t entries) {
+        checkpoint_interval_ = entries;
+    }
+    
+    uint64_t checkpoint_interval() const {
+        return checkpoint_interval_;
+    }
+    
+    /**
+     * @brief Move out a checkpoint entry emitted by the last log() call
+     * @return false if no checkpoint is pending
+     */
+    bool take_checkpoint(std::string& out) {
+        if (!checkpoint_pending_) return false;
+        out.assign(checkpoint_entry_);
+        checkpoint_pending_ = false;
+        return true;
+    }
+    
+    /**
+     * @brief Most recent checkpoint (valid once checkpoint_count() > 0)
+     */
+    const Checkpoint& last_checkpoint() const {
+        return last_checkpoint_;
+    }
+    
+    uint64_t checkpoint_count() const {
+        return checkpoints_.size();
+    }
+    
+    /**
+     * @brief Sign the chain hash every @p entries entries (nullptr detaches)
+     *
+     * Every @p entries entries the chain hands its current position to
+     * @p signer, which signs it off the logging thread. The first entry
+     * logged after the signature is ready is followed by a signed checkpoint
+     * entry: an ordinary chained entry (System/Info) whose message carries
+     * the signed sequence, hash and signature. It is delivered and taken
+     * like a Merkle checkpoint (take_checkpoint(), log_batch()), and is
+     * deferred while it would close a Merkle window, so use a checkpoint
+     * interval of 0 or at least 2 alongside it.
+     */
+    void set_checkpoint_signer(std::shared_ptr<CheckpointSigner> signer, uint64_t entries) {
+        signer_ = std::move(signer);
+        signature_interval_ = entries ? entries : 1;
+        signature_requested_ = sequence_number_;
+    }
+    
+    /**
+     * @brief Sign the current head now and log the signed checkpoint into @p out
+     *
+     * Waits for the signer, so call it where latency does not matter, e.g.
+     * before shutdown or an upload, to leave no unsigned entries behind
+     * but the checkpoint itself.
+     * @return Length of the entry, or 0 without a signer
+     */
+    size_t log_signed_checkpoint(std::string& out) {
+        if (!signer_) return 0;
+        signature_requested_ = sequence_number_;
+        signer_->request(device_id_->text, sequence_number_, previous_hash_);
+        signer_->flush();
+        if (!signer_->take_message(signature_message_)) return 0;
+        return log(out, signature_message_);
+    }
+    
+    /**
+     * @brief Replace the timestamp source (nullptr restores system_clock)
+     */
+    void set_clock(ClockSource clock) {
+        clock_ = std::move(clock);
     }
     
     /**
      * @brief Get current chain hash (for verification)
      */
     std::string get_chain_hash() const {
-        return hash_to_hex(previous_hash_);
+        return std::string(previous_hex_.data(), previous_hex_.size());
     }
     
     /**
@@ -259,88 +591,196 @@ public:
     /**
      * @brief Verify chain integrity from a sequence of log entries
      * @param entries Vector of JSON log entries (in order)
+     * @param recompute Also re-derive each chain_hash from the entry's fields,
+     *        detecting edits that leave the links intact
      * @return true if chain is valid, false if tampering detected
      */
-    static bool verify_chain(const std::vector<std::string>& entries) {
-        if (entries.empty()) return true;
-        
-        SHA256::Hash expected_prev = SHA256::hash("DTS_INIT");
+    static bool verify_chain(const std::vector<std::string>& entries, bool recompute = false) {
+        DTS_METRICS_TIME(Verify);
+        const bool valid = check_links(entries, recompute);
+        DTS_METRICS_ADD(EntriesVerified, valid ? entries.size() : 0);
+        DTS_METRICS_ADD(VerifyFailures, valid ? 0 : 1);
+        return valid;
+    }
+
+private:
+    const PooledString* device_id_;
+    SHA256::Hash previous_hash_;
+    std::array<char, 64> previous_hex_;
+    uint64_t sequence_number_ = 0;
+    SHA256 prefix_state_;
+    ClockSource clock_;
+    TimestampFormatter timestamp_formatter_;
+    std::shared_ptr<LogSink> sink_;
+    EntryInfo last_info_{};
+    uint64_t checkpoint_interval_ = 0;
+    uint64_t window_first_ = 0;
+    merkle::Accumulator window_;        ///< Chain hashes since the last checkpoint
+    merkle::Accumulator checkpoints_;   ///< Checkpoint roots (tree of roots)
+    Checkpoint last_checkpoint_{};
+    std::string checkpoint_entry_;
+    size_t checkpoint_message_start_ = 0;
+    bool checkpoint_pending_ = false;
+    bool batching_ = false;             ///< Checkpoints go into the batch, not to the sink
+    std::shared_ptr<CheckpointSigner> signer_;
+    uint64_t signature_interval_ = 0;
+    uint64_t signature_requested_ = 0;  ///< Sequence last handed to the signer
+    std::string signature_message_;
+    
+    struct BatchCheckpoint {
+        size_t info;
+        size_t offset;
+        size_t length;
+    };
+    std::vector<EntryInfo> batch_infos_;
+    std::vector<BatchCheckpoint> batch_checkpoints_;
+    std::vector<size_t> batch_escaped_;
+    
+    static bool check_links(const std::vector<std::string>& entries, bool recompute) {
+        SHA256::Hash expected_prev = detail::chain_init_hash();
+        std::string payload;
         
         for (const auto& entry : entries) {
-            // Extract chain_hash from previous entry and previous_hash from current
-            // Simplified: in production, use proper JSON parsing
-            size_t prev_hash_pos = entry.find("\"previous_hash\":\"");
-            size_t chain_hash_pos = entry.find("\"chain_hash\":\"");
+            if (recompute) {
+                EntryView view;
+                SHA256::Hash stated;
+                if (!parse_entry(entry, view) || !detail::chain_payload(view, payload) ||
+                    !detail::hex_decode(view.chain_hash.data(), stated.size(), stated.data()) ||
+                    SHA256::hash(payload) != stated) {
+                    return false;
+                }
+            }
             
-            if (prev_hash_pos == std::string::npos || chain_hash_pos == std::string::npos) {
+            const char* prev_hex;
+            const char* chain_hex;
+            SHA256::Hash prev_hash;
+            if (!detail::entry_link_hashes(entry, prev_hex, chain_hex) ||
+                !detail::hex_decode(prev_hex, prev_hash.size(), prev_hash.data())) {
                 return false;
             }
             
             // Verify previous_hash matches expected
-            std::string prev_hash_hex = extract_hex(entry, prev_hash_pos + 17);
-            if (prev_hash_hex != hash_to_hex(expected_prev)) {
+            if (prev_hash != expected_prev) {
                 return false;
             }
             
             // Update expected_prev for next iteration
-            std::string chain_hash_hex = extract_hex(entry, chain_hash_pos + 14);
-            expected_prev = hex_to_hash(chain_hash_hex);
+            if (!detail::hex_decode(chain_hex, expected_prev.size(), expected_prev.data())) {
+                return false;
+            }
         }
         
         return true;
     }
-
-private:
-    std::string device_id_;
-    SHA256::Hash previous_hash_;
-    uint64_t sequence_number_ = 0;
     
-    static std::string hash_to_hex(const SHA256::Hash& hash) {
-        std::ostringstream ss;
-        for (const auto& byte : hash) {
-            ss << std::hex << std::setfill('0') << std::setw(2) 
-               << static_cast<int>(byte);
-        }
-        return ss.str();
+    void deliver(std::string_view entry, std::string_view message) {
+        if (!sink_) return;
+        DTS_METRICS_TIME(SinkWrite);
+        EntryInfo info = last_info_;
+        info.device_id = device_id_->text;
+        info.message = message;
+        sink_->write(entry, info);
+    }
+    
+    size_t entry_length(size_t escaped_message_len, UserID user_id, Severity severity) const {
+        return detail::json_entry_length(device_id_->json.size(), escaped_message_len,
+                                         user_id, severity);
     }
     
-    static SHA256::Hash hex_to_hash(const std::string& hex) {
-        SHA256::Hash hash;
-        for (size_t i = 0; i < 32; ++i) {
-            hash[i] = static_cast<uint8_t>(
-                std::stoi(hex.substr(i * 2, 2), nullptr, 16));
+    void after_entry(int64_t timestamp_ms) {
+        checkpoint_pending_ = false;
+        if (checkpoint_interval_ != 0) {
+            add_to_window();
+            if (window_.size() >= checkpoint_interval_) emit_checkpoint(timestamp_ms);
         }
-        return hash;
-    }
-    
-    static std::string extract_hex(const std::string& json, size_t start_pos) {
-        size_t end_pos = json.find('"', start_pos);
-        if (end_pos == std::string::npos) return "";
-        return json.substr(start_pos, end_pos - start_pos);
-    }
-    
-    static std::string escape_json(const std::string& str) {
-        std::ostringstream escaped;
-        for (char c : str) {
-            switch (c) {
-                case '"': escaped << "\\\""; break;
-                case '\\': escaped << "\\\\"; break;
-                case '\b': escaped << "\\b"; break;
-                case '\f': escaped << "\\f"; break;
-                case '\n': escaped << "\\n"; break;
-                case '\r': escaped << "\\r"; break;
-                case '\t': escaped << "\\t"; break;
-                default:
-                    if (static_cast<unsigned char>(c) < 0x20) {
-                        escaped << "\\u" << std::hex << std::setfill('0') 
-                                << std::setw(4) << static_cast<int>(c);
-                    } else {
-                        escaped << c;
-                    }
-                    break;
-            }
+        if (signer_) sign_entries(timestamp_ms);
+    }
+    
+    void add_to_window() {
+        if (window_.size() == 0) window_first_ = sequence_number_;
+        window_.append(previous_hash_);
+    }
+    
+    void sign_entries(int64_t timestamp_ms) {
+        if (sequence_number_ - signature_requested_ >= signature_interval_) {
+            signature_requested_ = sequence_number_;
+            signer_->request(device_id_->text, sequence_number_, previous_hash_);
+        } else if (!checkpoint_pending_ &&
+                   (checkpoint_interval_ == 0 || window_.size() + 1 < checkpoint_interval_) &&
+                   signer_->take_message(signature_message_)) {
+            emit_signed_checkpoint(timestamp_ms);
         }
-        return escaped.str();
+    }
+    
+    void emit_signed_checkpoint(int64_t timestamp_ms) {
+        const std::string_view message(signature_message_);
+        checkpoint_entry_.resize(entry_length(message.size(), UserID::System, Severity::Info));
+        write_entry(&checkpoint_entry_[0], timestamp_ms, message, message.size(),
+                    UserID::System, Severity::Info);
+        checkpoint_message_start_ =
+            checkpoint_entry_.size() - detail::json_entry_tail_length - message.size();
+        // Counted as an ordinary entry by Merkle windows, as ChainState::apply() does
+        if (checkpoint_interval_ != 0) add_to_window();
+        checkpoint_pending_ = true;
+        if (!batching_) deliver(checkpoint_entry_, message);
+    }
+    
+    void emit_checkpoint(int64_t timestamp_ms) {
+        Checkpoint checkpoint;
+        checkpoint.index = checkpoints_.size();
+        checkpoint.first_sequence = window_first_;
+        checkpoint.count = window_.size();
+        checkpoint.root = window_.root();
+        checkpoints_.append(checkpoint.root);
+        checkpoint.roots_root = checkpoints_.root();
+        window_.clear();
+        
+        char text[detail::checkpoint_message_capacity];
+        const std::string_view message(text, detail::format_checkpoint_message(checkpoint, text));
+        checkpoint_entry_.resize(entry_length(message.size(), UserID::System, Severity::Info));
+        write_entry(&checkpoint_entry_[0], timestamp_ms, message, message.size(),
+                    UserID::System, Severity::Info);
+        checkpoint_message_start_ =
+            checkpoint_entry_.size() - detail::json_entry_tail_length - message.size();
+        last_checkpoint_ = checkpoint;
+        checkpoint_pending_ = true;
+        if (!batching_) deliver(checkpoint_entry_, message);
+    }
+    
+    int64_t now_ms() {
+        return to_epoch_ms(clock_ ? clock_() : std::chrono::system_clock::now());
+    }
+    
+    void write_entry(char* out, int64_t timestamp_ms, std::string_view message,
+                     size_t escaped_len, UserID user_id, Severity severity) {
+        char timestamp[detail::timestamp_length];
+        timestamp_formatter_.format(timestamp_ms, timestamp);
+        write_entry(out, timestamp_ms, timestamp, message, escaped_len, user_id, severity);
+    }
+    
+    /// @param timestamp @p timestamp_ms, already formatted
+    void write_entry(char* out, int64_t timestamp_ms, const char* timestamp,
+                     std::string_view message, size_t escaped_len,
+                     UserID user_id, Severity severity) {
+        DTS_METRICS_TIME(Log);
+        DTS_METRICS_ADD(EntriesLogged, 1);
+        DTS_METRICS_ADD(BytesLogged, entry_length(escaped_len, user_id, severity));
+        
+        // Chain hash streamed field by field from the pre-absorbed device prefix
+        auto current_hash = detail::chain_hash(prefix_state_, timestamp, user_id, severity,
+                                               message, previous_hex_.data());
+        std::array<char, 64> current_hex;
+        detail::hex_encode(current_hash.data(), current_hash.size(), current_hex.data());
+        
+        detail::write_json_entry(out, device_id_->json, timestamp, user_id, severity, message,
+                                 escaped_len, previous_hex_.data(), current_hex.data());
+        
+        // Update chain state
+        last_info_ = EntryInfo{sequence_number_ + 1, timestamp_ms, user_id, severity,
+                               current_hash, previous_hash_, {}, {}};
+        previous_hash_ = current_hash;
+        previous_hex_ = current_hex;
+        sequence_number_++;
     }
 };
 
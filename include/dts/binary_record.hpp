@@ -0,0 +1,433 @@
+/**
+ * @file binary_record.hpp
+ * @brief Compact binary encoding of audit entries
+ *
+ * A binary stream is a sequence of records, each prefixed by its length as
+ * an unsigned LEB128 varint. The first byte of a record is its type:
+ *
+ *   0x00 Header  "DTSB" + version byte; resets decoder state
+ *   0x01 Device  varint index, device ID bytes
+ *   0x02 Entry   varint device index
+ *                varint zigzag(sequence - previous sequence of the device)
+ *                varint zigzag(timestamp_ms - previous timestamp of the device)
+ *                u8 user_id, u8 severity, u8 flags
+ *                [32-byte previous hash if flags & 1]
+ *                32-byte chain hash
+ *                message bytes (raw, unescaped) to the end of the record
+ *
+ * The previous hash is omitted whenever it equals the chain hash of the
+ * device's preceding entry (or the chain's initial hash), which is every
+ * entry of an unbroken chain. Unknown record types are skipped.
+ *
+ * Entries convert losslessly to the JSON form written by AuditChain.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_BINARY_RECORD_HPP
+#define DTS_BINARY_RECORD_HPP
+
+#include "audit_chain.hpp"
+#include "entry_parser.hpp"
+#include "log_sink.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dts {
+
+namespace detail {
+
+enum class BinaryRecordType : uint8_t {
+    Header = 0x00,
+    Device = 0x01,
+    Entry = 0x02
+};
+
+static constexpr char binary_magic[4] = {'D', 'T', 'S', 'B'};
+static constexpr uint8_t binary_version = 1;
+static constexpr uint8_t binary_flag_explicit_prev = 0x01;
+
+inline void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+        const uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/// Per-device delta state shared by encoder and decoder
+struct BinaryDeviceState {
+    std::string_view name;      ///< Decoder only: view into the input
+    uint64_t sequence = 0;
+    int64_t timestamp_ms = 0;
+    SHA256::Hash last_hash = chain_init_hash();
+};
+
+} // namespace detail
+
+/**
+ * @brief Exact length of the JSON form of @p entry
+ */
+inline size_t json_entry_length(const EntryInfo& entry) {
+    return detail::json_entry_length(
+        detail::json_escaped_length(entry.device_id.data(), entry.device_id.size()),
+        detail::json_escaped_length(entry.message.data(), entry.message.size()),
+        entry.user_id, entry.severity);
+}
+
+/**
+ * @brief Append the JSON form of @p entry (as AuditChain writes it) to @p out
+ */
+inline void append_json(const EntryInfo& entry, std::string& out) {
+    const size_t escaped_len = detail::json_escaped_length(entry.message.data(),
+                                                           entry.message.size());
+    std::string_view device_id = entry.device_id;
+    std::string escaped_id;
+    const size_t id_len = detail::json_escaped_length(device_id.data(), device_id.size());
+    if (id_len != device_id.size()) {
+        escaped_id.resize(id_len);
+        detail::escape_json(device_id.data(), device_id.size(), &escaped_id[0]);
+        device_id = escaped_id;
+    }
+    const size_t offset = out.size();
+    out.resize(offset + detail::json_entry_length(device_id.size(), escaped_len,
+                                                  entry.user_id, entry.severity));
+    char timestamp[detail::timestamp_length];
+    detail::format_timestamp_ms(entry.timestamp_ms, timestamp);
+    char previous_hex[64];
+    char chain_hex[64];
+    detail::hex_encode(entry.previous_hash.data(), entry.previous_hash.size(), previous_hex);
+    detail::hex_encode(entry.chain_hash.data(), entry.chain_hash.size(), chain_hex);
+    detail::write_json_entry(&out[offset], device_id, timestamp, entry.user_id,
+                             entry.severity, entry.message, escaped_len, previous_hex,
+                             chain_hex);
+}
+
+/**
+ * @brief Encodes entries into the binary record format
+ *
+ * Stateful: device IDs are interned and sequence/timestamp are delta-coded
+ * against the previous entry of the same device. A header record is emitted
+ * before the first entry; concatenating the outputs of several encoders
+ * yields a valid stream.
+ */
+class BinaryRecordEncoder {
+public:
+    /**
+     * @brief Append the record(s) for @p entry to @p out
+     */
+    void encode(const EntryInfo& entry, std::string& out) {
+        if (!started_) {
+            body_.clear();
+            body_.push_back(static_cast<char>(detail::BinaryRecordType::Header));
+            body_.append(detail::binary_magic, sizeof(detail::binary_magic));
+            body_.push_back(static_cast<char>(detail::binary_version));
+            flush_record(out);
+            started_ = true;
+        }
+
+        const size_t index = intern(entry.device_id, out);
+        detail::BinaryDeviceState& device = devices_[index];
+
+        body_.clear();
+        body_.push_back(static_cast<char>(detail::BinaryRecordType::Entry));
+        detail::put_varint(body_, index);
+        detail::put_varint(body_, detail::zigzag_encode(
+            static_cast<int64_t>(entry.sequence - device.sequence)));
+        detail::put_varint(body_, detail::zigzag_encode(entry.timestamp_ms - device.timestamp_ms));
+        body_.push_back(static_cast<char>(entry.user_id));
+        body_.push_back(static_cast<char>(entry.severity));
+        const bool explicit_prev = entry.previous_hash != device.last_hash;
+        body_.push_back(static_cast<char>(explicit_prev ? detail::binary_flag_explicit_prev : 0));
+        if (explicit_prev) {
+            body_.append(reinterpret_cast<const char*>(entry.previous_hash.data()), 32);
+        }
+        body_.append(reinterpret_cast<const char*>(entry.chain_hash.data()), 32);
+        body_.append(entry.message.data(), entry.message.size());
+        flush_record(out);
+
+        device.sequence = entry.sequence;
+        device.timestamp_ms = entry.timestamp_ms;
+        device.last_hash = entry.chain_hash;
+    }
+
+    /**
+     * @brief Parse a JSON entry and append its binary record(s) to @p out
+     *
+     * JSON entries carry no sequence number; entries are numbered per device
+     * in the order they are encoded.
+     * @return false if @p json is not a well-formed entry
+     */
+    bool encode_json(std::string_view json, std::string& out) {
+        EntryView view;
+        if (!parse_entry(json, view)) return false;
+
+        EntryInfo entry{};
+        if (!detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                        entry.timestamp_ms) ||
+            !detail::hex_decode(view.previous_hash.data(), 32, entry.previous_hash.data()) ||
+            !detail::hex_decode(view.chain_hash.data(), 32, entry.chain_hash.data()) ||
+            view.user_id > 0xFF || view.severity > 0xFF) {
+            return false;
+        }
+        device_text_.clear();
+        message_text_.clear();
+        if (!unescape_json(view.device_id, device_text_) ||
+            !unescape_json(view.message, message_text_)) {
+            return false;
+        }
+        entry.user_id = static_cast<UserID>(view.user_id);
+        entry.severity = static_cast<Severity>(view.severity);
+        entry.device_id = device_text_;
+        entry.message = message_text_;
+        entry.sequence = next_sequence(device_text_);
+        encode(entry, out);
+        return true;
+    }
+
+    /**
+     * @brief Forget all interned devices; the next encode() starts a new stream
+     */
+    void reset() {
+        started_ = false;
+        devices_.clear();
+        names_.clear();
+    }
+
+private:
+    bool started_ = false;
+    std::vector<detail::BinaryDeviceState> devices_;
+    std::vector<std::string> names_;    ///< Device IDs, parallel to devices_
+    std::string body_;
+    std::string device_text_;
+    std::string message_text_;
+
+    void flush_record(std::string& out) {
+        detail::put_varint(out, body_.size());
+        out.append(body_);
+    }
+
+    size_t find(std::string_view device_id) const {
+        for (size_t i = devices_.size(); i > 0; --i) {
+            if (names_[i - 1] == device_id) return i - 1;
+        }
+        return devices_.size();
+    }
+
+    uint64_t next_sequence(std::string_view device_id) const {
+        const size_t index = find(device_id);
+        return index < devices_.size() ? devices_[index].sequence + 1 : 1;
+    }
+
+    size_t intern(std::string_view device_id, std::string& out) {
+        size_t index = find(device_id);
+        if (index < devices_.size()) return index;
+        names_.emplace_back(device_id);
+        devices_.emplace_back();
+
+        body_.clear();
+        body_.push_back(static_cast<char>(detail::BinaryRecordType::Device));
+        detail::put_varint(body_, index);
+        body_.append(device_id.data(), device_id.size());
+        flush_record(out);
+        return index;
+    }
+};
+
+/**
+ * @brief Decodes a binary record stream
+ *
+ * Device ID and message views in returned entries point into the input
+ * buffer, which must outlive the reader.
+ */
+class BinaryRecordReader {
+public:
+    explicit BinaryRecordReader(std::string_view data)
+        : pos_(reinterpret_cast<const uint8_t*>(data.data())),
+          end_(pos_ + data.size()) {}
+
+    /**
+     * @brief Decode the next entry
+     * @return false at end of stream or on a malformed record (see error())
+     */
+    bool next(EntryInfo& entry) {
+        while (pos_ < end_) {
+            uint64_t length;
+            if (!detail::get_varint(pos_, end_, length) ||
+                length == 0 || length > static_cast<uint64_t>(end_ - pos_)) {
+                return fail();
+            }
+            const uint8_t* p = pos_;
+            const uint8_t* record_end = pos_ + length;
+            pos_ = record_end;
+
+            const auto type = static_cast<detail::BinaryRecordType>(*p++);
+            if (type == detail::BinaryRecordType::Header) {
+                if (record_end - p != 5 || std::memcmp(p, detail::binary_magic, 4) != 0 ||
+                    p[4] != detail::binary_version) {
+                    return fail();
+                }
+                devices_.clear();
+                started_ = true;
+                continue;
+            }
+            if (!started_) return fail();
+
+            if (type == detail::BinaryRecordType::Device) {
+                uint64_t index;
+                if (!detail::get_varint(p, record_end, index) || index != devices_.size()) {
+                    return fail();
+                }
+                devices_.emplace_back();
+                devices_.back().name = std::string_view(reinterpret_cast<const char*>(p),
+                                                        static_cast<size_t>(record_end - p));
+                continue;
+            }
+            if (type != detail::BinaryRecordType::Entry) continue;
+
+            uint64_t index, seq_delta, ts_delta;
+            if (!detail::get_varint(p, record_end, index) || index >= devices_.size() ||
+                !detail::get_varint(p, record_end, seq_delta) ||
+                !detail::get_varint(p, record_end, ts_delta) || record_end - p < 3) {
+                return fail();
+            }
+            detail::BinaryDeviceState& device = devices_[index];
+            entry.sequence = device.sequence +
+                static_cast<uint64_t>(detail::zigzag_decode(seq_delta));
+            entry.timestamp_ms = device.timestamp_ms + detail::zigzag_decode(ts_delta);
+            entry.user_id = static_cast<UserID>(p[0]);
+            entry.severity = static_cast<Severity>(p[1]);
+            const uint8_t flags = p[2];
+            p += 3;
+            const size_t hashes = (flags & detail::binary_flag_explicit_prev) ? 64 : 32;
+            if (static_cast<size_t>(record_end - p) < hashes) return fail();
+            if (flags & detail::binary_flag_explicit_prev) {
+                std::memcpy(entry.previous_hash.data(), p, 32);
+                p += 32;
+            } else {
+                entry.previous_hash = device.last_hash;
+            }
+            std::memcpy(entry.chain_hash.data(), p, 32);
+            p += 32;
+            entry.device_id = device.name;
+            entry.message = std::string_view(reinterpret_cast<const char*>(p),
+                                             static_cast<size_t>(record_end - p));
+
+            device.sequence = entry.sequence;
+            device.timestamp_ms = entry.timestamp_ms;
+            device.last_hash = entry.chain_hash;
+            return true;
+        }
+        return false;
+    }
+
+    /// True if decoding stopped at a malformed record
+    bool error() const { return error_; }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+    std::vector<detail::BinaryDeviceState> devices_;
+    bool started_ = false;
+    bool error_ = false;
+
+    bool fail() {
+        error_ = true;
+        pos_ = end_;
+        return false;
+    }
+};
+
+/**
+ * @brief Convert a binary stream to JSON lines (one entry per line)
+ * @return false if the stream is malformed (entries before the error are kept)
+ */
+inline bool binary_to_json(std::string_view binary, std::string& json_lines) {
+    BinaryRecordReader reader(binary);
+    EntryInfo entry;
+    while (reader.next(entry)) {
+        append_json(entry, json_lines);
+        json_lines.push_back('\n');
+    }
+    return !reader.error();
+}
+
+/**
+ * @brief Convert JSON lines to a binary stream; blank lines are ignored
+ * @return false if any line is not a well-formed entry
+ */
+inline bool json_to_binary(std::string_view json_lines, std::string& binary) {
+    BinaryRecordEncoder encoder;
+    size_t start = 0;
+    while (start < json_lines.size()) {
+        size_t end = json_lines.find('\n', start);
+        if (end == std::string_view::npos) end = json_lines.size();
+        std::string_view line = json_lines.substr(start, end - start);
+        start = end + 1;
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+        if (!encoder.encode_json(line, binary)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Synchronous sink that appends binary records instead of JSON lines
+ *
+ * Each time the sink is constructed it starts a new header, so reopening an
+ * existing file and appending to it keeps the stream decodable.
+ */
+class BinaryFileSink : public LogSink {
+public:
+    explicit BinaryFileSink(const std::string& path, DurabilityPolicy policy = DurabilityPolicy())
+        : file_(path), policy_(policy) {}
+
+    void write(std::string_view, const EntryInfo& info) override {
+        record_.clear();
+        encoder_.encode(info, record_);
+        const detail::AppendFile::Span span{record_.data(), record_.size()};
+        file_.write(&span, 1);
+        if (info.severity >= policy_.sync_severity) {
+            file_.sync();
+        }
+    }
+
+    void flush() override {
+        file_.sync();
+    }
+
+    bool ok() const { return file_.is_open() && file_.error() == 0; }
+    int error() const { return file_.error(); }
+
+private:
+    detail::AppendFile file_;
+    DurabilityPolicy policy_;
+    BinaryRecordEncoder encoder_;
+    std::string record_;
+};
+
+} // namespace dts
+
+#endif // DTS_BINARY_RECORD_HPP
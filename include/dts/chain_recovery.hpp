@@ -0,0 +1,146 @@
+/**
+ * @file chain_recovery.hpp
+ * @brief Boot-time recovery of chain state from a snapshot and the log tail
+ *
+ * recover_chain_state() loads the last snapshot written by a sink, then
+ * replays only the entries appended after it (bounded by
+ * RecoveryOptions::max_tail_bytes), re-verifying each one. A torn final
+ * line left by a crash mid-write is cut off so new entries start on a
+ * clean line.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_CHAIN_RECOVERY_HPP
+#define DTS_CHAIN_RECOVERY_HPP
+
+#include "audit_chain.hpp"
+#include "chain_state.hpp"
+#include "chain_verifier.hpp"
+#include "entry_parser.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace dts {
+
+enum class RecoveryStatus {
+    Ok,
+    DeviceMismatch,     ///< The snapshot belongs to another device ID
+    TailTooLong,        ///< More than max_tail_bytes follow the snapshot
+    Corrupt,            ///< A complete entry after the snapshot failed verification
+    IoError             ///< The log could not be read or truncated
+};
+
+struct RecoveryOptions {
+    /// Refuse to replay more than this many bytes after the snapshot
+    size_t max_tail_bytes = 64 * 1024 * 1024;
+    /// Truncate a trailing partial line (a write torn by power loss)
+    bool truncate_torn_tail = true;
+};
+
+struct RecoveryResult {
+    RecoveryStatus status = RecoveryStatus::Ok;
+    bool snapshot_used = false;     ///< false: no valid snapshot, replayed from the start
+    uint64_t replayed_entries = 0;  ///< Entries found after the snapshot
+    uint64_t torn_bytes = 0;        ///< Bytes of a trailing partial line
+
+    bool ok() const { return status == RecoveryStatus::Ok; }
+};
+
+/**
+ * @brief Reconstruct the chain position of @p log_path
+ *
+ * On success @p state describes the last complete entry of the log and
+ * can be passed to AuditChain(const ChainState&) and a sink's seed_state().
+ * On Corrupt, @p state describes the last entry that verified.
+ * @param device_id Expected device; used as-is when there is no snapshot
+ */
+inline RecoveryResult recover_chain_state(const std::string& device_id,
+                                          const std::string& state_path,
+                                          const std::string& log_path,
+                                          ChainState& state,
+                                          const RecoveryOptions& options = RecoveryOptions()) {
+    RecoveryResult result;
+    state = ChainState();
+    if (load_chain_state(state_path, state)) {
+        result.snapshot_used = true;
+        if (state.device_id != device_id) {
+            result.status = RecoveryStatus::DeviceMismatch;
+            return result;
+        }
+    } else {
+        state.device_id = device_id;
+    }
+
+    {
+        MappedFile file(log_path);
+        if (!file.ok()) {
+            // A missing log is only acceptable for a chain that never wrote one
+            if (state.log_offset != 0) result.status = RecoveryStatus::IoError;
+            return result;
+        }
+        const std::string_view log = file.view();
+        if (log.size() < state.log_offset) {
+            result.status = RecoveryStatus::Corrupt;
+            return result;
+        }
+        const std::string_view tail = log.substr(state.log_offset);
+        if (tail.size() > options.max_tail_bytes) {
+            result.status = RecoveryStatus::TailTooLong;
+            return result;
+        }
+
+        std::string payload;
+        std::string message;
+        std::string entry_device;
+        size_t pos = 0;
+        for (;;) {
+            const size_t end = tail.find('\n', pos);
+            if (end == std::string_view::npos) break;
+            std::string_view line = tail.substr(pos, end - pos);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+            if (!line.empty()) {
+                EntryView view;
+                SHA256::Hash prev_hash, chain_hash;
+                int64_t timestamp_ms;
+                message.clear();
+                entry_device.clear();
+                if (!parse_entry(line, view) || !detail::chain_payload(view, payload) ||
+                    !detail::hex_decode(view.previous_hash.data(), 32, prev_hash.data()) ||
+                    !detail::hex_decode(view.chain_hash.data(), 32, chain_hash.data()) ||
+                    !detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                                timestamp_ms) ||
+                    !unescape_json(view.message, message) ||
+                    !unescape_json(view.device_id, entry_device) ||
+                    entry_device != state.device_id ||
+                    prev_hash != state.last_hash || SHA256::hash(payload) != chain_hash) {
+                    result.status = RecoveryStatus::Corrupt;
+                    return result;
+                }
+                state.apply(state.sequence + 1, timestamp_ms, chain_hash, message,
+                            view.user_id == static_cast<uint8_t>(UserID::System));
+                ++result.replayed_entries;
+            }
+            state.log_offset += end + 1 - pos;
+            pos = end + 1;
+        }
+        result.torn_bytes = tail.size() - pos;
+    }
+
+    if (result.torn_bytes > 0 && options.truncate_torn_tail) {
+        std::error_code error;
+        std::filesystem::resize_file(log_path, state.log_offset, error);
+        if (error) result.status = RecoveryStatus::IoError;
+    }
+    return result;
+}
+
+} // namespace dts
+
+#endif // DTS_CHAIN_RECOVERY_HPP
@@ -0,0 +1,396 @@
+/**
+ * @file chain_registry.hpp
+ * @brief Many device chains in one process, sharded across worker threads
+ *
+ * Gateways that front thousands of devices keep one hash chain per device.
+ * ChainRegistry interns each device ID once, keeps only the chain link of
+ * every device (56 bytes, no sink, clock, or buffers), and spreads devices
+ * over a fixed set of shards. Each shard owns an EventRing, a worker thread
+ * that chains and formats entries, and its own LogSink, so devices on
+ * different shards never contend.
+ *
+ * Entries are byte-identical to those of a standalone AuditChain with the
+ * same device ID and timestamps. Registry chains do not emit Merkle
+ * checkpoints; use AuditChain for devices that need them.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_CHAIN_REGISTRY_HPP
+#define DTS_CHAIN_REGISTRY_HPP
+
+#include "audit_chain.hpp"
+#include "concurrent_audit_chain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dts {
+
+namespace detail {
+
+/**
+ * @brief Chain link of one registry device
+ *
+ * The "device_id|" hash prefix and the previous hash's hex form are
+ * rebuilt per entry rather than stored; for IDs under 63 bytes the prefix
+ * is only buffered bytes, so caching it would save no compression work.
+ */
+struct DeviceChain {
+    const PooledString* device_id;  ///< Interned in the registry's pool, with its JSON form
+    SHA256::Hash previous_hash;
+    uint64_t sequence;
+    int64_t timestamp_ms;
+};
+
+} // namespace detail
+
+/**
+ * @brief Registered device; cheap to copy and valid for the registry's lifetime
+ */
+class DeviceHandle {
+public:
+    DeviceHandle() = default;
+
+    bool valid() const { return chain_ != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+    /// Shard (and thus worker thread and sink) serving the device
+    size_t shard() const { return shard_; }
+
+private:
+    friend class ChainRegistry;
+
+    DeviceHandle(size_t shard, detail::DeviceChain* chain) : shard_(shard), chain_(chain) {}
+
+    size_t shard_ = 0;
+    detail::DeviceChain* chain_ = nullptr;
+};
+
+/**
+ * @brief Owner of many device chains, sharded across worker threads
+ *
+ * add_device() and find() may be called from any thread; logging through a
+ * DeviceHandle needs no lookup or lock. Events are timestamped on the
+ * producer thread and chained in enqueue order per shard, so each device's
+ * entries keep the order in which a single producer logged them.
+ */
+class ChainRegistry {
+public:
+    /// Creates the sink of a shard; may return nullptr to discard entries
+    using SinkFactory = std::function<std::shared_ptr<LogSink>(size_t shard)>;
+
+    struct Options {
+        size_t shards = 4;                      ///< Worker threads (at least 1)
+        size_t queue_capacity = 4096;           ///< Per shard, rounded up to a power of two
+        size_t inline_message_size = 256;       ///< Larger messages spill to the heap
+        std::chrono::microseconds idle_wait{100};   ///< Worker sleep when idle
+        ClockSource clock;                      ///< Producer-side clock (must be thread-safe)
+        SinkFactory sink_factory;               ///< Called once per shard at construction
+    };
+
+    ChainRegistry() : ChainRegistry(Options()) {}
+
+    explicit ChainRegistry(Options options) : options_(std::move(options)) {
+        const size_t count = std::max<size_t>(options_.shards, 1);
+        shards_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            shards_.emplace_back(new Shard(options_.queue_capacity, options_.inline_message_size));
+            if (options_.sink_factory) shards_.back()->sink = options_.sink_factory(i);
+        }
+        for (auto& shard : shards_) {
+            Shard* s = shard.get();
+            s->worker = std::thread([this, s] { run(*s); });
+        }
+    }
+
+    ~ChainRegistry() {
+        stop();
+    }
+
+    ChainRegistry(const ChainRegistry&) = delete;
+    ChainRegistry& operator=(const ChainRegistry&) = delete;
+
+    /**
+     * @brief Register a device with a fresh chain
+     *
+     * Idempotent: registering a known ID returns its existing handle.
+     */
+    DeviceHandle add_device(std::string_view device_id) {
+        std::unique_lock<std::shared_mutex> lock(index_mutex_);
+        auto it = index_.find(device_id);
+        if (it != index_.end()) return it->second;
+        return insert(device_id, detail::chain_init_hash(), 0, 0);
+    }
+
+    /**
+     * @brief Register a device that resumes from a saved chain position
+     *
+     * Only the link (sequence, last hash, timestamp) is used; checkpoint
+     * windows in @p state are ignored.
+     * @return Invalid handle if the device is already registered
+     */
+    DeviceHandle add_device(const ChainState& state) {
+        std::unique_lock<std::shared_mutex> lock(index_mutex_);
+        if (index_.count(state.device_id) != 0) return DeviceHandle();
+        return insert(state.device_id, state.last_hash, state.sequence, state.timestamp_ms);
+    }
+
+    /**
+     * @brief Look up a registered device
+     * @return Invalid handle if @p device_id is unknown
+     */
+    DeviceHandle find(std::string_view device_id) const {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        auto it = index_.find(device_id);
+        return it == index_.end() ? DeviceHandle() : it->second;
+    }
+
+    /**
+     * @brief Enqueue an event for @p device without blocking
+     * @return false if @p device is invalid or the shard's queue is full (the
+     *         event is not logged)
+     */
+    bool try_log(DeviceHandle device,
+                 std::string_view message,
+                 UserID user_id = UserID::System,
+                 Severity severity = Severity::Info) {
+        if (!owns(device)) return false;
+        Shard& shard = *shards_[device.shard_];
+        if (!shard.ring.try_push(now_ms(), message, user_id, severity, device.chain_)) {
+            shard.rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.enqueued.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Enqueue an event for @p device, yielding while its shard is full
+     *
+     * @p device must be valid; an invalid handle is dropped (and asserts).
+     */
+    void log(DeviceHandle device,
+             std::string_view message,
+             UserID user_id = UserID::System,
+             Severity severity = Severity::Info) {
+        assert(owns(device));
+        if (!owns(device)) return;
+        Shard& shard = *shards_[device.shard_];
+        const int64_t timestamp_ms = now_ms();
+        while (!shard.ring.try_push(timestamp_ms, message, user_id, severity, device.chain_)) {
+            std::this_thread::yield();
+        }
+        shard.enqueued.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Look up @p device_id and log to it
+     *
+     * Prefer keeping the DeviceHandle; this takes a shared lock per call.
+     * @return false if the device is not registered
+     */
+    bool log(std::string_view device_id,
+             std::string_view message,
+             UserID user_id = UserID::System,
+             Severity severity = Severity::Info) {
+        const DeviceHandle device = find(device_id);
+        if (!device) return false;
+        log(device, message, user_id, severity);
+        return true;
+    }
+
+    /**
+     * @brief Wait until every event enqueued so far has been chained and written
+     */
+    void flush() {
+        for (auto& shard : shards_) {
+            const uint64_t target = shard->enqueued.load(std::memory_order_acquire);
+            while (shard->sequenced.load(std::memory_order_acquire) < target) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+
+    /**
+     * @brief Drain every queue, stop the workers, and flush the sinks
+     *
+     * Called by the destructor.
+     */
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        for (auto& shard : shards_) {
+            if (!shard->worker.joinable()) continue;
+            shard->worker.join();
+            if (shard->sink) shard->sink->flush();
+        }
+    }
+
+    /**
+     * @brief Chain position of @p device; call after flush() for a stable value
+     *
+     * An invalid handle yields a default (empty) state.
+     */
+    ChainState state(DeviceHandle device) const {
+        ChainState state;
+        if (!owns(device)) return state;
+        state.device_id = std::string(device.chain_->device_id->text);
+        state.sequence = device.chain_->sequence;
+        state.last_hash = device.chain_->previous_hash;
+        state.timestamp_ms = device.chain_->timestamp_ms;
+        return state;
+    }
+
+    /**
+     * @brief Entries chained for @p device; call after flush() for a stable value
+     * @return 0 for an invalid handle
+     */
+    uint64_t get_sequence_number(DeviceHandle device) const {
+        if (!owns(device)) return 0;
+        return device.chain_->sequence;
+    }
+
+    /**
+     * @brief Current chain hash of @p device; call after flush() for a stable value
+     * @return Empty for an invalid handle
+     */
+    std::string get_chain_hash(DeviceHandle device) const {
+        if (!owns(device)) return {};
+        std::string hex(64, '\0');
+        detail::hex_encode(device.chain_->previous_hash.data(),
+                           device.chain_->previous_hash.size(), &hex[0]);
+        return hex;
+    }
+
+    size_t device_count() const {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        return index_.size();
+    }
+
+    size_t shard_count() const { return shards_.size(); }
+
+    /**
+     * @brief Events refused by try_log() because a queue was full
+     */
+    uint64_t rejected_count() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards_) total += shard->rejected.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    struct Shard {
+        Shard(size_t capacity, size_t slot_size) : ring(capacity, slot_size) {}
+
+        detail::EventRing ring;
+        std::deque<detail::DeviceChain> devices;    ///< Stable addresses; guarded by index_mutex_
+        std::shared_ptr<LogSink> sink;
+        TimestampFormatter formatter;               ///< Worker thread only
+        std::string entry;                          ///< Worker thread only
+        std::thread worker;
+        std::atomic<uint64_t> enqueued{0};
+        std::atomic<uint64_t> sequenced{0};
+        std::atomic<uint64_t> rejected{0};
+    };
+
+    Options options_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> running_{true};
+
+    mutable std::shared_mutex index_mutex_;
+    std::unordered_map<std::string_view, DeviceHandle> index_;
+    StringPool ids_;                                    ///< Interned device IDs
+
+    /// A handle from add_device()/find(): valid, and for one of our shards
+    bool owns(const DeviceHandle& device) const {
+        return device.chain_ != nullptr && device.shard_ < shards_.size();
+    }
+
+    int64_t now_ms() const {
+        return to_epoch_ms(options_.clock ? options_.clock() : std::chrono::system_clock::now());
+    }
+
+    DeviceHandle insert(std::string_view device_id, const SHA256::Hash& last_hash,
+                        uint64_t sequence, int64_t timestamp_ms) {
+        const PooledString& id = ids_.intern(device_id);
+        const size_t shard = std::hash<std::string_view>()(id.text) % shards_.size();
+        auto& devices = shards_[shard]->devices;
+        devices.push_back(detail::DeviceChain{&id, last_hash, sequence, timestamp_ms});
+        const DeviceHandle handle(shard, &devices.back());
+        index_.emplace(id.text, handle);
+        return handle;
+    }
+
+    static void append(Shard& shard, detail::DeviceChain& device,
+                       const detail::EventRing::Event& event, std::string_view message) {
+        char timestamp[detail::timestamp_length];
+        shard.formatter.format(event.timestamp_ms, timestamp);
+
+        std::array<char, 64> previous_hex;
+        detail::hex_encode(device.previous_hash.data(), device.previous_hash.size(),
+                           previous_hex.data());
+        const auto current_hash = detail::chain_hash(detail::chain_prefix(device.device_id->text),
+                                                     timestamp, event.user_id, event.severity,
+                                                     message, previous_hex.data());
+        std::array<char, 64> current_hex;
+        detail::hex_encode(current_hash.data(), current_hash.size(), current_hex.data());
+
+        const size_t escaped_len = detail::json_escaped_length(message.data(), message.size());
+        shard.entry.resize(detail::json_entry_length(device.device_id->json.size(), escaped_len,
+                                                     event.user_id, event.severity));
+        detail::write_json_entry(&shard.entry[0], device.device_id->json, timestamp, event.user_id,
+                                 event.severity, message, escaped_len, previous_hex.data(),
+                                 current_hex.data());
+
+        const EntryInfo info{device.sequence + 1, event.timestamp_ms, event.user_id,
+                             event.severity, current_hash, device.previous_hash,
+                             device.device_id->text, message};
+        device.previous_hash = current_hash;
+        device.sequence = info.sequence;
+        device.timestamp_ms = event.timestamp_ms;
+        if (shard.sink) shard.sink->write(shard.entry, info);
+    }
+
+    void run(Shard& shard) {
+        unsigned idle_spins = 0;
+        for (;;) {
+            detail::EventRing::Event event;
+            std::string_view message;
+            if (shard.ring.peek(event, message)) {
+                append(shard, *static_cast<detail::DeviceChain*>(event.context), event, message);
+                shard.ring.pop();
+                shard.sequenced.fetch_add(1, std::memory_order_release);
+                idle_spins = 0;
+                continue;
+            }
+            if (!running_.load(std::memory_order_acquire) &&
+                shard.sequenced.load(std::memory_order_relaxed) ==
+                    shard.enqueued.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (++idle_spins < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(options_.idle_wait);
+            }
+        }
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_CHAIN_REGISTRY_HPP
@@ -0,0 +1,237 @@
+/**
+ * @file chain_state.hpp
+ * @brief Persistent chain-state snapshots for fast resume after restart
+ *
+ * A ChainState captures everything AuditChain needs to continue a chain:
+ * the last chain_hash, the sequence number, the Merkle checkpoint
+ * accumulators, and how many bytes of the log file it covers. Snapshots are
+ * written to a temporary file, synced, and renamed over the previous one,
+ * so a crash leaves either the old or the new snapshot, never a mix. Each
+ * snapshot ends with a SHA-256 checksum of its contents.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_CHAIN_STATE_HPP
+#define DTS_CHAIN_STATE_HPP
+
+#include "entry_format.hpp"
+#include "merkle.hpp"
+#include "sha256.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace dts {
+
+/**
+ * @brief Resumable position of a chain
+ */
+struct ChainState {
+    std::string device_id;
+    uint64_t sequence = 0;                      ///< Entries in the chain so far
+    SHA256::Hash last_hash = detail::chain_init_hash();  ///< chain_hash of entry @c sequence
+    int64_t timestamp_ms = 0;                   ///< Timestamp of entry @c sequence
+    uint64_t log_offset = 0;                    ///< Log bytes covered (through entry @c sequence)
+    uint64_t window_first = 0;                  ///< First sequence of the open checkpoint window
+    merkle::Accumulator window;                 ///< Chain hashes since the last checkpoint
+                                                ///< (AuditChain fills it only with checkpoints on)
+    merkle::Accumulator checkpoints;            ///< Checkpoint roots so far
+
+    /**
+     * @brief Advance past one entry
+     * @param message Raw (unescaped) message, inspected for checkpoints
+     * @param system_user Whether the entry was logged as UserID::System
+     */
+    void apply(uint64_t entry_sequence, int64_t entry_timestamp_ms,
+               const SHA256::Hash& chain_hash, std::string_view message, bool system_user) {
+        sequence = entry_sequence;
+        timestamp_ms = entry_timestamp_ms;
+        last_hash = chain_hash;
+        Checkpoint checkpoint;
+        if (system_user && parse_checkpoint_message(message, checkpoint)) {
+            checkpoints.append(checkpoint.root);
+            window.clear();
+            return;
+        }
+        if (window.size() == 0) window_first = entry_sequence;
+        window.append(chain_hash);
+    }
+};
+
+namespace detail {
+
+static constexpr char state_magic[4] = {'D', 'T', 'S', 'S'};
+static constexpr uint8_t state_version = 1;
+
+inline void put_u64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+inline bool get_u64(std::string_view& in, uint64_t& value) {
+    if (in.size() < 8) return false;
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    in.remove_prefix(8);
+    return true;
+}
+
+inline bool get_hash(std::string_view& in, SHA256::Hash& hash) {
+    if (in.size() < 32) return false;
+    std::memcpy(hash.data(), in.data(), 32);
+    in.remove_prefix(32);
+    return true;
+}
+
+inline void put_accumulator(std::string& out, const merkle::Accumulator& accumulator) {
+    put_u64(out, accumulator.size());
+    for (const auto& node : accumulator.frontier()) {
+        out.append(reinterpret_cast<const char*>(node.data()), 32);
+    }
+}
+
+inline bool get_accumulator(std::string_view& in, merkle::Accumulator& accumulator) {
+    uint64_t size;
+    if (!get_u64(in, size)) return false;
+    std::vector<SHA256::Hash> nodes;
+    for (uint64_t n = size; n; n &= n - 1) {
+        nodes.emplace_back();
+        if (!get_hash(in, nodes.back())) return false;
+    }
+    return accumulator.restore(size, nodes);
+}
+
+} // namespace detail
+
+/**
+ * @brief Serialize @p state (little-endian fields, SHA-256 trailer)
+ */
+inline std::string encode_chain_state(const ChainState& state) {
+    std::string out(detail::state_magic, sizeof(detail::state_magic));
+    out.push_back(static_cast<char>(detail::state_version));
+    detail::put_u64(out, state.device_id.size());
+    out.append(state.device_id);
+    detail::put_u64(out, state.sequence);
+    out.append(reinterpret_cast<const char*>(state.last_hash.data()), 32);
+    detail::put_u64(out, static_cast<uint64_t>(state.timestamp_ms));
+    detail::put_u64(out, state.log_offset);
+    detail::put_u64(out, state.window_first);
+    detail::put_accumulator(out, state.window);
+    detail::put_accumulator(out, state.checkpoints);
+    const auto checksum = SHA256::hash(out);
+    out.append(reinterpret_cast<const char*>(checksum.data()), 32);
+    return out;
+}
+
+/**
+ * @brief Parse a snapshot produced by encode_chain_state()
+ * @return false if it is truncated, corrupt, or of another version
+ */
+inline bool decode_chain_state(std::string_view data, ChainState& state) {
+    if (data.size() < sizeof(detail::state_magic) + 1 + 32 ||
+        std::memcmp(data.data(), detail::state_magic, sizeof(detail::state_magic)) != 0 ||
+        static_cast<uint8_t>(data[4]) != detail::state_version) {
+        return false;
+    }
+    const auto checksum = SHA256::hash(reinterpret_cast<const uint8_t*>(data.data()),
+                                       data.size() - 32);
+    if (std::memcmp(checksum.data(), data.data() + data.size() - 32, 32) != 0) return false;
+
+    std::string_view in = data.substr(5, data.size() - 5 - 32);
+    ChainState parsed;
+    uint64_t device_len, timestamp;
+    if (!detail::get_u64(in, device_len) || device_len > in.size()) return false;
+    parsed.device_id.assign(in.data(), device_len);
+    in.remove_prefix(device_len);
+    if (!detail::get_u64(in, parsed.sequence) || !detail::get_hash(in, parsed.last_hash) ||
+        !detail::get_u64(in, timestamp) || !detail::get_u64(in, parsed.log_offset) ||
+        !detail::get_u64(in, parsed.window_first) ||
+        !detail::get_accumulator(in, parsed.window) ||
+        !detail::get_accumulator(in, parsed.checkpoints) || !in.empty()) {
+        return false;
+    }
+    parsed.timestamp_ms = static_cast<int64_t>(timestamp);
+    state = std::move(parsed);
+    return true;
+}
+
+/**
+ * @brief Atomically replace the snapshot at @p path
+ *
+ * Writes @p path + ".tmp", syncs it, renames it over @p path, and syncs the
+ * directory (POSIX). Elsewhere the replace is best effort.
+ */
+inline bool save_chain_state(const std::string& path, const ChainState& state) {
+    const std::string data = encode_chain_state(state);
+    const std::string tmp = path + ".tmp";
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    size_t done = 0;
+    while (done < data.size()) {
+        const ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+#if defined(__APPLE__)
+    const bool synced = ::fcntl(fd, F_FULLFSYNC) == 0 || ::fsync(fd) == 0;
+#else
+    const bool synced = ::fsync(fd) == 0;
+#endif
+    if (::close(fd) != 0 || !synced || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    const size_t slash = path.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    const int dir_fd = ::open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+    return true;
+#else
+    std::FILE* file = std::fopen(tmp.c_str(), "wb");
+    if (!file) return false;
+    const bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    if (std::fclose(file) != 0 || !written) return false;
+    std::remove(path.c_str());
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+}
+
+/**
+ * @brief Load the snapshot at @p path
+ * @return false if it is missing or fails its checksum
+ */
+inline bool load_chain_state(const std::string& path, ChainState& state) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::string data;
+    char chunk[4096];
+    for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) data.append(chunk, n);
+    const bool read_ok = !std::ferror(file);
+    std::fclose(file);
+    return read_ok && decode_chain_state(data, state);
+}
+
+} // namespace dts
+
+#endif // DTS_CHAIN_STATE_HPP
@@ -0,0 +1,477 @@
+/**
+ * @file chain_verifier.hpp
+ * @brief Streaming and parallel verification of JSON-lines audit logs
+ *
+ * ChainVerifier checks entries one at a time without holding the log in
+ * memory. verify_buffer() and verify_file() check a whole JSON-lines log; a
+ * file is memory-mapped where the platform allows, and large logs are split
+ * into segments verified on separate threads, with the links between
+ * segments checked once all segments are done.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_CHAIN_VERIFIER_HPP
+#define DTS_CHAIN_VERIFIER_HPP
+
+#include "audit_chain.hpp"
+#include "entry_parser.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dts {
+
+/**
+ * @brief Outcome of verifying a log
+ */
+enum class VerifyStatus {
+    Ok,
+    Malformed,      ///< An entry could not be parsed
+    BrokenLink,     ///< previous_hash does not match the preceding chain_hash
+    HashMismatch,   ///< chain_hash does not match the entry's contents (recompute mode)
+    BadSignature    ///< A signed checkpoint does not verify (signed_checkpoint.hpp)
+};
+
+struct VerifyResult {
+    VerifyStatus status = VerifyStatus::Ok;
+    uint64_t entries = 0;           ///< Entries verified before stopping
+    uint64_t failed_entry = 0;      ///< 1-based index of the first bad entry (0 if none)
+    size_t failed_offset = 0;       ///< Byte offset of that entry (buffers and files)
+    SHA256::Hash first_previous_hash{};  ///< previous_hash of the first entry
+    SHA256::Hash last_hash{};       ///< chain_hash of the last good entry
+
+    bool ok() const { return status == VerifyStatus::Ok; }
+    explicit operator bool() const { return ok(); }
+};
+
+struct VerifyOptions {
+    /// Worker threads for buffers and files (0: hardware concurrency)
+    unsigned threads = 1;
+    /// Segments are never smaller than this
+    size_t min_segment_bytes = 4 * 1024 * 1024;
+    /// Expected previous_hash of the first entry
+    SHA256::Hash initial_hash = detail::chain_init_hash();
+    /// Re-derive every chain_hash from the entry fields, not just the links
+    bool recompute = false;
+};
+
+/**
+ * @brief Incremental verifier; feed entries in chain order
+ *
+ * In recompute mode entries are hashed in batches through
+ * SHA256::hash_many(), so the multi-buffer backend is used where it is
+ * faster; result() completes any partial batch.
+ */
+class ChainVerifier {
+public:
+    /**
+     * @brief Verify a chain from its first entry
+     */
+    ChainVerifier() : ChainVerifier(detail::chain_init_hash()) {}
+
+    /**
+     * @brief Verify a chain continuing from an entry whose chain_hash is @p previous
+     */
+    explicit ChainVerifier(const SHA256::Hash& previous, bool recompute = false)
+        : link_hash_(previous), recompute_(recompute) {
+        result_.last_hash = previous;
+    }
+
+    /**
+     * @brief Verifier that accepts whatever the first entry links to
+     *
+     * Used for segments of a larger log; the caller checks
+     * result().first_previous_hash against the preceding segment.
+     */
+    static ChainVerifier unanchored(bool recompute = false) {
+        ChainVerifier verifier(detail::chain_init_hash(), recompute);
+        verifier.anchored_ = false;
+        return verifier;
+    }
+
+    /**
+     * @brief Check the next entry
+     * @param offset Byte offset reported if this entry fails
+     * @return false once verification has failed
+     */
+    bool add(std::string_view entry, size_t offset = 0) {
+        if (!result_.ok()) return false;
+
+        const char* prev_hex;
+        const char* chain_hex;
+        EntryView view;
+        if (recompute_) {
+            if (!parse_entry(entry, view)) return fail_after_batch(VerifyStatus::Malformed, offset);
+            prev_hex = view.previous_hash.data();
+            chain_hex = view.chain_hash.data();
+        } else if (!detail::entry_link_hashes(entry, prev_hex, chain_hex)) {
+            return fail(VerifyStatus::Malformed, offset);
+        }
+        SHA256::Hash prev_hash;
+        SHA256::Hash chain_hash;
+        if (!detail::hex_decode(prev_hex, prev_hash.size(), prev_hash.data()) ||
+            !detail::hex_decode(chain_hex, chain_hash.size(), chain_hash.data())) {
+            return fail_after_batch(VerifyStatus::Malformed, offset);
+        }
+        if (linked_ == 0) {
+            result_.first_previous_hash = prev_hash;
+        }
+        if ((linked_ > 0 || anchored_) && prev_hash != link_hash_) {
+            return fail_after_batch(VerifyStatus::BrokenLink, offset);
+        }
+        link_hash_ = chain_hash;
+        ++linked_;
+
+        if (!recompute_) {
+            result_.last_hash = chain_hash;
+            ++result_.entries;
+            return true;
+        }
+        Pending& pending = batch_[batch_count_];
+        if (!detail::chain_payload(view, pending.payload)) {
+            --linked_;
+            return fail_after_batch(VerifyStatus::Malformed, offset);
+        }
+        pending.stated = chain_hash;
+        pending.offset = offset;
+        if (++batch_count_ == batch_size) return hash_batch();
+        return true;
+    }
+
+    /**
+     * @brief Verification outcome so far (completes any pending batch)
+     */
+    const VerifyResult& result() {
+        if (result_.ok()) hash_batch();
+        return result_;
+    }
+
+    bool ok() { return result().ok(); }
+
+private:
+    static constexpr size_t batch_size = 8;
+
+    struct Pending {
+        std::string payload;
+        SHA256::Hash stated{};
+        size_t offset = 0;
+    };
+
+    VerifyResult result_;
+    SHA256::Hash link_hash_;    ///< chain_hash of the last entry whose link was checked
+    uint64_t linked_ = 0;       ///< Entries whose link was checked
+    bool anchored_ = true;
+    bool recompute_ = false;
+    Pending batch_[batch_size];
+    size_t batch_count_ = 0;
+
+    bool fail(VerifyStatus status, size_t offset) {
+        result_.status = status;
+        result_.failed_entry = result_.entries + 1;
+        result_.failed_offset = offset;
+        return false;
+    }
+
+    /// Earlier entries still awaiting their hash check take precedence
+    bool fail_after_batch(VerifyStatus status, size_t offset) {
+        if (!hash_batch()) return false;
+        return fail(status, offset);
+    }
+
+    bool hash_batch() {
+        if (batch_count_ == 0) return true;
+        const uint8_t* data[batch_size];
+        size_t lens[batch_size];
+        SHA256::Hash computed[batch_size];
+        for (size_t i = 0; i < batch_count_; ++i) {
+            data[i] = reinterpret_cast<const uint8_t*>(batch_[i].payload.data());
+            lens[i] = batch_[i].payload.size();
+        }
+        SHA256::hash_many(data, lens, batch_count_, computed);
+
+        const size_t count = batch_count_;
+        batch_count_ = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (computed[i] != batch_[i].stated) {
+                return fail(VerifyStatus::HashMismatch, batch_[i].offset);
+            }
+            result_.last_hash = batch_[i].stated;
+            ++result_.entries;
+        }
+        return true;
+    }
+};
+
+namespace detail {
+
+/// Feed a verification outcome to the metrics counters
+inline void count_verified(const VerifyResult& result) {
+    DTS_METRICS_ADD(EntriesVerified, result.entries);
+    DTS_METRICS_ADD(VerifyFailures, result.ok() ? 0 : 1);
+    (void)result;
+}
+
+/// Entry visitor that does nothing
+struct IgnoreEntries {
+    void operator()(std::string_view, size_t) const {}
+};
+
+/**
+ * @brief Feed every non-blank line of [begin, end) to @p verifier
+ * @param base Byte offset of @p begin within the whole log
+ * @param visit Called as visit(entry, offset) for each entry the verifier accepts
+ */
+template <typename Visit = IgnoreEntries>
+void verify_lines(const char* begin, const char* end, size_t base,
+                  ChainVerifier& verifier, Visit&& visit = Visit()) {
+    const char* p = begin;
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(
+            std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!line_end) line_end = end;
+        const char* text_end = line_end;
+        if (text_end > p && text_end[-1] == '\r') --text_end;
+        if (text_end > p) {
+            const std::string_view entry(p, static_cast<size_t>(text_end - p));
+            const size_t offset = base + static_cast<size_t>(p - begin);
+            if (!verifier.add(entry, offset)) return;
+            visit(entry, offset);
+        }
+        p = line_end + 1;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Verify a sequence of entries from any input range
+ *
+ * Elements must convert to std::string_view. Only one entry is held at a
+ * time, so this works with single-pass iterators such as line readers.
+ */
+template <typename InputIt>
+VerifyResult verify_entries(InputIt first, InputIt last,
+                            const VerifyOptions& options = VerifyOptions()) {
+    ChainVerifier verifier(options.initial_hash, options.recompute);
+    for (; first != last; ++first) {
+        if (!verifier.add(std::string_view(*first))) break;
+    }
+    return verifier.result();
+}
+
+/**
+ * @brief Verify a JSON-lines stream, reusing one line buffer
+ */
+inline VerifyResult verify_stream(std::istream& in,
+                                  const VerifyOptions& options = VerifyOptions()) {
+    DTS_METRICS_TIME(Verify);
+    ChainVerifier verifier(options.initial_hash, options.recompute);
+    std::string line;
+    size_t offset = 0;
+    while (std::getline(in, line)) {
+        std::string_view text(line);
+        if (!text.empty() && text.back() == '\r') text.remove_suffix(1);
+        if (!text.empty() && !verifier.add(text, offset)) break;
+        offset += line.size() + 1;
+    }
+    detail::count_verified(verifier.result());
+    return verifier.result();
+}
+
+namespace detail {
+
+/// Segments verify_segments() cuts @p log into
+inline size_t segment_count(std::string_view log, const VerifyOptions& options) {
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    const size_t min_segment = std::max<size_t>(options.min_segment_bytes, 1);
+    const size_t max_segments = std::max<size_t>(log.size() / min_segment, 1);
+    return std::min<size_t>(std::max(threads, 1u), max_segments);
+}
+
+/**
+ * @param visit Called as visit(segment, entry, offset) for each accepted
+ *        entry, in log order within a segment; segments (numbered below
+ *        segment_count()) run on their own threads
+ */
+template <typename Visit>
+VerifyResult verify_segments(std::string_view log, const VerifyOptions& options, Visit&& visit) {
+    const size_t segments = segment_count(log, options);
+    auto visitor = [&visit](size_t segment) {
+        return [&visit, segment](std::string_view entry, size_t offset) {
+            visit(segment, entry, offset);
+        };
+    };
+
+    if (segments == 1) {
+        ChainVerifier verifier(options.initial_hash, options.recompute);
+        detail::verify_lines(log.data(), log.data() + log.size(), 0, verifier, visitor(0));
+        return verifier.result();
+    }
+
+    // Segment boundaries, each just past a newline
+    std::vector<size_t> bounds(segments + 1, log.size());
+    bounds[0] = 0;
+    for (size_t i = 1; i < segments; ++i) {
+        size_t cut = std::max(log.size() * i / segments, bounds[i - 1]);
+        const size_t newline = log.find('\n', cut);
+        bounds[i] = newline == std::string_view::npos ? log.size() : newline + 1;
+    }
+
+    std::vector<ChainVerifier> verifiers(segments, ChainVerifier::unanchored(options.recompute));
+    std::vector<std::thread> workers;
+    workers.reserve(segments - 1);
+    for (size_t i = 1; i < segments; ++i) {
+        workers.emplace_back([&, i] {
+            detail::verify_lines(log.data() + bounds[i], log.data() + bounds[i + 1],
+                                 bounds[i], verifiers[i], visitor(i));
+            verifiers[i].result();  // hash the final partial batch on this thread
+        });
+    }
+    detail::verify_lines(log.data(), log.data() + bounds[1], 0, verifiers[0], visitor(0));
+    verifiers[0].result();
+    for (auto& worker : workers) worker.join();
+
+    // Stitch segments together in log order
+    VerifyResult total;
+    total.last_hash = options.initial_hash;
+    for (size_t i = 0; i < segments; ++i) {
+        const VerifyResult& part = verifiers[i].result();
+        if (part.entries > 0 || !part.ok()) {
+            if (part.entries > 0 && part.first_previous_hash != total.last_hash) {
+                total.status = VerifyStatus::BrokenLink;
+                total.failed_entry = total.entries + 1;
+                total.failed_offset = bounds[i];
+                return total;
+            }
+            if (total.entries == 0) total.first_previous_hash = part.first_previous_hash;
+        }
+        if (!part.ok()) {
+            total.status = part.status;
+            total.failed_entry = total.entries + part.failed_entry;
+            total.failed_offset = part.failed_offset;
+            total.entries += part.entries;
+            return total;
+        }
+        if (part.entries > 0) total.last_hash = part.last_hash;
+        total.entries += part.entries;
+    }
+    return total;
+}
+
+inline VerifyResult verify_segments(std::string_view log, const VerifyOptions& options) {
+    return verify_segments(log, options, [](size_t, std::string_view, size_t) {});
+}
+
+} // namespace detail
+
+/**
+ * @brief Verify a JSON-lines log held in memory
+ *
+ * With more than one thread the log is cut at line boundaries into
+ * segments that are verified concurrently; each segment boundary is then
+ * checked against the preceding segment's last chain_hash.
+ */
+inline VerifyResult verify_buffer(std::string_view log, const VerifyOptions& options = VerifyOptions()) {
+    DTS_METRICS_TIME(Verify);
+    const VerifyResult result = detail::verify_segments(log, options);
+    detail::count_verified(result);
+    return result;
+}
+
+/**
+ * @brief Read-only view of a whole file (memory-mapped where available)
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat st{};
+        if (::fstat(fd, &st) == 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ == 0) {
+                ok_ = true;
+            } else {
+                void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map != MAP_FAILED) {
+#if defined(POSIX_MADV_SEQUENTIAL)
+                    ::posix_madvise(map, size_, POSIX_MADV_SEQUENTIAL);
+#endif
+                    map_ = map;
+                    data_ = static_cast<const char*>(map);
+                    ok_ = true;
+                }
+            }
+        }
+        ::close(fd);
+        if (ok_) return;
+#endif
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return;
+        char chunk[64 * 1024];
+        for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) {
+            buffer_.append(chunk, n);
+        }
+        ok_ = !std::ferror(file);
+        std::fclose(file);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (map_) ::munmap(map_, size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool ok() const { return ok_; }
+    std::string_view view() const { return std::string_view(data_ ? data_ : "", size_); }
+
+private:
+    void* map_ = nullptr;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_;    ///< Fallback when mapping is unavailable
+    bool ok_ = false;
+};
+
+/**
+ * @brief Verify a JSON-lines log file
+ * @param ok Set to false if the file could not be read
+ */
+inline VerifyResult verify_file(const std::string& path, const VerifyOptions& options = VerifyOptions(),
+                                bool* ok = nullptr) {
+    MappedFile file(path);
+    if (ok) *ok = file.ok();
+    if (!file.ok()) {
+        VerifyResult result;
+        result.status = VerifyStatus::Malformed;
+        result.failed_entry = 1;
+        return result;
+    }
+    return verify_buffer(file.view(), options);
+}
+
+} // namespace dts
+
+#endif // DTS_CHAIN_VERIFIER_HPP
@@ -0,0 +1,370 @@
+/**
+ * @file compression.hpp
+ * @brief Dependency-free LZ77 block codec with optional preset dictionaries
+ *
+ * Audit entries repeat the same field names, device ID and message prefixes
+ * in every line, and each entry's previous_hash is the chain_hash of the
+ * line before it. A plain LZ77 coder with a 64 KiB window captures most of
+ * that. Blocks are independent: each one decodes on its own, given only the
+ * dictionary it was compressed with.
+ *
+ * Block format (LZ4-style sequences):
+ *
+ *   token      u8: literal length (high nibble), match length - 4 (low nibble);
+ *              a nibble of 15 continues in 255-valued bytes and a final byte
+ *   literals   raw bytes
+ *   offset     u16 LE distance back, into this block's output or the dictionary
+ *   [length]   match length continuation
+ *
+ * The last sequence carries literals only and ends the block. Blocks carry
+ * no length of their own: a block cut short after a run of literals still
+ * parses, so callers store the decoded size and check it.
+ *
+ * A dictionary is text the compressor may copy from as if it preceded the
+ * block. train_dictionary() builds one from sample entries, e.g. the output
+ * of one adapter type.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_COMPRESSION_HPP
+#define DTS_COMPRESSION_HPP
+
+#include "sha256.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dts {
+
+namespace detail {
+
+static constexpr size_t lz_min_match = 4;
+static constexpr size_t lz_max_offset = 65535;
+static constexpr unsigned lz_hash_bits = 14;
+static constexpr unsigned lz_search_depth = 16;
+
+inline uint32_t lz_read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t lz_hash(uint32_t value) {
+    return (value * 2654435761u) >> (32 - lz_hash_bits);
+}
+
+inline void lz_put_length(std::string& out, size_t length) {
+    for (; length >= 255; length -= 255) out.push_back('\xff');
+    out.push_back(static_cast<char>(length));
+}
+
+inline bool lz_get_length(const uint8_t*& p, const uint8_t* end, size_t& length) {
+    for (;;) {
+        if (p == end) return false;
+        const uint8_t byte = *p++;
+        length += byte;
+        if (byte != 255) return true;
+    }
+}
+
+/// One sequence; match_length 0 writes the final, literals-only sequence
+inline void lz_put_sequence(std::string& out, const char* literals, size_t literal_length,
+                            size_t offset, size_t match_length) {
+    const size_t match_code = match_length ? match_length - lz_min_match : 0;
+    out.push_back(static_cast<char>((std::min<size_t>(literal_length, 15) << 4) |
+                                    std::min<size_t>(match_code, 15)));
+    if (literal_length >= 15) lz_put_length(out, literal_length - 15);
+    out.append(literals, literal_length);
+    if (match_length == 0) return;
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (match_code >= 15) lz_put_length(out, match_code - 15);
+}
+
+/// The part of a dictionary that matches can reach
+inline std::string_view lz_window(std::string_view dictionary) {
+    return dictionary.size() > lz_max_offset
+               ? dictionary.substr(dictionary.size() - lz_max_offset)
+               : dictionary;
+}
+
+} // namespace detail
+
+/**
+ * @brief Reusable block compressor
+ *
+ * The dictionary is hashed once, at construction; each block starts from a
+ * copy of those tables and only hashes the last few dictionary positions,
+ * whose four bytes run into the block.
+ */
+class BlockCompressor {
+public:
+    explicit BlockCompressor(std::string_view dictionary = {})
+        : dictionary_(detail::lz_window(dictionary)),
+          dictionary_head_(size_t{1} << detail::lz_hash_bits, none) {
+        const size_t hashed = dictionary_.size() >= detail::lz_min_match
+                                  ? dictionary_.size() - detail::lz_min_match + 1
+                                  : 0;
+        dictionary_chain_.resize(hashed);
+        for (size_t pos = 0; pos < hashed; ++pos) {
+            const uint32_t h = detail::lz_hash(detail::lz_read32(dictionary_.data() + pos));
+            dictionary_chain_[pos] = dictionary_head_[h];
+            dictionary_head_[h] = static_cast<uint32_t>(pos);
+        }
+    }
+
+    /**
+     * @brief Append the compressed form of @p input to @p out
+     */
+    void compress(std::string_view input, std::string& out) {
+        buffer_.assign(dictionary_);
+        buffer_.append(input.data(), input.size());
+        const char* data = buffer_.data();
+        const size_t end = buffer_.size();
+        head_ = dictionary_head_;
+        chain_.resize(end);
+        std::copy(dictionary_chain_.begin(), dictionary_chain_.end(), chain_.begin());
+
+        auto insert = [&](size_t pos) {
+            const uint32_t h = detail::lz_hash(detail::lz_read32(data + pos));
+            chain_[pos] = head_[h];
+            head_[h] = static_cast<uint32_t>(pos);
+        };
+        const size_t start = dictionary_.size();
+        for (size_t pos = dictionary_chain_.size();
+             pos < start && pos + detail::lz_min_match <= end; ++pos) {
+            insert(pos);
+        }
+
+        size_t anchor = start;
+        size_t pos = start;
+        while (pos + detail::lz_min_match <= end) {
+            const size_t limit = end - pos;
+            size_t best_length = 0;
+            size_t best_offset = 0;
+            uint32_t candidate = head_[detail::lz_hash(detail::lz_read32(data + pos))];
+            for (unsigned depth = 0; candidate != none && depth < detail::lz_search_depth &&
+                                     pos - candidate <= detail::lz_max_offset;
+                 ++depth, candidate = chain_[candidate]) {
+                // Only a candidate that beats the best so far is worth extending
+                if (data[candidate + best_length] != data[pos + best_length]) continue;
+                size_t length = 0;
+                while (length < limit && data[candidate + length] == data[pos + length]) ++length;
+                if (length > best_length) {
+                    best_length = length;
+                    best_offset = pos - candidate;
+                    if (length == limit) break;
+                }
+            }
+            if (best_length < detail::lz_min_match) {
+                insert(pos++);
+                continue;
+            }
+            detail::lz_put_sequence(out, data + anchor, pos - anchor, best_offset, best_length);
+            const size_t match_end = pos + best_length;
+            for (; pos < match_end && pos + detail::lz_min_match <= end; ++pos) insert(pos);
+            pos = anchor = match_end;
+        }
+        detail::lz_put_sequence(out, data + anchor, end - anchor, 0, 0);
+    }
+
+private:
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    std::string dictionary_;
+    std::vector<uint32_t> dictionary_head_;     ///< head_ after hashing the dictionary
+    std::vector<uint32_t> dictionary_chain_;    ///< chain_ of the dictionary positions
+    std::string buffer_;                ///< Dictionary followed by the block
+    std::vector<uint32_t> head_;        ///< Latest position per hash
+    std::vector<uint32_t> chain_;       ///< Previous position with the same hash
+};
+
+/**
+ * @brief Append the compressed form of @p input to @p out
+ */
+inline void compress_block(std::string_view input, std::string& out,
+                           std::string_view dictionary = {}) {
+    BlockCompressor(dictionary).compress(input, out);
+}
+
+/**
+ * @brief Append the decoded form of @p input to @p out
+ * @param max_size Fail rather than decode more than this many bytes
+ * @return false on malformed input or a dictionary that does not fit it
+ */
+inline bool decompress_block(std::string_view input, std::string& out,
+                             std::string_view dictionary = {},
+                             size_t max_size = std::numeric_limits<size_t>::max()) {
+    dictionary = detail::lz_window(dictionary);
+    const size_t start = out.size();
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(input.data());
+    const uint8_t* const end = p + input.size();
+    while (p < end) {
+        const uint8_t token = *p++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !detail::lz_get_length(p, end, literals)) return false;
+        if (static_cast<size_t>(end - p) < literals ||
+            out.size() - start + literals > max_size) {
+            return false;
+        }
+        out.append(reinterpret_cast<const char*>(p), literals);
+        p += literals;
+        if (p == end) return true;
+
+        if (end - p < 2) return false;
+        const size_t offset = static_cast<size_t>(p[0]) | (static_cast<size_t>(p[1]) << 8);
+        p += 2;
+        size_t length = token & 0x0F;
+        if (length == 15 && !detail::lz_get_length(p, end, length)) return false;
+        length += detail::lz_min_match;
+        const size_t produced = out.size() - start;
+        if (offset == 0 || offset > produced + dictionary.size() ||
+            produced + length > max_size) {
+            return false;
+        }
+        if (offset > produced) {
+            // Starts in the dictionary and may run on into this block
+            const size_t from_dictionary = std::min(length, offset - produced);
+            out.append(dictionary.data() + dictionary.size() - (offset - produced),
+                       from_dictionary);
+            length -= from_dictionary;
+        }
+        if (length == 0) continue;
+        const size_t source = out.size() - offset;
+        out.resize(out.size() + length);
+        char* dest = &out[out.size() - length];
+        if (offset >= length) {
+            std::memcpy(dest, out.data() + source, length);
+        } else {
+            // Overlapping copy repeats the last offset bytes
+            for (size_t i = 0; i < length; ++i) dest[i] = out[source + i];
+        }
+    }
+    return false;   // no final sequence
+}
+
+/**
+ * @brief Identifies a dictionary (first 8 bytes of its SHA-256; 0 for none)
+ */
+inline uint64_t dictionary_id(std::string_view dictionary) {
+    if (dictionary.empty()) return 0;
+    const SHA256::Hash digest = SHA256::hash(
+        reinterpret_cast<const uint8_t*>(dictionary.data()), dictionary.size());
+    uint64_t id = 0;
+    for (size_t i = 0; i < 8; ++i) id |= static_cast<uint64_t>(digest[i]) << (8 * i);
+    return id;
+}
+
+/**
+ * @brief Build a dictionary from sample text (e.g., entries from one adapter type)
+ *
+ * Picks the sample segments whose 8-byte substrings occur in the most
+ * samples, without repeating substrings already chosen. Substrings found in
+ * fewer than a tenth of the samples (or three) are ignored, which keeps out
+ * hash digits and serial numbers: a chain hash appears in two entries (as
+ * chain_hash, then previous_hash) and never again. The most useful segments
+ * go last, nearest to the data.
+ *
+ * @param max_size Dictionary size limit (at most 64 KiB is ever used)
+ */
+inline std::string train_dictionary(const std::vector<std::string>& samples,
+                                    size_t max_size = 16 * 1024) {
+    static constexpr size_t gram = 8;
+    static constexpr size_t segment = 48;
+    static constexpr size_t step = 8;
+
+    auto gram_at = [](const std::string& text, size_t pos) {
+        uint64_t value;
+        std::memcpy(&value, text.data() + pos, gram);
+        return value;
+    };
+
+    const uint32_t min_count = static_cast<uint32_t>(std::max<size_t>(3, samples.size() / 10));
+
+    // Number of samples containing each substring
+    std::unordered_map<uint64_t, uint32_t> frequency;
+    {
+        std::unordered_map<uint64_t, size_t> seen_in;
+        for (size_t s = 0; s < samples.size(); ++s) {
+            for (size_t pos = 0; pos + gram <= samples[s].size(); ++pos) {
+                const uint64_t value = gram_at(samples[s], pos);
+                auto it = seen_in.find(value);
+                if (it != seen_in.end() && it->second == s) continue;
+                seen_in[value] = s;
+                ++frequency[value];
+            }
+        }
+    }
+
+    struct Candidate {
+        size_t sample;
+        size_t offset;
+        size_t length;
+    };
+    std::vector<Candidate> candidates;
+    for (size_t s = 0; s < samples.size(); ++s) {
+        for (size_t pos = 0; pos + gram <= samples[s].size(); pos += step) {
+            candidates.push_back({s, pos, std::min(segment, samples[s].size() - pos)});
+        }
+    }
+    auto score = [&](const Candidate& c) {
+        uint64_t total = 0;
+        for (size_t pos = c.offset; pos + gram <= c.offset + c.length; ++pos) {
+            auto it = frequency.find(gram_at(samples[c.sample], pos));
+            if (it != frequency.end() && it->second >= min_count) total += it->second;
+        }
+        return total;
+    };
+
+    // Lazy greedy: a stale score is only an upper bound, so re-score on pop
+    std::priority_queue<std::pair<uint64_t, size_t>> queue;
+    for (size_t i = 0; i < candidates.size(); ++i) queue.emplace(score(candidates[i]), i);
+    std::vector<Candidate> chosen;
+    size_t size = 0;
+    while (!queue.empty() && size < max_size) {
+        const auto [stale, index] = queue.top();
+        queue.pop();
+        const Candidate& c = candidates[index];
+        const uint64_t current = score(c);
+        if (current == 0) continue;
+        if (current < stale && !queue.empty() && current < queue.top().first) {
+            queue.emplace(current, index);
+            continue;
+        }
+        // Keep only the span covered by useful substrings (drops hash digits)
+        size_t first = c.offset + c.length;
+        size_t last = c.offset;
+        for (size_t pos = c.offset; pos + gram <= c.offset + c.length; ++pos) {
+            uint32_t& count = frequency[gram_at(samples[c.sample], pos)];
+            if (count >= min_count) {
+                first = std::min(first, pos);
+                last = pos + gram;
+            }
+            count = 0;
+        }
+        if (size + (last - first) > max_size) continue;
+        chosen.push_back({c.sample, first, last - first});
+        size += last - first;
+    }
+
+    std::string dictionary;
+    dictionary.reserve(size);
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+        dictionary.append(samples[it->sample], it->offset, it->length);
+    }
+    return dictionary;
+}
+
+} // namespace dts
+
+#endif // DTS_COMPRESSION_HPP
@@ -0,0 +1,458 @@
+/**
+ * @file concurrent_audit_chain.hpp
+ * @brief Multi-producer front end for AuditChain
+ *
+ * Producer threads enqueue events into bounded lock-free rings, one per
+ * severity lane; a single sequencer thread drains them by priority, assigns
+ * sequence numbers, and extends the hash chain. Producers never hash,
+ * format, or perform I/O.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_CONCURRENT_AUDIT_CHAIN_HPP
+#define DTS_CONCURRENT_AUDIT_CHAIN_HPP
+
+#include "audit_chain.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace dts {
+
+namespace detail {
+
+/**
+ * @brief Bounded multi-producer/single-consumer ring (Vyukov sequence cells)
+ *
+ * Each cell owns a fixed inline message slot. Messages that do not fit are
+ * moved to a heap block allocated by the producer, so nothing is truncated.
+ */
+class EventRing {
+public:
+    struct Event {
+        int64_t timestamp_ms;
+        UserID user_id;
+        Severity severity;
+        size_t length;
+        char* overflow;     ///< Heap copy if length > slot size, else nullptr
+        void* context;      ///< Opaque tag for consumers that multiplex sources
+        int64_t enqueued_ns;    ///< Producer's steady-clock stamp, if it took one
+    };
+
+    EventRing(size_t capacity, size_t slot_size)
+        : mask_(round_up_pow2(capacity) - 1),
+          slot_size_(slot_size),
+          cells_(new Cell[mask_ + 1]),
+          slots_(new char[(mask_ + 1) * slot_size]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~EventRing() {
+        Event event;
+        std::string_view message;
+        while (peek(event, message)) {
+            pop();
+        }
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    /**
+     * @brief Enqueue an event; wait-free except for CAS retries between producers
+     * @return false if the ring is full
+     */
+    bool try_push(int64_t timestamp_ms, std::string_view message,
+                  UserID user_id, Severity severity, void* context = nullptr,
+                  int64_t enqueued_ns = 0) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        Event& event = cell->event;
+        event.timestamp_ms = timestamp_ms;
+        event.user_id = user_id;
+        event.severity = severity;
+        event.context = context;
+        event.enqueued_ns = enqueued_ns;
+        event.length = message.size();
+        if (message.size() <= slot_size_) {
+            event.overflow = nullptr;
+            std::memcpy(slot(pos), message.data(), message.size());
+        } else {
+            event.overflow = new char[message.size()];
+            std::memcpy(event.overflow, message.data(), message.size());
+        }
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Inspect the oldest event (consumer thread only)
+     * @param message View valid until pop()
+     */
+    bool peek(Event& event, std::string_view& message) const {
+        const Cell& cell = cells_[tail_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return false;
+        }
+        event = cell.event;
+        message = std::string_view(event.overflow ? event.overflow : slot(tail_), event.length);
+        return true;
+    }
+
+    /**
+     * @brief Release the event returned by peek() (consumer thread only)
+     */
+    void pop() {
+        Cell& cell = cells_[tail_ & mask_];
+        delete[] cell.event.overflow;
+        cell.event.overflow = nullptr;
+        cell.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+        ++tail_;
+        consumed_.store(tail_, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /// Approximate number of queued events
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = consumed_.load(std::memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence{0};
+        Event event{};
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    char* slot(size_t pos) const { return slots_.get() + (pos & mask_) * slot_size_; }
+
+    const size_t mask_;
+    const size_t slot_size_;
+    std::unique_ptr<Cell[]> cells_;
+    std::unique_ptr<char[]> slots_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) size_t tail_ = 0;
+    std::atomic<size_t> consumed_{0};
+};
+
+} // namespace detail
+
+/**
+ * @brief Sequencing lanes of ConcurrentAuditChain, highest priority first
+ */
+enum class Lane : uint8_t {
+    Critical = 0,   ///< Severity::Critical
+    Error = 1,      ///< Severity::Error
+    Bulk = 2        ///< Everything below Error
+};
+
+constexpr size_t lane_count = 3;
+
+inline Lane lane_of(Severity severity) {
+    if (severity >= Severity::Critical) return Lane::Critical;
+    if (severity == Severity::Error) return Lane::Error;
+    return Lane::Bulk;
+}
+
+/**
+ * @brief Per-lane counters; latency runs from enqueue until the entry has
+ *        been chained, handled, and (for priority lanes) flushed
+ */
+struct LaneMetrics {
+    uint64_t chained = 0;
+    uint64_t rejected = 0;              ///< Refused by try_log() because the lane was full
+    uint64_t total_latency_ns = 0;
+    uint64_t max_latency_ns = 0;
+    size_t depth = 0;                   ///< Approximate events waiting
+
+    uint64_t mean_latency_ns() const { return chained ? total_latency_ns / chained : 0; }
+};
+
+/**
+ * @brief Thread-safe audit chain with lock-free producers and one sequencer
+ *
+ * Any number of threads may call try_log()/log() concurrently. Events are
+ * timestamped on the producer thread, then chained by a background
+ * sequencer that owns the underlying AuditChain.
+ *
+ * Each severity tier has its own queue (see Lane). The sequencer always
+ * drains Critical before Error before Bulk, so a safety record waits for at
+ * most the one bulk entry being chained, never for a saturated telemetry
+ * queue, and the sink is flushed right after each priority entry. Within a
+ * lane events keep their enqueue order; across lanes, a priority entry may
+ * be chained ahead of bulk entries enqueued before it, so timestamps along
+ * the chain are not strictly ordered.
+ */
+class ConcurrentAuditChain {
+public:
+    /// Receives each chained JSON entry on the sequencer thread
+    using EntryHandler = std::function<void(std::string_view entry)>;
+
+    struct Options {
+        size_t queue_capacity = 4096;           ///< Bulk lane; rounded up to a power of two
+        size_t priority_queue_capacity = 256;   ///< Critical and Error lanes, each
+        size_t inline_message_size = 256;       ///< Larger messages spill to the heap
+        std::chrono::microseconds idle_wait{100};   ///< Sequencer sleep when idle
+        ClockSource clock;                      ///< Producer-side clock (must be thread-safe)
+        std::shared_ptr<LogSink> sink;          ///< Receives entries on the sequencer thread
+        uint64_t checkpoint_interval = 0;       ///< See AuditChain::set_checkpoint_interval()
+        bool flush_priority = true;             ///< Flush the sink after each Critical/Error entry
+    };
+
+    explicit ConcurrentAuditChain(const std::string& device_id,
+                                  EntryHandler handler = nullptr)
+        : ConcurrentAuditChain(device_id, std::move(handler), Options()) {}
+
+    ConcurrentAuditChain(const std::string& device_id, EntryHandler handler, Options options)
+        : chain_(device_id),
+          handler_(std::move(handler)),
+          options_(std::move(options)),
+          lanes_{{{options_.priority_queue_capacity, options_.inline_message_size},
+                  {options_.priority_queue_capacity, options_.inline_message_size},
+                  {options_.queue_capacity, options_.inline_message_size}}} {
+        chain_.set_sink(options_.sink);
+        chain_.set_checkpoint_interval(options_.checkpoint_interval);
+#if DTS_ENABLE_METRICS
+        depth_gauge_ = metrics::GaugeHandle("queue_depth", device_id,
+                                            [this] { return static_cast<double>(queue_depth()); });
+#endif
+        sequencer_ = std::thread([this] { run(); });
+    }
+
+    ~ConcurrentAuditChain() {
+        stop();
+    }
+
+    ConcurrentAuditChain(const ConcurrentAuditChain&) = delete;
+    ConcurrentAuditChain& operator=(const ConcurrentAuditChain&) = delete;
+
+    /**
+     * @brief Enqueue an event without blocking
+     * @return false if the event's lane is full or its message is reserved
+     *         (the event is not logged)
+     */
+    bool try_log(std::string_view message,
+                 UserID user_id = UserID::System,
+                 Severity severity = Severity::Info) {
+        if (AuditChain::is_reserved(message, user_id)) return false;
+        LaneState& lane = lane_state(severity);
+        if (!lane.ring.try_push(now_ms(), message, user_id, severity, nullptr, steady_ns())) {
+            lane.rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        enqueued_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Enqueue an event, yielding while its lane is full
+     * @return false if the message is reserved (the event is not logged)
+     */
+    bool log(std::string_view message,
+             UserID user_id = UserID::System,
+             Severity severity = Severity::Info) {
+        if (AuditChain::is_reserved(message, user_id)) return false;
+        LaneState& lane = lane_state(severity);
+        const int64_t timestamp_ms = now_ms();
+        const int64_t enqueued_ns = steady_ns();
+        while (!lane.ring.try_push(timestamp_ms, message, user_id, severity, nullptr,
+                                   enqueued_ns)) {
+            std::this_thread::yield();
+        }
+        enqueued_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Wait until every event enqueued so far has been chained and handled
+     */
+    void flush() {
+        const uint64_t target = enqueued_.load(std::memory_order_acquire);
+        while (sequenced_.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    /**
+     * @brief Drain the queue and stop the sequencer (called by the destructor)
+     */
+    void stop() {
+        if (!sequencer_.joinable()) return;
+        running_.store(false, std::memory_order_release);
+        sequencer_.join();
+    }
+
+    /**
+     * @brief Events chained so far (checkpoint entries not included)
+     */
+    uint64_t get_sequence_number() const {
+        return sequenced_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Events refused by try_log() because a lane was full
+     */
+    uint64_t rejected_count() const {
+        uint64_t total = 0;
+        for (const auto& lane : lanes_) total += lane.rejected.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /**
+     * @brief Approximate queue depth over all lanes
+     */
+    size_t queue_depth() const {
+        size_t total = 0;
+        for (const auto& lane : lanes_) total += lane.ring.size();
+        return total;
+    }
+
+    /**
+     * @brief Counters and enqueue-to-durable latency of one lane
+     */
+    LaneMetrics lane_metrics(Lane lane) const {
+        const LaneState& state = lanes_[static_cast<size_t>(lane)];
+        LaneMetrics metrics;
+        metrics.chained = state.chained.load(std::memory_order_relaxed);
+        metrics.rejected = state.rejected.load(std::memory_order_relaxed);
+        metrics.total_latency_ns = state.total_latency_ns.load(std::memory_order_relaxed);
+        metrics.max_latency_ns = state.max_latency_ns.load(std::memory_order_relaxed);
+        metrics.depth = state.ring.size();
+        return metrics;
+    }
+
+    /**
+     * @brief Current chain hash; call after flush() for a stable value
+     */
+    std::string get_chain_hash() const {
+        return chain_.get_chain_hash();
+    }
+
+private:
+    struct LaneState {
+        LaneState(size_t capacity, size_t slot_size) : ring(capacity, slot_size) {}
+
+        detail::EventRing ring;
+        std::atomic<uint64_t> rejected{0};
+        std::atomic<uint64_t> chained{0};           ///< Written by the sequencer only
+        std::atomic<uint64_t> total_latency_ns{0};
+        std::atomic<uint64_t> max_latency_ns{0};
+    };
+
+    AuditChain chain_;
+    EntryHandler handler_;
+    Options options_;
+    std::array<LaneState, lane_count> lanes_;
+    std::thread sequencer_;
+    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> sequenced_{0};
+    metrics::GaugeHandle depth_gauge_;      ///< Published while metrics are compiled in
+
+    LaneState& lane_state(Severity severity) {
+        return lanes_[static_cast<size_t>(lane_of(severity))];
+    }
+
+    int64_t now_ms() const {
+        return to_epoch_ms(options_.clock ? options_.clock() : std::chrono::system_clock::now());
+    }
+
+    static int64_t steady_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Chain the oldest event of the highest-priority non-empty lane
+    bool sequence_one(std::string& entry, std::string& checkpoint) {
+        for (size_t index = 0; index < lane_count; ++index) {
+            LaneState& lane = lanes_[index];
+            detail::EventRing::Event event;
+            std::string_view message;
+            if (!lane.ring.peek(event, message)) continue;
+
+            chain_.log_at(entry, event.timestamp_ms, message, event.user_id, event.severity);
+            lane.ring.pop();
+            if (handler_) {
+                handler_(entry);
+                if (chain_.take_checkpoint(checkpoint)) handler_(checkpoint);
+            }
+            if (index != static_cast<size_t>(Lane::Bulk) && options_.flush_priority &&
+                options_.sink) {
+                options_.sink->flush();
+            }
+
+            const uint64_t latency = static_cast<uint64_t>(steady_ns() - event.enqueued_ns);
+            lane.chained.store(lane.chained.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+            lane.total_latency_ns.store(
+                lane.total_latency_ns.load(std::memory_order_relaxed) + latency,
+                std::memory_order_relaxed);
+            if (latency > lane.max_latency_ns.load(std::memory_order_relaxed)) {
+                lane.max_latency_ns.store(latency, std::memory_order_relaxed);
+            }
+            sequenced_.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    void run() {
+        std::string entry;
+        std::string checkpoint;
+        unsigned idle_spins = 0;
+        for (;;) {
+            if (sequence_one(entry, checkpoint)) {
+                idle_spins = 0;
+                continue;
+            }
+            if (!running_.load(std::memory_order_acquire) &&
+                sequenced_.load(std::memory_order_relaxed) ==
+                    enqueued_.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (++idle_spins < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(options_.idle_wait);
+            }
+        }
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_CONCURRENT_AUDIT_CHAIN_HPP
@@ -0,0 +1,777 @@
+/**
+ * @file ed25519.hpp
+ * @brief Ed25519 signatures (RFC 8032) with batch verification
+ *
+ * Portable, header-only and dependency-free like the rest of DTS. Field
+ * elements use five 51-bit limbs and 64x64->128-bit products (a portable
+ * fallback is used where the compiler has no 128-bit integer, or when
+ * DTS_ED25519_NO_INT128 is defined); scalars modulo the group order are
+ * reduced byte-wise.
+ *
+ * Signing runs in constant time with respect to the key: a fixed sequence
+ * of 4-bit signed windows over a small table of base-point multiples, with
+ * table lookups by masking. Verification touches only public data and
+ * runs in variable time.
+ *
+ * Both verify() and verify_batch() use the cofactored equation
+ * [8][S]B = [8]R + [8][k]A and reject non-canonical S and point encodings,
+ * so a signature is accepted by one if and only if it is accepted by the
+ * other. verify_batch() checks n signatures with one random linear
+ * combination evaluated as a single multi-scalar multiplication: the
+ * doublings are shared, the 128-bit coefficients halve the additions for R
+ * and signatures under the same key share one public-key term. The
+ * coefficients are derived from a SHA-512 transcript of the whole batch.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_ED25519_HPP
+#define DTS_ED25519_HPP
+
+#include "hmac.hpp"
+#include "sha512.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace dts {
+namespace ed25519 {
+
+using Seed = std::array<uint8_t, 32>;        ///< Private key (RFC 8032 "secret key")
+using PublicKey = std::array<uint8_t, 32>;
+using Signature = std::array<uint8_t, 64>;   ///< R || S
+
+namespace detail {
+
+#if defined(__SIZEOF_INT128__) && !defined(DTS_ED25519_NO_INT128)
+__extension__ typedef unsigned __int128 Wide;
+
+inline Wide wide_mul(uint64_t a, uint64_t b) { return static_cast<Wide>(a) * b; }
+inline void wide_add(Wide& acc, Wide value) { acc += value; }
+inline void wide_add(Wide& acc, uint64_t value) { acc += value; }
+inline uint64_t wide_low(Wide value) { return static_cast<uint64_t>(value); }
+inline uint64_t wide_shr51(Wide value) { return static_cast<uint64_t>(value >> 51); }
+#else
+struct Wide {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+};
+
+inline Wide wide_mul(uint64_t a, uint64_t b) {
+    const uint64_t a0 = a & 0xffffffffu, a1 = a >> 32;
+    const uint64_t b0 = b & 0xffffffffu, b1 = b >> 32;
+    const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffu) + (p10 & 0xffffffffu);
+    return {(mid << 32) | (p00 & 0xffffffffu), p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32)};
+}
+inline void wide_add(Wide& acc, Wide value) {
+    acc.lo += value.lo;
+    acc.hi += value.hi + (acc.lo < value.lo);
+}
+inline void wide_add(Wide& acc, uint64_t value) {
+    acc.lo += value;
+    acc.hi += acc.lo < value;
+}
+inline uint64_t wide_low(Wide value) { return value.lo; }
+inline uint64_t wide_shr51(Wide value) { return (value.lo >> 51) | (value.hi << 13); }
+#endif
+
+static constexpr uint64_t mask51 = (static_cast<uint64_t>(1) << 51) - 1;
+
+/// Element of GF(2^255 - 19); limbs are kept below about 2^51 after every operation
+struct Fe {
+    uint64_t v[5];
+};
+
+inline void fe_carry(Fe& h) {
+    uint64_t c;
+    c = h.v[0] >> 51; h.v[0] &= mask51; h.v[1] += c;
+    c = h.v[1] >> 51; h.v[1] &= mask51; h.v[2] += c;
+    c = h.v[2] >> 51; h.v[2] &= mask51; h.v[3] += c;
+    c = h.v[3] >> 51; h.v[3] &= mask51; h.v[4] += c;
+    c = h.v[4] >> 51; h.v[4] &= mask51; h.v[0] += 19 * c;
+}
+
+inline Fe fe_constant(uint64_t value) {
+    return Fe{{value, 0, 0, 0, 0}};
+}
+
+inline Fe fe_add(const Fe& f, const Fe& g) {
+    Fe h;
+    for (int i = 0; i < 5; ++i) h.v[i] = f.v[i] + g.v[i];
+    fe_carry(h);
+    return h;
+}
+
+inline Fe fe_sub(const Fe& f, const Fe& g) {
+    // Add 4p first so that no limb goes negative
+    Fe h;
+    h.v[0] = f.v[0] + 0x1FFFFFFFFFFFB4ULL - g.v[0];
+    for (int i = 1; i < 5; ++i) h.v[i] = f.v[i] + 0x1FFFFFFFFFFFFCULL - g.v[i];
+    fe_carry(h);
+    return h;
+}
+
+inline Fe fe_neg(const Fe& f) {
+    return fe_sub(fe_constant(0), f);
+}
+
+inline Fe fe_reduce_wide(Wide r0, Wide r1, Wide r2, Wide r3, Wide r4) {
+    Fe h;
+    wide_add(r1, wide_shr51(r0));
+    h.v[0] = wide_low(r0) & mask51;
+    wide_add(r2, wide_shr51(r1));
+    h.v[1] = wide_low(r1) & mask51;
+    wide_add(r3, wide_shr51(r2));
+    h.v[2] = wide_low(r2) & mask51;
+    wide_add(r4, wide_shr51(r3));
+    h.v[3] = wide_low(r3) & mask51;
+    h.v[0] += 19 * wide_shr51(r4);
+    h.v[4] = wide_low(r4) & mask51;
+    h.v[1] += h.v[0] >> 51;
+    h.v[0] &= mask51;
+    return h;
+}
+
+inline Fe fe_mul(const Fe& f, const Fe& g) {
+    const uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+    const uint64_t g0 = g.v[0], g1 = g.v[1], g2 = g.v[2], g3 = g.v[3], g4 = g.v[4];
+    const uint64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+    Wide r0 = wide_mul(f0, g0), r1 = wide_mul(f0, g1), r2 = wide_mul(f0, g2);
+    Wide r3 = wide_mul(f0, g3), r4 = wide_mul(f0, g4);
+    wide_add(r0, wide_mul(f1, g4_19)); wide_add(r1, wide_mul(f1, g0));
+    wide_add(r2, wide_mul(f1, g1));    wide_add(r3, wide_mul(f1, g2));
+    wide_add(r4, wide_mul(f1, g3));
+    wide_add(r0, wide_mul(f2, g3_19)); wide_add(r1, wide_mul(f2, g4_19));
+    wide_add(r2, wide_mul(f2, g0));    wide_add(r3, wide_mul(f2, g1));
+    wide_add(r4, wide_mul(f2, g2));
+    wide_add(r0, wide_mul(f3, g2_19)); wide_add(r1, wide_mul(f3, g3_19));
+    wide_add(r2, wide_mul(f3, g4_19)); wide_add(r3, wide_mul(f3, g0));
+    wide_add(r4, wide_mul(f3, g1));
+    wide_add(r0, wide_mul(f4, g1_19)); wide_add(r1, wide_mul(f4, g2_19));
+    wide_add(r2, wide_mul(f4, g3_19)); wide_add(r3, wide_mul(f4, g4_19));
+    wide_add(r4, wide_mul(f4, g0));
+    return fe_reduce_wide(r0, r1, r2, r3, r4);
+}
+
+inline Fe fe_sq(const Fe& f) {
+    const uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+    const uint64_t d0 = 2 * f0, d1 = 2 * f1, d2 = 2 * f2, d3 = 2 * f3;
+    const uint64_t f3_19 = 19 * f3, f4_19 = 19 * f4;
+
+    Wide r0 = wide_mul(f0, f0), r1 = wide_mul(d0, f1), r2 = wide_mul(d0, f2);
+    Wide r3 = wide_mul(d0, f3), r4 = wide_mul(d0, f4);
+    wide_add(r0, wide_mul(d1, f4_19)); wide_add(r0, wide_mul(d2, f3_19));
+    wide_add(r1, wide_mul(d2, f4_19)); wide_add(r1, wide_mul(f3, f3_19));
+    wide_add(r2, wide_mul(f1, f1));    wide_add(r2, wide_mul(d3, f4_19));
+    wide_add(r3, wide_mul(d1, f2));    wide_add(r3, wide_mul(f4, f4_19));
+    wide_add(r4, wide_mul(d1, f3));    wide_add(r4, wide_mul(f2, f2));
+    return fe_reduce_wide(r0, r1, r2, r3, r4);
+}
+
+inline Fe fe_sq_n(Fe f, int n) {
+    while (n-- > 0) f = fe_sq(f);
+    return f;
+}
+
+inline uint64_t load_le64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | p[i];
+    return value;
+}
+
+/// Decode 255 bits little-endian; the top bit of @p s is ignored
+inline Fe fe_frombytes(const uint8_t* s) {
+    Fe h;
+    h.v[0] = load_le64(s) & mask51;
+    h.v[1] = (load_le64(s + 6) >> 3) & mask51;
+    h.v[2] = (load_le64(s + 12) >> 6) & mask51;
+    h.v[3] = (load_le64(s + 19) >> 1) & mask51;
+    h.v[4] = (load_le64(s + 24) >> 12) & mask51;
+    return h;
+}
+
+/// Canonical (fully reduced) little-endian encoding
+inline void fe_tobytes(uint8_t* s, const Fe& f) {
+    Fe t = f;
+    fe_carry(t);
+    fe_carry(t);
+    // t < 2^255 now; adding 19 carries out of bit 255 exactly when t >= p
+    t.v[0] += 19;
+    fe_carry(t);
+    // Subtract the 19 again by adding 2^255 - 19 and dropping bit 255
+    t.v[0] += (static_cast<uint64_t>(1) << 51) - 19;
+    for (int i = 1; i < 5; ++i) t.v[i] += (static_cast<uint64_t>(1) << 51) - 1;
+    t.v[1] += t.v[0] >> 51; t.v[0] &= mask51;
+    t.v[2] += t.v[1] >> 51; t.v[1] &= mask51;
+    t.v[3] += t.v[2] >> 51; t.v[2] &= mask51;
+    t.v[4] += t.v[3] >> 51; t.v[3] &= mask51;
+    t.v[4] &= mask51;
+
+    const uint64_t words[4] = {
+        t.v[0] | (t.v[1] << 51),
+        (t.v[1] >> 13) | (t.v[2] << 38),
+        (t.v[2] >> 26) | (t.v[3] << 25),
+        (t.v[3] >> 39) | (t.v[4] << 12),
+    };
+    for (int w = 0; w < 4; ++w) {
+        for (int b = 0; b < 8; ++b) s[w * 8 + b] = static_cast<uint8_t>(words[w] >> (8 * b));
+    }
+}
+
+inline bool fe_equal(const Fe& f, const Fe& g) {
+    uint8_t a[32], b[32];
+    fe_tobytes(a, f);
+    fe_tobytes(b, g);
+    return std::memcmp(a, b, 32) == 0;
+}
+
+inline bool fe_is_zero(const Fe& f) {
+    return fe_equal(f, fe_constant(0));
+}
+
+inline int fe_is_negative(const Fe& f) {
+    uint8_t s[32];
+    fe_tobytes(s, f);
+    return s[0] & 1;
+}
+
+/// f = g where @p mask is all ones, unchanged where it is 0
+inline void fe_cmov(Fe& f, const Fe& g, uint64_t mask) {
+    for (int i = 0; i < 5; ++i) f.v[i] ^= mask & (f.v[i] ^ g.v[i]);
+}
+
+/// z^(2^250 - 1), the common prefix of inversion and square roots; @p z11 receives z^11
+inline Fe fe_pow2_250_1(const Fe& z, Fe& z11) {
+    const Fe z2 = fe_sq(z);
+    const Fe z9 = fe_mul(fe_sq_n(z2, 2), z);
+    z11 = fe_mul(z9, z2);
+    const Fe z_5_0 = fe_mul(fe_sq(z11), z9);                  // 2^5 - 1
+    const Fe z_10_0 = fe_mul(fe_sq_n(z_5_0, 5), z_5_0);       // 2^10 - 1
+    const Fe z_20_0 = fe_mul(fe_sq_n(z_10_0, 10), z_10_0);    // 2^20 - 1
+    const Fe z_40_0 = fe_mul(fe_sq_n(z_20_0, 20), z_20_0);    // 2^40 - 1
+    const Fe z_50_0 = fe_mul(fe_sq_n(z_40_0, 10), z_10_0);    // 2^50 - 1
+    const Fe z_100_0 = fe_mul(fe_sq_n(z_50_0, 50), z_50_0);   // 2^100 - 1
+    const Fe z_200_0 = fe_mul(fe_sq_n(z_100_0, 100), z_100_0);  // 2^200 - 1
+    return fe_mul(fe_sq_n(z_200_0, 50), z_50_0);              // 2^250 - 1
+}
+
+/// z^(p - 2) = 1/z
+inline Fe fe_invert(const Fe& z) {
+    Fe z11;
+    const Fe t = fe_pow2_250_1(z, z11);
+    return fe_mul(fe_sq_n(t, 5), z11);
+}
+
+/// z^((p - 5) / 8), for square roots
+inline Fe fe_pow22523(const Fe& z) {
+    Fe z11;
+    const Fe t = fe_pow2_250_1(z, z11);
+    return fe_mul(fe_sq_n(t, 2), z);
+}
+
+/// Point on edwards25519 in extended coordinates: x = X/Z, y = Y/Z, xy = T/Z
+struct Point {
+    Fe X, Y, Z, T;
+};
+
+inline Point point_identity() {
+    return Point{fe_constant(0), fe_constant(1), fe_constant(1), fe_constant(0)};
+}
+
+struct Constants {
+    Fe d;
+    Fe d2;
+    Fe sqrtm1;
+    Point base;
+    Point base_multiples[8];    ///< 1B .. 8B for constant-time signing
+};
+
+inline const Constants& constants();
+
+/// Unified addition (add-2008-hwcd-3) given 2d; complete on edwards25519
+inline Point point_add(const Point& p, const Point& q, const Fe& d2) {
+    const Fe a = fe_mul(fe_sub(p.Y, p.X), fe_sub(q.Y, q.X));
+    const Fe b = fe_mul(fe_add(p.Y, p.X), fe_add(q.Y, q.X));
+    const Fe c = fe_mul(fe_mul(p.T, q.T), d2);
+    Fe zz = fe_mul(p.Z, q.Z);
+    zz = fe_add(zz, zz);
+    const Fe e = fe_sub(b, a), f = fe_sub(zz, c), g = fe_add(zz, c), h = fe_add(b, a);
+    return Point{fe_mul(e, f), fe_mul(g, h), fe_mul(f, g), fe_mul(e, h)};
+}
+
+inline Point point_add(const Point& p, const Point& q) {
+    return point_add(p, q, constants().d2);
+}
+
+/// Doubling (dbl-2008-hwcd with a = -1)
+inline Point point_double(const Point& p) {
+    const Fe a = fe_sq(p.X);
+    const Fe b = fe_sq(p.Y);
+    Fe c = fe_sq(p.Z);
+    c = fe_add(c, c);
+    const Fe e = fe_sub(fe_sub(fe_sq(fe_add(p.X, p.Y)), a), b);
+    const Fe g = fe_sub(b, a);
+    const Fe f = fe_sub(g, c);
+    const Fe h = fe_neg(fe_add(a, b));
+    return Point{fe_mul(e, f), fe_mul(g, h), fe_mul(f, g), fe_mul(e, h)};
+}
+
+inline Point point_neg(const Point& p) {
+    return Point{fe_neg(p.X), p.Y, p.Z, fe_neg(p.T)};
+}
+
+inline bool point_is_identity(const Point& p) {
+    return fe_is_zero(p.X) && fe_equal(p.Y, p.Z);
+}
+
+inline void point_encode(uint8_t* out, const Point& p) {
+    const Fe z_inv = fe_invert(p.Z);
+    const Fe x = fe_mul(p.X, z_inv);
+    const Fe y = fe_mul(p.Y, z_inv);
+    fe_tobytes(out, y);
+    out[31] = static_cast<uint8_t>(out[31] | (fe_is_negative(x) << 7));
+}
+
+/**
+ * @brief Decode a point, rejecting non-canonical encodings (variable time)
+ */
+inline bool point_decode(Point& p, const uint8_t* in) {
+    const Fe y = fe_frombytes(in);
+    uint8_t canonical[32];
+    fe_tobytes(canonical, y);
+    canonical[31] = static_cast<uint8_t>(canonical[31] | (in[31] & 0x80));
+    if (std::memcmp(canonical, in, 32) != 0) return false;
+
+    // x^2 = u / v with u = y^2 - 1, v = d y^2 + 1
+    const Fe y2 = fe_sq(y);
+    const Fe u = fe_sub(y2, fe_constant(1));
+    const Fe v = fe_add(fe_mul(y2, constants().d), fe_constant(1));
+    const Fe v3 = fe_mul(fe_sq(v), v);
+    Fe x = fe_mul(fe_mul(fe_pow22523(fe_mul(u, fe_mul(fe_sq(v3), v))), v3), u);
+    const Fe vxx = fe_mul(v, fe_sq(x));
+    if (!fe_equal(vxx, u)) {
+        if (!fe_equal(vxx, fe_neg(u))) return false;
+        x = fe_mul(x, constants().sqrtm1);
+    }
+    const int sign = in[31] >> 7;
+    if (sign && fe_is_zero(x)) return false;
+    if (fe_is_negative(x) != sign) x = fe_neg(x);
+    p = Point{x, y, fe_constant(1), fe_mul(x, y)};
+    return true;
+}
+
+inline Constants make_constants() {
+    static constexpr uint8_t d_bytes[32] = {
+        0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
+        0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52};
+    static constexpr uint8_t sqrtm1_bytes[32] = {
+        0xb0, 0xa0, 0x0e, 0x4a, 0x27, 0x1b, 0xee, 0xc4, 0x78, 0xe4, 0x2f, 0xad, 0x06, 0x18, 0x43, 0x2f,
+        0xa7, 0xd7, 0xfb, 0x3d, 0x99, 0x00, 0x4d, 0x2b, 0x0b, 0xdf, 0xc1, 0x4f, 0x80, 0x24, 0x83, 0x2b};
+    static constexpr uint8_t base_x_bytes[32] = {
+        0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9, 0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69,
+        0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0, 0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21};
+    static constexpr uint8_t base_y_bytes[32] = {
+        0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+        0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66};
+
+    Constants c;
+    c.d = fe_frombytes(d_bytes);
+    c.d2 = fe_add(c.d, c.d);
+    c.sqrtm1 = fe_frombytes(sqrtm1_bytes);
+    const Fe x = fe_frombytes(base_x_bytes);
+    const Fe y = fe_frombytes(base_y_bytes);
+    c.base = Point{x, y, fe_constant(1), fe_mul(x, y)};
+    return c;
+}
+
+inline const Constants& constants() {
+    static const Constants table = [] {
+        Constants c = make_constants();
+        c.base_multiples[0] = c.base;
+        for (int i = 1; i < 8; ++i) {
+            c.base_multiples[i] = point_add(c.base_multiples[i - 1], c.base, c.d2);
+        }
+        return c;
+    }();
+    return table;
+}
+
+// ---- Scalars modulo the group order L = 2^252 + 27742317777372353535851937790883648493
+
+static constexpr int64_t group_order[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10};
+
+/**
+ * @brief Reduce 64 signed byte-weighted limbs modulo L into @p out
+ *
+ * Each limb may hold a sum of byte products (as left by sc_muladd()).
+ * Relies on arithmetic right shifts of negative values, as every
+ * supported compiler provides.
+ */
+inline void sc_reduce_limbs(uint8_t* out, int64_t* x) {
+    for (int i = 63; i >= 32; --i) {
+        int64_t carry = 0;
+        int j;
+        for (j = i - 32; j < i - 12; ++j) {
+            x[j] += carry - 16 * x[i] * group_order[j - (i - 32)];
+            carry = (x[j] + 128) >> 8;
+            x[j] -= carry * 256;
+        }
+        x[j] += carry;
+        x[i] = 0;
+    }
+    int64_t carry = 0;
+    for (int j = 0; j < 32; ++j) {
+        x[j] += carry - (x[31] >> 4) * group_order[j];
+        carry = x[j] >> 8;
+        x[j] &= 255;
+    }
+    for (int j = 0; j < 32; ++j) x[j] -= carry * group_order[j];
+    for (int i = 0; i < 32; ++i) {
+        x[i + 1] += x[i] >> 8;
+        out[i] = static_cast<uint8_t>(x[i] & 255);
+    }
+}
+
+/// out = in mod L for a 64-byte little-endian value (a SHA-512 digest)
+inline void sc_reduce(uint8_t* out, const uint8_t* in) {
+    int64_t x[64];
+    for (int i = 0; i < 64; ++i) x[i] = in[i];
+    sc_reduce_limbs(out, x);
+}
+
+/// out = (a * b + c) mod L; @p out may alias @p c
+inline void sc_muladd(uint8_t* out, const uint8_t* a, const uint8_t* b, const uint8_t* c) {
+    int64_t x[64] = {0};
+    for (int i = 0; i < 32; ++i) x[i] = c[i];
+    for (int i = 0; i < 32; ++i) {
+        for (int j = 0; j < 32; ++j) x[i + j] += static_cast<int64_t>(a[i]) * b[j];
+    }
+    sc_reduce_limbs(out, x);
+}
+
+/// Whether @p s < L
+inline bool sc_is_canonical(const uint8_t* s) {
+    for (int i = 31; i >= 0; --i) {
+        if (s[i] < group_order[i]) return true;
+        if (s[i] > group_order[i]) return false;
+    }
+    return false;
+}
+
+/// Signed 4-bit digits e[0..63] in [-8, 8] with a = sum e[i] 16^i; needs a < 2^255
+inline void sc_signed_digits(int8_t* e, const uint8_t* a) {
+    for (int i = 0; i < 32; ++i) {
+        e[2 * i] = static_cast<int8_t>(a[i] & 15);
+        e[2 * i + 1] = static_cast<int8_t>(a[i] >> 4);
+    }
+    int8_t carry = 0;
+    for (int i = 0; i < 63; ++i) {
+        e[i] = static_cast<int8_t>(e[i] + carry);
+        carry = static_cast<int8_t>((e[i] + 8) >> 4);
+        e[i] = static_cast<int8_t>(e[i] - carry * 16);
+    }
+    e[63] = static_cast<int8_t>(e[63] + carry);
+}
+
+inline uint64_t ct_equal_mask(uint8_t a, uint8_t b) {
+    const uint64_t x = static_cast<uint64_t>(a ^ b);
+    return static_cast<uint64_t>(0) - ((x - 1) >> 63);
+}
+
+inline void point_cmov(Point& p, const Point& q, uint64_t mask) {
+    fe_cmov(p.X, q.X, mask);
+    fe_cmov(p.Y, q.Y, mask);
+    fe_cmov(p.Z, q.Z, mask);
+    fe_cmov(p.T, q.T, mask);
+}
+
+/// [digit]B for a digit in [-8, 8], reading every table entry
+inline Point select_base_multiple(int8_t digit) {
+    const uint8_t negative = static_cast<uint8_t>(static_cast<uint8_t>(digit) >> 7);
+    const uint8_t magnitude = static_cast<uint8_t>(
+        (static_cast<uint8_t>(digit) ^ static_cast<uint8_t>(0 - negative)) + negative);
+    Point p = point_identity();
+    for (uint8_t k = 1; k <= 8; ++k) {
+        point_cmov(p, constants().base_multiples[k - 1], ct_equal_mask(magnitude, k));
+    }
+    point_cmov(p, point_neg(p), static_cast<uint64_t>(0) - negative);
+    return p;
+}
+
+/// [a]B in constant time; @p a < 2^255
+inline Point scalarmult_base(const uint8_t* a) {
+    int8_t e[64];
+    sc_signed_digits(e, a);
+    Point r = point_identity();
+    for (int i = 63; i >= 0; --i) {
+        r = point_double(point_double(point_double(point_double(r))));
+        r = point_add(r, select_base_multiple(e[i]));
+    }
+    dts::detail::secure_wipe(e, sizeof(e));
+    return r;
+}
+
+/// One term of a multi-scalar multiplication
+struct Term {
+    uint8_t scalar[32];     ///< Little-endian, < 2^255
+    Point point;
+};
+
+/**
+ * @brief sum [scalar_i] point_i in variable time (Straus, signed 4-bit windows)
+ */
+inline Point multiscalar_mul(const std::vector<Term>& terms) {
+    struct Window {
+        int8_t digits[64];
+        Point multiples[8];     ///< 1P .. 8P
+    };
+    std::vector<Window> windows(terms.size());
+    int top = -1;
+    for (size_t t = 0; t < terms.size(); ++t) {
+        Window& w = windows[t];
+        sc_signed_digits(w.digits, terms[t].scalar);
+        for (int i = 63; i > top; --i) {
+            if (w.digits[i] != 0) {
+                top = i;
+                break;
+            }
+        }
+        w.multiples[0] = terms[t].point;
+        for (int i = 1; i < 8; ++i) w.multiples[i] = point_add(w.multiples[i - 1], terms[t].point);
+    }
+
+    Point r = point_identity();
+    for (int i = top; i >= 0; --i) {
+        if (i != top) r = point_double(point_double(point_double(point_double(r))));
+        for (const Window& w : windows) {
+            const int8_t digit = w.digits[i];
+            if (digit > 0) {
+                r = point_add(r, w.multiples[digit - 1]);
+            } else if (digit < 0) {
+                r = point_add(r, point_neg(w.multiples[-digit - 1]));
+            }
+        }
+    }
+    return r;
+}
+
+/// k = SHA-512(R || A || M) mod L
+inline void challenge(uint8_t* k, const uint8_t* r, const PublicKey& public_key,
+                      const uint8_t* message, size_t len) {
+    SHA512 hash;
+    hash.update(r, 32);
+    hash.update(public_key.data(), public_key.size());
+    hash.update(message, len);
+    const SHA512::Hash digest = hash.finalize();
+    sc_reduce(k, digest.data());
+}
+
+} // namespace detail
+
+/**
+ * @brief Expanded signing key: clamped scalar, nonce prefix and public key
+ *
+ * Key material is wiped on destruction.
+ */
+class SigningKey {
+public:
+    explicit SigningKey(const Seed& seed) {
+        SHA512::Hash expanded = SHA512::hash(seed.data(), seed.size());
+        expanded[0] &= 248;
+        expanded[31] &= 127;
+        expanded[31] |= 64;
+        std::memcpy(scalar_, expanded.data(), 32);
+        std::memcpy(prefix_, expanded.data() + 32, 32);
+        dts::detail::secure_wipe(expanded.data(), expanded.size());
+        detail::point_encode(public_key_.data(), detail::scalarmult_base(scalar_));
+    }
+
+    ~SigningKey() {
+        dts::detail::secure_wipe(scalar_, sizeof(scalar_));
+        dts::detail::secure_wipe(prefix_, sizeof(prefix_));
+    }
+
+    SigningKey(const SigningKey&) = default;
+    SigningKey& operator=(const SigningKey&) = default;
+
+    const PublicKey& public_key() const { return public_key_; }
+
+    Signature sign(const uint8_t* message, size_t len) const {
+        SHA512 nonce_hash;
+        nonce_hash.update(prefix_, sizeof(prefix_));
+        nonce_hash.update(message, len);
+        SHA512::Hash digest = nonce_hash.finalize();
+        uint8_t nonce[32];
+        detail::sc_reduce(nonce, digest.data());
+
+        Signature signature;
+        detail::point_encode(signature.data(), detail::scalarmult_base(nonce));
+        uint8_t k[32];
+        detail::challenge(k, signature.data(), public_key_, message, len);
+        detail::sc_muladd(signature.data() + 32, k, scalar_, nonce);
+
+        dts::detail::secure_wipe(digest.data(), digest.size());
+        dts::detail::secure_wipe(nonce, sizeof(nonce));
+        return signature;
+    }
+
+    Signature sign(std::string_view message) const {
+        return sign(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+    }
+
+private:
+    uint8_t scalar_[32];
+    uint8_t prefix_[32];
+    PublicKey public_key_;
+};
+
+/**
+ * @brief Public key of @p seed
+ */
+inline PublicKey public_key(const Seed& seed) {
+    return SigningKey(seed).public_key();
+}
+
+/**
+ * @brief Verify one signature
+ */
+inline bool verify(const PublicKey& public_key, const uint8_t* message, size_t len,
+                   const Signature& signature) {
+    const uint8_t* s = signature.data() + 32;
+    detail::Point a, r;
+    if (!detail::sc_is_canonical(s) || !detail::point_decode(a, public_key.data()) ||
+        !detail::point_decode(r, signature.data())) {
+        return false;
+    }
+    std::vector<detail::Term> terms(3);
+    std::memcpy(terms[0].scalar, s, 32);
+    terms[0].point = detail::constants().base;
+    detail::challenge(terms[1].scalar, signature.data(), public_key, message, len);
+    terms[1].point = detail::point_neg(a);
+    std::memset(terms[2].scalar, 0, 32);
+    terms[2].scalar[0] = 1;
+    terms[2].point = detail::point_neg(r);
+    const detail::Point sum = detail::multiscalar_mul(terms);
+    return detail::point_is_identity(
+        detail::point_double(detail::point_double(detail::point_double(sum))));
+}
+
+inline bool verify(const PublicKey& public_key, std::string_view message,
+                   const Signature& signature) {
+    return verify(public_key, reinterpret_cast<const uint8_t*>(message.data()), message.size(),
+                  signature);
+}
+
+/**
+ * @brief One input of verify_batch()
+ */
+struct SignedMessage {
+    PublicKey public_key{};
+    Signature signature{};
+    std::string_view message;   ///< Must stay valid for the call
+};
+
+/**
+ * @brief Verify @p count signatures at once
+ *
+ * Checks one random linear combination of the verification equations; if
+ * it fails, the signatures are checked one by one to find the culprit.
+ * Batches of 32 to 256 signatures get most of the speed-up.
+ * @return @p count if every signature verifies, otherwise the index of the
+ *         first one that does not
+ */
+inline size_t verify_batch(const SignedMessage* items, size_t count) {
+    auto first_invalid = [items, count]() {
+        for (size_t i = 0; i < count; ++i) {
+            if (!verify(items[i].public_key, items[i].message, items[i].signature)) return i;
+        }
+        return count;
+    };
+    if (count < 2) return first_invalid();
+
+    // Coefficients from a transcript of the whole batch
+    SHA512 transcript;
+    transcript.update(reinterpret_cast<const uint8_t*>("DTS-Ed25519-batch"), 17);
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t len[8];
+        for (int b = 0; b < 8; ++b) len[b] = static_cast<uint8_t>(items[i].message.size() >> (8 * b));
+        transcript.update(items[i].signature.data(), items[i].signature.size());
+        transcript.update(items[i].public_key.data(), items[i].public_key.size());
+        transcript.update(len, sizeof(len));
+        transcript.update(items[i].message);
+    }
+    const SHA512::Hash seed = transcript.finalize();
+
+    std::vector<detail::Term> terms(1);
+    std::vector<PublicKey> keys;            // distinct keys; terms[1 + k] belongs to keys[k]
+    uint8_t base_scalar[32] = {0};
+    terms.reserve(1 + count * 2);
+    for (size_t i = 0; i < count; ++i) {
+        const SignedMessage& item = items[i];
+        const uint8_t* s = item.signature.data() + 32;
+        detail::Point r;
+        if (!detail::sc_is_canonical(s) || !detail::point_decode(r, item.signature.data())) {
+            return first_invalid();
+        }
+        size_t key = 0;
+        while (key < keys.size() && keys[key] != item.public_key) ++key;
+        if (key == keys.size()) {
+            detail::Point a;
+            if (!detail::point_decode(a, item.public_key.data())) return first_invalid();
+            keys.push_back(item.public_key);
+            detail::Term term;
+            std::memset(term.scalar, 0, 32);
+            term.point = detail::point_neg(a);
+            terms.insert(terms.begin() + 1 + static_cast<std::ptrdiff_t>(key), term);
+        }
+
+        SHA512 coefficient_hash;
+        coefficient_hash.update(seed.data(), seed.size());
+        uint8_t index[8];
+        for (int b = 0; b < 8; ++b) index[b] = static_cast<uint8_t>(i >> (8 * b));
+        coefficient_hash.update(index, sizeof(index));
+        const SHA512::Hash coefficient_digest = coefficient_hash.finalize();
+        uint8_t z[32] = {0};
+        std::memcpy(z, coefficient_digest.data(), 16);    // 128-bit coefficient
+
+        // z (S B - R - k A): accumulate z S, z k, and the term z (-R)
+        detail::sc_muladd(base_scalar, z, s, base_scalar);
+        uint8_t k[32];
+        detail::challenge(k, item.signature.data(), item.public_key,
+                          reinterpret_cast<const uint8_t*>(item.message.data()),
+                          item.message.size());
+        uint8_t* key_scalar = terms[1 + key].scalar;
+        detail::sc_muladd(key_scalar, z, k, key_scalar);
+        detail::Term term;
+        std::memcpy(term.scalar, z, 32);
+        term.point = detail::point_neg(r);
+        terms.push_back(term);
+    }
+    std::memcpy(terms[0].scalar, base_scalar, 32);
+    terms[0].point = detail::constants().base;
+
+    const detail::Point sum = detail::multiscalar_mul(terms);
+    if (detail::point_is_identity(
+            detail::point_double(detail::point_double(detail::point_double(sum))))) {
+        return count;
+    }
+    return first_invalid();
+}
+
+inline size_t verify_batch(const std::vector<SignedMessage>& items) {
+    return verify_batch(items.data(), items.size());
+}
+
+} // namespace ed25519
+} // namespace dts
+
+#endif // DTS_ED25519_HPP
@@ -0,0 +1,153 @@
+/**
+ * @file entry_format.hpp
+ * @brief Byte format and chain hash of one audit entry
+ *
+ * The field layout, JSON rendering and hash chaining rules shared by every
+ * chain type. Nothing here allocates or needs more than <cstring>,
+ * <string_view> and SHA256, so fixed-capacity builds (see
+ * static_audit_chain.hpp) produce exactly the bytes AuditChain does.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_ENTRY_FORMAT_HPP
+#define DTS_ENTRY_FORMAT_HPP
+
+#include "format.hpp"
+#include "sha256.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace dts {
+
+/**
+ * @brief User identifier enum for audit logging
+ */
+enum class UserID : uint8_t {
+    System = 0,
+    Admin = 1,
+    Operator = 2,
+    Service = 3,
+    Unauthorized = 255
+};
+
+/**
+ * @brief Event severity levels
+ */
+enum class Severity : uint8_t {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3,
+    Critical = 4
+};
+
+namespace detail {
+
+/**
+ * @brief previous_hash of the first entry in a chain
+ */
+inline SHA256::Hash chain_init_hash() {
+    return SHA256::hash(std::string_view("DTS_INIT"));
+}
+
+/// Length of the JSON after the message: previous_hash and chain_hash fields
+static constexpr size_t json_entry_tail_length =
+    sizeof("\",\"previous_hash\":\"\",\"chain_hash\":\"\"}") - 1 + 128;
+
+/**
+ * @brief Exact length of a JSON entry
+ * @param device_id_len Length of the JSON-escaped device ID
+ */
+inline size_t json_entry_length(size_t device_id_len, size_t escaped_message_len,
+                                UserID user_id, Severity severity) {
+    return sizeof("{\"device_id\":\"\",\"timestamp\":\"\",\"user_id\":,\"severity\":,"
+                  "\"message\":\"\",\"previous_hash\":\"\",\"chain_hash\":\"\"}") - 1
+           + device_id_len + timestamp_length
+           + uint_length(static_cast<uint8_t>(user_id))
+           + uint_length(static_cast<uint8_t>(severity))
+           + escaped_message_len + 128;
+}
+
+/**
+ * @brief Render a JSON entry (json_entry_length() chars, no terminator)
+ * @param device_id Device identifier, already JSON-escaped (PooledString::json)
+ * @param timestamp timestamp_length chars
+ * @param message Raw message; escaped while writing
+ * @param escaped_message_len json_escaped_length() of @p message
+ * @param previous_hex, chain_hex 64 hex chars each
+ */
+inline void write_json_entry(char* out, std::string_view device_id, const char* timestamp,
+                             UserID user_id, Severity severity, std::string_view message,
+                             size_t escaped_message_len, const char* previous_hex,
+                             const char* chain_hex) {
+    CharWriter json{out};
+    json.literal("{\"device_id\":\"");
+    json.put(device_id.data(), device_id.size());
+    json.literal("\",\"timestamp\":\"");
+    json.put(timestamp, timestamp_length);
+    json.literal("\",\"user_id\":");
+    json.uint(static_cast<uint8_t>(user_id));
+    json.literal(",\"severity\":");
+    json.uint(static_cast<uint8_t>(severity));
+    json.literal(",\"message\":\"");
+    if (escaped_message_len == message.size()) {
+        json.put(message.data(), message.size());
+    } else {
+        json.escaped(message.data(), message.size());
+    }
+    json.literal("\",\"previous_hash\":\"");
+    json.put(previous_hex, 64);
+    json.literal("\",\"chain_hash\":\"");
+    json.put(chain_hex, 64);
+    json.literal("\"}");
+}
+
+/**
+ * @brief Chain hash of one entry
+ *
+ * SHA-256 over device_id|timestamp|user|severity|message|previous_hex, where
+ * @p prefix has already absorbed "device_id|".
+ */
+inline SHA256::Hash chain_hash(const SHA256& prefix, const char* timestamp,
+                               UserID user_id, Severity severity,
+                               std::string_view message, const char* previous_hex) {
+    char fields[timestamp_length + 9];
+    CharWriter head{fields};
+    head.put(timestamp, timestamp_length);
+    head.put('|');
+    head.uint(static_cast<uint8_t>(user_id));
+    head.put('|');
+    head.uint(static_cast<uint8_t>(severity));
+    head.put('|');
+    
+    char tail[65];
+    tail[0] = '|';
+    std::memcpy(tail + 1, previous_hex, 64);
+    
+    SHA256 ctx = prefix;
+    ctx.update(reinterpret_cast<const uint8_t*>(fields), static_cast<size_t>(head.pos - fields));
+    ctx.update(message);
+    ctx.update(reinterpret_cast<const uint8_t*>(tail), sizeof(tail));
+    return ctx.finalize();
+}
+
+/**
+ * @brief SHA-256 state that has absorbed "device_id|"
+ */
+inline SHA256 chain_prefix(std::string_view device_id) {
+    SHA256 prefix;
+    prefix.update(device_id);
+    prefix.update("|");
+    return prefix;
+}
+
+} // namespace detail
+
+} // namespace dts
+
+#endif // DTS_ENTRY_FORMAT_HPP
@@ -0,0 +1,228 @@
+/**
+ * @file entry_parser.hpp
+ * @brief Zero-copy parser for JSON audit entries
+ *
+ * Splits one JSON-lines entry into views of its fields without allocating.
+ * String values are returned still escaped; use unescape_json() to recover
+ * the raw text that was hashed.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_ENTRY_PARSER_HPP
+#define DTS_ENTRY_PARSER_HPP
+
+#include "format.hpp"
+#include "simd_scan.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace dts {
+
+/**
+ * @brief Fields of one JSON entry, as views into the entry text
+ */
+struct EntryView {
+    std::string_view device_id;     ///< Escaped as it appears in the entry
+    std::string_view timestamp;
+    uint64_t user_id = 0;
+    uint64_t severity = 0;
+    std::string_view message;       ///< Escaped as it appears in the entry
+    std::string_view previous_hash; ///< 64 hex chars
+    std::string_view chain_hash;    ///< 64 hex chars
+};
+
+namespace detail {
+
+inline const char* skip_json_space(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+    return p;
+}
+
+/**
+ * @brief Scan a JSON string starting at the opening quote
+ * @param value Contents between the quotes, still escaped
+ * @return Position after the closing quote, or nullptr if unterminated
+ */
+inline const char* scan_json_string(const char* p, const char* end, std::string_view& value) {
+    if (p >= end || *p != '"') return nullptr;
+    const char* start = ++p;
+    while ((p = find_quote_or_backslash(p, end)) < end) {
+        if (*p == '\\') {
+            p += 2;
+        } else {
+            value = std::string_view(start, static_cast<size_t>(p - start));
+            return p + 1;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace detail
+
+/**
+ * @brief Decode JSON string escapes in @p escaped, appending to @p out
+ *
+ * \\uXXXX escapes are emitted as UTF-8 (surrogate pairs are combined).
+ * @return false on a malformed escape
+ */
+inline bool unescape_json(std::string_view escaped, std::string& out) {
+    const char* p = escaped.data();
+    const char* end = p + escaped.size();
+    while (p < end) {
+        const char* run = p;
+        p = static_cast<const char*>(std::memchr(p, '\\', static_cast<size_t>(end - p)));
+        if (!p) p = end;
+        out.append(run, static_cast<size_t>(p - run));
+        if (p == end) break;
+        if (++p == end) return false;
+        const char c = *p++;
+        switch (c) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                auto hex4 = [&](uint32_t& value) {
+                    if (end - p < 4) return false;
+                    value = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        const int digit = detail::hex_value(p[i]);
+                        if (digit < 0) return false;
+                        value = (value << 4) | static_cast<uint32_t>(digit);
+                    }
+                    p += 4;
+                    return true;
+                };
+                uint32_t cp;
+                if (!hex4(cp)) return false;
+                if (cp >= 0xD800 && cp < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    p += 2;
+                    uint32_t low;
+                    if (!hex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                if (cp < 0x80) {
+                    out.push_back(static_cast<char>(cp));
+                } else if (cp < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                } else if (cp < 0x10000) {
+                    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Parse one JSON entry into views of its fields
+ *
+ * Accepts any key order and whitespace; unknown keys with string or integer
+ * values are skipped. No allocation.
+ * @return false if the entry is malformed or a required field is missing
+ */
+inline bool parse_entry(std::string_view entry, EntryView& view) {
+    const char* p = entry.data();
+    const char* end = p + entry.size();
+    unsigned seen = 0;
+
+    p = detail::skip_json_space(p, end);
+    if (p == end || *p++ != '{') return false;
+    for (;;) {
+        p = detail::skip_json_space(p, end);
+        std::string_view key;
+        p = detail::scan_json_string(p, end, key);
+        if (!p) return false;
+        p = detail::skip_json_space(p, end);
+        if (p == end || *p++ != ':') return false;
+        p = detail::skip_json_space(p, end);
+        if (p == end) return false;
+
+        if (*p == '"') {
+            std::string_view value;
+            p = detail::scan_json_string(p, end, value);
+            if (!p) return false;
+            if (key == "device_id") { view.device_id = value; seen |= 1; }
+            else if (key == "timestamp") { view.timestamp = value; seen |= 2; }
+            else if (key == "message") { view.message = value; seen |= 4; }
+            else if (key == "previous_hash") { view.previous_hash = value; seen |= 8; }
+            else if (key == "chain_hash") { view.chain_hash = value; seen |= 16; }
+        } else if (*p >= '0' && *p <= '9') {
+            uint64_t value = 0;
+            while (p < end && *p >= '0' && *p <= '9') {
+                value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+            }
+            if (key == "user_id") { view.user_id = value; seen |= 32; }
+            else if (key == "severity") { view.severity = value; seen |= 64; }
+        } else {
+            return false;
+        }
+
+        p = detail::skip_json_space(p, end);
+        if (p == end) return false;
+        if (*p == ',') { ++p; continue; }
+        if (*p == '}') break;
+        return false;
+    }
+    return seen == 127 && view.previous_hash.size() == 64 && view.chain_hash.size() == 64;
+}
+
+namespace detail {
+
+/**
+ * @brief Locate the previous_hash and chain_hash values of an entry
+ *
+ * Entries written by AuditChain end with both hashes at fixed offsets from
+ * the end of the line, so they are found without scanning; anything else
+ * falls back to parse_entry().
+ */
+inline bool entry_link_hashes(std::string_view entry, const char*& previous_hex,
+                              const char*& chain_hex) {
+    static constexpr char previous_key[] = "\"previous_hash\":\"";
+    static constexpr char chain_key[] = "\",\"chain_hash\":\"";
+    constexpr size_t previous_key_len = sizeof(previous_key) - 1;
+    constexpr size_t chain_key_len = sizeof(chain_key) - 1;
+    constexpr size_t tail_len = previous_key_len + 64 + chain_key_len + 64 + 2;
+
+    if (entry.size() > tail_len) {
+        const char* tail = entry.data() + entry.size() - tail_len;
+        if (tail[-1] == ',' && std::memcmp(tail, previous_key, previous_key_len) == 0 &&
+            std::memcmp(tail + previous_key_len + 64, chain_key, chain_key_len) == 0 &&
+            tail[tail_len - 2] == '"' && tail[tail_len - 1] == '}') {
+            previous_hex = tail + previous_key_len;
+            chain_hex = previous_hex + 64 + chain_key_len;
+            return true;
+        }
+    }
+    EntryView view;
+    if (!parse_entry(entry, view)) return false;
+    previous_hex = view.previous_hash.data();
+    chain_hex = view.chain_hash.data();
+    return true;
+}
+
+} // namespace detail
+
+} // namespace dts
+
+#endif // DTS_ENTRY_PARSER_HPP
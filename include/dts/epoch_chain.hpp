@@ -0,0 +1,550 @@
+/**
+ * @file epoch_chain.hpp
+ * @brief Chain construction across cores: per-epoch lanes sealed into a main chain
+ *
+ * A plain AuditChain hashes one entry at a time, because every chain_hash
+ * covers the one before it. EpochChain trades the single link for a
+ * two-level structure. Each log_epoch() call is an epoch. Its events are
+ * cut into contiguous lanes, and the lanes are hashed on separate threads.
+ * Lane n is an ordinary sub-chain whose first previous_hash is a seed
+ * derived from the main chain hash and n. A serial step then appends one
+ * seal entry to the main chain. The seal links to the previous seal and
+ * records the Merkle root over the lanes' last chain hashes.
+ *
+ * Entries keep the usual JSON format and stay in event order, with the
+ * seal last. Taking out, reordering or editing any entry breaks a lane
+ * link, a seed or the sealed root, so tampering is caught as in a single
+ * chain. Lanes cannot be moved between epochs, because their seeds cover
+ * the main chain hash. Use verify_epoch_buffer() or EpochVerifier to check
+ * such a log; ChainVerifier stops at the first lane boundary.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_EPOCH_CHAIN_HPP
+#define DTS_EPOCH_CHAIN_HPP
+
+#include "audit_chain.hpp"
+#include "chain_verifier.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dts {
+
+/**
+ * @brief Contents of an epoch seal entry
+ */
+struct EpochSeal {
+    uint64_t index = 0;             ///< 0-based epoch number since construction
+    uint64_t first_sequence = 0;    ///< Sequence of the epoch's first entry
+    uint64_t count = 0;             ///< Entries in the epoch, seal not included
+    uint64_t lanes = 0;             ///< Sub-chains the epoch was cut into
+    SHA256::Hash root{};            ///< Root over the lanes' last chain hashes
+};
+
+namespace detail {
+
+static constexpr char epoch_seal_prefix[] = "Epoch Seal | ";
+
+/// Longest seal message (four 20-digit counters)
+static constexpr size_t epoch_seal_message_capacity = 256;
+
+/**
+ * @brief previous_hash of the first entry of lane @p lane
+ * @param main_hash chain_hash the epoch's seal will link to
+ */
+inline SHA256::Hash epoch_seed(const SHA256::Hash& main_hash, uint64_t lane) {
+    char text[sizeof("DTS_EPOCH||") + 64 + 20];
+    CharWriter w{text};
+    w.literal("DTS_EPOCH|");
+    hex_encode(main_hash.data(), 32, w.pos);
+    w.pos += 64;
+    w.put('|');
+    w.uint(lane);
+    return SHA256::hash(reinterpret_cast<const uint8_t*>(text), static_cast<size_t>(w.pos - text));
+}
+
+/**
+ * @brief Render the message of a seal entry
+ * @return Message length
+ */
+inline size_t format_epoch_seal_message(const EpochSeal& seal, char* out) {
+    CharWriter w{out};
+    w.literal(epoch_seal_prefix);
+    w.literal("index=");
+    w.uint(seal.index);
+    w.literal(" | first=");
+    w.uint(seal.first_sequence);
+    w.literal(" | count=");
+    w.uint(seal.count);
+    w.literal(" | lanes=");
+    w.uint(seal.lanes);
+    w.literal(" | root=");
+    hex_encode(seal.root.data(), 32, w.pos);
+    w.pos += 64;
+    return static_cast<size_t>(w.pos - out);
+}
+
+} // namespace detail
+
+/**
+ * @brief Parse the message of a seal entry
+ * @return false if @p message is not a seal
+ */
+inline bool parse_epoch_seal_message(std::string_view message, EpochSeal& seal) {
+    std::string_view rest = message;
+    const std::string_view prefix(detail::epoch_seal_prefix);
+    if (rest.substr(0, prefix.size()) != prefix) return false;
+    rest.remove_prefix(prefix.size());
+
+    auto number = [&rest](std::string_view key, uint64_t& value) {
+        if (rest.substr(0, key.size()) != key) return false;
+        rest.remove_prefix(key.size());
+        size_t n = 0;
+        value = 0;
+        while (n < rest.size() && n < 20 && rest[n] >= '0' && rest[n] <= '9') {
+            value = value * 10 + static_cast<uint64_t>(rest[n++] - '0');
+        }
+        rest.remove_prefix(n);
+        return n > 0;
+    };
+    if (!number("index=", seal.index) || !number(" | first=", seal.first_sequence) ||
+        !number(" | count=", seal.count) || !number(" | lanes=", seal.lanes)) {
+        return false;
+    }
+    const std::string_view key(" | root=");
+    if (rest.size() != key.size() + 64 || rest.substr(0, key.size()) != key) return false;
+    return detail::hex_decode(rest.data() + key.size(), 32, seal.root.data());
+}
+
+struct EpochOptions {
+    unsigned threads = 0;           ///< Lanes per epoch (0: hardware concurrency)
+    size_t min_lane_events = 256;   ///< Smaller epochs are cut into fewer lanes
+};
+
+/**
+ * @brief Audit chain whose epochs are hashed on several threads
+ *
+ * Not thread-safe: one caller logs epoch by epoch, and each epoch fans out
+ * internally. Sequence numbers count lane entries and seals alike, so an
+ * epoch of n events advances the chain by n + 1.
+ */
+class EpochChain {
+public:
+    explicit EpochChain(std::string_view device_id, EpochOptions options = EpochOptions(),
+                        ClockSource clock = nullptr)
+        : options_(options), clock_(std::move(clock)) {
+        state_.device_id = std::string(device_id);
+    }
+
+    /**
+     * @brief Continue after @p state; the first epoch seeds from its last hash
+     */
+    explicit EpochChain(const ChainState& state, EpochOptions options = EpochOptions(),
+                        ClockSource clock = nullptr)
+        : options_(options), clock_(std::move(clock)) {
+        state_.device_id = state.device_id;
+        state_.sequence = state.sequence;
+        state_.last_hash = state.last_hash;
+        state_.timestamp_ms = state.timestamp_ms;
+    }
+
+    /**
+     * @brief Log one epoch
+     *
+     * Replaces the contents of @p out with one JSON entry per event, each
+     * followed by '\n', and the seal entry last. The clock is read once and
+     * every entry carries that timestamp. The sink receives the whole epoch
+     * in one write_batch() call, after all lanes have finished.
+     * @return Number of entries in @p out (0 for an empty epoch, which is not
+     *         sealed, or one refused because an event's message is reserved)
+     */
+    size_t log_epoch(std::string& out, const LogEvent* events, size_t count) {
+        return log_epoch_at(out, now_ms(), events, count);
+    }
+
+    size_t log_epoch(std::string& out, const std::vector<LogEvent>& events) {
+        return log_epoch(out, events.data(), events.size());
+    }
+
+    size_t log_epoch(std::string& out, EventBatch& batch) {
+        return log_epoch(out, batch.events(), batch.size());
+    }
+
+    /**
+     * @brief log_epoch() with an explicit timestamp for every entry
+     * @param timestamp_ms Milliseconds since the Unix epoch
+     */
+    size_t log_epoch_at(std::string& out, int64_t timestamp_ms,
+                        const LogEvent* events, size_t count) {
+        out.clear();
+        if (count == 0) return 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (AuditChain::is_reserved(events[i].message, events[i].user_id)) return 0;
+        }
+        const unsigned threads = options_.threads ? options_.threads
+                                                  : std::max(std::thread::hardware_concurrency(), 1u);
+        const size_t by_size = std::max<size_t>(count / std::max<size_t>(options_.min_lane_events, 1), 1);
+        const size_t lanes = std::min<size_t>(threads, by_size);
+        if (lanes_.size() < lanes) lanes_.resize(lanes);
+
+        for (size_t i = 0; i < lanes; ++i) {
+            lanes_[i].first = count * i / lanes;
+            lanes_[i].count = count * (i + 1) / lanes - lanes_[i].first;
+        }
+        auto run_lane = [&](size_t i) {
+            Lane& lane = lanes_[i];
+            ChainState start;
+            start.device_id = state_.device_id;
+            start.sequence = state_.sequence + lane.first;
+            start.last_hash = detail::epoch_seed(state_.last_hash, i);
+            AuditChain chain(start);
+            if (sink_) {
+                if (!lane.collector) lane.collector = std::make_shared<InfoCollector>();
+                lane.collector->infos.clear();
+                chain.set_sink(lane.collector);
+            }
+            chain.log_batch_at(lane.out, timestamp_ms, events + lane.first, lane.count);
+            lane.tail = chain.last_entry_info().chain_hash;
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(lanes - 1);
+        for (size_t i = 1; i < lanes; ++i) workers.emplace_back(run_lane, i);
+        run_lane(0);
+        for (auto& worker : workers) worker.join();
+
+        // Serial step: one seal links the lanes into the main chain
+        merkle::Accumulator tails;
+        size_t total = 0;
+        for (size_t i = 0; i < lanes; ++i) {
+            tails.append(lanes_[i].tail);
+            total += lanes_[i].out.size();
+        }
+        EpochSeal seal;
+        seal.index = epochs_;
+        seal.first_sequence = state_.sequence + 1;
+        seal.count = count;
+        seal.lanes = lanes;
+        seal.root = tails.root();
+        seal_message_.resize(detail::epoch_seal_message_capacity);
+        seal_message_.resize(detail::format_epoch_seal_message(seal, &seal_message_[0]));
+
+        ChainState main = state_;
+        main.sequence += count;
+        AuditChain sealer(main);
+        if (sink_) {
+            if (!seal_collector_) seal_collector_ = std::make_shared<InfoCollector>();
+            seal_collector_->infos.clear();
+            sealer.set_sink(seal_collector_);
+        }
+        sealer.log_at(seal_entry_, timestamp_ms, seal_message_);
+
+        out.reserve(total + seal_entry_.size() + 1);
+        for (size_t i = 0; i < lanes; ++i) out.append(lanes_[i].out);
+        out.append(seal_entry_).push_back('\n');
+
+        state_.sequence = main.sequence + 1;
+        state_.last_hash = sealer.last_entry_info().chain_hash;
+        state_.timestamp_ms = timestamp_ms;
+        last_seal_ = seal;
+        ++epochs_;
+
+        if (sink_) {
+            infos_.clear();
+            for (size_t i = 0; i < lanes; ++i) {
+                const auto& infos = lanes_[i].collector->infos;
+                infos_.insert(infos_.end(), infos.begin(), infos.end());
+            }
+            infos_.push_back(seal_collector_->infos.back());
+            DTS_METRICS_TIME(SinkWrite);
+            sink_->write_batch(out, infos_.data(), infos_.size());
+        }
+        return count + 1;
+    }
+
+    /**
+     * @brief Attach a sink that receives every subsequent epoch (nullptr detaches)
+     */
+    void set_sink(std::shared_ptr<LogSink> sink) {
+        sink_ = std::move(sink);
+    }
+
+    /**
+     * @brief Replace the timestamp source (nullptr restores system_clock)
+     */
+    void set_clock(ClockSource clock) {
+        clock_ = std::move(clock);
+    }
+
+    /**
+     * @brief Position after the last seal (log_offset is left 0)
+     */
+    ChainState state() const {
+        return state_;
+    }
+
+    /**
+     * @brief chain_hash of the last seal (the next epoch's seeds derive from it)
+     */
+    std::string get_chain_hash() const {
+        std::string hex(64, '\0');
+        detail::hex_encode(state_.last_hash.data(), state_.last_hash.size(), &hex[0]);
+        return hex;
+    }
+
+    uint64_t get_sequence_number() const {
+        return state_.sequence;
+    }
+
+    uint64_t epoch_count() const {
+        return epochs_;
+    }
+
+    /**
+     * @brief Most recent seal (valid once epoch_count() > 0)
+     */
+    const EpochSeal& last_seal() const {
+        return last_seal_;
+    }
+
+private:
+    /// Keeps the EntryInfos a lane's AuditChain hands to its sink
+    class InfoCollector : public LogSink {
+    public:
+        void write(std::string_view, const EntryInfo& info) override {
+            infos.push_back(info);
+        }
+
+        void write_batch(std::string_view, const EntryInfo* batch, size_t count) override {
+            infos.insert(infos.end(), batch, batch + count);
+        }
+
+        std::vector<EntryInfo> infos;
+    };
+
+    struct Lane {
+        size_t first = 0;
+        size_t count = 0;
+        std::string out;
+        SHA256::Hash tail{};
+        std::shared_ptr<InfoCollector> collector;
+    };
+
+    EpochOptions options_;
+    ClockSource clock_;
+    ChainState state_;          ///< sequence, last_hash and timestamp_ms only
+    std::shared_ptr<LogSink> sink_;
+    std::vector<Lane> lanes_;
+    std::shared_ptr<InfoCollector> seal_collector_;
+    std::vector<EntryInfo> infos_;
+    std::string seal_message_;
+    std::string seal_entry_;
+    EpochSeal last_seal_{};
+    uint64_t epochs_ = 0;
+
+    int64_t now_ms() {
+        return to_epoch_ms(clock_ ? clock_() : std::chrono::system_clock::now());
+    }
+};
+
+/**
+ * @brief Incremental verifier for EpochChain logs; feed entries in log order
+ *
+ * An entry continues the open lane, starts the next lane of the epoch
+ * (its previous_hash is that lane's seed) or seals the epoch. A seal must
+ * link to the previous seal, and its counts and root must match the lanes
+ * seen. In recompute mode every chain_hash is re-derived as well.
+ */
+class EpochVerifier {
+public:
+    explicit EpochVerifier(const SHA256::Hash& initial = detail::chain_init_hash(),
+                           bool recompute = false)
+        : main_hash_(initial), recompute_(recompute), lane_(initial, recompute) {
+        result_.first_previous_hash = initial;
+        result_.last_hash = initial;
+        next_seed_ = detail::epoch_seed(main_hash_, 0);
+    }
+
+    /**
+     * @brief Check the next entry
+     * @param offset Byte offset reported if this entry fails
+     * @return false once verification has failed
+     */
+    bool add(std::string_view entry, size_t offset = 0) {
+        if (!result_.ok()) return false;
+        const char* prev_hex;
+        const char* chain_hex;
+        SHA256::Hash prev;
+        SHA256::Hash chain;
+        if (!detail::entry_link_hashes(entry, prev_hex, chain_hex) ||
+            !detail::hex_decode(prev_hex, prev.size(), prev.data()) ||
+            !detail::hex_decode(chain_hex, chain.size(), chain.data())) {
+            return fail(VerifyStatus::Malformed, offset);
+        }
+        if (lanes_ > 0 && prev == lane_tail_) return lane_add(entry, offset, chain);
+        if (prev == next_seed_) {
+            if (!close_lane()) return false;
+            if (lanes_ == 0) first_unsealed_offset_ = offset;
+            lane_ = ChainVerifier(next_seed_, recompute_);
+            lane_base_ = result_.entries + pending_;
+            next_seed_ = detail::epoch_seed(main_hash_, ++lanes_);
+            return lane_add(entry, offset, chain);
+        }
+        if (prev == main_hash_ && lanes_ > 0) return seal(entry, offset, chain);
+        return fail(VerifyStatus::BrokenLink, offset);
+    }
+
+    /**
+     * @brief Verification outcome; entries after the last seal fail as BrokenLink
+     */
+    VerifyResult result() const {
+        VerifyResult result = result_;
+        if (result.ok() && pending_ > 0) {
+            result.status = VerifyStatus::BrokenLink;
+            result.failed_entry = result.entries + 1;
+            result.failed_offset = first_unsealed_offset_;
+        }
+        return result;
+    }
+
+    bool ok() const { return result().ok(); }
+
+    /// Seals verified so far
+    uint64_t epochs() const { return epochs_; }
+
+private:
+    VerifyResult result_;
+    SHA256::Hash main_hash_;            ///< chain_hash of the last seal
+    SHA256::Hash next_seed_;            ///< Seed of the next lane of the open epoch
+    SHA256::Hash lane_tail_{};
+    bool recompute_;
+    ChainVerifier lane_;
+    uint64_t lane_base_ = 0;            ///< Entries before the open lane
+    uint64_t lanes_ = 0;                ///< Lanes of the open epoch
+    uint64_t pending_ = 0;              ///< Entries of the open epoch
+    size_t first_unsealed_offset_ = 0;
+    merkle::Accumulator tails_;         ///< Last chain hashes of the closed lanes
+    uint64_t epochs_ = 0;
+    uint64_t next_index_ = 0;
+    uint64_t next_first_ = 0;           ///< Expected first_sequence (0: first seal seen)
+
+    bool fail(VerifyStatus status, size_t offset) {
+        result_.status = status;
+        result_.failed_entry = result_.entries + pending_ + 1;
+        result_.failed_offset = offset;
+        return false;
+    }
+
+    /// A lane failure reported by its ChainVerifier (possibly for an earlier entry)
+    bool lane_failed() {
+        const VerifyResult& lane = lane_.result();
+        result_.status = lane.status;
+        result_.failed_entry = lane_base_ + lane.failed_entry;
+        result_.failed_offset = lane.failed_offset;
+        return false;
+    }
+
+    bool lane_add(std::string_view entry, size_t offset, const SHA256::Hash& chain) {
+        if (!lane_.add(entry, offset)) return lane_failed();
+        lane_tail_ = chain;
+        ++pending_;
+        return true;
+    }
+
+    bool close_lane() {
+        if (lanes_ == 0) return true;
+        if (!lane_.ok()) return lane_failed();
+        tails_.append(lane_tail_);
+        return true;
+    }
+
+    bool seal(std::string_view entry, size_t offset, const SHA256::Hash& chain) {
+        if (!close_lane()) return false;
+        ChainVerifier link(main_hash_, recompute_);
+        EntryView view;
+        EpochSeal seal;
+        if (!link.add(entry, offset) || !link.ok()) {
+            result_.status = link.result().status;
+            result_.failed_entry = result_.entries + pending_ + 1;
+            result_.failed_offset = offset;
+            return false;
+        }
+        if (!parse_entry(entry, view) || !parse_epoch_seal_message(view.message, seal)) {
+            return fail(VerifyStatus::Malformed, offset);
+        }
+        // Indexes restart at 0 when a chain is resumed from a ChainState
+        const bool ordered = next_first_ == 0 ||
+                             ((seal.index == next_index_ || seal.index == 0) &&
+                              seal.first_sequence == next_first_);
+        if (!ordered || seal.count != pending_ || seal.lanes != lanes_ || seal.root != tails_.root()) {
+            return fail(VerifyStatus::HashMismatch, offset);
+        }
+        result_.entries += pending_ + 1;
+        result_.last_hash = chain;
+        main_hash_ = chain;
+        next_seed_ = detail::epoch_seed(main_hash_, 0);
+        next_index_ = seal.index + 1;
+        next_first_ = seal.first_sequence + seal.count + 1;
+        tails_.clear();
+        lanes_ = 0;
+        pending_ = 0;
+        ++epochs_;
+        return true;
+    }
+};
+
+/**
+ * @brief Verify an EpochChain JSON-lines log held in memory
+ */
+inline VerifyResult verify_epoch_buffer(std::string_view log,
+                                        const VerifyOptions& options = VerifyOptions()) {
+    DTS_METRICS_TIME(Verify);
+    EpochVerifier verifier(options.initial_hash, options.recompute);
+    const char* p = log.data();
+    const char* end = log.data() + log.size();
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(
+            std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!line_end) line_end = end;
+        const char* text_end = line_end;
+        if (text_end > p && text_end[-1] == '\r') --text_end;
+        if (text_end > p && !verifier.add(std::string_view(p, static_cast<size_t>(text_end - p)),
+                                          static_cast<size_t>(p - log.data()))) {
+            break;
+        }
+        p = line_end + 1;
+    }
+    const VerifyResult result = verifier.result();
+    detail::count_verified(result);
+    return result;
+}
+
+/**
+ * @brief Verify an EpochChain JSON-lines log file
+ * @param ok Set to false if the file could not be read
+ */
+inline VerifyResult verify_epoch_file(const std::string& path,
+                                      const VerifyOptions& options = VerifyOptions(),
+                                      bool* ok = nullptr) {
+    MappedFile file(path);
+    if (ok) *ok = file.ok();
+    if (!file.ok()) {
+        VerifyResult result;
+        result.status = VerifyStatus::Malformed;
+        result.failed_entry = 1;
+        return result;
+    }
+    return verify_epoch_buffer(file.view(), options);
+}
+
+} // namespace dts
+
+#endif // DTS_EPOCH_CHAIN_HPP
@@ -0,0 +1,284 @@
+/**
+ * @file event_coalescer.hpp
+ * @brief Pre-chain coalescing of high-frequency telemetry events
+ *
+ * Sensors and flapping I/O points can produce thousands of near-identical
+ * events per second. EventCoalescer holds repeats of the same (event, key)
+ * for a time window and then chains a single summary record:
+ *
+ * @code
+ * Coalesced Events | Event:I/O Change | Key:I0.3 | Count:412 | First:1 | Last:0 |
+ *     Min:0 | Max:1 | Span:998ms
+ * @endcode
+ *
+ * A window holding a single event chains that event's message unchanged.
+ * Events at or above Options::passthrough_severity are chained immediately
+ * and never held; any pending window for the same key is chained first, so
+ * per-key order is kept. Every submitted event is still accounted for in the
+ * hash chain (as itself or in a summary's count), only the number of entries
+ * to hash and store shrinks. Records carry the time of the event they
+ * describe (the last one, for a summary), so they may be older than entries
+ * chained while the window was open.
+ *
+ * The coalescer does not own the chain; each call names it. Records chained
+ * while closing windows reach the chain's LogSink, so attach one.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_EVENT_COALESCER_HPP
+#define DTS_EVENT_COALESCER_HPP
+
+#include "audit_chain.hpp"
+#include "event_schema.hpp"
+#include "message_builder.hpp"
+#include "timestamp.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dts {
+
+/**
+ * @brief Schema of the summary record chained for a coalesced window
+ */
+struct CoalescedEvents {
+    static constexpr std::string_view name = "Coalesced Events";
+    static constexpr std::string_view fields[] = {"Event", "Key", "Count", "First", "Last",
+                                                  "Min", "Max", "Span"};
+};
+
+/**
+ * @brief Windowed coalescing stage in front of an AuditChain
+ */
+class EventCoalescer {
+public:
+    struct Options {
+        std::chrono::milliseconds window{1000};     ///< Measured from a key's first held event
+        size_t max_keys = 256;                      ///< Beyond this, new keys pass through
+        Severity passthrough_severity = Severity::Critical;  ///< Never held at or above this
+        ClockSource clock;                          ///< Defaults to the system clock
+    };
+
+    EventCoalescer() : EventCoalescer(Options()) {}
+
+    explicit EventCoalescer(Options options) : options_(std::move(options)) {}
+
+    /**
+     * @brief Submit an event whose value is text (numeric text also feeds Min/Max)
+     * @param event Event name, e.g. the schema name
+     * @param key Source within the event, e.g. the I/O address
+     * @param message Full message, chained as-is if not coalesced
+     * @param out Receives the entry if the event was chained now, else cleared
+     * @return true if the event was chained immediately, false if it is held
+     */
+    bool submit(AuditChain& chain, std::string& out,
+                std::string_view event, std::string_view key, std::string_view value,
+                std::string_view message, UserID user_id, Severity severity) {
+        double number = 0.0;
+        const bool numeric = parse_number(value, number);
+        return submit_value(chain, out, event, key, value, numeric, number,
+                            message, user_id, severity);
+    }
+
+    /**
+     * @brief Submit an event with a numeric value
+     */
+    bool submit(AuditChain& chain, std::string& out,
+                std::string_view event, std::string_view key, double value,
+                std::string_view message, UserID user_id, Severity severity) {
+        value_text_.begin({}) << value;
+        return submit_value(chain, out, event, key, value_text_.view(), true, value,
+                            message, user_id, severity);
+    }
+
+    /**
+     * @brief Chain every window that has expired
+     * @return Records chained
+     */
+    size_t poll(AuditChain& chain) {
+        return close_windows(chain, now_ms(), false);
+    }
+
+    /**
+     * @brief Chain every pending window regardless of age
+     * @return Records chained
+     */
+    size_t flush(AuditChain& chain) {
+        return close_windows(chain, 0, true);
+    }
+
+    /// Keys with held events
+    size_t pending() const { return active_; }
+
+    /// Events folded into summary records (not chained individually)
+    uint64_t coalesced_count() const { return coalesced_; }
+
+private:
+    struct Bucket {
+        std::string id;         ///< event '\0' key
+        size_t event_length;
+        std::string message;    ///< First held event, chained verbatim if alone
+        std::string first;
+        std::string last;
+        double min;
+        double max;
+        bool numeric;
+        uint64_t count;         ///< 0 if idle
+        int64_t first_ms;
+        int64_t last_ms;
+        UserID user_id;
+        Severity severity;      ///< Highest held severity
+    };
+
+    Options options_;
+    std::vector<Bucket> buckets_;
+    std::unordered_map<std::string, size_t> index_;
+    std::string id_;
+    std::string record_;
+    MessageBuilder value_text_;
+    MessageBuilder summary_;
+    EventFormat<CoalescedEvents> format_;
+    size_t active_ = 0;
+    uint64_t coalesced_ = 0;
+    int64_t next_deadline_ = std::numeric_limits<int64_t>::max();
+
+    int64_t now_ms() const {
+        return to_epoch_ms(options_.clock ? options_.clock() : std::chrono::system_clock::now());
+    }
+
+    static bool parse_number(std::string_view text, double& value) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        const char* end = text.data() + text.size();
+        const auto result = std::from_chars(text.data(), end, value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == end;
+#else
+        (void)text;
+        (void)value;
+        return false;
+#endif
+    }
+
+    bool submit_value(AuditChain& chain, std::string& out,
+                      std::string_view event, std::string_view key, std::string_view value,
+                      bool numeric, double number,
+                      std::string_view message, UserID user_id, Severity severity) {
+        const int64_t now = now_ms();
+        if (now >= next_deadline_) close_windows(chain, now, false);
+
+        id_.assign(event.data(), event.size()).push_back('\0');
+        id_.append(key.data(), key.size());
+        auto it = index_.find(id_);
+
+        if (severity >= options_.passthrough_severity) {
+            if (it != index_.end() && buckets_[it->second].count != 0) {
+                close(chain, buckets_[it->second]);
+            }
+            chain.log_at(out, now, message, user_id, severity);
+            return true;
+        }
+
+        if (it == index_.end()) {
+            if (index_.size() >= options_.max_keys) drop_idle();
+            if (index_.size() >= options_.max_keys) {
+                chain.log_at(out, now, message, user_id, severity);
+                return true;
+            }
+            it = index_.emplace(id_, buckets_.size()).first;
+            buckets_.emplace_back();
+            buckets_.back().id = id_;
+            buckets_.back().event_length = event.size();
+            buckets_.back().count = 0;
+        }
+
+        Bucket& bucket = buckets_[it->second];
+        if (bucket.count == 0) {
+            bucket.message.assign(message.data(), message.size());
+            bucket.first.assign(value.data(), value.size());
+            bucket.min = bucket.max = number;
+            bucket.numeric = numeric;
+            bucket.first_ms = now;
+            bucket.severity = severity;
+            next_deadline_ = std::min(next_deadline_, now + window_ms());
+            ++active_;
+        } else {
+            bucket.numeric = bucket.numeric && numeric;
+            bucket.min = std::min(bucket.min, number);
+            bucket.max = std::max(bucket.max, number);
+            bucket.severity = std::max(bucket.severity, severity);
+        }
+        bucket.last.assign(value.data(), value.size());
+        bucket.last_ms = now;
+        bucket.user_id = user_id;
+        ++bucket.count;
+        out.clear();
+        return false;
+    }
+
+    int64_t window_ms() const {
+        return static_cast<int64_t>(options_.window.count());
+    }
+
+    size_t close_windows(AuditChain& chain, int64_t now, bool all) {
+        size_t records = 0;
+        next_deadline_ = std::numeric_limits<int64_t>::max();
+        for (Bucket& bucket : buckets_) {
+            if (bucket.count == 0) continue;
+            const int64_t deadline = bucket.first_ms + window_ms();
+            if (all || now >= deadline) {
+                close(chain, bucket);
+                ++records;
+            } else {
+                next_deadline_ = std::min(next_deadline_, deadline);
+            }
+        }
+        return records;
+    }
+
+    void close(AuditChain& chain, Bucket& bucket) {
+        if (bucket.count == 1) {
+            chain.log_at(record_, bucket.first_ms, bucket.message, bucket.user_id,
+                         bucket.severity);
+        } else {
+            const std::string_view id = bucket.id;
+            const std::string_view event = id.substr(0, bucket.event_length);
+            const std::string_view key = id.substr(bucket.event_length + 1);
+            const std::string_view first = bucket.first;
+            const std::string_view last = bucket.last;
+            format_.render(summary_, event, key, bucket.count, first, last,
+                           optional_field(bucket.min, bucket.numeric),
+                           optional_field(bucket.max, bucket.numeric),
+                           with_unit(bucket.last_ms - bucket.first_ms, "ms"));
+            chain.log_at(record_, bucket.last_ms, summary_.view(), bucket.user_id,
+                         bucket.severity);
+            coalesced_ += bucket.count;
+        }
+        bucket.count = 0;
+        --active_;
+    }
+
+    /// Forget idle keys so the table can take new ones
+    void drop_idle() {
+        size_t kept = 0;
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            if (buckets_[i].count == 0) continue;
+            if (kept != i) buckets_[kept] = std::move(buckets_[i]);
+            ++kept;
+        }
+        buckets_.resize(kept);
+        index_.clear();
+        for (size_t i = 0; i < buckets_.size(); ++i) index_.emplace(buckets_[i].id, i);
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_EVENT_COALESCER_HPP
@@ -0,0 +1,89 @@
+/**
+ * @file event_fields.hpp
+ * @brief Field wrappers and enum name tables for structured event messages
+ *
+ * Shared by EventFormat (event_schema.hpp) and the fixed-capacity
+ * renderer in static_message.hpp. Header-only and allocation-free.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_EVENT_FIELDS_HPP
+#define DTS_EVENT_FIELDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace dts {
+
+/**
+ * @brief Field that is left out of the message (key included) unless present
+ */
+template <typename T>
+struct OptionalField {
+    T value;
+    bool present;
+};
+
+template <typename T>
+OptionalField<T> optional_field(T value, bool present) {
+    return {value, present};
+}
+
+/// Present unless @p value is empty
+inline OptionalField<std::string_view> if_not_empty(std::string_view value) {
+    return {value, !value.empty()};
+}
+
+/**
+ * @brief Value followed by a unit ("80%", or "21.5 C" with a ' ' separator)
+ *
+ * Nothing follows the value if @c unit is empty.
+ */
+template <typename T>
+struct UnitField {
+    T value;
+    std::string_view unit;
+    char separator;     ///< Written between value and unit unless '\0'
+};
+
+template <typename T>
+UnitField<T> with_unit(T value, std::string_view unit, char separator = '\0') {
+    return {value, unit, separator};
+}
+
+/**
+ * @brief 256-entry name table for a uint8_t-based enum
+ *
+ * Built at compile time; values without a name map to the fallback.
+ */
+template <typename Enum>
+class EnumNames {
+public:
+    struct Entry {
+        Enum value;
+        std::string_view name;
+    };
+
+    template <size_t N>
+    constexpr EnumNames(const Entry (&entries)[N], std::string_view fallback) : names_() {
+        static_assert(sizeof(Enum) == 1, "EnumNames requires a one-byte enum");
+        for (auto& name : names_) name = fallback;
+        for (size_t i = 0; i < N; ++i) {
+            names_[static_cast<uint8_t>(entries[i].value)] = entries[i].name;
+        }
+    }
+
+    constexpr std::string_view operator[](Enum value) const {
+        return names_[static_cast<uint8_t>(value)];
+    }
+
+private:
+    std::string_view names_[256];
+};
+
+} // namespace dts
+
+#endif // DTS_EVENT_FIELDS_HPP
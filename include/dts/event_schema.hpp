@@ -0,0 +1,129 @@
+/**
+ * @file event_schema.hpp
+ * @brief Compile-time event schemas for structured adapter messages
+ *
+ * An event schema is a type that declares an event's name and the keys of
+ * its fields:
+ *
+ * @code
+ * struct IoChange {
+ *     static constexpr std::string_view name = "I/O Change";
+ *     static constexpr std::string_view fields[] = {"Input", "From", "To"};
+ * };
+ * @endcode
+ *
+ * EventFormat<IoChange> pre-renders the " | Key:" separators and any
+ * constant trailer (e.g., " | Asset:PRESS-01") once, so each message only
+ * formats its variable values. The number of values is checked at compile
+ * time, and messages always have the shape "Name | Key:value | ...", with
+ * keys in schema order, which gives downstream parsers stable fields. An
+ * empty key renders a bare " | value".
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_EVENT_SCHEMA_HPP
+#define DTS_EVENT_SCHEMA_HPP
+
+#include "event_fields.hpp"
+#include "message_builder.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace dts {
+
+/**
+ * @brief Pre-rendered formatter for one event schema
+ */
+template <typename Schema>
+class EventFormat {
+public:
+    static constexpr size_t field_count = std::size(Schema::fields);
+
+    /**
+     * @param trailer Constant text appended to every message, e.g.
+     *        " | Asset:PRESS-01" (see constant_field())
+     */
+    explicit EventFormat(std::string_view trailer = {}) : trailer_(trailer) {
+        for (size_t i = 0; i < field_count; ++i) {
+            const std::string_view key = Schema::fields[i];
+            keys_[i] = " | ";
+            if (!key.empty()) {
+                keys_[i].append(key.data(), key.size());
+                keys_[i].push_back(':');
+            }
+        }
+    }
+
+    /**
+     * @brief Render Schema::name followed by one value per field
+     */
+    template <typename... Values>
+    std::string_view render(MessageBuilder& msg, const Values&... values) const {
+        return render_as(msg, Schema::name, values...);
+    }
+
+    /**
+     * @brief Render with a per-call event name (e.g., from an EnumNames table)
+     */
+    template <typename... Values>
+    std::string_view render_as(MessageBuilder& msg, std::string_view name,
+                               const Values&... values) const {
+        static_assert(sizeof...(Values) == field_count,
+                      "one value is required for each field of the schema");
+        msg.begin(name);
+        size_t index = 0;
+        (put(msg, keys_[index++], values), ...);
+        msg << trailer_;
+        return msg.view();
+    }
+
+    const std::string& trailer() const { return trailer_; }
+
+private:
+    std::array<std::string, field_count> keys_;
+    std::string trailer_;
+
+    template <typename T>
+    static void put(MessageBuilder& msg, const std::string& key, const T& value) {
+        msg << key << value;
+    }
+
+    template <typename T>
+    static void put(MessageBuilder& msg, const std::string& key, const OptionalField<T>& field) {
+        if (field.present) put(msg, key, field.value);
+    }
+
+    template <typename T>
+    static void put(MessageBuilder& msg, const std::string& key, const UnitField<T>& field) {
+        msg << key << field.value;
+        if (field.unit.empty()) return;
+        if (field.separator != '\0') msg << field.separator;
+        msg << field.unit;
+    }
+};
+
+/**
+ * @brief " | key:value", or nothing if @p value is empty
+ *
+ * For building EventFormat trailers from per-instance constants.
+ */
+inline std::string constant_field(std::string_view key, std::string_view value) {
+    std::string text;
+    if (value.empty()) return text;
+    text.reserve(key.size() + value.size() + 4);
+    text.append(" | ").append(key.data(), key.size()).append(":");
+    text.append(value.data(), value.size());
+    return text;
+}
+
+} // namespace dts
+
+#endif // DTS_EVENT_SCHEMA_HPP
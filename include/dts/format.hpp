@@ -0,0 +1,309 @@
+/**
+ * @file format.hpp
+ * @brief Allocation-free formatting primitives shared by DTS components
+ *
+ * Every routine writes into a caller-supplied character buffer and never
+ * touches the heap, locale, or iostreams. Callers are responsible for
+ * sizing buffers; the *_length() helpers report exact output sizes.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_FORMAT_HPP
+#define DTS_FORMAT_HPP
+
+#include "simd_scan.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace dts {
+namespace detail {
+
+static constexpr char hex_digits[] = "0123456789abcdef";
+
+/// Length of a formatted timestamp: YYYY-MM-DDTHH:MM:SS.mmmZ
+static constexpr size_t timestamp_length = 24;
+
+/**
+ * @brief Lower-case hex encode @p len bytes into @p out (2 * len chars)
+ */
+inline void hex_encode(const uint8_t* data, size_t len, char* out) {
+    for (size_t i = 0; i < len; ++i) {
+        out[i * 2] = hex_digits[data[i] >> 4];
+        out[i * 2 + 1] = hex_digits[data[i] & 0x0F];
+    }
+}
+
+/// Hex digit values by character; -1 for non-hex characters
+struct HexTable {
+    int8_t value[256];
+    constexpr HexTable() : value() {
+        for (int i = 0; i < 256; ++i) value[i] = -1;
+        for (int i = 0; i < 10; ++i) value['0' + i] = static_cast<int8_t>(i);
+        for (int i = 0; i < 6; ++i) {
+            value['a' + i] = static_cast<int8_t>(10 + i);
+            value['A' + i] = static_cast<int8_t>(10 + i);
+        }
+    }
+};
+
+static constexpr HexTable hex_table{};
+
+inline int hex_value(char c) {
+    return hex_table.value[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief Decode 2 * @p len hex chars into @p out
+ * @return false on any non-hex character
+ */
+inline bool hex_decode(const char* hex, size_t len, uint8_t* out) {
+    int invalid = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const int hi = hex_value(hex[i * 2]);
+        const int lo = hex_value(hex[i * 2 + 1]);
+        invalid |= hi | lo;
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return invalid >= 0;
+}
+
+/**
+ * @brief Number of decimal digits in @p value
+ */
+inline size_t uint_length(uint64_t value) {
+    size_t n = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * @brief Write @p value in decimal
+ * @return Number of characters written
+ */
+inline size_t format_uint(uint64_t value, char* out) {
+    const size_t n = uint_length(value);
+    for (size_t i = n; i > 0; --i) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return n;
+}
+
+inline void format_fixed(uint32_t value, size_t width, char* out) {
+    for (size_t i = width; i > 0; --i) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/**
+ * @brief Convert days since 1970-01-01 to a proleptic Gregorian date
+ *
+ * H. Hinnant's civil_from_days algorithm; valid for the full int64 range
+ * of realistic timestamps and independent of the C library's gmtime.
+ */
+inline void civil_from_days(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+/**
+ * @brief Inverse of civil_from_days()
+ */
+inline int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+inline int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t q = value / divisor;
+    if ((value % divisor) != 0 && ((value < 0) != (divisor < 0))) --q;
+    return q;
+}
+
+/**
+ * @brief Format seconds since the epoch as YYYY-MM-DDTHH:MM:SS (19 chars)
+ */
+inline void format_utc_seconds(int64_t seconds, char* out) {
+    const int64_t days = floor_div(seconds, 86400);
+    const uint32_t sod = static_cast<uint32_t>(seconds - days * 86400);
+    int64_t year;
+    unsigned month, day;
+    civil_from_days(days, year, month, day);
+
+    format_fixed(static_cast<uint32_t>(year < 0 ? 0 : year % 10000), 4, out);
+    out[4] = '-';
+    format_fixed(month, 2, out + 5);
+    out[7] = '-';
+    format_fixed(day, 2, out + 8);
+    out[10] = 'T';
+    format_fixed(sod / 3600, 2, out + 11);
+    out[13] = ':';
+    format_fixed((sod / 60) % 60, 2, out + 14);
+    out[16] = ':';
+    format_fixed(sod % 60, 2, out + 17);
+}
+
+/**
+ * @brief Format milliseconds since the epoch as YYYY-MM-DDTHH:MM:SS.mmmZ
+ * @param out Buffer of at least timestamp_length chars
+ */
+inline void format_timestamp_ms(int64_t ms_since_epoch, char* out) {
+    const int64_t seconds = floor_div(ms_since_epoch, 1000);
+    format_utc_seconds(seconds, out);
+    out[19] = '.';
+    format_fixed(static_cast<uint32_t>(ms_since_epoch - seconds * 1000), 3, out + 20);
+    out[23] = 'Z';
+}
+
+/**
+ * @brief Parse YYYY-MM-DDTHH:MM:SS.mmmZ back to milliseconds since the epoch
+ * @return false if @p text is not in exactly that form
+ */
+inline bool parse_timestamp_ms(const char* text, size_t len, int64_t& ms_since_epoch) {
+    if (len != timestamp_length || text[4] != '-' || text[7] != '-' || text[10] != 'T' ||
+        text[13] != ':' || text[16] != ':' || text[19] != '.' || text[23] != 'Z') {
+        return false;
+    }
+    auto digits = [text](size_t pos, size_t width, uint32_t& value) {
+        value = 0;
+        for (size_t i = 0; i < width; ++i) {
+            const char c = text[pos + i];
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+        }
+        return true;
+    };
+    uint32_t year, month, day, hour, minute, second, millis;
+    if (!digits(0, 4, year) || !digits(5, 2, month) || !digits(8, 2, day) ||
+        !digits(11, 2, hour) || !digits(14, 2, minute) || !digits(17, 2, second) ||
+        !digits(20, 3, millis) || month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    const int64_t days = days_from_civil(year, month, day);
+    ms_since_epoch = ((days * 86400 + hour * 3600 + minute * 60 + second) * 1000) + millis;
+    return true;
+}
+
+/**
+ * @brief Exact length of @p data after JSON string escaping
+ */
+inline size_t json_escaped_length(const char* data, size_t len) {
+    // Most messages need no escaping; skip the clean prefix 16 bytes at a time
+    const size_t clean = static_cast<size_t>(find_json_escape(data, data + len) - data);
+    size_t n = len;
+    for (size_t i = clean; i < len; ++i) {
+        const unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' ||
+            c == '\r' || c == '\t') {
+            n += 1;
+        } else if (c < 0x20) {
+            n += 5;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief JSON-escape @p data into @p out
+ * @return Number of characters written (json_escaped_length())
+ */
+inline size_t escape_json(const char* data, size_t len, char* out) {
+    const size_t clean = static_cast<size_t>(find_json_escape(data, data + len) - data);
+    std::memcpy(out, data, clean);
+    char* p = out + clean;
+    for (size_t i = clean; i < len; ++i) {
+        const char c = data[i];
+        switch (c) {
+            case '"': *p++ = '\\'; *p++ = '"'; break;
+            case '\\': *p++ = '\\'; *p++ = '\\'; break;
+            case '\b': *p++ = '\\'; *p++ = 'b'; break;
+            case '\f': *p++ = '\\'; *p++ = 'f'; break;
+            case '\n': *p++ = '\\'; *p++ = 'n'; break;
+            case '\r': *p++ = '\\'; *p++ = 'r'; break;
+            case '\t': *p++ = '\\'; *p++ = 't'; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    *p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
+                    *p++ = hex_digits[(static_cast<unsigned char>(c) >> 4) & 0x0F];
+                    *p++ = hex_digits[static_cast<unsigned char>(c) & 0x0F];
+                } else {
+                    *p++ = c;
+                }
+                break;
+        }
+    }
+    return static_cast<size_t>(p - out);
+}
+
+/**
+ * @brief Sequential writer over a pre-sized character buffer
+ */
+struct CharWriter {
+    char* pos;
+
+    void put(char c) { *pos++ = c; }
+
+    void put(const char* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) pos[i] = data[i];
+        pos += len;
+    }
+
+    template <size_t N>
+    void literal(const char (&text)[N]) { put(text, N - 1); }
+
+    void uint(uint64_t value) { pos += format_uint(value, pos); }
+
+    void escaped(const char* data, size_t len) { pos += escape_json(data, len, pos); }
+};
+
+} // namespace detail
+
+/**
+ * @brief Formats YYYY-MM-DDTHH:MM:SS.mmmZ, re-deriving the date only once per second
+ */
+class TimestampFormatter {
+public:
+    /**
+     * @param ms_since_epoch Milliseconds since 1970-01-01T00:00:00Z
+     * @param out Buffer of at least detail::timestamp_length chars
+     */
+    void format(int64_t ms_since_epoch, char* out) {
+        const int64_t seconds = detail::floor_div(ms_since_epoch, 1000);
+        if (seconds != cached_second_) {
+            detail::format_utc_seconds(seconds, prefix_);
+            cached_second_ = seconds;
+        }
+        std::memcpy(out, prefix_, sizeof(prefix_));
+        out[19] = '.';
+        detail::format_fixed(static_cast<uint32_t>(ms_since_epoch - seconds * 1000), 3, out + 20);
+        out[23] = 'Z';
+    }
+
+private:
+    int64_t cached_second_ = std::numeric_limits<int64_t>::min();
+    char prefix_[19] = {0};
+};
+
+} // namespace dts
+
+#endif // DTS_FORMAT_HPP
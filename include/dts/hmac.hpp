@@ -0,0 +1,92 @@
+/**
+ * @file hmac.hpp
+ * @brief HMAC-SHA256 and secure wiping of key material
+ *
+ * Shared by the keyed anonymizer and by watermark signatures.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_HMAC_HPP
+#define DTS_HMAC_HPP
+
+#include "sha256.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace dts {
+
+namespace detail {
+
+/// Zero @p size bytes in a way the compiler may not optimize away
+inline void secure_wipe(void* data, size_t size) {
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(data);
+    while (size--) *p++ = 0;
+}
+
+/// Zero the whole buffer of @p text, past its size too, and empty it
+inline void secure_wipe(std::string& text) {
+    text.resize(text.capacity());
+    secure_wipe(&text[0], text.size());
+    text.clear();
+}
+
+} // namespace detail
+
+/**
+ * @brief HMAC-SHA256 (RFC 2104) with the keyed pad states absorbed once
+ */
+class HmacSha256 {
+public:
+    explicit HmacSha256(std::string_view key) {
+        uint8_t block[64] = {0};
+        if (key.size() > sizeof(block)) {
+            const SHA256::Hash digest = SHA256::hash(
+                reinterpret_cast<const uint8_t*>(key.data()), key.size());
+            std::memcpy(block, digest.data(), digest.size());
+        } else if (!key.empty()) {
+            std::memcpy(block, key.data(), key.size());
+        }
+        uint8_t pad[64];
+        for (size_t i = 0; i < sizeof(pad); ++i) pad[i] = block[i] ^ 0x36;
+        inner_.update(pad, sizeof(pad));
+        for (size_t i = 0; i < sizeof(pad); ++i) pad[i] = block[i] ^ 0x5c;
+        outer_.update(pad, sizeof(pad));
+        detail::secure_wipe(block, sizeof(block));
+        detail::secure_wipe(pad, sizeof(pad));
+    }
+
+    ~HmacSha256() {
+        detail::secure_wipe(&inner_, sizeof(inner_));
+        detail::secure_wipe(&outer_, sizeof(outer_));
+    }
+
+    HmacSha256(const HmacSha256&) = default;
+    HmacSha256& operator=(const HmacSha256&) = default;
+
+    SHA256::Hash mac(const uint8_t* data, size_t len) const {
+        SHA256 inner = inner_;
+        inner.update(data, len);
+        const SHA256::Hash inner_hash = inner.finalize();
+        SHA256 outer = outer_;
+        outer.update(inner_hash.data(), inner_hash.size());
+        return outer.finalize();
+    }
+
+    SHA256::Hash mac(std::string_view data) const {
+        return mac(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+
+private:
+    SHA256 inner_;
+    SHA256 outer_;
+};
+
+} // namespace dts
+
+#endif // DTS_HMAC_HPP
@@ -0,0 +1,159 @@
+/**
+ * @file inclusion_proof.hpp
+ * @brief Inclusion proofs for single entries of a checkpointed chain
+ *
+ * The party holding the log builds a proof for one entry from the entries
+ * of its checkpoint window and the list of checkpoint roots. The recipient
+ * needs only the entry, the proof, and a trusted roots_root taken from a
+ * checkpoint entry; verification costs O(log n) hashes.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_INCLUSION_PROOF_HPP
+#define DTS_INCLUSION_PROOF_HPP
+
+#include "audit_chain.hpp"
+#include "entry_parser.hpp"
+#include "merkle.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dts {
+
+/**
+ * @brief Audit paths linking one entry to a checkpoint's tree of roots
+ */
+struct InclusionProof {
+    uint64_t sequence = 0;              ///< 1-based position of the entry in the chain
+    SHA256::Hash chain_hash{};          ///< The entry's chain_hash
+    uint64_t leaf_index = 0;            ///< Position within its checkpoint window
+    uint64_t leaf_count = 0;            ///< Entries in that window
+    std::vector<SHA256::Hash> leaf_path;
+    SHA256::Hash window_root{};         ///< Root recorded by the window's checkpoint
+    uint64_t checkpoint_index = 0;      ///< Index of that checkpoint
+    uint64_t checkpoint_count = 0;      ///< Checkpoints covered by roots_root
+    std::vector<SHA256::Hash> checkpoint_path;
+    SHA256::Hash roots_root{};          ///< roots= of checkpoint checkpoint_count - 1
+};
+
+/**
+ * @brief Check both audit paths against a trusted tree-of-roots root
+ */
+inline bool verify_inclusion_proof(const InclusionProof& proof,
+                                   const SHA256::Hash& trusted_roots_root) {
+    return proof.roots_root == trusted_roots_root &&
+           merkle::verify_inclusion(proof.chain_hash, proof.leaf_index, proof.leaf_count,
+                                    proof.leaf_path, proof.window_root) &&
+           merkle::verify_inclusion(proof.window_root, proof.checkpoint_index,
+                                    proof.checkpoint_count, proof.checkpoint_path,
+                                    proof.roots_root);
+}
+
+/**
+ * @brief Verify that a JSON entry is the one the proof covers
+ *
+ * The entry's chain_hash is recomputed from its fields, so an edited entry
+ * fails even if its stated chain_hash was left alone.
+ */
+inline bool verify_entry_inclusion(std::string_view entry, const InclusionProof& proof,
+                                   const SHA256::Hash& trusted_roots_root) {
+    EntryView view;
+    std::string payload;
+    SHA256::Hash stated;
+    if (!parse_entry(entry, view) || !detail::chain_payload(view, payload) ||
+        !detail::hex_decode(view.chain_hash.data(), stated.size(), stated.data())) {
+        return false;
+    }
+    return SHA256::hash(payload) == stated && stated == proof.chain_hash &&
+           verify_inclusion_proof(proof, trusted_roots_root);
+}
+
+/**
+ * @brief Build the proof for entry @p sequence from a JSON-lines log
+ *
+ * The log must start at the beginning of the chain. Only the leaves of the
+ * entry's own window and one root per checkpoint are held in memory. The
+ * proof is against the last checkpoint in the log.
+ * @return false if the entry is a checkpoint, lies after the last
+ *         checkpoint, or the log's checkpoints do not match its entries
+ */
+inline bool build_inclusion_proof(std::string_view log, uint64_t sequence,
+                                  InclusionProof& proof) {
+    std::vector<SHA256::Hash> window;
+    std::vector<SHA256::Hash> roots;
+    std::string message;
+    bool found = false;
+    bool closed = false;
+    uint64_t current = 0;
+
+    size_t start = 0;
+    while (start < log.size()) {
+        size_t end = log.find('\n', start);
+        if (end == std::string_view::npos) end = log.size();
+        std::string_view line = log.substr(start, end - start);
+        start = end + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+        ++current;
+
+        EntryView view;
+        SHA256::Hash chain_hash;
+        if (!parse_entry(line, view) ||
+            !detail::hex_decode(view.chain_hash.data(), 32, chain_hash.data())) {
+            return false;
+        }
+
+        Checkpoint checkpoint;
+        bool is_checkpoint = false;
+        if (view.user_id == static_cast<uint8_t>(UserID::System) &&
+            view.message.substr(0, sizeof(detail::checkpoint_prefix) - 1) ==
+                detail::checkpoint_prefix) {
+            message.clear();
+            is_checkpoint = unescape_json(view.message, message) &&
+                            parse_checkpoint_message(message, checkpoint);
+        }
+        if (!is_checkpoint) {
+            if (current == sequence) {
+                found = true;
+                proof.sequence = sequence;
+                proof.chain_hash = chain_hash;
+                proof.leaf_index = window.size();
+            }
+            if (!closed) window.push_back(chain_hash);
+            continue;
+        }
+
+        if (current == sequence || checkpoint.index != roots.size()) return false;
+        roots.push_back(checkpoint.root);
+        if (found && !closed) {
+            merkle::Tree tree(window);
+            if (checkpoint.count != window.size() || tree.root() != checkpoint.root) {
+                return false;
+            }
+            proof.leaf_count = window.size();
+            proof.leaf_path = tree.inclusion_proof(proof.leaf_index);
+            proof.window_root = checkpoint.root;
+            proof.checkpoint_index = checkpoint.index;
+            closed = true;
+        }
+        window.clear();
+        proof.roots_root = checkpoint.roots_root;
+    }
+    if (!closed) return false;
+
+    merkle::Tree roots_tree(roots);
+    if (roots_tree.root() != proof.roots_root) return false;
+    proof.checkpoint_count = roots.size();
+    proof.checkpoint_path = roots_tree.inclusion_proof(proof.checkpoint_index);
+    return true;
+}
+
+} // namespace dts
+
+#endif // DTS_INCLUSION_PROOF_HPP
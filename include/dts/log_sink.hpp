@@ -0,0 +1,574 @@
+/**
+ * @file log_sink.hpp
+ * @brief File sinks for chained audit entries
+ *
+ * FileSink appends synchronously. AsyncFileSink hands entries to a background
+ * writer that appends them in batches with a single vectored write and
+ * commits each batch with one fdatasync (group commit). Entries at or above
+ * the policy's sync severity force an immediate commit, and by default the
+ * logging thread waits until that entry is durable.
+ *
+ * Entries are written as JSON lines (one entry per line).
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_LOG_SINK_HPP
+#define DTS_LOG_SINK_HPP
+
+#include "audit_chain.hpp"
+#include "chain_state.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DTS_POSIX_IO 1
+#include <cerrno>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+namespace dts {
+
+namespace detail {
+
+/**
+ * @brief Append-only file handle with vectored writes and data sync
+ */
+class AppendFile {
+public:
+    struct Span {
+        const char* data;
+        size_t size;
+    };
+
+    AppendFile() = default;
+    explicit AppendFile(const std::string& path) { open(path); }
+    ~AppendFile() { close(); }
+
+    AppendFile(const AppendFile&) = delete;
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#if defined(DTS_POSIX_IO)
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0) error_ = errno;
+        return fd_ >= 0;
+#else
+        file_ = std::fopen(path.c_str(), "ab");
+        if (!file_) error_ = 1;
+        return file_ != nullptr;
+#endif
+    }
+
+    bool is_open() const {
+#if defined(DTS_POSIX_IO)
+        return fd_ >= 0;
+#else
+        return file_ != nullptr;
+#endif
+    }
+
+    void close() {
+#if defined(DTS_POSIX_IO)
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#else
+        if (file_) std::fclose(file_);
+        file_ = nullptr;
+#endif
+    }
+
+    /**
+     * @brief Append all spans in order, retrying partial writes
+     */
+    bool write(const Span* spans, size_t count) {
+        if (!is_open()) return false;
+#if DTS_ENABLE_METRICS
+        size_t bytes = 0;
+        for (size_t i = 0; i < count; ++i) bytes += spans[i].size;
+        DTS_METRICS_ADD(SinkWrites, 1);
+        DTS_METRICS_ADD(SinkBytes, bytes);
+#endif
+#if defined(DTS_POSIX_IO)
+        const size_t max_iov = IOV_MAX < 1024 ? IOV_MAX : 1024;
+        iovec iov[1024];
+        size_t index = 0;
+        size_t offset = 0;     // bytes of spans[index] already written
+        while (index < count) {
+            size_t n = 0;
+            for (size_t i = index; i < count && n < max_iov; ++i, ++n) {
+                const size_t skip = i == index ? offset : 0;
+                iov[n].iov_base = const_cast<char*>(spans[i].data + skip);
+                iov[n].iov_len = spans[i].size - skip;
+            }
+            ssize_t written = ::writev(fd_, iov, static_cast<int>(n));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                error_ = errno;
+                return false;
+            }
+            size_t remaining = static_cast<size_t>(written);
+            while (index < count && remaining >= spans[index].size - offset) {
+                remaining -= spans[index].size - offset;
+                offset = 0;
+                ++index;
+            }
+            offset += remaining;
+        }
+        return true;
+#else
+        for (size_t i = 0; i < count; ++i) {
+            if (std::fwrite(spans[i].data, 1, spans[i].size, file_) != spans[i].size) {
+                error_ = 1;
+                return false;
+            }
+        }
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Flush file data to stable storage
+     */
+    bool sync() {
+        if (!is_open()) return false;
+        DTS_METRICS_TIME(SinkSync);
+        DTS_METRICS_ADD(SinkSyncs, 1);
+#if defined(__APPLE__)
+        if (::fcntl(fd_, F_FULLFSYNC) == 0) return true;
+        if (::fsync(fd_) == 0) return true;
+        error_ = errno;
+        return false;
+#elif defined(DTS_POSIX_IO)
+        if (::fdatasync(fd_) == 0) return true;
+        error_ = errno;
+        return false;
+#else
+        if (std::fflush(file_) != 0) {
+            error_ = 1;
+            return false;
+        }
+#if defined(_WIN32)
+        if (_commit(_fileno(file_)) != 0) {
+            error_ = 1;
+            return false;
+        }
+#endif
+        return true;
+#endif
+    }
+
+    /// Current file size (the offset the next write lands at)
+    uint64_t size() const {
+#if defined(DTS_POSIX_IO)
+        if (fd_ < 0) return 0;
+        const off_t end = ::lseek(fd_, 0, SEEK_END);
+        return end < 0 ? 0 : static_cast<uint64_t>(end);
+#else
+        if (!file_) return 0;
+        std::fseek(file_, 0, SEEK_END);
+        const long end = std::ftell(file_);
+        return end < 0 ? 0 : static_cast<uint64_t>(end);
+#endif
+    }
+
+    /// Last OS error (errno on POSIX), 0 if none
+    int error() const { return error_; }
+
+private:
+#if defined(DTS_POSIX_IO)
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+    int error_ = 0;
+};
+
+/**
+ * @brief Follows the chain position of the entries a sink has appended
+ */
+class StateTracker {
+public:
+    void start(uint64_t log_offset) { state_.log_offset = log_offset; }
+
+    /// Adopt a recovered state; the log offset stays at the file's size
+    void seed(const ChainState& state) {
+        const uint64_t offset = state_.log_offset;
+        state_ = state;
+        state_.log_offset = offset;
+    }
+
+    void observe(std::string_view entry, const EntryInfo& info) {
+        if (state_.device_id != info.device_id) state_.device_id.assign(info.device_id);
+        state_.apply(info.sequence, info.timestamp_ms, info.chain_hash, info.message,
+                     info.user_id == UserID::System);
+        state_.log_offset += entry.size() + 1;
+        ++unsaved_;
+    }
+
+    const ChainState& state() const { return state_; }
+    uint64_t unsaved() const { return unsaved_; }
+    void mark_saved(uint64_t entries) { unsaved_ -= std::min(unsaved_, entries); }
+
+private:
+    ChainState state_;
+    uint64_t unsaved_ = 0;      ///< Entries observed since the last snapshot
+};
+
+} // namespace detail
+
+/**
+ * @brief When batched entries are committed to stable storage
+ */
+struct DurabilityPolicy {
+    /// Entries at or above this severity are committed immediately
+    Severity sync_severity = Severity::Critical;
+    /// Block the logging thread until such an entry is durable
+    bool wait_for_sync = true;
+    /// Commit once this many bytes are pending
+    size_t max_batch_bytes = 256 * 1024;
+    /// Commit once this many entries are pending
+    size_t max_batch_entries = 1024;
+    /// Commit no later than this after the first pending entry
+    std::chrono::milliseconds max_batch_delay{20};
+    /// fdatasync every batch (false: write only, sync on severity/flush)
+    bool sync_batches = true;
+    /// Write a ChainState snapshot here after syncs (empty: disabled)
+    std::string state_path;
+    /// Batched entries between snapshots; every forced sync (flush(), urgent
+    /// entries) and shutdown also writes one
+    uint64_t state_interval = 1024;
+};
+
+namespace detail {
+
+/// StateTracker::observe() for each entry of a LogSink::write_batch() buffer
+inline void observe_batch(StateTracker& tracker, std::string_view entries,
+                          const EntryInfo* infos, size_t count) {
+    size_t pos = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t end = entries.find('\n', pos);
+        tracker.observe(entries.substr(pos, end - pos), infos[i]);
+        pos = end + 1;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Synchronous JSON-lines file sink
+ *
+ * One vectored write per entry; data sync for entries at or above the
+ * policy's sync severity and on flush(). With a state_path, each of those
+ * syncs is followed by a chain-state snapshot.
+ */
+class FileSink : public LogSink {
+public:
+    explicit FileSink(const std::string& path, DurabilityPolicy policy = DurabilityPolicy())
+        : file_(path), policy_(std::move(policy)) {
+        tracker_.start(file_.size());
+    }
+
+    void write(std::string_view entry, const EntryInfo& info) override {
+        const detail::AppendFile::Span spans[2] = {{entry.data(), entry.size()}, {"\n", 1}};
+        const bool written = file_.write(spans, 2);
+        if (!policy_.state_path.empty() && written) tracker_.observe(entry, info);
+        if (info.severity >= policy_.sync_severity && file_.sync() && tracker_.unsaved() > 0) {
+            save_state();
+        }
+    }
+
+    /**
+     * @brief One write for the whole batch; one sync if any entry calls for it
+     */
+    void write_batch(std::string_view entries, const EntryInfo* infos, size_t count) override {
+        const detail::AppendFile::Span span{entries.data(), entries.size()};
+        const bool written = file_.write(&span, 1);
+        Severity highest = Severity::Debug;
+        for (size_t i = 0; i < count; ++i) highest = std::max(highest, infos[i].severity);
+        if (!policy_.state_path.empty() && written) {
+            detail::observe_batch(tracker_, entries, infos, count);
+        }
+        if (highest >= policy_.sync_severity && file_.sync() && tracker_.unsaved() > 0) {
+            save_state();
+        }
+    }
+
+    void flush() override {
+        if (file_.sync() && tracker_.unsaved() > 0) save_state();
+    }
+
+    /**
+     * @brief Continue snapshots from a recovered state (call before the first write)
+     */
+    void seed_state(const ChainState& state) { tracker_.seed(state); }
+
+    bool ok() const { return file_.is_open() && file_.error() == 0; }
+    int error() const { return file_.error(); }
+
+private:
+    detail::AppendFile file_;
+    DurabilityPolicy policy_;
+    detail::StateTracker tracker_;
+
+    void save_state() {
+        if (save_chain_state(policy_.state_path, tracker_.state())) {
+            tracker_.mark_saved(tracker_.unsaved());
+        }
+    }
+};
+
+/**
+ * @brief Background group-commit JSON-lines file sink
+ *
+ * write() copies the entry into a pending chunk and returns; a writer thread
+ * appends pending chunks with writev and commits them with one fdatasync.
+ */
+class AsyncFileSink : public LogSink {
+public:
+    explicit AsyncFileSink(const std::string& path, DurabilityPolicy policy = DurabilityPolicy())
+        : file_(path), policy_(std::move(policy)) {
+        tracker_.start(file_.size());
+        writer_ = std::thread([this] { run(); });
+    }
+
+    ~AsyncFileSink() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_writer_.notify_one();
+        writer_.join();
+    }
+
+    AsyncFileSink(const AsyncFileSink&) = delete;
+    AsyncFileSink& operator=(const AsyncFileSink&) = delete;
+
+    void write(std::string_view entry, const EntryInfo& info) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        append_locked(entry);
+        if (!policy_.state_path.empty()) tracker_.observe(entry, info);
+        accepted_locked(lock, 1, info.severity >= policy_.sync_severity);
+    }
+
+    /**
+     * @brief Queue the whole batch under one lock, as one pending copy
+     */
+    void write_batch(std::string_view entries, const EntryInfo* infos, size_t count) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        append_locked(entries, false);
+        if (!policy_.state_path.empty()) detail::observe_batch(tracker_, entries, infos, count);
+        bool urgent = false;
+        for (size_t i = 0; i < count; ++i) {
+            urgent = urgent || infos[i].severity >= policy_.sync_severity;
+        }
+        accepted_locked(lock, count, urgent);
+    }
+
+    /**
+     * @brief Write and commit everything accepted so far, then return
+     */
+    void flush() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const uint64_t ticket = appended_;
+        sync_requested_ = std::max(sync_requested_, ticket);
+        wake_writer_.notify_one();
+        durable_cv_.wait(lock, [&] { return durable_ >= ticket || failed_; });
+    }
+
+    /**
+     * @brief Continue snapshots from a recovered state (call before the first write)
+     */
+    void seed_state(const ChainState& state) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tracker_.seed(state);
+    }
+
+    /**
+     * @brief Entries accepted by write()
+     */
+    uint64_t appended_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return appended_;
+    }
+
+    /**
+     * @brief Entries committed to stable storage
+     */
+    uint64_t durable_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return durable_;
+    }
+
+    /**
+     * @brief Number of fdatasync calls issued (one per committed batch)
+     */
+    uint64_t sync_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return syncs_;
+    }
+
+    bool ok() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !failed_ && file_.is_open();
+    }
+
+private:
+    static constexpr size_t chunk_size = 64 * 1024;
+
+    detail::AppendFile file_;
+    DurabilityPolicy policy_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_writer_;
+    std::condition_variable durable_cv_;
+    std::vector<std::string> pending_;     ///< Chunks awaiting the writer
+    std::vector<std::string> spare_;       ///< Recycled chunks
+    size_t pending_bytes_ = 0;
+    uint64_t appended_ = 0;     ///< Entries accepted
+    uint64_t taken_ = 0;        ///< Entries handed to the writer
+    uint64_t written_ = 0;      ///< Entries written, possibly not yet synced
+    uint64_t durable_ = 0;      ///< Entries synced
+    uint64_t sync_requested_ = 0;
+    uint64_t syncs_ = 0;
+    bool stopping_ = false;
+    bool failed_ = false;
+    detail::StateTracker tracker_;      ///< Position after the last accepted entry
+    ChainState batch_state_;            ///< Position after the batch being written (writer only)
+    uint64_t unsaved_entries_ = 0;      ///< Durable entries not yet in a snapshot (writer only)
+    std::thread writer_;
+
+    /// Count @p entries just appended; wake the writer and wait as the policy says
+    void accepted_locked(std::unique_lock<std::mutex>& lock, uint64_t entries, bool urgent) {
+        const bool first = appended_ == taken_;
+        appended_ += entries;
+        const uint64_t ticket = appended_;
+        if (urgent) {
+            sync_requested_ = std::max(sync_requested_, ticket);
+        }
+        if (urgent || pending_bytes_ >= policy_.max_batch_bytes ||
+            appended_ - taken_ >= policy_.max_batch_entries || first) {
+            // First entry starts the batch timer; thresholds and urgent entries cut it short
+            wake_writer_.notify_one();
+        }
+        if (urgent && policy_.wait_for_sync) {
+            durable_cv_.wait(lock, [&] { return durable_ >= ticket || failed_; });
+        }
+    }
+
+    /// Copy @p entry into the pending chunks (@p newline: append '\n' after it)
+    void append_locked(std::string_view entry, bool newline = true) {
+        const size_t need = entry.size() + (newline ? 1 : 0);
+        if (pending_.empty() || pending_.back().size() + need > pending_.back().capacity()) {
+            std::string chunk;
+            if (!spare_.empty()) {
+                chunk = std::move(spare_.back());
+                spare_.pop_back();
+                chunk.clear();
+            }
+            chunk.reserve(std::max(chunk_size, need));
+            pending_.push_back(std::move(chunk));
+        }
+        pending_.back().append(entry.data(), entry.size());
+        if (newline) pending_.back().push_back('\n');
+        pending_bytes_ += need;
+    }
+
+    void run() {
+        std::vector<std::string> batch;
+        std::vector<detail::AppendFile::Span> spans;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_writer_.wait(lock, [&] { return stopping_ || appended_ > taken_ ||
+                                                 sync_requested_ > durable_; });
+            if (appended_ == taken_ && sync_requested_ <= durable_) {
+                if (!stopping_) continue;
+                if (!failed_ && written_ > durable_ && file_.sync()) {
+                    durable_ = written_;
+                    ++syncs_;
+                }
+                if (!failed_ && !policy_.state_path.empty() && durable_ == written_ &&
+                    unsaved_entries_ > 0) {
+                    lock.unlock();
+                    if (save_chain_state(policy_.state_path, batch_state_)) unsaved_entries_ = 0;
+                    lock.lock();
+                }
+                break;
+            }
+
+            // Hold the batch open until it fills, times out, or is forced
+            const auto deadline = std::chrono::steady_clock::now() + policy_.max_batch_delay;
+            wake_writer_.wait_until(lock, deadline, [&] {
+                return stopping_ || sync_requested_ > durable_ ||
+                       pending_bytes_ >= policy_.max_batch_bytes ||
+                       appended_ - taken_ >= policy_.max_batch_entries;
+            });
+
+            batch.swap(pending_);
+            const uint64_t batch_end = appended_;
+            const bool sync = policy_.sync_batches || sync_requested_ > durable_ || stopping_;
+            const bool track = !policy_.state_path.empty();
+            if (track) {
+                batch_state_ = tracker_.state();
+                unsaved_entries_ += tracker_.unsaved();
+                tracker_.mark_saved(tracker_.unsaved());
+            }
+            const bool save_now = sync_requested_ > durable_ || stopping_;
+            // After a failed write the file has a gap; nothing past it counts
+            const bool failed = failed_;
+            taken_ = batch_end;
+            pending_bytes_ = 0;
+            lock.unlock();
+
+            spans.clear();
+            for (const auto& chunk : batch) {
+                spans.push_back({chunk.data(), chunk.size()});
+            }
+            bool good = !failed && (spans.empty() || file_.write(spans.data(), spans.size()));
+            if (good && sync) good = file_.sync();
+            // Snapshots only ever describe data that is already durable
+            if (good && sync && track && unsaved_entries_ > 0 &&
+                (unsaved_entries_ >= policy_.state_interval || save_now) &&
+                save_chain_state(policy_.state_path, batch_state_)) {
+                unsaved_entries_ = 0;
+            }
+
+            lock.lock();
+            for (auto& chunk : batch) {
+                if (spare_.size() < 8) spare_.push_back(std::move(chunk));
+            }
+            batch.clear();
+            if (good) written_ = batch_end;
+            if (good && sync) {
+                durable_ = batch_end;
+                ++syncs_;
+            } else if (!good) {
+                // Waiters wake on failed_; drop their requests so the writer does not spin
+                failed_ = true;
+                sync_requested_ = durable_;
+            }
+            durable_cv_.notify_all();
+        }
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_LOG_SINK_HPP
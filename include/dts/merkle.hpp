@@ -0,0 +1,290 @@
+/**
+ * @file merkle.hpp
+ * @brief Merkle trees over chain hashes for compact inclusion proofs
+ *
+ * Trees follow RFC 6962 (Certificate Transparency): leaves are
+ * SHA-256(0x00 || chain_hash), interior nodes SHA-256(0x01 || left || right),
+ * and trees of any size split at the largest power of two below the size.
+ *
+ * AuditChain can emit a checkpoint entry every N entries carrying the root
+ * of those N chain hashes and the root of a second tree built over all
+ * checkpoint roots so far ("tree of roots"). An entry is then proven with
+ * two short audit paths instead of a replay from DTS_INIT.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_MERKLE_HPP
+#define DTS_MERKLE_HPP
+
+#include "format.hpp"
+#include "sha256.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dts {
+
+namespace merkle {
+
+using Hash = SHA256::Hash;
+
+inline Hash leaf_hash(const Hash& value) {
+    uint8_t buffer[33];
+    buffer[0] = 0x00;
+    std::memcpy(buffer + 1, value.data(), 32);
+    return SHA256::hash(buffer, sizeof(buffer));
+}
+
+inline Hash node_hash(const Hash& left, const Hash& right) {
+    uint8_t buffer[65];
+    buffer[0] = 0x01;
+    std::memcpy(buffer + 1, left.data(), 32);
+    std::memcpy(buffer + 33, right.data(), 32);
+    return SHA256::hash(buffer, sizeof(buffer));
+}
+
+/**
+ * @brief Root of an empty tree (SHA-256 of the empty string)
+ */
+inline Hash empty_root() {
+    return SHA256::hash(std::string());
+}
+
+/**
+ * @brief Streaming Merkle root over an unbounded sequence of leaves
+ *
+ * Keeps one perfect-subtree root per set bit of the leaf count, so memory
+ * is O(log n) and each append costs amortized O(1) node hashes.
+ */
+class Accumulator {
+public:
+    Accumulator() { frontier_.reserve(64); }
+
+    /**
+     * @brief Append a value; it is leaf-hashed here
+     */
+    void append(const Hash& value) {
+        Hash node = leaf_hash(value);
+        for (uint64_t n = size_; n & 1; n >>= 1) {
+            node = node_hash(frontier_.back(), node);
+            frontier_.pop_back();
+        }
+        frontier_.push_back(node);
+        ++size_;
+    }
+
+    Hash root() const {
+        if (frontier_.empty()) return empty_root();
+        Hash root = frontier_.back();
+        for (size_t i = frontier_.size() - 1; i > 0; --i) {
+            root = node_hash(frontier_[i - 1], root);
+        }
+        return root;
+    }
+
+    uint64_t size() const { return size_; }
+
+    void clear() {
+        frontier_.clear();
+        size_ = 0;
+    }
+
+    /**
+     * @brief Subtree roots, largest first (one per set bit of size())
+     */
+    const std::vector<Hash>& frontier() const { return frontier_; }
+
+    /**
+     * @brief Restore a saved state
+     * @param nodes frontier() of an accumulator of @p size leaves
+     * @return false if the node count does not match @p size
+     */
+    bool restore(uint64_t size, const std::vector<Hash>& nodes) {
+        size_t expected = 0;
+        for (uint64_t n = size; n; n &= n - 1) ++expected;
+        if (nodes.size() != expected) return false;
+        frontier_ = nodes;
+        size_ = size;
+        return true;
+    }
+
+private:
+    std::vector<Hash> frontier_;    ///< Subtree roots, largest first
+    uint64_t size_ = 0;
+};
+
+/**
+ * @brief Merkle tree held in memory, for producing audit paths
+ */
+class Tree {
+public:
+    Tree() = default;
+
+    /**
+     * @param values Leaf values (e.g., chain hashes); leaf-hashed here
+     */
+    explicit Tree(const std::vector<Hash>& values) {
+        leaves_.reserve(values.size());
+        for (const auto& value : values) leaves_.push_back(leaf_hash(value));
+    }
+
+    void append(const Hash& value) { leaves_.push_back(leaf_hash(value)); }
+
+    uint64_t size() const { return leaves_.size(); }
+
+    Hash root() const {
+        return leaves_.empty() ? empty_root() : subtree_root(0, leaves_.size());
+    }
+
+    /**
+     * @brief Audit path for leaf @p index, leaf level first
+     * @return Empty if @p index is out of range (or the tree has one leaf)
+     */
+    std::vector<Hash> inclusion_proof(uint64_t index) const {
+        std::vector<Hash> path;
+        if (index < leaves_.size()) build_path(index, 0, leaves_.size(), path);
+        return path;
+    }
+
+private:
+    std::vector<Hash> leaves_;
+
+    static size_t split_point(size_t n) {
+        size_t k = 1;
+        while (k * 2 < n) k *= 2;
+        return k;
+    }
+
+    Hash subtree_root(size_t begin, size_t end) const {
+        if (end - begin == 1) return leaves_[begin];
+        const size_t k = split_point(end - begin);
+        return node_hash(subtree_root(begin, begin + k), subtree_root(begin + k, end));
+    }
+
+    void build_path(size_t index, size_t begin, size_t end, std::vector<Hash>& path) const {
+        if (end - begin == 1) return;
+        const size_t k = split_point(end - begin);
+        if (index < begin + k) {
+            build_path(index, begin, begin + k, path);
+            path.push_back(subtree_root(begin + k, end));
+        } else {
+            build_path(index, begin + k, end, path);
+            path.push_back(subtree_root(begin, begin + k));
+        }
+    }
+};
+
+/**
+ * @brief Check an audit path (RFC 9162 section 2.1.3.2)
+ * @param value Leaf value (not yet leaf-hashed)
+ */
+inline bool verify_inclusion(const Hash& value, uint64_t index, uint64_t tree_size,
+                             const std::vector<Hash>& path, const Hash& root) {
+    if (index >= tree_size) return false;
+    uint64_t fn = index;
+    uint64_t sn = tree_size - 1;
+    Hash r = leaf_hash(value);
+    for (const auto& p : path) {
+        if (sn == 0) return false;
+        if ((fn & 1) || fn == sn) {
+            r = node_hash(p, r);
+            while (!(fn & 1) && fn != 0) {
+                fn >>= 1;
+                sn >>= 1;
+            }
+        } else {
+            r = node_hash(r, p);
+        }
+        fn >>= 1;
+        sn >>= 1;
+    }
+    return sn == 0 && r == root;
+}
+
+} // namespace merkle
+
+/**
+ * @brief Contents of a checkpoint entry
+ */
+struct Checkpoint {
+    uint64_t index = 0;             ///< 0-based checkpoint number
+    uint64_t first_sequence = 0;    ///< Sequence of the first entry covered
+    uint64_t count = 0;             ///< Entries covered (the tree's leaves)
+    SHA256::Hash root{};            ///< Root over the covered chain hashes
+    SHA256::Hash roots_root{};      ///< Root over checkpoint roots 0..index
+};
+
+namespace detail {
+
+static constexpr char checkpoint_prefix[] = "Merkle Checkpoint | ";
+
+/// Longest checkpoint message (three 20-digit counters)
+static constexpr size_t checkpoint_message_capacity = 256;
+
+/**
+ * @brief Render the message of a checkpoint entry
+ * @return Message length
+ */
+inline size_t format_checkpoint_message(const Checkpoint& checkpoint, char* out) {
+    CharWriter w{out};
+    w.literal(checkpoint_prefix);
+    w.literal("index=");
+    w.uint(checkpoint.index);
+    w.literal(" | first=");
+    w.uint(checkpoint.first_sequence);
+    w.literal(" | count=");
+    w.uint(checkpoint.count);
+    w.literal(" | root=");
+    hex_encode(checkpoint.root.data(), 32, w.pos);
+    w.pos += 64;
+    w.literal(" | roots=");
+    hex_encode(checkpoint.roots_root.data(), 32, w.pos);
+    w.pos += 64;
+    return static_cast<size_t>(w.pos - out);
+}
+
+} // namespace detail
+
+/**
+ * @brief Parse the (unescaped) message of a checkpoint entry
+ * @return false if @p message is not a checkpoint
+ */
+inline bool parse_checkpoint_message(std::string_view message, Checkpoint& checkpoint) {
+    std::string_view rest = message;
+    const std::string_view prefix(detail::checkpoint_prefix);
+    if (rest.substr(0, prefix.size()) != prefix) return false;
+    rest.remove_prefix(prefix.size());
+
+    auto number = [&rest](std::string_view key, uint64_t& value) {
+        if (rest.substr(0, key.size()) != key) return false;
+        rest.remove_prefix(key.size());
+        size_t n = 0;
+        value = 0;
+        while (n < rest.size() && n < 20 && rest[n] >= '0' && rest[n] <= '9') {
+            value = value * 10 + static_cast<uint64_t>(rest[n++] - '0');
+        }
+        rest.remove_prefix(n);
+        return n > 0;
+    };
+    auto hash = [&rest](std::string_view key, SHA256::Hash& value) {
+        if (rest.substr(0, key.size()) != key || rest.size() < key.size() + 64) return false;
+        rest.remove_prefix(key.size());
+        if (!detail::hex_decode(rest.data(), 32, value.data())) return false;
+        rest.remove_prefix(64);
+        return true;
+    };
+    return number("index=", checkpoint.index) &&
+           number(" | first=", checkpoint.first_sequence) &&
+           number(" | count=", checkpoint.count) &&
+           hash(" | root=", checkpoint.root) &&
+           hash(" | roots=", checkpoint.roots_root) && rest.empty();
+}
+
+} // namespace dts
+
+#endif // DTS_MERKLE_HPP
@@ -0,0 +1,127 @@
+/**
+ * @file message_builder.hpp
+ * @brief Allocation-free builder for structured event messages
+ *
+ * Domain adapters compose messages of the form
+ * "Event Name | Key:value | Key:value". MessageBuilder appends text and
+ * numbers into a buffer it keeps between messages, so once the buffer has
+ * grown to fit typical messages no heap allocation takes place. Numbers
+ * are formatted exactly as a default-configured std::ostream would.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_MESSAGE_BUILDER_HPP
+#define DTS_MESSAGE_BUILDER_HPP
+
+#include "format.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace dts {
+
+/**
+ * @brief Reusable "Name | Key:value" message buffer
+ */
+class MessageBuilder {
+public:
+    MessageBuilder() { buffer_.reserve(256); }
+
+    /**
+     * @brief Start a new message with @p name
+     */
+    MessageBuilder& begin(std::string_view name) {
+        buffer_.clear();
+        buffer_.append(name.data(), name.size());
+        return *this;
+    }
+
+    /**
+     * @brief Append " | key:value"
+     */
+    template <typename T>
+    MessageBuilder& field(std::string_view key, const T& value) {
+        buffer_.append(" | ", 3);
+        buffer_.append(key.data(), key.size());
+        buffer_.push_back(':');
+        return *this << value;
+    }
+
+    /**
+     * @brief Append " | key:value" unless @p value is empty
+     */
+    MessageBuilder& field_if(std::string_view key, std::string_view value) {
+        return value.empty() ? *this : field(key, value);
+    }
+
+    MessageBuilder& operator<<(std::string_view text) {
+        buffer_.append(text.data(), text.size());
+        return *this;
+    }
+
+    MessageBuilder& operator<<(const char* text) { return *this << std::string_view(text); }
+
+    MessageBuilder& operator<<(char c) {
+        buffer_.push_back(c);
+        return *this;
+    }
+
+    template <typename Int,
+              typename std::enable_if<std::is_integral<Int>::value &&
+                                      !std::is_same<Int, bool>::value &&
+                                      !std::is_same<Int, char>::value, int>::type = 0>
+    MessageBuilder& operator<<(Int value) {
+        char text[24];
+        size_t len = 0;
+        uint64_t magnitude = static_cast<uint64_t>(value);
+        if (std::is_signed<Int>::value && value < 0) {
+            text[len++] = '-';
+            magnitude = 0 - magnitude;
+        }
+        len += detail::format_uint(magnitude, text + len);
+        buffer_.append(text, len);
+        return *this;
+    }
+
+    /**
+     * @brief Shortest of fixed/scientific with 6 significant digits (%g)
+     */
+    MessageBuilder& operator<<(double value) {
+        char text[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        const auto result = std::to_chars(text, text + sizeof(text), value,
+                                          std::chars_format::general, 6);
+        buffer_.append(text, static_cast<size_t>(result.ptr - text));
+#else
+        const int len = std::snprintf(text, sizeof(text), "%g", value);
+        if (len > 0) buffer_.append(text, static_cast<size_t>(len));
+#endif
+        return *this;
+    }
+
+    /**
+     * @brief Append @p len bytes as lower-case hex
+     */
+    MessageBuilder& hex(const uint8_t* data, size_t len) {
+        const size_t offset = buffer_.size();
+        buffer_.resize(offset + len * 2);
+        detail::hex_encode(data, len, &buffer_[offset]);
+        return *this;
+    }
+
+    std::string_view view() const { return buffer_; }
+    size_t size() const { return buffer_.size(); }
+
+private:
+    std::string buffer_;
+};
+
+} // namespace dts
+
+#endif // DTS_MESSAGE_BUILDER_HPP
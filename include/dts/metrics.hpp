@@ -0,0 +1,514 @@
+/**
+ * @file metrics.hpp
+ * @brief Hot-path counters and latency histograms with a pull API
+ *
+ * Instrumentation is compiled in only when DTS_ENABLE_METRICS is defined
+ * to 1 (CMake option DTS_ENABLE_METRICS); otherwise the DTS_METRICS_*
+ * macros expand to nothing and the logging path is unchanged. Define it
+ * the same way in every translation unit of a program.
+ *
+ * Each thread updates its own block of counters and histograms with plain
+ * relaxed stores, so recording never contends. snapshot() sums all blocks,
+ * including those of threads that have exited. Histograms are log-linear
+ * (HDR-style): 8 sub-buckets per power of two, so any reported percentile
+ * is within 12.5% of the true value, from 1 ns up.
+ *
+ * Text exporters render a snapshot in the Prometheus exposition format or
+ * as StatsD lines.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_METRICS_HPP
+#define DTS_METRICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef DTS_ENABLE_METRICS
+#define DTS_ENABLE_METRICS 0
+#endif
+
+namespace dts {
+namespace metrics {
+
+enum class Counter : uint8_t {
+    EntriesLogged = 0,      ///< Entries chained by AuditChain
+    BytesLogged = 1,        ///< JSON bytes of those entries
+    SinkWrites = 2,         ///< Vectored writes issued by file sinks
+    SinkBytes = 3,          ///< Bytes written by file sinks
+    SinkSyncs = 4,          ///< Data syncs issued by file sinks
+    EntriesVerified = 5,    ///< Entries that passed verification
+    VerifyFailures = 6      ///< Verification calls that found a bad entry
+};
+
+constexpr size_t counter_count = 7;
+
+enum class Timer : uint8_t {
+    Log = 0,        ///< Hashing and formatting one entry
+    SinkWrite = 1,  ///< LogSink::write() of one entry
+    SinkSync = 2,   ///< One data sync (flush latency)
+    Verify = 3      ///< One verification call
+};
+
+constexpr size_t timer_count = 4;
+
+constexpr std::string_view counter_name(Counter counter) {
+    constexpr std::string_view names[counter_count] = {
+        "entries_logged", "logged_bytes", "sink_writes", "sink_bytes", "sink_syncs",
+        "verified_entries", "verify_failures"};
+    return names[static_cast<size_t>(counter)];
+}
+
+constexpr std::string_view timer_name(Timer timer) {
+    constexpr std::string_view names[timer_count] = {
+        "log_latency", "sink_write_latency", "sink_sync_latency", "verify_latency"};
+    return names[static_cast<size_t>(timer)];
+}
+
+/**
+ * @brief Bucket layout of the log-linear latency histograms (values in ns)
+ */
+struct Buckets {
+    static constexpr unsigned sub_bits = 3;
+    static constexpr uint64_t sub_count = uint64_t{1} << sub_bits;
+    static constexpr size_t count = (64 - sub_bits + 1) * sub_count;
+
+    static size_t index(uint64_t value) {
+        if (value < sub_count) return static_cast<size_t>(value);
+        unsigned msb = 63;
+        while (!(value >> msb)) --msb;
+        const unsigned shift = msb - sub_bits;
+        return (static_cast<size_t>(shift + 1) << sub_bits) +
+               static_cast<size_t>((value >> shift) & (sub_count - 1));
+    }
+
+    static uint64_t lower(size_t index) {
+        if (index < sub_count) return index;
+        const unsigned shift = static_cast<unsigned>(index >> sub_bits) - 1;
+        return ((index & (sub_count - 1)) | sub_count) << shift;
+    }
+
+    /// Largest value mapped to @p index
+    static uint64_t upper(size_t index) {
+        if (index < sub_count) return index;
+        const unsigned shift = static_cast<unsigned>(index >> sub_bits) - 1;
+        return lower(index) + ((uint64_t{1} << shift) - 1);
+    }
+};
+
+/**
+ * @brief Summed state of one histogram
+ */
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+    std::vector<uint64_t> buckets = std::vector<uint64_t>(Buckets::count, 0);
+
+    uint64_t mean_ns() const { return count ? sum_ns / count : 0; }
+
+    /**
+     * @brief Upper bound of the bucket holding quantile @p q (0..1), capped at max_ns
+     */
+    uint64_t percentile_ns(double q) const {
+        if (count == 0) return 0;
+        const double clamped = std::min(std::max(q, 0.0), 1.0);
+        uint64_t rank = static_cast<uint64_t>(clamped * static_cast<double>(count) + 0.5);
+        rank = std::min(std::max<uint64_t>(rank, 1), count);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::min(Buckets::upper(i), max_ns);
+        }
+        return max_ns;
+    }
+};
+
+/**
+ * @brief Instantaneous value published by a component (e.g., queue depth)
+ */
+struct GaugeValue {
+    std::string name;
+    std::string device;     ///< Device label; empty if process-wide
+    double value;
+};
+
+/**
+ * @brief Totals of every counter, histogram and gauge at one point in time
+ */
+struct Snapshot {
+    std::array<uint64_t, counter_count> counters{};
+    std::array<HistogramSnapshot, timer_count> timers;
+    std::vector<GaugeValue> gauges;
+
+    uint64_t counter(Counter c) const { return counters[static_cast<size_t>(c)]; }
+    const HistogramSnapshot& timer(Timer t) const { return timers[static_cast<size_t>(t)]; }
+
+    /**
+     * @brief Activity since @p earlier (counters and histograms; gauges as of now)
+     *
+     * max_ns keeps the all-time maximum; the histogram buckets are exact.
+     */
+    Snapshot since(const Snapshot& earlier) const {
+        Snapshot delta = *this;
+        for (size_t i = 0; i < counter_count; ++i) delta.counters[i] -= earlier.counters[i];
+        for (size_t t = 0; t < timer_count; ++t) {
+            delta.timers[t].count -= earlier.timers[t].count;
+            delta.timers[t].sum_ns -= earlier.timers[t].sum_ns;
+            for (size_t i = 0; i < Buckets::count; ++i) {
+                delta.timers[t].buckets[i] -= earlier.timers[t].buckets[i];
+            }
+        }
+        return delta;
+    }
+};
+
+namespace detail {
+
+/// Single-writer increment; readers on other threads see whole values
+inline void bump(std::atomic<uint64_t>& cell, uint64_t n) {
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+struct Histogram {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::array<std::atomic<uint64_t>, Buckets::count> buckets{};
+
+    void record(uint64_t ns) {
+        bump(count, 1);
+        bump(sum_ns, ns);
+        if (ns > max_ns.load(std::memory_order_relaxed)) {
+            max_ns.store(ns, std::memory_order_relaxed);
+        }
+        bump(buckets[Buckets::index(ns)], 1);
+    }
+
+    void add_to(HistogramSnapshot& out) const {
+        out.count += count.load(std::memory_order_relaxed);
+        out.sum_ns += sum_ns.load(std::memory_order_relaxed);
+        out.max_ns = std::max(out.max_ns, max_ns.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < Buckets::count; ++i) {
+            out.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+/// Metrics of one thread; reused by a later thread once its owner exits
+struct Block {
+    std::array<std::atomic<uint64_t>, counter_count> counters{};
+    std::array<Histogram, timer_count> timers;
+    bool in_use = false;    ///< Guarded by Registry::mutex_
+};
+
+class Registry {
+public:
+    /// Never destroyed, so thread exit and static destruction may run in any order
+    static Registry& instance() {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    Block* acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& block : blocks_) {
+            if (!block->in_use) {
+                block->in_use = true;
+                return block.get();
+            }
+        }
+        blocks_.emplace_back(new Block());
+        blocks_.back()->in_use = true;
+        return blocks_.back().get();
+    }
+
+    void release(Block* block) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        block->in_use = false;
+    }
+
+    uint64_t add_gauge(std::string name, std::string device, std::function<double()> read) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        gauges_.push_back(Gauge{++last_gauge_, std::move(name), std::move(device),
+                                std::move(read)});
+        return last_gauge_;
+    }
+
+    void remove_gauge(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        gauges_.erase(std::remove_if(gauges_.begin(), gauges_.end(),
+                                     [id](const Gauge& gauge) { return gauge.id == id; }),
+                      gauges_.end());
+    }
+
+    Snapshot snapshot() {
+        Snapshot out;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& block : blocks_) {
+            for (size_t i = 0; i < counter_count; ++i) {
+                out.counters[i] += block->counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t t = 0; t < timer_count; ++t) block->timers[t].add_to(out.timers[t]);
+        }
+        for (const auto& gauge : gauges_) {
+            out.gauges.push_back(GaugeValue{gauge.name, gauge.device, gauge.read()});
+        }
+        return out;
+    }
+
+private:
+    struct Gauge {
+        uint64_t id;
+        std::string name;
+        std::string device;
+        std::function<double()> read;
+    };
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Block>> blocks_;
+    std::vector<Gauge> gauges_;
+    uint64_t last_gauge_ = 0;
+};
+
+/// The calling thread's block, acquired on first use
+inline Block& local_block() {
+    struct Owner {
+        Block* block = Registry::instance().acquire();
+        ~Owner() { Registry::instance().release(block); }
+    };
+    thread_local Owner owner;
+    return *owner.block;
+}
+
+inline uint64_t steady_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace detail
+
+/**
+ * @brief Add @p n to a counter of the calling thread
+ */
+inline void add(Counter counter, uint64_t n = 1) {
+    detail::bump(detail::local_block().counters[static_cast<size_t>(counter)], n);
+}
+
+/**
+ * @brief Record one latency sample
+ */
+inline void record(Timer timer, uint64_t ns) {
+    detail::local_block().timers[static_cast<size_t>(timer)].record(ns);
+}
+
+/**
+ * @brief Records the lifetime of the scope into a histogram
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Timer timer) : timer_(timer), start_(detail::steady_ns()) {}
+    ~ScopedTimer() { record(timer_, detail::steady_ns() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Timer timer_;
+    uint64_t start_;
+};
+
+/**
+ * @brief Publishes a gauge for as long as the handle lives
+ *
+ * @p read is called from snapshot(), on the caller's thread; it must be
+ * safe to call concurrently with the component it observes.
+ */
+class GaugeHandle {
+public:
+    GaugeHandle() = default;
+
+    GaugeHandle(std::string name, std::string device, std::function<double()> read)
+        : id_(detail::Registry::instance().add_gauge(std::move(name), std::move(device),
+                                                     std::move(read))) {}
+
+    ~GaugeHandle() { reset(); }
+
+    GaugeHandle(GaugeHandle&& other) noexcept : id_(other.id_) { other.id_ = 0; }
+
+    GaugeHandle& operator=(GaugeHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            id_ = other.id_;
+            other.id_ = 0;
+        }
+        return *this;
+    }
+
+    void reset() {
+        if (id_ != 0) detail::Registry::instance().remove_gauge(id_);
+        id_ = 0;
+    }
+
+private:
+    uint64_t id_ = 0;
+};
+
+/**
+ * @brief Current totals over all threads (all zero if instrumentation is compiled out)
+ */
+inline Snapshot snapshot() {
+    return detail::Registry::instance().snapshot();
+}
+
+namespace detail {
+
+inline void append_number(std::string& out, double value) {
+    char text[32];
+    const int len = std::snprintf(text, sizeof(text), "%.9g", value);
+    if (len > 0) out.append(text, static_cast<size_t>(len));
+}
+
+inline void append_uint(std::string& out, uint64_t value) {
+    out += std::to_string(value);
+}
+
+/// Append @p text with Prometheus label-value escaping
+inline void append_label(std::string& out, std::string_view text) {
+    for (char c : text) {
+        if (c == '\\' || c == '"') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out.push_back(c);
+        }
+    }
+}
+
+constexpr double exported_quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+} // namespace detail
+
+/**
+ * @brief Append @p snapshot in the Prometheus text exposition format
+ *
+ * Counters become <prefix>_<name>_total, latencies become summaries in
+ * seconds (p50/p90/p99/p99.9 quantiles, _sum and _count) and gauges carry
+ * a device label.
+ */
+inline void write_prometheus(const Snapshot& snapshot, std::string& out,
+                             std::string_view prefix = "dts") {
+    for (size_t i = 0; i < counter_count; ++i) {
+        const std::string name = std::string(prefix) + "_" +
+                                 std::string(counter_name(static_cast<Counter>(i))) + "_total";
+        out += "# TYPE " + name + " counter\n" + name + " ";
+        detail::append_uint(out, snapshot.counters[i]);
+        out.push_back('\n');
+    }
+    for (size_t t = 0; t < timer_count; ++t) {
+        const HistogramSnapshot& timer = snapshot.timers[t];
+        const std::string name = std::string(prefix) + "_" +
+                                 std::string(timer_name(static_cast<Timer>(t))) + "_seconds";
+        out += "# TYPE " + name + " summary\n";
+        for (double q : detail::exported_quantiles) {
+            out += name + "{quantile=\"";
+            detail::append_number(out, q);
+            out += "\"} ";
+            detail::append_number(out, static_cast<double>(timer.percentile_ns(q)) * 1e-9);
+            out.push_back('\n');
+        }
+        out += name + "_sum ";
+        detail::append_number(out, static_cast<double>(timer.sum_ns) * 1e-9);
+        out += "\n" + name + "_count ";
+        detail::append_uint(out, timer.count);
+        out.push_back('\n');
+    }
+    std::string typed;
+    for (const auto& gauge : snapshot.gauges) {
+        const std::string name = std::string(prefix) + "_" + gauge.name;
+        if (typed.find("|" + name + "|") == std::string::npos) {
+            out += "# TYPE " + name + " gauge\n";
+            typed += "|" + name + "|";
+        }
+        out += name;
+        if (!gauge.device.empty()) {
+            out += "{device=\"";
+            detail::append_label(out, gauge.device);
+            out += "\"}";
+        }
+        out.push_back(' ');
+        detail::append_number(out, gauge.value);
+        out.push_back('\n');
+    }
+}
+
+/**
+ * @brief Append StatsD lines for the activity between two snapshots
+ *
+ * Counters are sent as deltas (|c); latency percentiles of the interval
+ * (in microseconds) and gauges are sent as |g values.
+ */
+inline void write_statsd(const Snapshot& current, const Snapshot& previous,
+                         std::string& out, std::string_view prefix = "dts") {
+    const Snapshot delta = current.since(previous);
+    for (size_t i = 0; i < counter_count; ++i) {
+        out += std::string(prefix) + "." + std::string(counter_name(static_cast<Counter>(i))) +
+               ":";
+        detail::append_uint(out, delta.counters[i]);
+        out += "|c\n";
+    }
+    static constexpr const char* labels[] = {"p50", "p90", "p99", "p999"};
+    for (size_t t = 0; t < timer_count; ++t) {
+        const HistogramSnapshot& timer = delta.timers[t];
+        if (timer.count == 0) continue;
+        const std::string name = std::string(prefix) + "." +
+                                 std::string(timer_name(static_cast<Timer>(t))) + "_us.";
+        for (size_t q = 0; q < std::size(detail::exported_quantiles); ++q) {
+            out += name + labels[q] + ":";
+            detail::append_number(
+                out, static_cast<double>(timer.percentile_ns(detail::exported_quantiles[q])) / 1e3);
+            out += "|g\n";
+        }
+    }
+    for (const auto& gauge : current.gauges) {
+        out += std::string(prefix) + "." + gauge.name;
+        if (!gauge.device.empty()) out += "." + gauge.device;
+        out.push_back(':');
+        detail::append_number(out, gauge.value);
+        out += "|g\n";
+    }
+}
+
+} // namespace metrics
+} // namespace dts
+
+#if DTS_ENABLE_METRICS
+#define DTS_METRICS_CONCAT_(a, b) a##b
+#define DTS_METRICS_CONCAT(a, b) DTS_METRICS_CONCAT_(a, b)
+/// Add @p n to counter dts::metrics::Counter::@p name
+#define DTS_METRICS_ADD(name, n) ::dts::metrics::add(::dts::metrics::Counter::name, (n))
+/// Time the rest of the enclosing scope into dts::metrics::Timer::@p name
+#define DTS_METRICS_TIME(name) \
+    ::dts::metrics::ScopedTimer DTS_METRICS_CONCAT(dts_metrics_timer_, __LINE__)( \
+        ::dts::metrics::Timer::name)
+#else
+#define DTS_METRICS_ADD(name, n) ((void)0)
+#define DTS_METRICS_TIME(name) ((void)0)
+#endif
+
+#endif // DTS_METRICS_HPP
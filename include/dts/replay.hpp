@@ -0,0 +1,295 @@
+/**
+ * @file replay.hpp
+ * @brief Deterministic replay: regenerate a chain byte for byte from recorded inputs
+ *
+ * An entry depends only on the device ID, its timestamp, user, severity
+ * and message, and the previous hash. AuditChain reads its timestamps
+ * from an injectable ClockSource. ReplayEngine feeds recorded timestamps
+ * through log_at() instead, so the same inputs give the same bytes on any
+ * machine and in any run.
+ *
+ * replay_log() takes such inputs from an existing log. It regenerates
+ * every entry and requires the result to equal the stored line exactly.
+ * That is stricter than verify_buffer() with recompute: hashes, field
+ * order, escaping and formatting must all match. Large logs are cut into
+ * segments that are replayed on separate threads. Each segment is seeded
+ * from the previous_hash of its first line, and the segments are stitched
+ * together afterwards, as in verify_buffer().
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_REPLAY_HPP
+#define DTS_REPLAY_HPP
+
+#include "audit_chain.hpp"
+#include "chain_verifier.hpp"
+#include "entry_parser.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dts {
+
+/**
+ * @brief Inputs of one entry as originally logged
+ */
+struct RecordedEvent {
+    int64_t timestamp_ms = 0;           ///< Milliseconds since the Unix epoch
+    std::string_view message;
+    UserID user_id = UserID::System;
+    Severity severity = Severity::Info;
+};
+
+/**
+ * @brief Rebuilds a chain from recorded events, independent of any clock
+ */
+class ReplayEngine {
+public:
+    explicit ReplayEngine(std::string_view device_id, uint64_t checkpoint_interval = 0)
+        : chain_(device_id) {
+        chain_.set_checkpoint_interval(checkpoint_interval);
+    }
+
+    /**
+     * @brief Continue after @p state, checkpoint windows included
+     */
+    explicit ReplayEngine(const ChainState& state, uint64_t checkpoint_interval = 0)
+        : chain_(state) {
+        chain_.set_checkpoint_interval(checkpoint_interval);
+    }
+
+    /**
+     * @brief Append one JSON entry per event to @p out, each followed by '\n'
+     *
+     * Checkpoints fall due as in the original chain and are appended after
+     * the entry that completed their window.
+     * @return Entries appended (events plus checkpoints)
+     */
+    size_t replay(std::string& out, const RecordedEvent* events, size_t count) {
+        size_t appended = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const RecordedEvent& event = events[i];
+            chain_.replay_at(entry_, event.timestamp_ms, event.message, event.user_id,
+                             event.severity);
+            out.append(entry_).push_back('\n');
+            ++appended;
+            if (chain_.take_checkpoint(entry_)) {
+                out.append(entry_).push_back('\n');
+                ++appended;
+            }
+        }
+        return appended;
+    }
+
+    size_t replay(std::string& out, const std::vector<RecordedEvent>& events) {
+        return replay(out, events.data(), events.size());
+    }
+
+    const AuditChain& chain() const { return chain_; }
+
+private:
+    AuditChain chain_;
+    std::string entry_;
+};
+
+struct ReplayOptions {
+    /// Worker threads (0: hardware concurrency); one when checkpoints are regenerated
+    unsigned threads = 1;
+    /// Segments are never smaller than this
+    size_t min_segment_bytes = 4 * 1024 * 1024;
+    /// Chain position before the first line (device_id is taken from the log)
+    ChainState start;
+    /**
+     * Checkpoint interval of the original chain. When set, checkpoint lines
+     * are regenerated from the entries before them rather than replayed as
+     * recorded, which also re-derives their Merkle roots; @c start must then
+     * carry the checkpoint state of the chain at that point.
+     */
+    uint64_t checkpoint_interval = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief Replay the lines of [begin, end) and compare them with the regenerated entries
+ *
+ * BrokenLink: a line's previous_hash is not the regenerated chain's;
+ * HashMismatch: it links correctly but its bytes differ.
+ * @param anchored Seed from @p start; otherwise from the first line's previous_hash
+ */
+inline VerifyResult replay_lines(const char* begin, const char* end, size_t base,
+                                 const ChainState& start, uint64_t checkpoint_interval,
+                                 bool anchored) {
+    VerifyResult result;
+    result.first_previous_hash = start.last_hash;
+    result.last_hash = start.last_hash;
+    std::unique_ptr<AuditChain> chain;
+    std::string device;
+    std::string message;
+    std::string entry;
+    std::string checkpoint;
+    bool checkpoint_due = false;
+    EntryView view;
+
+    auto fail = [&result](VerifyStatus status, size_t offset) {
+        result.status = status;
+        result.failed_entry = result.entries + 1;
+        result.failed_offset = offset;
+        return result;
+    };
+    // The line parsed but differs from the regenerated entry
+    auto differs = [&](size_t offset) {
+        SHA256::Hash linked;
+        if (!hex_decode(view.previous_hash.data(), linked.size(), linked.data())) {
+            return fail(VerifyStatus::Malformed, offset);
+        }
+        return fail(linked == result.last_hash ? VerifyStatus::HashMismatch
+                                               : VerifyStatus::BrokenLink, offset);
+    };
+
+    const char* p = begin;
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(
+            std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!line_end) line_end = end;
+        const char* text_end = line_end;
+        if (text_end > p && text_end[-1] == '\r') --text_end;
+        const std::string_view line(p, static_cast<size_t>(text_end - p));
+        const size_t offset = base + static_cast<size_t>(p - begin);
+        p = line_end + 1;
+        if (line.empty()) continue;
+
+        int64_t timestamp_ms = 0;
+        if (!parse_entry(line, view) || view.user_id > 0xFF || view.severity > 0xFF ||
+            !parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(), timestamp_ms)) {
+            return fail(VerifyStatus::Malformed, offset);
+        }
+        if (!chain) {
+            ChainState state = start;
+            if (!unescape_json(view.device_id, device)) return fail(VerifyStatus::Malformed, offset);
+            state.device_id = device;
+            if (!anchored &&
+                !hex_decode(view.previous_hash.data(), state.last_hash.size(), state.last_hash.data())) {
+                return fail(VerifyStatus::Malformed, offset);
+            }
+            result.first_previous_hash = state.last_hash;
+            result.last_hash = state.last_hash;
+            chain.reset(new AuditChain(state));
+            chain->set_checkpoint_interval(checkpoint_interval);
+        }
+
+        if (checkpoint_due) {
+            checkpoint_due = false;
+            if (line != checkpoint) return differs(offset);
+        } else {
+            message.clear();
+            if (!unescape_json(view.message, message)) return fail(VerifyStatus::Malformed, offset);
+            Checkpoint recorded;
+            if (checkpoint_interval && view.user_id == static_cast<uint8_t>(UserID::System) &&
+                parse_checkpoint_message(message, recorded)) {
+                return differs(offset);     // a checkpoint where none is due
+            }
+            chain->replay_at(entry, timestamp_ms, message, static_cast<UserID>(view.user_id),
+                             static_cast<Severity>(view.severity));
+            if (line != entry) return differs(offset);
+            checkpoint_due = chain->take_checkpoint(checkpoint);
+        }
+        // Identical bytes, so the stored chain_hash is the regenerated one
+        hex_decode(view.chain_hash.data(), result.last_hash.size(), result.last_hash.data());
+        ++result.entries;
+    }
+    if (checkpoint_due) {
+        // The log ends where a checkpoint was due
+        result.status = VerifyStatus::BrokenLink;
+        result.failed_entry = result.entries + 1;
+        result.failed_offset = base + static_cast<size_t>(end - begin);
+    }
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Regenerate a JSON-lines log from its own inputs and compare byte for byte
+ * @return As verify_buffer(); failed_entry is the first line that is not reproduced
+ */
+inline VerifyResult replay_log(std::string_view log, const ReplayOptions& options = ReplayOptions()) {
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    if (options.checkpoint_interval) threads = 1;
+    const size_t min_segment = std::max<size_t>(options.min_segment_bytes, 1);
+    const size_t max_segments = std::max<size_t>(log.size() / min_segment, 1);
+    const size_t segments = std::min<size_t>(std::max(threads, 1u), max_segments);
+
+    std::vector<size_t> bounds(segments + 1, log.size());
+    bounds[0] = 0;
+    for (size_t i = 1; i < segments; ++i) {
+        const size_t cut = std::max(log.size() * i / segments, bounds[i - 1]);
+        const size_t newline = log.find('\n', cut);
+        bounds[i] = newline == std::string_view::npos ? log.size() : newline + 1;
+    }
+
+    std::vector<VerifyResult> parts(segments);
+    auto run = [&](size_t i) {
+        parts[i] = detail::replay_lines(log.data() + bounds[i], log.data() + bounds[i + 1],
+                                        bounds[i], options.start, options.checkpoint_interval,
+                                        i == 0);
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(segments - 1);
+    for (size_t i = 1; i < segments; ++i) workers.emplace_back(run, i);
+    run(0);
+    for (auto& worker : workers) worker.join();
+
+    // Stitch segments together in log order
+    VerifyResult total;
+    total.first_previous_hash = options.start.last_hash;
+    total.last_hash = options.start.last_hash;
+    for (size_t i = 0; i < segments; ++i) {
+        const VerifyResult& part = parts[i];
+        if (part.entries > 0 && part.first_previous_hash != total.last_hash) {
+            total.status = VerifyStatus::BrokenLink;
+            total.failed_entry = total.entries + 1;
+            total.failed_offset = bounds[i];
+            return total;
+        }
+        if (!part.ok()) {
+            total.status = part.status;
+            total.failed_entry = total.entries + part.failed_entry;
+            total.failed_offset = part.failed_offset;
+            total.entries += part.entries;
+            return total;
+        }
+        if (part.entries > 0) total.last_hash = part.last_hash;
+        total.entries += part.entries;
+    }
+    return total;
+}
+
+/**
+ * @brief Replay a JSON-lines log file
+ * @param ok Set to false if the file could not be read
+ */
+inline VerifyResult replay_file(const std::string& path, const ReplayOptions& options = ReplayOptions(),
+                                bool* ok = nullptr) {
+    MappedFile file(path);
+    if (ok) *ok = file.ok();
+    if (!file.ok()) {
+        VerifyResult result;
+        result.status = VerifyStatus::Malformed;
+        result.failed_entry = 1;
+        return result;
+    }
+    return replay_log(file.view(), options);
+}
+
+} // namespace dts
+
+#endif // DTS_REPLAY_HPP
@@ -0,0 +1,809 @@
+/**
+ * @file segmented_log.hpp
+ * @brief Rotating segmented log store with a sequence/time sidecar index
+ *
+ * SegmentedLogSink writes one chain's JSON lines into a directory of
+ * segment files, each named after the sequence number of its first entry:
+ *
+ * @code
+ * audit/00000000000000000001.log   JSON lines, as FileSink writes them
+ * audit/00000000000000000001.idx   "DTSIDX01", hash before the first entry,
+ *                                  then one 48-byte record per index block
+ * audit/00000000000000052114.log
+ * ...
+ * @endcode
+ *
+ * A segment is closed when the next entry would push it past
+ * SegmentOptions::max_segment_bytes or when its first entry is older than
+ * max_segment_age (by entry timestamps). The chain simply continues into
+ * the next segment; its index header records the hash the first entry
+ * links to, so any suffix of segments verifies on its own after old ones
+ * are removed (max_segments).
+ *
+ * Each index record covers a block of up to index_interval consecutive
+ * entries: first sequence, entry count, byte range, and the lowest and
+ * highest timestamp in the block. SegmentedLogReader uses it to answer
+ * sequence and time-range queries by reading only matching blocks.
+ * Entries written after the last index record (at most one block, or
+ * more after a crash) are found by scanning the segment tail.
+ *
+ * With SegmentOptions::compress_sealed, a segment is compressed when the
+ * sink moves on from it: each index block becomes one independently
+ * decodable block of a .lz file (dts/compression.hpp), and the index is
+ * rewritten as "DTSIDX02" with the packed byte range of every block and the
+ * ID of the dictionary used, stored once per store as <id>.dict. The .log
+ * is deleted last, so a crash at any point leaves a readable segment; while
+ * both files exist the .log is used.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_SEGMENTED_LOG_HPP
+#define DTS_SEGMENTED_LOG_HPP
+
+#include "audit_chain.hpp"
+#include "chain_state.hpp"
+#include "chain_verifier.hpp"
+#include "compression.hpp"
+#include "entry_parser.hpp"
+#include "log_sink.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace dts {
+
+struct SegmentOptions {
+    uint64_t max_segment_bytes = 64 * 1024 * 1024;  ///< Rotate before exceeding this
+    std::chrono::milliseconds max_segment_age{0};   ///< 0: rotate by size only
+    size_t max_segments = 0;                        ///< Delete the oldest beyond this; 0 keeps all
+    uint32_t index_interval = 64;                   ///< Entries per index record
+    Severity sync_severity = Severity::Critical;    ///< Sync log and index at or above this
+    bool compress_sealed = false;                   ///< Compress segments once they are closed
+    std::string dictionary;                         ///< Optional preset dictionary (train_dictionary)
+};
+
+/**
+ * @brief One index record: a run of consecutive entries within a segment
+ */
+struct IndexBlock {
+    uint64_t first_sequence = 0;
+    uint64_t count = 0;
+    uint64_t offset = 0;                ///< Byte offset of the first entry in the segment
+    uint64_t bytes = 0;                 ///< Bytes of the run, newlines included
+    int64_t min_timestamp_ms = std::numeric_limits<int64_t>::max();
+    int64_t max_timestamp_ms = std::numeric_limits<int64_t>::min();
+    uint64_t packed_offset = 0;         ///< Compressed segments: offset in the .lz file
+    uint64_t packed_bytes = 0;          ///< Compressed segments: compressed size
+
+    void add(uint64_t sequence, int64_t timestamp_ms, uint64_t length) {
+        if (count == 0) first_sequence = sequence;
+        ++count;
+        bytes += length;
+        min_timestamp_ms = std::min(min_timestamp_ms, timestamp_ms);
+        max_timestamp_ms = std::max(max_timestamp_ms, timestamp_ms);
+    }
+};
+
+/**
+ * @brief A segment as found on disk
+ */
+struct SegmentInfo {
+    std::string log_path;
+    std::string index_path;
+    std::string packed_path;                ///< .lz file, read when the .log is gone
+    bool packed = false;                    ///< Read from packed_path
+    uint64_t dictionary_id = 0;             ///< Dictionary the blocks were compressed with
+    uint64_t first_sequence = 0;
+    SHA256::Hash first_previous_hash{};     ///< Hash the segment's first entry links to
+    std::vector<IndexBlock> blocks;         ///< Indexed blocks, then the scanned tail if any
+    size_t indexed_blocks = 0;              ///< Leading blocks that come from the index file
+    uint64_t size = 0;                      ///< Bytes of complete lines
+
+    uint64_t entries() const {
+        return blocks.empty() ? 0 : blocks.back().first_sequence + blocks.back().count -
+                                        first_sequence;
+    }
+};
+
+namespace detail {
+
+static constexpr char index_magic[8] = {'D', 'T', 'S', 'I', 'D', 'X', '0', '1'};
+static constexpr char packed_index_magic[8] = {'D', 'T', 'S', 'I', 'D', 'X', '0', '2'};
+static constexpr char packed_magic[8] = {'D', 'T', 'S', 'L', 'Z', '0', '0', '1'};
+static constexpr size_t index_header_size = sizeof(index_magic) + 32;
+static constexpr size_t index_record_size = 48;
+static constexpr size_t packed_index_header_size = index_header_size + 8;
+static constexpr size_t packed_index_record_size = index_record_size + 16;
+
+inline std::string segment_stem(const std::string& dir, uint64_t first_sequence) {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%020llu", static_cast<unsigned long long>(first_sequence));
+    return (std::filesystem::path(dir) / name).string();
+}
+
+inline std::string dictionary_path(const std::string& dir, uint64_t id) {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.dict", static_cast<unsigned long long>(id));
+    return (std::filesystem::path(dir) / name).string();
+}
+
+/// Header of a plain index, or of a packed one when @p packed
+inline void put_index_header(std::string& out, const SHA256::Hash& first_previous_hash,
+                             bool packed = false, uint64_t dictionary_id = 0) {
+    out.assign(packed ? packed_index_magic : index_magic, sizeof(index_magic));
+    out.append(reinterpret_cast<const char*>(first_previous_hash.data()), 32);
+    if (packed) put_u64(out, dictionary_id);
+}
+
+inline void put_index_record(std::string& out, const IndexBlock& block, bool packed = false) {
+    put_u64(out, block.first_sequence);
+    put_u64(out, block.count);
+    put_u64(out, block.offset);
+    put_u64(out, block.bytes);
+    put_u64(out, static_cast<uint64_t>(block.min_timestamp_ms));
+    put_u64(out, static_cast<uint64_t>(block.max_timestamp_ms));
+    if (!packed) return;
+    put_u64(out, block.packed_offset);
+    put_u64(out, block.packed_bytes);
+}
+
+/**
+ * @brief Read an index file; a trailing partial record is ignored
+ * @param packed Set when the index describes a compressed segment
+ */
+inline bool read_segment_index(const std::string& path, SegmentInfo& segment,
+                               bool* packed = nullptr) {
+    MappedFile file(path);
+    if (!file.ok()) return false;
+    std::string_view in = file.view();
+    if (in.size() < index_header_size) return false;
+    const bool is_packed =
+        std::memcmp(in.data(), packed_index_magic, sizeof(packed_index_magic)) == 0;
+    if (!is_packed && std::memcmp(in.data(), index_magic, sizeof(index_magic)) != 0) {
+        return false;
+    }
+    if (is_packed && in.size() < packed_index_header_size) return false;
+    in.remove_prefix(sizeof(index_magic));
+    get_hash(in, segment.first_previous_hash);
+    if (is_packed) get_u64(in, segment.dictionary_id);
+    const size_t record_size = is_packed ? packed_index_record_size : index_record_size;
+    while (in.size() >= record_size) {
+        IndexBlock block;
+        uint64_t min_ts, max_ts;
+        get_u64(in, block.first_sequence);
+        get_u64(in, block.count);
+        get_u64(in, block.offset);
+        get_u64(in, block.bytes);
+        get_u64(in, min_ts);
+        get_u64(in, max_ts);
+        block.min_timestamp_ms = static_cast<int64_t>(min_ts);
+        block.max_timestamp_ms = static_cast<int64_t>(max_ts);
+        if (is_packed) {
+            get_u64(in, block.packed_offset);
+            get_u64(in, block.packed_bytes);
+        }
+        segment.blocks.push_back(block);
+    }
+    if (packed) *packed = is_packed;
+    return true;
+}
+
+/**
+ * @brief Write @p data to @p path via a synced temporary file and a rename
+ */
+inline bool replace_file(const std::string& path, std::string_view data) {
+    const std::string tmp = path + ".tmp";
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    bool written;
+    {
+        AppendFile file(tmp);
+        const AppendFile::Span span{data.data(), data.size()};
+        written = file.write(&span, 1) && file.sync();
+    }
+    if (written) std::filesystem::rename(tmp, path, ec);
+    return written && !ec;
+}
+
+/**
+ * @brief Timestamp of one JSON entry line
+ */
+inline bool entry_timestamp(std::string_view line, int64_t& timestamp_ms) {
+    EntryView view;
+    return parse_entry(line, view) &&
+           parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(), timestamp_ms);
+}
+
+/**
+ * @brief Call visit(line, offset, length) for each complete line of log from @p from
+ * @return Offset just past the last complete line
+ */
+template <typename Visit>
+size_t scan_lines(std::string_view log, size_t from, Visit&& visit) {
+    size_t pos = from;
+    for (;;) {
+        const size_t end = log.find('\n', pos);
+        if (end == std::string_view::npos) return pos;
+        std::string_view line = log.substr(pos, end - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty() && !visit(line, pos, end + 1 - pos)) return pos;
+        pos = end + 1;
+    }
+}
+
+/**
+ * @brief Index @p segment's unindexed tail as one extra block
+ * @return Offset just past the last complete, parseable entry
+ */
+inline uint64_t scan_segment_tail(std::string_view log, SegmentInfo& segment) {
+    // Records written ahead of log data that never reached the disk are dropped
+    while (!segment.blocks.empty() &&
+           segment.blocks.back().offset + segment.blocks.back().bytes > log.size()) {
+        segment.blocks.pop_back();
+    }
+    segment.indexed_blocks = segment.blocks.size();
+    uint64_t start = 0;
+    uint64_t next_sequence = segment.first_sequence;
+    if (!segment.blocks.empty()) {
+        const IndexBlock& last = segment.blocks.back();
+        start = last.offset + last.bytes;
+        next_sequence = last.first_sequence + last.count;
+    }
+    IndexBlock tail;
+    tail.offset = start;
+    uint64_t covered = start;
+    scan_lines(log, start, [&](std::string_view line, size_t offset, size_t length) {
+        int64_t timestamp_ms;
+        if (!entry_timestamp(line, timestamp_ms)) return false;
+        if (tail.count == 0) tail.offset = offset;
+        tail.add(next_sequence++, timestamp_ms, offset + length - (tail.offset + tail.bytes));
+        covered = offset + length;
+        return true;
+    });
+    if (tail.count > 0) segment.blocks.push_back(tail);
+    return covered;
+}
+
+/**
+ * @brief Segments of @p dir in sequence order, indexes loaded and tails scanned
+ */
+inline std::vector<SegmentInfo> list_segments(const std::string& dir) {
+    std::vector<SegmentInfo> segments;
+    std::error_code ec;
+    for (const auto& item : std::filesystem::directory_iterator(dir, ec)) {
+        const auto& path = item.path();
+        const bool packed = path.extension() == ".lz";
+        if (path.extension() != ".log" && !packed) continue;
+        const std::string stem = path.stem().string();
+        if (stem.size() != 20 || stem.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        // A .lz whose .log still exists is a seal in progress
+        if (packed && std::filesystem::exists(path.parent_path() / (stem + ".log"), ec)) continue;
+        SegmentInfo segment;
+        segment.log_path = (path.parent_path() / (stem + ".log")).string();
+        segment.index_path = (path.parent_path() / (stem + ".idx")).string();
+        segment.packed_path = (path.parent_path() / (stem + ".lz")).string();
+        segment.packed = packed;
+        segment.first_sequence = std::stoull(stem);
+        segments.push_back(std::move(segment));
+    }
+    std::sort(segments.begin(), segments.end(), [](const SegmentInfo& a, const SegmentInfo& b) {
+        return a.first_sequence < b.first_sequence;
+    });
+    for (auto& segment : segments) {
+        bool packed_index = false;
+        const bool indexed = read_segment_index(segment.index_path, segment, &packed_index);
+        if (segment.packed) {
+            // Sealed segments are fully indexed; without a packed index they cannot be read
+            if (!packed_index) segment.blocks.clear();
+            segment.indexed_blocks = segment.blocks.size();
+            segment.size = segment.blocks.empty()
+                               ? 0 : segment.blocks.back().offset + segment.blocks.back().bytes;
+            continue;
+        }
+        MappedFile log(segment.log_path);
+        if (!log.ok()) continue;
+        if (!indexed) {
+            // Without an index, anchor on what the first entry links to
+            segment.blocks.clear();
+            scan_lines(log.view(), 0, [&segment](std::string_view line, size_t, size_t) {
+                const char* previous_hex;
+                const char* chain_hex;
+                if (entry_link_hashes(line, previous_hex, chain_hex)) {
+                    hex_decode(previous_hex, 32, segment.first_previous_hash.data());
+                }
+                return false;
+            });
+        }
+        segment.size = scan_segment_tail(log.view(), segment);
+    }
+    return segments;
+}
+
+/**
+ * @brief Decode @p block of a packed segment into @p out (replacing its contents)
+ */
+inline bool unpack_block(std::string_view packed, const IndexBlock& block,
+                         std::string_view dictionary, std::string& out) {
+    out.clear();
+    if (block.packed_offset > packed.size() ||
+        block.packed_bytes > packed.size() - block.packed_offset) {
+        return false;
+    }
+    return decompress_block(packed.substr(block.packed_offset, block.packed_bytes), out,
+                            dictionary, block.bytes) &&
+           out.size() == block.bytes;
+}
+
+} // namespace detail
+
+/**
+ * @brief LogSink that writes a segmented, indexed, rotating store
+ *
+ * Reopening a directory continues its last segment; a torn final line is
+ * cut off and entries written after the last index record are re-indexed.
+ * Feed it a single chain (one device), in order.
+ */
+class SegmentedLogSink : public LogSink {
+public:
+    explicit SegmentedLogSink(std::string dir, SegmentOptions options = SegmentOptions())
+        : dir_(std::move(dir)), options_(std::move(options)) {
+        if (options_.index_interval == 0) options_.index_interval = 1;
+        std::error_code ec;
+        std::filesystem::create_directories(dir_, ec);
+        auto segments = detail::list_segments(dir_);
+        for (const auto& segment : segments) first_sequences_.push_back(segment.first_sequence);
+        if (options_.compress_sealed) {
+            dictionary_id_ = dts::dictionary_id(options_.dictionary);
+            if (dictionary_id_ != 0) store_dictionary();
+            // Segments left unsealed by a crash or an earlier configuration
+            for (size_t i = 0; i + 1 < segments.size(); ++i) {
+                if (!segments[i].packed) seal(segments[i].first_sequence);
+            }
+        }
+        // A sealed last segment is never appended to
+        if (!segments.empty() && !segments.back().packed) reopen(segments.back());
+    }
+
+    ~SegmentedLogSink() override { flush(); }
+
+    SegmentedLogSink(const SegmentedLogSink&) = delete;
+    SegmentedLogSink& operator=(const SegmentedLogSink&) = delete;
+
+    void write(std::string_view entry, const EntryInfo& info) override {
+        const uint64_t length = entry.size() + 1;
+        if (!log_.is_open() || should_rotate(length, info.timestamp_ms)) {
+            if (!rotate(info)) return;
+        }
+        const detail::AppendFile::Span spans[2] = {{entry.data(), entry.size()}, {"\n", 1}};
+        if (!log_.write(spans, 2)) return;
+        if (block_.count == 0) block_.offset = size_;
+        block_.add(info.sequence, info.timestamp_ms, length);
+        size_ += length;
+        if (block_.count >= options_.index_interval) close_block();
+        if (info.severity >= options_.sync_severity) sync();
+    }
+
+    /**
+     * @brief One write per run of entries that share a segment and index block
+     */
+    void write_batch(std::string_view entries, const EntryInfo* infos, size_t count) override {
+        size_t run_begin = 0;
+        size_t run_end = 0;
+        auto write_run = [&] {
+            const detail::AppendFile::Span span{entries.data() + run_begin, run_end - run_begin};
+            const bool written = run_end == run_begin || log_.write(&span, 1);
+            run_begin = run_end;
+            return written;
+        };
+        bool urgent = false;
+        for (size_t i = 0; i < count; ++i) {
+            const EntryInfo& info = infos[i];
+            const uint64_t length = entries.find('\n', run_end) + 1 - run_end;
+            if (!log_.is_open() || should_rotate(length, info.timestamp_ms)) {
+                if (!write_run() || !rotate(info)) return;
+            }
+            if (block_.count == 0) block_.offset = size_;
+            block_.add(info.sequence, info.timestamp_ms, length);
+            size_ += length;
+            run_end += length;
+            // Index records never reach the file ahead of the data they cover
+            if (block_.count >= options_.index_interval) {
+                if (!write_run()) return;
+                close_block();
+            }
+            urgent = urgent || info.severity >= options_.sync_severity;
+        }
+        if (write_run() && urgent) sync();
+    }
+
+    /**
+     * @brief Index the open block and sync log and index
+     */
+    void flush() override {
+        if (!log_.is_open()) return;
+        close_block();
+        sync();
+    }
+
+    /// Segments currently in the directory
+    size_t segment_count() const { return first_sequences_.size(); }
+
+    /// First sequence number of the segment being written (0 before the first entry)
+    uint64_t current_segment() const {
+        return log_.is_open() ? first_sequences_.back() : 0;
+    }
+
+    bool ok() const { return error_ == 0 && log_.error() == 0 && index_.error() == 0; }
+
+private:
+    std::string dir_;
+    SegmentOptions options_;
+    detail::AppendFile log_;
+    detail::AppendFile index_;
+    std::vector<uint64_t> first_sequences_;     ///< Oldest first
+    uint64_t size_ = 0;
+    int64_t first_timestamp_ms_ = 0;
+    IndexBlock block_;
+    std::string record_;
+    int error_ = 0;
+    bool force_rotate_ = false;
+    uint64_t dictionary_id_ = 0;
+
+    bool should_rotate(uint64_t length, int64_t timestamp_ms) const {
+        if (force_rotate_) return true;
+        if (size_ == 0) return false;
+        if (size_ + length > options_.max_segment_bytes) return true;
+        return options_.max_segment_age.count() > 0 &&
+               timestamp_ms - first_timestamp_ms_ >= options_.max_segment_age.count();
+    }
+
+    void reopen(SegmentInfo& segment) {
+        std::error_code ec;
+        bool damaged = false;
+        {
+            MappedFile file(segment.log_path);
+            const std::string_view rest = file.view().substr(std::min<size_t>(
+                segment.size, file.view().size()));
+            // A partial last line is cut off; anything else is kept for investigation
+            damaged = rest.find('\n') != std::string_view::npos;
+        }
+        if (!damaged && std::filesystem::file_size(segment.log_path, ec) > segment.size && !ec) {
+            std::filesystem::resize_file(segment.log_path, segment.size, ec);
+            if (ec) error_ = ec.value();
+        }
+        // The scanned tail becomes the open block; the index is rewritten to match the log
+        if (segment.blocks.size() > segment.indexed_blocks) {
+            block_ = segment.blocks.back();
+            segment.blocks.pop_back();
+        }
+        if (!rewrite_index(segment)) return;
+        log_.open(segment.log_path);
+        index_.open(segment.index_path);
+        size_ = segment.size;
+        first_timestamp_ms_ = segment.blocks.empty() ? block_.min_timestamp_ms
+                                                     : segment.blocks.front().min_timestamp_ms;
+        // Never append after unparseable lines: the next entry starts a new segment
+        force_rotate_ = damaged;
+    }
+
+    bool rewrite_index(const SegmentInfo& segment, bool packed = false) {
+        detail::put_index_header(record_, segment.first_previous_hash, packed, dictionary_id_);
+        for (const IndexBlock& block : segment.blocks) {
+            detail::put_index_record(record_, block, packed);
+        }
+        if (!detail::replace_file(segment.index_path, record_)) {
+            error_ = errno ? errno : 1;
+            return false;
+        }
+        return true;
+    }
+
+    bool rotate(const EntryInfo& info) {
+        const uint64_t previous = log_.is_open() ? first_sequences_.back() : 0;
+        if (log_.is_open()) {
+            close_block();
+            sync();
+        }
+        const std::string stem = detail::segment_stem(dir_, info.sequence);
+        if (!log_.open(stem + ".log") || !index_.open(stem + ".idx")) {
+            error_ = log_.error() ? log_.error() : index_.error();
+            return false;
+        }
+        detail::put_index_header(record_, info.previous_hash);
+        const detail::AppendFile::Span header{record_.data(), record_.size()};
+        index_.write(&header, 1);
+        first_sequences_.push_back(info.sequence);
+        size_ = 0;
+        first_timestamp_ms_ = info.timestamp_ms;
+        block_ = IndexBlock();
+        force_rotate_ = false;
+        // The new segment exists before the old one is sealed, so the last is never sealed
+        if (previous != 0 && options_.compress_sealed) seal(previous);
+        retain();
+        return true;
+    }
+
+    /**
+     * @brief Compress a closed segment: write .lz, then the packed index, then delete .log
+     */
+    void seal(uint64_t first_sequence) {
+        const std::string stem = detail::segment_stem(dir_, first_sequence);
+        SegmentInfo segment;
+        segment.first_sequence = first_sequence;
+        segment.index_path = stem + ".idx";
+        bool packed_index = false;
+        detail::read_segment_index(segment.index_path, segment, &packed_index);
+        {
+            MappedFile log(stem + ".log");
+            if (!log.ok()) return;
+            if (!packed_index) segment.size = detail::scan_segment_tail(log.view(), segment);
+            else segment.size = log.view().size();
+            // Lines that do not parse stay in plain text for investigation
+            if (segment.size != log.view().size()) return;
+
+            BlockCompressor compressor(options_.dictionary);
+            detail::AppendFile packed;
+            const std::string tmp = stem + ".lz.tmp";
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            if (!packed.open(tmp)) return;
+            record_.assign(detail::packed_magic, sizeof(detail::packed_magic));
+            uint64_t packed_size = record_.size();
+            for (IndexBlock& block : segment.blocks) {
+                const size_t start = record_.size();
+                compressor.compress(log.view().substr(block.offset, block.bytes), record_);
+                block.packed_offset = packed_size;
+                block.packed_bytes = record_.size() - start;
+                packed_size += block.packed_bytes;
+                // Write in chunks rather than holding the whole segment
+                if (record_.size() >= 1024 * 1024) {
+                    const detail::AppendFile::Span span{record_.data(), record_.size()};
+                    if (!packed.write(&span, 1)) return;
+                    record_.clear();
+                }
+            }
+            const detail::AppendFile::Span span{record_.data(), record_.size()};
+            if (!packed.write(&span, 1) || !packed.sync()) return;
+            packed.close();
+            std::filesystem::rename(tmp, stem + ".lz", ec);
+            if (ec) return;
+        }
+        if (!rewrite_index(segment, true)) return;
+        std::error_code ec;
+        std::filesystem::remove(stem + ".log", ec);
+    }
+
+    void store_dictionary() {
+        const std::string path = detail::dictionary_path(dir_, dictionary_id_);
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec)) return;
+        if (!detail::replace_file(path, options_.dictionary)) error_ = errno ? errno : 1;
+    }
+
+    void close_block() {
+        if (block_.count == 0) return;
+        record_.clear();
+        detail::put_index_record(record_, block_);
+        const detail::AppendFile::Span span{record_.data(), record_.size()};
+        index_.write(&span, 1);
+        block_ = IndexBlock();
+    }
+
+    void sync() {
+        // The log is durable before any index record that points into it
+        log_.sync();
+        index_.sync();
+    }
+
+    void retain() {
+        if (options_.max_segments == 0) return;
+        while (first_sequences_.size() > options_.max_segments) {
+            const std::string stem = detail::segment_stem(dir_, first_sequences_.front());
+            std::error_code ec;
+            std::filesystem::remove(stem + ".log", ec);
+            std::filesystem::remove(stem + ".lz", ec);
+            std::filesystem::remove(stem + ".idx", ec);
+            first_sequences_.erase(first_sequences_.begin());
+        }
+    }
+};
+
+/**
+ * @brief Read-only view of a segmented store, as of construction
+ */
+class SegmentedLogReader {
+public:
+    explicit SegmentedLogReader(const std::string& dir) : segments_(detail::list_segments(dir)) {
+        for (const SegmentInfo& segment : segments_) {
+            const uint64_t id = segment.dictionary_id;
+            if (!segment.packed || id == 0 || dictionaries_.count(id)) continue;
+            MappedFile file(detail::dictionary_path(dir, id));
+            // A dictionary that fails its ID check is treated as missing
+            if (file.ok() && dts::dictionary_id(file.view()) == id) {
+                dictionaries_.emplace(id, std::string(file.view()));
+            }
+        }
+    }
+
+    const std::vector<SegmentInfo>& segments() const { return segments_; }
+
+    uint64_t first_sequence() const {
+        return segments_.empty() ? 0 : segments_.front().first_sequence;
+    }
+
+    uint64_t last_sequence() const {
+        for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+            if (it->entries() > 0) return it->first_sequence + it->entries() - 1;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Call visit(entry, sequence) for each entry numbered in [first, last]
+     *
+     * @p visit returns true to continue.
+     * @return false if a segment could not be read or visit stopped early
+     */
+    template <typename Visit>
+    bool read_sequences(uint64_t first, uint64_t last, Visit&& visit) const {
+        return for_blocks(
+            [&](const IndexBlock& block) {
+                return block.first_sequence <= last && block.first_sequence + block.count > first;
+            },
+            [&](std::string_view entry, uint64_t sequence, int64_t) {
+                if (sequence < first || sequence > last) return true;
+                return static_cast<bool>(visit(entry, sequence));
+            });
+    }
+
+    /**
+     * @brief Call visit(entry, sequence) for each entry timestamped in [from_ms, to_ms]
+     *
+     * Entries come in log order, which is timestamp order unless the chain
+     * logged back-dated records (e.g., coalesced summaries).
+     */
+    template <typename Visit>
+    bool read_time_range(int64_t from_ms, int64_t to_ms, Visit&& visit) const {
+        return for_blocks(
+            [&](const IndexBlock& block) {
+                return block.min_timestamp_ms <= to_ms && block.max_timestamp_ms >= from_ms;
+            },
+            [&](std::string_view entry, uint64_t sequence, int64_t timestamp_ms) {
+                if (timestamp_ms < from_ms || timestamp_ms > to_ms) return true;
+                return static_cast<bool>(visit(entry, sequence));
+            });
+    }
+
+    /**
+     * @brief Verify every segment, each anchored on the hash recorded for it
+     *
+     * Links between segments are checked too. failed_entry counts from the
+     * first entry of the store; failed_offset is within @p failed_segment.
+     */
+    VerifyResult verify(VerifyOptions options = VerifyOptions(),
+                        size_t* failed_segment = nullptr) const {
+        VerifyResult total;
+        bool first = true;
+        for (size_t i = 0; i < segments_.size(); ++i) {
+            const SegmentInfo& segment = segments_[i];
+            options.initial_hash = first ? segment.first_previous_hash : total.last_hash;
+            MappedFile file(segment.packed ? segment.packed_path : segment.log_path);
+            VerifyResult part;
+            std::string text;
+            const bool readable =
+                file.ok() && (!segment.packed || unpack(segment, file.view(), text));
+            if (!readable || (!first && segment.first_previous_hash != total.last_hash)) {
+                part.status = readable ? VerifyStatus::BrokenLink : VerifyStatus::Malformed;
+                part.failed_entry = 1;
+            } else if (segment.packed) {
+                part = verify_buffer(text, options);
+            } else {
+                // Everything but a partial line still being written
+                const std::string_view log = file.view();
+                part = verify_buffer(log.substr(0, log.rfind('\n') + 1), options);
+            }
+            if (first) total.first_previous_hash = segment.first_previous_hash;
+            if (!part.ok()) {
+                total.status = part.status;
+                total.failed_entry = total.entries + part.failed_entry;
+                total.failed_offset = part.failed_offset;
+                total.entries += part.entries;
+                if (failed_segment) *failed_segment = i;
+                return total;
+            }
+            total.entries += part.entries;
+            if (part.entries > 0) total.last_hash = part.last_hash;
+            first = false;
+        }
+        if (first) total.last_hash = options.initial_hash;
+        return total;
+    }
+
+private:
+    std::vector<SegmentInfo> segments_;
+    std::unordered_map<uint64_t, std::string> dictionaries_;
+
+    bool dictionary(const SegmentInfo& segment, std::string_view& out) const {
+        out = {};
+        if (segment.dictionary_id == 0) return true;
+        auto it = dictionaries_.find(segment.dictionary_id);
+        if (it == dictionaries_.end()) return false;
+        out = it->second;
+        return true;
+    }
+
+    /// Decode a whole packed segment into @p out
+    bool unpack(const SegmentInfo& segment, std::string_view packed, std::string& out) const {
+        std::string_view dict;
+        if (!dictionary(segment, dict) || packed.size() < sizeof(detail::packed_magic) ||
+            std::memcmp(packed.data(), detail::packed_magic, sizeof(detail::packed_magic)) != 0) {
+            return false;
+        }
+        std::string block_text;
+        out.clear();
+        for (const IndexBlock& block : segment.blocks) {
+            if (block.offset != out.size() ||
+                !detail::unpack_block(packed, block, dict, block_text)) {
+                return false;
+            }
+            out += block_text;
+        }
+        return true;
+    }
+
+    template <typename Match, typename Visit>
+    bool for_blocks(Match&& match, Visit&& visit) const {
+        for (const SegmentInfo& segment : segments_) {
+            bool wanted = false;
+            for (const IndexBlock& block : segment.blocks) wanted = wanted || match(block);
+            if (!wanted) continue;
+            MappedFile file(segment.packed ? segment.packed_path : segment.log_path);
+            if (!file.ok()) return false;
+            std::string_view dict;
+            if (segment.packed && !dictionary(segment, dict)) return false;
+            std::string text;
+            for (const IndexBlock& block : segment.blocks) {
+                if (!match(block)) continue;
+                // Packed blocks decode on their own; plain ones are read in place
+                std::string_view log = file.view();
+                uint64_t offset = block.offset;
+                if (segment.packed) {
+                    if (!detail::unpack_block(log, block, dict, text)) return false;
+                    log = text;
+                    offset = 0;
+                }
+                if (offset + block.bytes > log.size()) return false;
+                uint64_t sequence = block.first_sequence;
+                bool keep_going = true;
+                detail::scan_lines(log.substr(0, offset + block.bytes), offset,
+                                   [&](std::string_view line, size_t, size_t) {
+                                       int64_t timestamp_ms = 0;
+                                       detail::entry_timestamp(line, timestamp_ms);
+                                       keep_going = visit(line, sequence++, timestamp_ms);
+                                       return keep_going;
+                                   });
+                if (!keep_going) return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_SEGMENTED_LOG_HPP
@@ -0,0 +1,636 @@
+/**
+ * @file sha256.hpp
+ * @brief SHA-256 implementation with runtime-dispatched compression backends
+ *
+ * The portable scalar compression function is always available and is the
+ * reference for every accelerated path. On x86 the SHA extensions (SHA-NI)
+ * are used when the CPU reports them, on ARMv8 the crypto extensions are
+ * used when the compiler targets them, and batches of independent messages
+ * can be hashed eight at a time with AVX2. All backends produce
+ * bit-identical digests.
+ *
+ * Define DTS_SHA256_NO_SIMD to compile the portable path only.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_SHA256_HPP
+#define DTS_SHA256_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if !defined(DTS_SHA256_NO_SIMD)
+#  if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define DTS_SHA256_X86 1
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#      include <intrin.h>
+#      define DTS_TARGET_SHANI
+#      define DTS_TARGET_AVX2
+#    else
+#      include <cpuid.h>
+#      define DTS_TARGET_SHANI __attribute__((target("sha,sse4.1,ssse3")))
+#      define DTS_TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#  elif (defined(__aarch64__) || defined(_M_ARM64)) && \
+        (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#    define DTS_SHA256_ARMV8 1
+#    include <arm_neon.h>
+#  endif
+#endif
+
+namespace dts {
+
+/**
+ * @brief SHA-256 compression backends
+ */
+enum class SHA256Backend : uint8_t {
+    Scalar = 0,     ///< Portable C++ implementation
+    ShaNi = 1,      ///< x86 SHA extensions
+    ArmCrypto = 2   ///< ARMv8 crypto extensions
+};
+
+namespace detail {
+
+/// Compresses @p nblocks consecutive 64-byte blocks into @p state
+using SHA256CompressFn = void (*)(uint32_t* state, const uint8_t* blocks, size_t nblocks);
+
+alignas(16) static constexpr uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static constexpr uint32_t sha256_init[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+inline uint32_t sha256_rotr(uint32_t value, uint32_t amount) {
+    return (value >> amount) | (value << (32 - amount));
+}
+
+inline uint32_t load_be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline void sha256_compress_scalar(uint32_t* state, const uint8_t* data, size_t nblocks) {
+    for (; nblocks > 0; --nblocks, data += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = load_be32(data + i * 4);
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = sha256_rotr(w[i-15], 7) ^ sha256_rotr(w[i-15], 18) ^ (w[i-15] >> 3);
+            uint32_t s1 = sha256_rotr(w[i-2], 17) ^ sha256_rotr(w[i-2], 19) ^ (w[i-2] >> 10);
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3],
+                 e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int i = 0; i < 64; ++i) {
+            uint32_t S1 = sha256_rotr(e, 6) ^ sha256_rotr(e, 11) ^ sha256_rotr(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + S1 + ch + sha256_k[i] + w[i];
+            uint32_t S0 = sha256_rotr(a, 2) ^ sha256_rotr(a, 13) ^ sha256_rotr(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = S0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#if defined(DTS_SHA256_X86)
+
+struct X86Features {
+    bool sha_ni = false;
+    bool avx2 = false;
+};
+
+inline X86Features detect_x86_features() {
+    X86Features features;
+    unsigned int r1[4] = {0, 0, 0, 0};
+    unsigned int r7[4] = {0, 0, 0, 0};
+    unsigned int max_leaf = 0;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    max_leaf = static_cast<unsigned int>(regs[0]);
+    __cpuidex(regs, 1, 0);
+    for (int i = 0; i < 4; ++i) r1[i] = static_cast<unsigned int>(regs[i]);
+    if (max_leaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        for (int i = 0; i < 4; ++i) r7[i] = static_cast<unsigned int>(regs[i]);
+    }
+#else
+    max_leaf = __get_cpuid_max(0, nullptr);
+    __cpuid_count(1, 0, r1[0], r1[1], r1[2], r1[3]);
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, r7[0], r7[1], r7[2], r7[3]);
+    }
+#endif
+    const bool ssse3 = (r1[2] >> 9) & 1;
+    const bool sse41 = (r1[2] >> 19) & 1;
+    const bool osxsave = (r1[2] >> 27) & 1;
+    const bool avx = (r1[2] >> 28) & 1;
+
+    features.sha_ni = ssse3 && sse41 && ((r7[1] >> 29) & 1);
+
+    if (osxsave && avx && ((r7[1] >> 5) & 1)) {
+        // The OS must save YMM state across context switches
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long long xcr0 = _xgetbv(0);
+#else
+        unsigned int eax = 0, edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        unsigned long long xcr0 = (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+        features.avx2 = (xcr0 & 0x6) == 0x6;
+    }
+    return features;
+}
+
+inline const X86Features& x86_features() {
+    static const X86Features features = detect_x86_features();
+    return features;
+}
+
+DTS_TARGET_SHANI
+inline void sha256_compress_shani(uint32_t* state, const uint8_t* data, size_t nblocks) {
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);                 // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);           // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);        // CDGH
+
+    for (; nblocks > 0; --nblocks, data += 64) {
+        const __m128i abef_save = state0;
+        const __m128i cdgh_save = state1;
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), mask);
+        }
+
+        for (int g = 0; g < 16; ++g) {
+            if (g >= 4) {
+                // W[g] = msg2(msg1(W[g-4], W[g-3]) + (W[g-1]:W[g-2] >> 32), W[g-1])
+                __m128i w = _mm_sha256msg1_epu32(msg[g & 3], msg[(g + 1) & 3]);
+                w = _mm_add_epi32(w, _mm_alignr_epi8(msg[(g + 3) & 3], msg[(g + 2) & 3], 4));
+                msg[g & 3] = _mm_sha256msg2_epu32(w, msg[(g + 3) & 3]);
+            }
+            __m128i m = _mm_add_epi32(msg[g & 3],
+                _mm_load_si128(reinterpret_cast<const __m128i*>(&sha256_k[g * 4])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+            m = _mm_shuffle_epi32(m, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, m);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);              // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);           // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);        // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);           // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+DTS_TARGET_AVX2
+inline __m256i sha256_rotr8x(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+/**
+ * @brief Compress one block per lane for eight independent states
+ * @param state Transposed state: state[i] holds word i of all eight lanes
+ * @param blocks Per-lane block pointers (ignored for inactive lanes)
+ * @param active_mask Bit i set if lane i has a block this round
+ */
+DTS_TARGET_AVX2
+inline void sha256_compress_avx2_x8(__m256i* state, const uint8_t* const* blocks,
+                                    unsigned active_mask) {
+    __m256i w[16];
+    for (int t = 0; t < 16; ++t) {
+        alignas(32) uint32_t lane[8];
+        for (int i = 0; i < 8; ++i) {
+            lane[i] = (active_mask >> i) & 1 ? load_be32(blocks[i] + t * 4) : 0;
+        }
+        w[t] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lane));
+    }
+
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3],
+            e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; ++i) {
+        __m256i wi;
+        if (i < 16) {
+            wi = w[i];
+        } else {
+            const __m256i w15 = w[(i - 15) & 15];
+            const __m256i w2 = w[(i - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(
+                sha256_rotr8x(w15, 7), sha256_rotr8x(w15, 18)), _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(
+                sha256_rotr8x(w2, 17), sha256_rotr8x(w2, 19)), _mm256_srli_epi32(w2, 10));
+            wi = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0),
+                                  _mm256_add_epi32(w[(i - 7) & 15], s1));
+            w[i & 15] = wi;
+        }
+
+        const __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(
+            sha256_rotr8x(e, 6), sha256_rotr8x(e, 11)), sha256_rotr8x(e, 25));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(h, S1),
+            _mm256_add_epi32(_mm256_add_epi32(ch, _mm256_set1_epi32(static_cast<int>(sha256_k[i]))), wi));
+        const __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(
+            sha256_rotr8x(a, 2), sha256_rotr8x(a, 13)), sha256_rotr8x(a, 22));
+        const __m256i maj = _mm256_xor_si256(_mm256_xor_si256(
+            _mm256_and_si256(a, b), _mm256_and_si256(a, c)), _mm256_and_si256(b, c));
+        const __m256i temp2 = _mm256_add_epi32(S0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, temp2);
+    }
+
+    alignas(32) int32_t lanes[8];
+    for (int i = 0; i < 8; ++i) {
+        lanes[i] = (active_mask >> i) & 1 ? -1 : 0;
+    }
+    const __m256i keep = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+    const __m256i sums[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; ++i) {
+        state[i] = _mm256_add_epi32(state[i], _mm256_and_si256(sums[i], keep));
+    }
+}
+
+/**
+ * @brief Hash up to eight independent messages in parallel lanes
+ */
+DTS_TARGET_AVX2
+inline void sha256_hash_x8_avx2(const uint8_t* const* data, const size_t* lens,
+                                size_t count, std::array<uint8_t, 32>* out) {
+    // Each lane hashes its full blocks straight from the input, then one or
+    // two padded tail blocks staged here.
+    uint8_t tails[8][128];
+    size_t full_blocks[8] = {0};
+    size_t total_blocks[8] = {0};
+    size_t max_blocks = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t len = lens[i];
+        const size_t rem = len % 64;
+        full_blocks[i] = len / 64;
+        const size_t tail_len = rem < 56 ? 64 : 128;
+        std::memset(tails[i], 0, tail_len);
+        if (rem > 0) {
+            std::memcpy(tails[i], data[i] + full_blocks[i] * 64, rem);
+        }
+        tails[i][rem] = 0x80;
+        const uint64_t bits = static_cast<uint64_t>(len) * 8;
+        for (int b = 0; b < 8; ++b) {
+            tails[i][tail_len - 1 - b] = static_cast<uint8_t>(bits >> (8 * b));
+        }
+        total_blocks[i] = full_blocks[i] + tail_len / 64;
+        if (total_blocks[i] > max_blocks) max_blocks = total_blocks[i];
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i) {
+        state[i] = _mm256_set1_epi32(static_cast<int>(sha256_init[i]));
+    }
+
+    for (size_t r = 0; r < max_blocks; ++r) {
+        const uint8_t* blocks[8] = {nullptr};
+        unsigned active = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (r < full_blocks[i]) {
+                blocks[i] = data[i] + r * 64;
+                active |= 1u << i;
+            } else if (r < total_blocks[i]) {
+                blocks[i] = tails[i] + (r - full_blocks[i]) * 64;
+                active |= 1u << i;
+            }
+        }
+        sha256_compress_avx2_x8(state, blocks, active);
+    }
+
+    alignas(32) uint32_t words[8][8];
+    for (int i = 0; i < 8; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words[i]), state[i]);
+    }
+    for (size_t lane = 0; lane < count; ++lane) {
+        for (int i = 0; i < 8; ++i) {
+            const uint32_t v = words[i][lane];
+            out[lane][i * 4 + 0] = static_cast<uint8_t>(v >> 24);
+            out[lane][i * 4 + 1] = static_cast<uint8_t>(v >> 16);
+            out[lane][i * 4 + 2] = static_cast<uint8_t>(v >> 8);
+            out[lane][i * 4 + 3] = static_cast<uint8_t>(v);
+        }
+    }
+}
+
+#endif // DTS_SHA256_X86
+
+#if defined(DTS_SHA256_ARMV8)
+
+inline void sha256_compress_armv8(uint32_t* state, const uint8_t* data, size_t nblocks) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);   // ABCD
+    uint32x4_t state1 = vld1q_u32(&state[4]);   // EFGH
+
+    for (; nblocks > 0; --nblocks, data += 64) {
+        const uint32x4_t abcd_save = state0;
+        const uint32x4_t efgh_save = state1;
+
+        uint32x4_t msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+        }
+
+        for (int g = 0; g < 16; ++g) {
+            if (g >= 4) {
+                msg[g & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[g & 3], msg[(g + 1) & 3]),
+                                             msg[(g + 2) & 3], msg[(g + 3) & 3]);
+            }
+            const uint32x4_t m = vaddq_u32(msg[g & 3], vld1q_u32(&sha256_k[g * 4]));
+            const uint32x4_t prev = state0;
+            state0 = vsha256hq_u32(state0, state1, m);
+            state1 = vsha256h2q_u32(state1, prev, m);
+        }
+
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+#endif // DTS_SHA256_ARMV8
+
+inline bool sha256_backend_supported(SHA256Backend backend) {
+    switch (backend) {
+        case SHA256Backend::Scalar:
+            return true;
+        case SHA256Backend::ShaNi:
+#if defined(DTS_SHA256_X86)
+            return x86_features().sha_ni;
+#else
+            return false;
+#endif
+        case SHA256Backend::ArmCrypto:
+#if defined(DTS_SHA256_ARMV8)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+inline SHA256CompressFn sha256_compress_for(SHA256Backend backend) {
+    switch (backend) {
+#if defined(DTS_SHA256_X86)
+        case SHA256Backend::ShaNi:
+            return &sha256_compress_shani;
+#endif
+#if defined(DTS_SHA256_ARMV8)
+        case SHA256Backend::ArmCrypto:
+            return &sha256_compress_armv8;
+#endif
+        default:
+            return &sha256_compress_scalar;
+    }
+}
+
+inline SHA256Backend sha256_best_backend() {
+    if (sha256_backend_supported(SHA256Backend::ShaNi)) return SHA256Backend::ShaNi;
+    if (sha256_backend_supported(SHA256Backend::ArmCrypto)) return SHA256Backend::ArmCrypto;
+    return SHA256Backend::Scalar;
+}
+
+struct SHA256Dispatch {
+    std::atomic<SHA256CompressFn> compress;
+    std::atomic<SHA256Backend> backend;
+    std::atomic<bool> multibuffer;
+
+    SHA256Dispatch()
+        : compress(sha256_compress_for(sha256_best_backend())),
+          backend(sha256_best_backend()),
+          multibuffer(true) {}
+};
+
+inline SHA256Dispatch& sha256_dispatch() {
+    static SHA256Dispatch dispatch;
+    return dispatch;
+}
+
+} // namespace detail
+
+/**
+ * @brief SHA-256 hash implementation (lightweight, header-only)
+ */
+class SHA256 {
+public:
+    using Hash = std::array<uint8_t, 32>;
+
+    static Hash hash(const uint8_t* data, size_t len) {
+        SHA256 ctx;
+        ctx.update(data, len);
+        return ctx.finalize();
+    }
+
+    static Hash hash(std::string_view text) {
+        return hash(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+
+    /**
+     * @brief Hash many independent messages
+     *
+     * Uses the hardware backend per message when one is active, otherwise
+     * hashes eight messages at a time in AVX2 lanes if the CPU supports it.
+     * @param data Message pointers
+     * @param lens Message lengths
+     * @param count Number of messages
+     * @param out Output digests (count entries)
+     */
+    static void hash_many(const uint8_t* const* data, const size_t* lens,
+                          size_t count, Hash* out) {
+#if defined(DTS_SHA256_X86)
+        auto& dispatch = detail::sha256_dispatch();
+        if (dispatch.backend.load(std::memory_order_relaxed) == SHA256Backend::Scalar &&
+            dispatch.multibuffer.load(std::memory_order_relaxed) &&
+            detail::x86_features().avx2) {
+            for (size_t i = 0; i < count; i += 8) {
+                const size_t n = (count - i) < 8 ? (count - i) : 8;
+                detail::sha256_hash_x8_avx2(data + i, lens + i, n, out + i);
+            }
+            return;
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = hash(data[i], lens[i]);
+        }
+    }
+
+    /**
+     * @brief Backend currently used for single-stream hashing
+     */
+    static SHA256Backend backend() {
+        return detail::sha256_dispatch().backend.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check whether a backend can run on this CPU/build
+     */
+    static bool backend_supported(SHA256Backend backend) {
+        return detail::sha256_backend_supported(backend);
+    }
+
+    /**
+     * @brief Override the auto-selected backend (e.g., for validation)
+     * @return false if the backend is unavailable; the selection is unchanged
+     */
+    static bool set_backend(SHA256Backend backend) {
+        if (!backend_supported(backend)) return false;
+        auto& dispatch = detail::sha256_dispatch();
+        dispatch.compress.store(detail::sha256_compress_for(backend), std::memory_order_relaxed);
+        dispatch.backend.store(backend, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Enable or disable AVX2 multi-buffer hashing in hash_many()
+     */
+    static void set_multibuffer_enabled(bool enabled) {
+        detail::sha256_dispatch().multibuffer.store(enabled, std::memory_order_relaxed);
+    }
+
+    static const char* backend_name(SHA256Backend backend) {
+        switch (backend) {
+            case SHA256Backend::Scalar: return "scalar";
+            case SHA256Backend::ShaNi: return "sha-ni";
+            case SHA256Backend::ArmCrypto: return "armv8-crypto";
+        }
+        return "unknown";
+    }
+
+    void update(const uint8_t* data, size_t len) {
+        bit_len += static_cast<uint64_t>(len) * 8;
+
+        if (buffer_len > 0) {
+            size_t take = 64 - buffer_len;
+            if (take > len) take = len;
+            std::memcpy(buffer + buffer_len, data, take);
+            buffer_len = static_cast<uint8_t>(buffer_len + take);
+            data += take;
+            len -= take;
+            if (buffer_len < 64) return;
+            compress(buffer, 1);
+            buffer_len = 0;
+        }
+
+        if (len >= 64) {
+            compress(data, len / 64);
+            data += len & ~static_cast<size_t>(63);
+            len &= 63;
+        }
+
+        if (len > 0) {
+            std::memcpy(buffer, data, len);
+            buffer_len = static_cast<uint8_t>(len);
+        }
+    }
+
+    void update(std::string_view data) {
+        update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+
+    Hash finalize() {
+        // Pad in place: 0x80, zeros, then the 64-bit big-endian bit length
+        const uint64_t total_bits = bit_len;
+        buffer[buffer_len++] = 0x80;
+        if (buffer_len > 56) {
+            std::memset(buffer + buffer_len, 0, 64 - buffer_len);
+            compress(buffer, 1);
+            buffer_len = 0;
+        }
+        std::memset(buffer + buffer_len, 0, 56 - buffer_len);
+        for (int i = 0; i < 8; ++i) {
+            buffer[63 - i] = static_cast<uint8_t>(total_bits >> (8 * i));
+        }
+        compress(buffer, 1);
+        buffer_len = 0;
+
+        Hash result;
+        for (int i = 0; i < 8; ++i) {
+            result[i * 4 + 0] = (h[i] >> 24) & 0xFF;
+            result[i * 4 + 1] = (h[i] >> 16) & 0xFF;
+            result[i * 4 + 2] = (h[i] >> 8) & 0xFF;
+            result[i * 4 + 3] = (h[i] >> 0) & 0xFF;
+        }
+        return result;
+    }
+
+private:
+    uint32_t h[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    uint8_t buffer[64] = {0};
+    uint8_t buffer_len = 0;
+    uint64_t bit_len = 0;
+
+    void compress(const uint8_t* blocks, size_t nblocks) {
+        detail::sha256_dispatch().compress.load(std::memory_order_relaxed)(h, blocks, nblocks);
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_SHA256_HPP
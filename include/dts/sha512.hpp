@@ -0,0 +1,188 @@
+/**
+ * @file sha512.hpp
+ * @brief Portable SHA-512 (FIPS 180-4)
+ *
+ * Needed by Ed25519 (RFC 8032), which hashes keys and messages with
+ * SHA-512. Only signed checkpoints use it, a few times per thousand
+ * entries, so there is a single scalar implementation and no dispatch.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_SHA512_HPP
+#define DTS_SHA512_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace dts {
+
+namespace detail {
+
+static constexpr uint64_t sha512_k[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+inline uint64_t sha512_rotr(uint64_t value, unsigned amount) {
+    return (value >> amount) | (value << (64 - amount));
+}
+
+inline uint64_t load_be64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value = (value << 8) | p[i];
+    return value;
+}
+
+inline void sha512_compress(uint64_t* state, const uint8_t* data, size_t nblocks) {
+    for (; nblocks > 0; --nblocks, data += 128) {
+        uint64_t w[80];
+        for (int i = 0; i < 16; ++i) w[i] = load_be64(data + 8 * i);
+        for (int i = 16; i < 80; ++i) {
+            const uint64_t s0 = sha512_rotr(w[i - 15], 1) ^ sha512_rotr(w[i - 15], 8) ^
+                                (w[i - 15] >> 7);
+            const uint64_t s1 = sha512_rotr(w[i - 2], 19) ^ sha512_rotr(w[i - 2], 61) ^
+                                (w[i - 2] >> 6);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 80; ++i) {
+            const uint64_t s1 = sha512_rotr(e, 14) ^ sha512_rotr(e, 18) ^ sha512_rotr(e, 41);
+            const uint64_t ch = (e & f) ^ (~e & g);
+            const uint64_t t1 = h + s1 + ch + sha512_k[i] + w[i];
+            const uint64_t s0 = sha512_rotr(a, 28) ^ sha512_rotr(a, 34) ^ sha512_rotr(a, 39);
+            const uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+            const uint64_t t2 = s0 + maj;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief SHA-512 hash implementation (portable, header-only)
+ */
+class SHA512 {
+public:
+    using Hash = std::array<uint8_t, 64>;
+
+    static Hash hash(const uint8_t* data, size_t len) {
+        SHA512 ctx;
+        ctx.update(data, len);
+        return ctx.finalize();
+    }
+
+    static Hash hash(std::string_view text) {
+        return hash(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+
+    void update(const uint8_t* data, size_t len) {
+        byte_len_ += len;
+
+        if (buffer_len_ > 0) {
+            size_t take = 128 - buffer_len_;
+            if (take > len) take = len;
+            std::memcpy(buffer_ + buffer_len_, data, take);
+            buffer_len_ = static_cast<uint8_t>(buffer_len_ + take);
+            data += take;
+            len -= take;
+            if (buffer_len_ < 128) return;
+            detail::sha512_compress(h_, buffer_, 1);
+            buffer_len_ = 0;
+        }
+
+        if (len >= 128) {
+            detail::sha512_compress(h_, data, len / 128);
+            data += len & ~static_cast<size_t>(127);
+            len &= 127;
+        }
+
+        if (len > 0) {
+            std::memcpy(buffer_, data, len);
+            buffer_len_ = static_cast<uint8_t>(len);
+        }
+    }
+
+    void update(std::string_view data) {
+        update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+
+    Hash finalize() {
+        // 0x80, zeros, then the 128-bit big-endian bit length (high half 0)
+        const uint64_t total_bits = byte_len_ * 8;
+        buffer_[buffer_len_++] = 0x80;
+        if (buffer_len_ > 112) {
+            std::memset(buffer_ + buffer_len_, 0, 128 - buffer_len_);
+            detail::sha512_compress(h_, buffer_, 1);
+            buffer_len_ = 0;
+        }
+        std::memset(buffer_ + buffer_len_, 0, 120 - buffer_len_);
+        for (int i = 0; i < 8; ++i) {
+            buffer_[127 - i] = static_cast<uint8_t>(total_bits >> (8 * i));
+        }
+        detail::sha512_compress(h_, buffer_, 1);
+        buffer_len_ = 0;
+
+        Hash result;
+        for (int i = 0; i < 8; ++i) {
+            for (int b = 0; b < 8; ++b) {
+                result[i * 8 + b] = static_cast<uint8_t>(h_[i] >> (56 - 8 * b));
+            }
+        }
+        return result;
+    }
+
+private:
+    uint64_t h_[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+    };
+
+    uint8_t buffer_[128] = {0};
+    uint8_t buffer_len_ = 0;
+    uint64_t byte_len_ = 0;
+};
+
+} // namespace dts
+
+#endif // DTS_SHA512_HPP
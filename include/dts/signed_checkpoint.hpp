@@ -0,0 +1,489 @@
+/**
+ * @file signed_checkpoint.hpp
+ * @brief Ed25519-signed checkpoints over the chain hash, and their batch verification
+ *
+ * The hash chain shows that a log is internally consistent, but anyone able
+ * to rewrite the whole log can recompute every hash. Signed checkpoints
+ * bind the chain to a device key: every N entries the chain hands its
+ * position to a CheckpointSigner, and once the signature is ready it is
+ * logged as an ordinary chained entry
+ *
+ *   Signed Checkpoint | seq=S | hash=H | key=K | sig=G
+ *
+ * where G is the Ed25519 signature of "DTSSIG1|device_id|S|H", H the hex
+ * chain hash of entry S and K the first 8 bytes of the public key in hex.
+ * A signature over entry S covers it and everything before it.
+ *
+ * Ed25519CheckpointSigner signs on a worker thread, so the logging thread
+ * only copies a hash every N entries. At about 100 us per signature,
+ * N = 4096 costs some 25 ns per entry on a desktop core; on a device,
+ * pick N so that one signature per N entries fits the CPU budget.
+ *
+ * verify_signed_checkpoints() verifies the chain, checks that every
+ * signed hash is the chain hash at its sequence, and verifies the
+ * signatures in batches (ed25519::verify_batch()), about four times
+ * faster than one by one.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_SIGNED_CHECKPOINT_HPP
+#define DTS_SIGNED_CHECKPOINT_HPP
+
+#include "audit_chain.hpp"
+#include "chain_verifier.hpp"
+#include "ed25519.hpp"
+#include "entry_parser.hpp"
+#include "format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dts {
+
+/**
+ * @brief Contents of a signed checkpoint entry
+ */
+struct SignedCheckpoint {
+    uint64_t sequence = 0;              ///< Entry whose chain hash is signed
+    SHA256::Hash chain_hash{};          ///< chain_hash of that entry
+    std::array<uint8_t, 8> key_id{};    ///< First bytes of the signer's public key
+    ed25519::Signature signature{};
+};
+
+namespace detail {
+
+static constexpr char signed_checkpoint_prefix[] = "Signed Checkpoint | ";
+
+/// Longest signed checkpoint message (a 20-digit sequence)
+static constexpr size_t signed_checkpoint_message_capacity = 320;
+
+/**
+ * @brief Bytes a checkpoint signature covers: "DTSSIG1|device_id|sequence|chain_hex"
+ */
+inline void signed_checkpoint_payload(std::string_view device_id, uint64_t sequence,
+                                      const SHA256::Hash& chain_hash, std::string& out) {
+    out.assign("DTSSIG1|");
+    out.append(device_id.data(), device_id.size());
+    char digits[20];
+    out.push_back('|');
+    out.append(digits, format_uint(sequence, digits));
+    char hex[64];
+    hex_encode(chain_hash.data(), chain_hash.size(), hex);
+    out.push_back('|');
+    out.append(hex, sizeof(hex));
+}
+
+/**
+ * @brief Render the message of a signed checkpoint entry
+ * @return Message length
+ */
+inline size_t format_signed_checkpoint_message(const SignedCheckpoint& checkpoint, char* out) {
+    CharWriter w{out};
+    w.literal(signed_checkpoint_prefix);
+    w.literal("seq=");
+    w.uint(checkpoint.sequence);
+    w.literal(" | hash=");
+    hex_encode(checkpoint.chain_hash.data(), checkpoint.chain_hash.size(), w.pos);
+    w.pos += 64;
+    w.literal(" | key=");
+    hex_encode(checkpoint.key_id.data(), checkpoint.key_id.size(), w.pos);
+    w.pos += 16;
+    w.literal(" | sig=");
+    hex_encode(checkpoint.signature.data(), checkpoint.signature.size(), w.pos);
+    w.pos += 128;
+    return static_cast<size_t>(w.pos - out);
+}
+
+inline std::array<uint8_t, 8> key_id(const ed25519::PublicKey& public_key) {
+    std::array<uint8_t, 8> id;
+    std::memcpy(id.data(), public_key.data(), id.size());
+    return id;
+}
+
+} // namespace detail
+
+/**
+ * @brief Parse the (unescaped) message of a signed checkpoint entry
+ * @return false if @p message is not a signed checkpoint
+ */
+inline bool parse_signed_checkpoint_message(std::string_view message,
+                                            SignedCheckpoint& checkpoint) {
+    std::string_view rest = message;
+    const std::string_view prefix(detail::signed_checkpoint_prefix);
+    if (rest.substr(0, prefix.size()) != prefix) return false;
+    rest.remove_prefix(prefix.size());
+
+    auto number = [&rest](std::string_view key, uint64_t& value) {
+        if (rest.substr(0, key.size()) != key) return false;
+        rest.remove_prefix(key.size());
+        size_t n = 0;
+        value = 0;
+        while (n < rest.size() && n < 20 && rest[n] >= '0' && rest[n] <= '9') {
+            value = value * 10 + static_cast<uint64_t>(rest[n++] - '0');
+        }
+        rest.remove_prefix(n);
+        return n > 0;
+    };
+    auto bytes = [&rest](std::string_view key, uint8_t* value, size_t size) {
+        if (rest.substr(0, key.size()) != key || rest.size() < key.size() + 2 * size) {
+            return false;
+        }
+        rest.remove_prefix(key.size());
+        if (!detail::hex_decode(rest.data(), size, value)) return false;
+        rest.remove_prefix(2 * size);
+        return true;
+    };
+    return number("seq=", checkpoint.sequence) &&
+           bytes(" | hash=", checkpoint.chain_hash.data(), checkpoint.chain_hash.size()) &&
+           bytes(" | key=", checkpoint.key_id.data(), checkpoint.key_id.size()) &&
+           bytes(" | sig=", checkpoint.signature.data(), checkpoint.signature.size()) &&
+           rest.empty();
+}
+
+/**
+ * @brief Sign entry @p sequence of @p device_id's chain
+ */
+inline SignedCheckpoint sign_checkpoint(const ed25519::SigningKey& key, std::string_view device_id,
+                                        uint64_t sequence, const SHA256::Hash& chain_hash) {
+    SignedCheckpoint checkpoint;
+    checkpoint.sequence = sequence;
+    checkpoint.chain_hash = chain_hash;
+    checkpoint.key_id = detail::key_id(key.public_key());
+    std::string payload;
+    detail::signed_checkpoint_payload(device_id, sequence, chain_hash, payload);
+    checkpoint.signature = key.sign(payload);
+    return checkpoint;
+}
+
+/**
+ * @brief CheckpointSigner holding an Ed25519 key
+ *
+ * With @p background (the default) signatures are computed on a worker
+ * thread; otherwise request() signs before it returns, for targets
+ * without threads. Only the newest request is kept: one that arrives
+ * while another is still queued replaces it.
+ */
+class Ed25519CheckpointSigner : public CheckpointSigner {
+public:
+    explicit Ed25519CheckpointSigner(const ed25519::Seed& seed, bool background = true)
+        : key_(seed), background_(background) {
+        if (background_) worker_ = std::thread([this] { run(); });
+    }
+
+    ~Ed25519CheckpointSigner() override {
+        if (!background_) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        worker_.join();
+    }
+
+    Ed25519CheckpointSigner(const Ed25519CheckpointSigner&) = delete;
+    Ed25519CheckpointSigner& operator=(const Ed25519CheckpointSigner&) = delete;
+
+    void request(std::string_view device_id, uint64_t sequence,
+                 const SHA256::Hash& chain_hash) override {
+        if (!background_) {
+            publish(sign_checkpoint(key_, device_id, sequence, chain_hash));
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queued_) ++superseded_;
+            device_id_.assign(device_id.data(), device_id.size());
+            sequence_ = sequence;
+            chain_hash_ = chain_hash;
+            queued_ = true;
+        }
+        wake_.notify_one();
+    }
+
+    bool take_message(std::string& message) override {
+        if (!ready_.load(std::memory_order_acquire)) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        message.swap(message_);
+        ready_.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    void flush() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return !queued_ && !busy_; });
+    }
+
+    const ed25519::PublicKey& public_key() const { return key_.public_key(); }
+
+    /// Signatures computed so far
+    uint64_t signed_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return signed_;
+    }
+
+    /// Requests replaced by a later one before they were signed
+    uint64_t superseded() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return superseded_;
+    }
+
+private:
+    ed25519::SigningKey key_;
+    const bool background_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::thread worker_;
+    std::string device_id_;
+    uint64_t sequence_ = 0;
+    SHA256::Hash chain_hash_{};
+    bool queued_ = false;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::string message_;               ///< Newest finished message
+    std::atomic<bool> ready_{false};
+    uint64_t signed_ = 0;
+    uint64_t superseded_ = 0;
+
+    void publish(const SignedCheckpoint& checkpoint) {
+        char text[detail::signed_checkpoint_message_capacity];
+        const size_t len = detail::format_signed_checkpoint_message(checkpoint, text);
+        std::lock_guard<std::mutex> lock(mutex_);
+        message_.assign(text, len);
+        ++signed_;
+        ready_.store(true, std::memory_order_release);
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return queued_ || stop_; });
+            if (stop_) return;
+            const std::string device_id = device_id_;
+            const uint64_t sequence = sequence_;
+            const SHA256::Hash chain_hash = chain_hash_;
+            queued_ = false;
+            busy_ = true;
+            lock.unlock();
+            const SignedCheckpoint checkpoint = sign_checkpoint(key_, device_id, sequence,
+                                                                chain_hash);
+            publish(checkpoint);
+            lock.lock();
+            busy_ = false;
+            if (!queued_) idle_.notify_all();
+        }
+    }
+};
+
+struct SignatureOptions {
+    /// Options of the chain pass; its thread count also applies to signatures
+    VerifyOptions verify;
+    /// Entries before the first line of the log (with verify.initial_hash)
+    uint64_t first_sequence = 0;
+    /// Signatures per batch equation
+    size_t batch_size = 64;
+};
+
+struct SignedVerifyResult : VerifyResult {
+    uint64_t signatures = 0;        ///< Signed checkpoints verified
+    uint64_t signed_sequence = 0;   ///< Last entry covered by a valid signature (0: none)
+};
+
+namespace detail {
+
+/// Entries between recorded offsets in a SignedScan
+static constexpr uint64_t signed_scan_stride = 256;
+
+/**
+ * @brief What one segment of the chain pass records for signature checks
+ */
+struct SignedScan {
+    struct Claim {
+        uint64_t entry;                 ///< 1-based entry within the segment
+        size_t offset;
+        SignedCheckpoint checkpoint;
+        std::string payload;            ///< Signed bytes
+    };
+
+    uint64_t entries = 0;               ///< Entries seen
+    std::vector<size_t> offsets;        ///< Offset of entries 1, 1 + stride, ...
+    std::vector<Claim> claims;
+    std::string message;                ///< Scratch
+
+    void add(std::string_view entry, size_t offset) {
+        if (entries++ % signed_scan_stride == 0) offsets.push_back(offset);
+        // Cheap filter before parsing: the message must start with the prefix
+        static constexpr char needle[] = "\"message\":\"Signed Checkpoint | ";
+        if (entry.find(needle) == std::string_view::npos) return;
+        EntryView view;
+        Claim claim{entries, offset, {}, {}};
+        message.clear();
+        // An ordinary message that merely starts like one is not a claim
+        if (!parse_entry(entry, view) || view.user_id != static_cast<uint64_t>(UserID::System) ||
+            !unescape_json(view.message, message) ||
+            !parse_signed_checkpoint_message(message, claim.checkpoint) ||
+            !unescape_json(view.device_id, message.erase())) {
+            return;
+        }
+        signed_checkpoint_payload(message, claim.checkpoint.sequence, claim.checkpoint.chain_hash,
+                                  claim.payload);
+        claims.push_back(std::move(claim));
+    }
+
+    /// Entry @p number (1-based) of the segment, via the nearest recorded offset
+    std::string_view entry_at(std::string_view log, uint64_t number) const {
+        size_t pos = offsets[(number - 1) / signed_scan_stride];
+        for (uint64_t skip = (number - 1) % signed_scan_stride;; ) {
+            const size_t newline = log.find('\n', pos);
+            std::string_view line = log.substr(pos, newline == std::string_view::npos
+                                                        ? std::string_view::npos
+                                                        : newline - pos);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (!line.empty() && skip-- == 0) return line;
+            if (newline == std::string_view::npos) return {};
+            pos = newline + 1;
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Verify a JSON-lines log and the signed checkpoints in it
+ *
+ * Signed checkpoints are the System entries whose message parses as one;
+ * they are collected during the chain pass. Each must name an earlier
+ * entry of the log by its chain hash (HashMismatch) and carry a valid
+ * signature by @p public_key (BadSignature). On failure, failed_entry and
+ * failed_offset locate the checkpoint entry. Checkpoints over entries
+ * before the start of the log are not counted.
+ */
+inline SignedVerifyResult verify_signed_checkpoints(std::string_view log,
+                                                    const ed25519::PublicKey& public_key,
+                                                    const SignatureOptions& options = SignatureOptions()) {
+    SignedVerifyResult result;
+    std::vector<detail::SignedScan> scans(detail::segment_count(log, options.verify));
+    static_cast<VerifyResult&>(result) = detail::verify_segments(
+        log, options.verify, [&scans](size_t segment, std::string_view entry, size_t offset) {
+            scans[segment].add(entry, offset);
+        });
+    detail::count_verified(result);
+    if (!result.ok()) return result;
+
+    struct Claim {
+        uint64_t entry;     ///< 1-based entry of the checkpoint
+        size_t offset;
+        uint64_t sequence;
+    };
+    std::vector<Claim> claims;
+    std::vector<ed25519::SignedMessage> items;
+    auto fail = [&result](VerifyStatus status, const Claim& claim, uint64_t signatures) {
+        result.status = status;
+        result.failed_entry = claim.entry;
+        result.failed_offset = claim.offset;
+        result.entries = claim.entry - 1;
+        result.signatures = signatures;
+        result.signed_sequence = 0;
+        return result;
+    };
+
+    const std::array<uint8_t, 8> expected_key = detail::key_id(public_key);
+    uint64_t base = 0;      // entries before the current segment
+    for (const detail::SignedScan& scan : scans) {
+        for (const detail::SignedScan::Claim& found : scan.claims) {
+            const SignedCheckpoint& checkpoint = found.checkpoint;
+            const Claim claim{base + found.entry, found.offset, checkpoint.sequence};
+            if (checkpoint.sequence <= options.first_sequence) continue;
+
+            // The signed entry must be an earlier entry carrying the signed hash
+            uint64_t signed_entry = checkpoint.sequence - options.first_sequence;
+            if (signed_entry >= claim.entry) {
+                return fail(VerifyStatus::HashMismatch, claim, items.size());
+            }
+            const detail::SignedScan* holder = scans.data();
+            while (signed_entry > holder->entries) signed_entry -= (holder++)->entries;
+            const char* prev_hex;
+            const char* chain_hex;
+            SHA256::Hash chain_hash;
+            if (!detail::entry_link_hashes(holder->entry_at(log, signed_entry), prev_hex,
+                                           chain_hex) ||
+                !detail::hex_decode(chain_hex, chain_hash.size(), chain_hash.data()) ||
+                chain_hash != checkpoint.chain_hash) {
+                return fail(VerifyStatus::HashMismatch, claim, items.size());
+            }
+            if (checkpoint.key_id != expected_key) {
+                return fail(VerifyStatus::BadSignature, claim, items.size());
+            }
+            claims.push_back(claim);
+            items.push_back({public_key, checkpoint.signature, found.payload});
+        }
+        base += scan.entries;
+    }
+
+    // Batches on up to options.verify.threads threads; the first failure wins
+    const size_t batch = std::max<size_t>(options.batch_size, 1);
+    const size_t batches = (items.size() + batch - 1) / batch;
+    unsigned threads = options.verify.threads ? options.verify.threads
+                                              : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::min<size_t>(std::max(threads, 1u), std::max<size_t>(batches, 1)));
+    std::vector<size_t> first_bad(batches, 0);
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t b = next.fetch_add(1); b < batches; b = next.fetch_add(1)) {
+            const size_t begin = b * batch;
+            const size_t count = std::min(batch, items.size() - begin);
+            first_bad[b] = begin + ed25519::verify_batch(items.data() + begin, count);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work);
+    work();
+    for (auto& worker : workers) worker.join();
+
+    for (size_t b = 0; b < batches; ++b) {
+        const size_t end = std::min((b + 1) * batch, items.size());
+        if (first_bad[b] != end) {
+            const size_t bad = first_bad[b];
+            return fail(VerifyStatus::BadSignature, claims[bad], bad);
+        }
+    }
+    result.signatures = items.size();
+    for (const Claim& claim : claims) {
+        result.signed_sequence = std::max(result.signed_sequence, claim.sequence);
+    }
+    return result;
+}
+
+/**
+ * @brief verify_signed_checkpoints() over a file
+ * @param ok Set to false if the file could not be read
+ */
+inline SignedVerifyResult verify_signed_file(const std::string& path,
+                                             const ed25519::PublicKey& public_key,
+                                             const SignatureOptions& options = SignatureOptions(),
+                                             bool* ok = nullptr) {
+    MappedFile file(path);
+    if (ok) *ok = file.ok();
+    if (!file.ok()) {
+        SignedVerifyResult result;
+        result.status = VerifyStatus::Malformed;
+        result.failed_entry = 1;
+        return result;
+    }
+    return verify_signed_checkpoints(file.view(), public_key, options);
+}
+
+} // namespace dts
+
+#endif // DTS_SIGNED_CHECKPOINT_HPP
@@ -0,0 +1,117 @@
+/**
+ * @file simd_scan.hpp
+ * @brief Vectorized byte scans for JSON entry parsing and escaping
+ *
+ * Parsing an entry means walking its string values, and formatting one
+ * means checking each message for characters that need escaping. Both
+ * scans test 16 bytes at a time with SSE2 (always present on x86-64) or
+ * NEON (AArch64), then finish the tail byte by byte. Define
+ * DTS_SCAN_NO_SIMD to build the portable loops only.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_SIMD_SCAN_HPP
+#define DTS_SIMD_SCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(DTS_SCAN_NO_SIMD)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DTS_SCAN_SSE2 1
+#    include <emmintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#      include <intrin.h>
+#    endif
+#  elif defined(__aarch64__) && defined(__ARM_NEON)
+#    define DTS_SCAN_NEON 1
+#    include <arm_neon.h>
+#  endif
+#endif
+
+namespace dts {
+namespace detail {
+
+#if defined(DTS_SCAN_SSE2)
+
+/// Index of the lowest set bit of a non-zero mask
+inline unsigned lowest_bit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#endif
+
+/**
+ * @brief First '"' or '\\' in [p, end), or @p end
+ */
+inline const char* find_quote_or_backslash(const char* p, const char* end) {
+#if defined(DTS_SCAN_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; end - p >= 16; p += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                        _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask) return p + lowest_bit(static_cast<unsigned>(mask));
+    }
+#elif defined(DTS_SCAN_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        if (vmaxvq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)))) break;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == '"' || *p == '\\') return p;
+    }
+    return end;
+}
+
+/**
+ * @brief First byte in [p, end) that JSON requires escaping ('"', '\\', < 0x20), or @p end
+ */
+inline const char* find_json_escape(const char* p, const char* end) {
+#if defined(DTS_SCAN_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    for (; end - p >= 16; p += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // Unsigned c <= 0x1F  <=>  max(c, 0x1F) == 0x1F
+        const __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max);
+        const int mask = _mm_movemask_epi8(_mm_or_si128(
+            control, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))));
+        if (mask) return p + lowest_bit(static_cast<unsigned>(mask));
+    }
+#elif defined(DTS_SCAN_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control_end = vdupq_n_u8(0x20);
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t hits = vorrq_u8(vcltq_u8(chunk, control_end),
+                                         vorrq_u8(vceqq_u8(chunk, quote),
+                                                  vceqq_u8(chunk, backslash)));
+        if (vmaxvq_u8(hits)) break;
+    }
+#endif
+    for (; p < end; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\' || c < 0x20) return p;
+    }
+    return end;
+}
+
+} // namespace detail
+} // namespace dts
+
+#endif // DTS_SIMD_SCAN_HPP
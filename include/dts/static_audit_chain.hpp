@@ -0,0 +1,239 @@
+/**
+ * @file static_audit_chain.hpp
+ * @brief Fixed-capacity audit chain for targets without a heap
+ *
+ * StaticAuditChain produces the same entries as AuditChain, byte for
+ * byte, but keeps all of its state inline: the device ID, the chaining
+ * state and a ring of Slots pending entries of up to SlotBytes each. It
+ * never allocates, and it needs no std::string, iostreams, std::function
+ * or std::chrono. The includes are entry_format.hpp, format.hpp and
+ * sha256.hpp plus <atomic>, <cstring> and <string_view>. Logs it writes
+ * are verified with the usual tools.
+ *
+ * Entries go into the ring; a storage task drains it with front()/pop().
+ * One producer and one consumer may run concurrently, e.g. an application
+ * task and a flash writer. When the ring is full, or an entry would not
+ * fit its slot, log() returns 0 and the chain does not advance, so the
+ * stored log stays verifiable and the caller decides what to do.
+ *
+ * An entry takes 265 bytes plus the escaped device ID and message, so a
+ * 512-byte slot holds messages of about 230 characters. Budget per log():
+ * - RAM: sizeof(StaticAuditChain) = Slots * (SlotBytes + sizeof(size_t))
+ *   plus about 360 bytes of chain state (4520 bytes for <512, 8> on
+ *   x86-64). Nothing else is allocated.
+ * - Stack: fixed and independent of the message. The largest frames are
+ *   log_at() itself and the SHA-256 message schedule. GCC 12 -O2 with the
+ *   portable SHA-256 reports 880 bytes on x86-64 with -fstack-usage;
+ *   measure the same way for the target toolchain.
+ * - Cycles: one pass over the message to find escapes, one to copy it,
+ *   and at most max_compressions(M) SHA-256 block compressions for an
+ *   M-byte message. The only other data-dependent work is escaping and
+ *   the date, which is rendered once per second. The worst case is
+ *   therefore bounded by SlotBytes: about 7 compressions for a 512-byte
+ *   slot, or 2.4 us per log with the portable code on a desktop x86 core.
+ *
+ * Merkle checkpoints, sinks and batching are not available in this
+ * profile; use AuditChain where a heap exists.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_STATIC_AUDIT_CHAIN_HPP
+#define DTS_STATIC_AUDIT_CHAIN_HPP
+
+#include "entry_format.hpp"
+#include "format.hpp"
+#include "sha256.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace dts {
+
+/**
+ * @brief Wall-clock source of a static chain: milliseconds since the Unix epoch
+ *
+ * Typically a thin wrapper over the board's RTC.
+ */
+using StaticClock = int64_t (*)();
+
+/**
+ * @brief Allocation-free audit chain with a ring of @p Slots pending entries
+ * @tparam SlotBytes Capacity of one entry; bounds the message length
+ * @tparam Slots Pending entries held until the consumer pops them
+ */
+template <size_t SlotBytes = 512, size_t Slots = 8>
+class StaticAuditChain {
+public:
+    static_assert(Slots > 0, "StaticAuditChain needs at least one slot");
+
+    /// Longest device ID, JSON-escaped
+    static constexpr size_t max_device_id_bytes = 64;
+
+    /**
+     * @brief Upper bound on SHA-256 compressions for a message of @p message_bytes
+     *
+     * The "device_id|" prefix is absorbed once at construction; a log then
+     * hashes at most 63 buffered prefix bytes, the timestamp, user and
+     * severity fields, the message and "|previous_hash", plus padding.
+     */
+    static constexpr size_t max_compressions(size_t message_bytes) {
+        return (63 + detail::timestamp_length + 9 + message_bytes + 65 + 9 + 63) / 64;
+    }
+
+    /**
+     * @param device_id Unique device identifier; see valid()
+     * @param clock Timestamp source for log(); log_at() works without one
+     */
+    explicit StaticAuditChain(std::string_view device_id, StaticClock clock = nullptr)
+        : clock_(clock) {
+        init(device_id, 0, detail::chain_init_hash());
+    }
+
+    /**
+     * @brief Continue a chain after @p sequence entries ending in @p last_hash
+     */
+    StaticAuditChain(std::string_view device_id, uint64_t sequence,
+                     const SHA256::Hash& last_hash, StaticClock clock = nullptr)
+        : clock_(clock) {
+        init(device_id, sequence, last_hash);
+    }
+
+    StaticAuditChain(const StaticAuditChain&) = delete;
+    StaticAuditChain& operator=(const StaticAuditChain&) = delete;
+
+    /**
+     * @brief false if the device ID did not fit; every log() then fails
+     */
+    bool valid() const { return valid_; }
+
+    /**
+     * @brief Log an event timestamped by the clock (0 ms without one)
+     * @return Entry length, or 0 if it was not logged (see the file comment)
+     */
+    size_t log(std::string_view message, UserID user_id = UserID::System,
+               Severity severity = Severity::Info) {
+        return log_at(clock_ ? clock_() : 0, message, user_id, severity);
+    }
+
+    /**
+     * @brief Log an event with an explicit timestamp
+     * @param timestamp_ms Milliseconds since the Unix epoch
+     */
+    size_t log_at(int64_t timestamp_ms, std::string_view message,
+                  UserID user_id = UserID::System, Severity severity = Severity::Info) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (!valid() || head - tail_.load(std::memory_order_acquire) >= Slots) {
+            ++rejected_;
+            return 0;
+        }
+        const size_t escaped_len = detail::json_escaped_length(message.data(), message.size());
+        const size_t length = detail::json_entry_length(device_json_len_, escaped_len,
+                                                        user_id, severity);
+        if (length > SlotBytes) {
+            ++rejected_;
+            return 0;
+        }
+
+        char timestamp[detail::timestamp_length];
+        timestamp_formatter_.format(timestamp_ms, timestamp);
+        const SHA256::Hash hash = detail::chain_hash(prefix_state_, timestamp, user_id, severity,
+                                                     message, previous_hex_);
+        char hex[64];
+        detail::hex_encode(hash.data(), hash.size(), hex);
+
+        Slot& slot = slots_[head % Slots];
+        detail::write_json_entry(slot.data, std::string_view(device_json_, device_json_len_),
+                                 timestamp, user_id, severity, message, escaped_len,
+                                 previous_hex_, hex);
+        slot.length = length;
+        head_.store(head + 1, std::memory_order_release);
+
+        previous_hash_ = hash;
+        std::memcpy(previous_hex_, hex, sizeof(hex));
+        ++sequence_number_;
+        return length;
+    }
+
+    /**
+     * @brief Oldest pending entry (without a newline), or an empty view
+     *
+     * Valid until pop(). Consumer side.
+     */
+    std::string_view front() const {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return {};
+        const Slot& slot = slots_[tail % Slots];
+        return std::string_view(slot.data, slot.length);
+    }
+
+    /**
+     * @brief Release the oldest pending entry. Consumer side.
+     */
+    void pop() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail != head_.load(std::memory_order_acquire)) {
+            tail_.store(tail + 1, std::memory_order_release);
+        }
+    }
+
+    size_t pending() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool full() const { return pending() >= Slots; }
+
+    /// log() calls refused because the ring was full or the entry too long
+    uint64_t rejected() const { return rejected_; }
+
+    uint64_t get_sequence_number() const { return sequence_number_; }
+
+    const SHA256::Hash& last_hash() const { return previous_hash_; }
+
+    /// Current chain hash as 64 hex characters
+    std::string_view chain_hash_hex() const { return std::string_view(previous_hex_, 64); }
+
+    static constexpr size_t slot_bytes() { return SlotBytes; }
+    static constexpr size_t slot_count() { return Slots; }
+
+private:
+    struct Slot {
+        size_t length = 0;
+        char data[SlotBytes];
+    };
+
+    Slot slots_[Slots];
+    std::atomic<size_t> head_{0};       ///< Entries logged (producer)
+    std::atomic<size_t> tail_{0};       ///< Entries popped (consumer)
+    char device_json_[max_device_id_bytes];
+    size_t device_json_len_ = 0;
+    bool valid_ = false;
+    SHA256 prefix_state_;
+    SHA256::Hash previous_hash_{};
+    char previous_hex_[64];
+    uint64_t sequence_number_ = 0;
+    uint64_t rejected_ = 0;
+    StaticClock clock_;
+    TimestampFormatter timestamp_formatter_;
+
+    void init(std::string_view device_id, uint64_t sequence, const SHA256::Hash& last_hash) {
+        const size_t json_len = detail::json_escaped_length(device_id.data(), device_id.size());
+        if (json_len <= max_device_id_bytes) {
+            detail::escape_json(device_id.data(), device_id.size(), device_json_);
+            device_json_len_ = json_len;
+            valid_ = true;
+        }
+        prefix_state_ = detail::chain_prefix(device_id);
+        previous_hash_ = last_hash;
+        detail::hex_encode(previous_hash_.data(), previous_hash_.size(), previous_hex_);
+        sequence_number_ = sequence;
+    }
+};
+
+} // namespace dts
+
+#endif // DTS_STATIC_AUDIT_CHAIN_HPP
@@ -0,0 +1,141 @@
+/**
+ * @file static_message.hpp
+ * @brief Fixed-capacity message builder and schema renderer
+ *
+ * The allocation-free counterparts of MessageBuilder and EventFormat, for
+ * targets without a heap. Messages are rendered into an inline buffer of
+ * a compile-time capacity, in exactly the "Name | Key:value" form that
+ * EventFormat produces for the same schema and values. Floating-point
+ * values are not supported, which keeps <charconv> and printf out of the
+ * build.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_STATIC_MESSAGE_HPP
+#define DTS_STATIC_MESSAGE_HPP
+
+#include "event_fields.hpp"
+#include "format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace dts {
+
+/**
+ * @brief "Name | Key:value" message in an inline buffer of @p Capacity bytes
+ *
+ * Text that does not fit is dropped and overflowed() is set until the next
+ * begin(); callers should not log a message that overflowed.
+ */
+template <size_t Capacity>
+class StaticMessageBuilder {
+public:
+    static_assert(Capacity > 0, "StaticMessageBuilder needs a non-zero capacity");
+
+    StaticMessageBuilder& begin(std::string_view name) {
+        size_ = 0;
+        overflowed_ = false;
+        return *this << name;
+    }
+
+    template <typename T>
+    StaticMessageBuilder& field(std::string_view key, const T& value) {
+        *this << " | " << key << ':';
+        return *this << value;
+    }
+
+    StaticMessageBuilder& field_if(std::string_view key, std::string_view value) {
+        return value.empty() ? *this : field(key, value);
+    }
+
+    StaticMessageBuilder& operator<<(std::string_view text) {
+        size_t len = text.size();
+        if (len > Capacity - size_) {
+            len = Capacity - size_;
+            overflowed_ = true;
+        }
+        std::memcpy(buffer_ + size_, text.data(), len);
+        size_ += len;
+        return *this;
+    }
+
+    StaticMessageBuilder& operator<<(const char* text) { return *this << std::string_view(text); }
+
+    StaticMessageBuilder& operator<<(char c) { return *this << std::string_view(&c, 1); }
+
+    template <typename Int,
+              typename std::enable_if<std::is_integral<Int>::value &&
+                                      !std::is_same<Int, bool>::value &&
+                                      !std::is_same<Int, char>::value, int>::type = 0>
+    StaticMessageBuilder& operator<<(Int value) {
+        char text[24];
+        size_t len = 0;
+        uint64_t magnitude = static_cast<uint64_t>(value);
+        if (std::is_signed<Int>::value && value < 0) {
+            text[len++] = '-';
+            magnitude = 0 - magnitude;
+        }
+        len += detail::format_uint(magnitude, text + len);
+        return *this << std::string_view(text, len);
+    }
+
+    std::string_view view() const { return std::string_view(buffer_, size_); }
+    size_t size() const { return size_; }
+    bool overflowed() const { return overflowed_; }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    char buffer_[Capacity];
+    size_t size_ = 0;
+    bool overflowed_ = false;
+};
+
+namespace detail {
+
+template <typename Builder, typename T>
+void put_schema_field(Builder& msg, std::string_view key, const T& value) {
+    msg << " | ";
+    if (!key.empty()) msg << key << ':';
+    msg << value;
+}
+
+template <typename Builder, typename T>
+void put_schema_field(Builder& msg, std::string_view key, const UnitField<T>& field) {
+    put_schema_field(msg, key, field.value);
+    if (field.unit.empty()) return;
+    if (field.separator != '\0') msg << field.separator;
+    msg << field.unit;
+}
+
+template <typename Builder, typename T>
+void put_schema_field(Builder& msg, std::string_view key, const OptionalField<T>& field) {
+    if (field.present) put_schema_field(msg, key, field.value);
+}
+
+} // namespace detail
+
+/**
+ * @brief Render @p name followed by one value per field of @p Schema
+ *
+ * Same output as EventFormat<Schema>::render_as() without a trailer; the
+ * separators are written per call instead of being pre-rendered.
+ */
+template <typename Schema, typename Builder, typename... Values>
+std::string_view render_event(Builder& msg, std::string_view name, const Values&... values) {
+    static_assert(sizeof...(Values) == sizeof(Schema::fields) / sizeof(Schema::fields[0]),
+                  "one value is required for each field of the schema");
+    msg.begin(name);
+    size_t index = 0;
+    (detail::put_schema_field(msg, Schema::fields[index++], values), ...);
+    return msg.view();
+}
+
+} // namespace dts
+
+#endif // DTS_STATIC_MESSAGE_HPP
@@ -0,0 +1,172 @@
+/**
+ * @file string_pool.hpp
+ * @brief Interned device IDs and adapter metadata with cached JSON forms
+ *
+ * A process that runs thousands of chains repeats the same few device,
+ * building, zone and protocol identifiers in every chain and adapter.
+ * StringPool stores each distinct string once, in arena blocks, together
+ * with its JSON-escaped form, so chains hold an 8-byte pointer instead of a
+ * std::string and never escape or copy an identifier when they log.
+ *
+ * Interned strings are never freed individually; they live as long as the
+ * pool. StringPool::shared() is the process-wide pool used by AuditChain
+ * and the adapters, and is never destroyed.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_STRING_POOL_HPP
+#define DTS_STRING_POOL_HPP
+
+#include "format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dts {
+
+namespace detail {
+
+/**
+ * @brief Bump allocator for bytes that live as long as the arena
+ */
+class Arena {
+public:
+    explicit Arena(size_t block_size = 4096) : block_size_(block_size) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    char* allocate(size_t size) {
+        if (size > left_) {
+            const size_t block = std::max(block_size_, size);
+            blocks_.emplace_back(new char[block]);
+            next_ = blocks_.back().get();
+            left_ = block;
+            reserved_ += block;
+        }
+        char* out = next_;
+        next_ += size;
+        left_ -= size;
+        return out;
+    }
+
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) return {};
+        char* out = allocate(text.size());
+        std::memcpy(out, text.data(), text.size());
+        return std::string_view(out, text.size());
+    }
+
+    /// Bytes held in blocks, including unused block tails
+    size_t reserved() const { return reserved_; }
+
+private:
+    size_t block_size_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* next_ = nullptr;
+    size_t left_ = 0;
+    size_t reserved_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief An interned string and its JSON string-body form
+ */
+struct PooledString {
+    std::string_view text;
+    std::string_view json;      ///< Escaped; shares text's bytes when nothing needs escaping
+};
+
+/**
+ * @brief Thread-safe, append-only string interning pool
+ */
+class StringPool {
+public:
+    explicit StringPool(size_t block_size = 4096) : arena_(block_size) {}
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @brief The pooled copy of @p text, added on first use
+     * @return Reference valid for the pool's lifetime
+     */
+    const PooledString& intern(std::string_view text) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = index_.find(text);
+            if (it != index_.end()) return *it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(text);
+        if (it != index_.end()) return *it->second;
+
+        PooledString pooled;
+        pooled.text = arena_.copy(text);
+        const size_t escaped = detail::json_escaped_length(text.data(), text.size());
+        if (escaped == text.size()) {
+            pooled.json = pooled.text;
+        } else {
+            char* out = arena_.allocate(escaped);
+            detail::escape_json(text.data(), text.size(), out);
+            pooled.json = std::string_view(out, escaped);
+        }
+        strings_.push_back(pooled);
+        index_.emplace(strings_.back().text, &strings_.back());
+        return strings_.back();
+    }
+
+    /// nullptr if @p text has not been interned
+    const PooledString* find(std::string_view text) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(text);
+        return it == index_.end() ? nullptr : it->second;
+    }
+
+    /// Distinct strings held
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return strings_.size();
+    }
+
+    /// Arena bytes reserved for string data
+    size_t bytes() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return arena_.reserved();
+    }
+
+    /**
+     * @brief Process-wide pool (never destroyed, so usable from static destructors)
+     */
+    static StringPool& shared() {
+        static StringPool* pool = new StringPool();
+        return *pool;
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    detail::Arena arena_;
+    std::deque<PooledString> strings_;      ///< Stable addresses
+    std::unordered_map<std::string_view, const PooledString*> index_;
+};
+
+/**
+ * @brief Intern @p text in the shared pool; the view never dangles
+ */
+inline std::string_view intern(std::string_view text) {
+    return StringPool::shared().intern(text).text;
+}
+
+} // namespace dts
+
+#endif // DTS_STRING_POOL_HPP
@@ -0,0 +1,130 @@
+/**
+ * @file timestamp.hpp
+ * @brief Clock sources for audit entries
+ *
+ * Audit entries carry a UTC timestamp with millisecond precision. The clock
+ * that produces it is injectable so gateways can use a monotonic-anchored or
+ * PTP-disciplined time base, and tests or replays can use a fixed one.
+ * TimestampFormatter (format.hpp) renders the timestamps.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_TIMESTAMP_HPP
+#define DTS_TIMESTAMP_HPP
+
+#include "format.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace dts {
+
+/**
+ * @brief Wall-clock time source used to timestamp entries
+ */
+using ClockSource = std::function<std::chrono::system_clock::time_point()>;
+
+namespace clocks {
+
+/**
+ * @brief std::chrono::system_clock (the default)
+ */
+inline ClockSource system() {
+    return [] { return std::chrono::system_clock::now(); };
+}
+
+/**
+ * @brief Wall-clock time anchored once, then advanced by steady_clock
+ *
+ * Immune to NTP steps and manual clock changes after construction, so
+ * timestamps within a chain never go backwards.
+ */
+inline ClockSource monotonic_anchored() {
+    const auto wall_anchor = std::chrono::system_clock::now();
+    const auto steady_anchor = std::chrono::steady_clock::now();
+    return [wall_anchor, steady_anchor] {
+        return wall_anchor + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::steady_clock::now() - steady_anchor);
+    };
+}
+
+/**
+ * @brief Always returns @p time (deterministic tests)
+ */
+inline ClockSource fixed(std::chrono::system_clock::time_point time) {
+    return [time] { return time; };
+}
+
+/**
+ * @brief Returns @p start, then advances by @p step on every call
+ *
+ * Gives reproducible, strictly ordered timestamps for deterministic replay.
+ */
+inline ClockSource stepping(std::chrono::system_clock::time_point start,
+                            std::chrono::system_clock::duration step) {
+    auto next = std::make_shared<std::chrono::system_clock::time_point>(start);
+    return [next, step] {
+        auto now = *next;
+        *next += step;
+        return now;
+    };
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief Read a POSIX clock (e.g., CLOCK_REALTIME, CLOCK_TAI, or a PTP clock id)
+ */
+inline ClockSource posix(clockid_t clock_id) {
+    return [clock_id] {
+        timespec ts{};
+        clock_gettime(clock_id, &ts);
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+    };
+}
+#endif
+
+#if defined(__linux__)
+/**
+ * @brief Read a PTP hardware clock (e.g., "/dev/ptp0")
+ *
+ * The device stays open for the lifetime of the returned source. Falls
+ * back to system() if the device cannot be opened.
+ */
+inline ClockSource ptp(const char* device) {
+    const int fd = ::open(device, O_RDONLY);
+    if (fd < 0) return system();
+    auto handle = std::shared_ptr<int>(new int(fd), [](int* p) { ::close(*p); delete p; });
+    // FD_TO_CLOCKID from the kernel's posix-timers ABI
+    const clockid_t clock_id = static_cast<clockid_t>((~static_cast<unsigned>(fd) << 3) | 3);
+    auto read = posix(clock_id);
+    return [handle, read] { return read(); };
+}
+#endif
+
+} // namespace clocks
+
+/**
+ * @brief Convert a time point to milliseconds since the epoch (floored)
+ */
+inline int64_t to_epoch_ms(std::chrono::system_clock::time_point time) {
+    return std::chrono::floor<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace dts
+
+#endif // DTS_TIMESTAMP_HPP
@@ -0,0 +1,833 @@
+/**
+ * @file upload_pipeline.hpp
+ * @brief Batched, compressed upload of chained entries with resume
+ *
+ * UploadPipeline is a sink that ships a chain's entries to a collector
+ * (e.g. clinical_ai_gateway) in stages:
+ *
+ * - format: AuditChain renders each JSON line, exactly as the file sinks
+ *   store it;
+ * - batch: write() copies the line into the open batch, one contiguous
+ *   buffer with room for the frame header in front;
+ * - compress: the sender thread packs a sealed batch as one block
+ *   (dts/compression.hpp) if that makes it smaller;
+ * - transport: Transport::send() receives the finished frame as a single
+ *   view into the pipeline's buffer, and returns once it is acknowledged.
+ *
+ * A batch is sealed when it reaches max_batch_bytes or max_batch_entries,
+ * or when its first entry is max_batch_delay old. Sealed batches stay
+ * queued in order until the receiver acknowledges them. A frame is built
+ * once and sent again unchanged after a reconnect. At most
+ * max_pending_bytes of entries are queued. Beyond that, write() either
+ * waits (Overflow::Block) or refuses the entry (Overflow::Drop).
+ *
+ * Frame layout (integers are u64 little-endian):
+ *
+ * @code
+ * magic            "DTSBAT01" (body is JSON lines) or "DTSBAT02" (one compressed block)
+ * first_sequence   sequence number of the first entry
+ * entries          number of entries
+ * raw_bytes        size of the JSON lines
+ * body_bytes       size of the body that follows the header
+ * dictionary_id    dictionary of a compressed body (0: none)
+ * body
+ * @endcode
+ *
+ * Resume: the pipeline only queues a contiguous run of sequence numbers.
+ * Transport::connect() reports the last sequence the receiver holds, so
+ * acknowledged batches are dropped and sending continues from there. An
+ * entry may be missing from the queue: it was dropped, it predates a
+ * restart, or the receiver lost it. The pipeline is then behind(), and
+ * it refuses later entries until the missing ones arrive via
+ * write_entry(), usually through catch_up() from the local store the
+ * entries were also written to.
+ *
+ * BatchReceiver is the collector side: it decodes frames, skips entries
+ * it already has, and verifies that the rest continue its chain.
+ * TcpTransport speaks a minimal protocol over one TCP connection. Other
+ * transports (MQTT, HTTP/2, ...) implement Transport on top of their
+ * client library and send the frame as one message or request body.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_UPLOAD_PIPELINE_HPP
+#define DTS_UPLOAD_PIPELINE_HPP
+
+#include "audit_chain.hpp"
+#include "chain_state.hpp"
+#include "chain_verifier.hpp"
+#include "compression.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DTS_POSIX_IO 1
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace dts {
+
+namespace detail {
+
+static constexpr char batch_magic_raw[8] = {'D', 'T', 'S', 'B', 'A', 'T', '0', '1'};
+static constexpr char batch_magic_packed[8] = {'D', 'T', 'S', 'B', 'A', 'T', '0', '2'};
+
+} // namespace detail
+
+/// Size of the header at the front of every frame
+static constexpr size_t batch_header_bytes = 48;
+
+/**
+ * @brief Decoded frame header
+ */
+struct BatchHeader {
+    uint64_t first_sequence = 0;
+    uint64_t entries = 0;
+    uint64_t raw_bytes = 0;         ///< Size of the JSON lines
+    uint64_t body_bytes = 0;        ///< Size of the body after the header
+    uint64_t dictionary_id = 0;     ///< Dictionary of a compressed body (0: none)
+    bool compressed = false;
+
+    uint64_t last_sequence() const { return first_sequence + entries - 1; }
+};
+
+/**
+ * @brief Parse the first batch_header_bytes of a frame
+ */
+inline bool parse_batch_header(std::string_view frame, BatchHeader& header) {
+    if (frame.size() < batch_header_bytes) return false;
+    if (std::memcmp(frame.data(), detail::batch_magic_raw, 8) == 0) {
+        header.compressed = false;
+    } else if (std::memcmp(frame.data(), detail::batch_magic_packed, 8) == 0) {
+        header.compressed = true;
+    } else {
+        return false;
+    }
+    frame.remove_prefix(8);
+    return detail::get_u64(frame, header.first_sequence) && detail::get_u64(frame, header.entries) &&
+           detail::get_u64(frame, header.raw_bytes) && detail::get_u64(frame, header.body_bytes) &&
+           detail::get_u64(frame, header.dictionary_id) && header.entries > 0 &&
+           header.first_sequence > 0;
+}
+
+/**
+ * @brief Append the JSON lines of a complete frame to @p lines
+ * @return false if the frame is malformed or was packed with another dictionary
+ */
+inline bool unpack_batch(std::string_view frame, std::string& lines,
+                         std::string_view dictionary = {}, BatchHeader* decoded = nullptr) {
+    BatchHeader header;
+    if (!parse_batch_header(frame, header) ||
+        frame.size() - batch_header_bytes != header.body_bytes) {
+        return false;
+    }
+    if (decoded) *decoded = header;
+    const std::string_view body = frame.substr(batch_header_bytes);
+    if (!header.compressed) {
+        if (body.size() != header.raw_bytes) return false;
+        lines.append(body.data(), body.size());
+        return true;
+    }
+    if (header.dictionary_id != dictionary_id(dictionary)) return false;
+    const size_t start = lines.size();
+    if (!decompress_block(body, lines, dictionary, header.raw_bytes) ||
+        lines.size() - start != header.raw_bytes) {
+        lines.resize(start);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief A sealed batch as handed to Transport::send()
+ */
+struct UploadBatch {
+    uint64_t first_sequence;
+    uint64_t entries;
+    uint64_t raw_bytes;         ///< JSON lines before compression
+    std::string_view frame;     ///< Header and body; valid only during send()
+};
+
+/**
+ * @brief Delivers frames to a receiver and reports what it holds
+ *
+ * Called from the pipeline's sender thread only. Each frame must be
+ * delivered whole, e.g. as one message or request body.
+ */
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    /**
+     * @brief Connect (or reconnect) to the receiver
+     * @param acknowledged Receives the last sequence number the receiver holds (0: none)
+     */
+    virtual bool connect(uint64_t& acknowledged) = 0;
+
+    /**
+     * @brief Deliver one frame and wait for the receiver's answer
+     * @param acknowledged Receives the last sequence number the receiver now holds
+     * @return false if the connection failed; the pipeline reconnects
+     */
+    virtual bool send(const UploadBatch& batch, uint64_t& acknowledged) = 0;
+
+    /**
+     * @brief Drop the connection after a failed or refused send
+     */
+    virtual void disconnect() {}
+};
+
+/**
+ * @brief What write() does when max_pending_bytes are already queued
+ */
+enum class Overflow {
+    Block,      ///< Wait until the sender frees space
+    Drop        ///< Refuse the entry; the pipeline is behind() until catch_up()
+};
+
+/**
+ * @brief Batching, compression and retry settings of an UploadPipeline
+ */
+struct UploadOptions {
+    /// Seal a batch once its entries take this many bytes
+    size_t max_batch_bytes = 256 * 1024;
+    /// Seal a batch once it holds this many entries
+    size_t max_batch_entries = 4096;
+    /// Seal a batch no later than this after its first entry
+    std::chrono::milliseconds max_batch_delay{200};
+    /// Entry bytes queued (sealed and open) before write() applies back-pressure
+    size_t max_pending_bytes = 8 * 1024 * 1024;
+    /// What write() does when the queue is full
+    Overflow overflow = Overflow::Block;
+    /// Compress batches that get smaller that way
+    bool compress = true;
+    /// Optional preset dictionary (train_dictionary); the receiver needs the same one
+    std::string dictionary;
+    /// Wait between a failed connect or send and the next attempt
+    std::chrono::milliseconds retry_delay{1000};
+};
+
+/**
+ * @brief Sink that uploads entries in acknowledged batches
+ *
+ * Entries are passed on to the optional local sink first (typically a
+ * SegmentedLogSink), which keeps the durable copy that catch_up() reads
+ * after an outage or restart.
+ */
+class UploadPipeline : public LogSink {
+public:
+    UploadPipeline(std::shared_ptr<Transport> transport, UploadOptions options = UploadOptions(),
+                   std::shared_ptr<LogSink> local = nullptr)
+        : transport_(std::move(transport)), options_(std::move(options)),
+          local_(std::move(local)), compressor_(options_.dictionary),
+          dictionary_id_(dictionary_id(options_.dictionary)) {
+        sender_ = std::thread([this] { run(); });
+    }
+
+    /**
+     * @brief Send what is queued, stopping at the first failure
+     *
+     * Entries still unacknowledged are in the local store; catch_up()
+     * uploads them after a restart.
+     */
+    ~UploadPipeline() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_sender_.notify_one();
+        space_cv_.notify_all();
+        sender_.join();
+    }
+
+    UploadPipeline(const UploadPipeline&) = delete;
+    UploadPipeline& operator=(const UploadPipeline&) = delete;
+
+    void write(std::string_view entry, const EntryInfo& info) override {
+        if (local_) local_->write(entry, info);
+        write_entry(entry, info.sequence);
+    }
+
+    /**
+     * @brief Queue the whole batch as one copy when it continues the queue
+     *
+     * Under Overflow::Drop a batch that does not fit is refused whole and
+     * counted once per entry; one that overlaps the queue is retried entry
+     * by entry.
+     */
+    void write_batch(std::string_view entries, const EntryInfo* infos, size_t count) override {
+        if (local_) local_->write_batch(entries, infos, count);
+        if (count == 0) return;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            const uint64_t dropped = dropped_;
+            if (accept_locked(lock, entries, infos[0].sequence, count, false)) return;
+            if (dropped_ != dropped) return;
+        }
+        size_t pos = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t end = entries.find('\n', pos);
+            write_entry(entries.substr(pos, end - pos), infos[i].sequence);
+            pos = end + 1;
+        }
+    }
+
+    /**
+     * @brief Queue one entry (without a newline) by its sequence number
+     * @return true if the entry is queued (now or already); false if it was
+     *         refused because the queue was full or entries before it are missing
+     */
+    bool write_entry(std::string_view entry, uint64_t sequence) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return accept_locked(lock, entry, sequence, 1, true);
+    }
+
+    /**
+     * @brief Seal the open batch and wait until all queued entries are
+     *        acknowledged, a send fails, or the pipeline falls behind
+     */
+    void flush() override {
+        if (local_) local_->flush();
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (next_sequence_ == 0) return;
+        const uint64_t ticket = next_sequence_ - 1;
+        const uint64_t failures = failures_;
+        seal_requested_ = true;
+        wake_sender_.notify_one();
+        flushed_cv_.wait(lock, [&] {
+            return acknowledged_ >= ticket || failures_ != failures || behind_ || stopping_;
+        });
+    }
+
+    /**
+     * @brief Next sequence number the queue accepts (0: any, nothing seen yet)
+     */
+    uint64_t next_sequence() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return next_sequence_;
+    }
+
+    /**
+     * @brief Whether an entry was refused because earlier ones are missing
+     */
+    bool behind() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return behind_;
+    }
+
+    /// Last sequence number the receiver acknowledged
+    uint64_t acknowledged() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return acknowledged_;
+    }
+
+    /// Entries refused because the queue was full (Overflow::Drop)
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+    /// Entry bytes queued and not yet acknowledged
+    size_t pending_bytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_bytes_;
+    }
+
+    /// Frames acknowledged by the receiver
+    uint64_t batches_sent() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_sent_;
+    }
+
+    /// Frame bytes acknowledged by the receiver (after compression)
+    uint64_t bytes_sent() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bytes_sent_;
+    }
+
+    /// Failed connects and sends so far
+    uint64_t failures() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failures_;
+    }
+
+private:
+    struct Batch {
+        std::string frame;          ///< Header space, then JSON lines or the packed block
+        uint64_t first_sequence = 0;
+        uint64_t entries = 0;
+        uint64_t raw_bytes = 0;
+        bool packed = false;        ///< Header written (and body compressed)
+
+        uint64_t last_sequence() const { return first_sequence + entries - 1; }
+    };
+
+    std::shared_ptr<Transport> transport_;
+    UploadOptions options_;
+    std::shared_ptr<LogSink> local_;
+    BlockCompressor compressor_;        ///< Sender thread only
+    uint64_t dictionary_id_;
+    std::string packed_;                ///< Compression output (sender thread only)
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_sender_;
+    std::condition_variable space_cv_;
+    std::condition_variable flushed_cv_;
+    std::deque<Batch> queue_;           ///< Sealed batches, oldest first; the front may be in flight
+    Batch open_;                        ///< Batch being filled
+    std::chrono::steady_clock::time_point open_started_;
+    std::vector<std::string> spare_;    ///< Recycled frame buffers
+    size_t pending_bytes_ = 0;
+    uint64_t next_sequence_ = 0;
+    uint64_t acknowledged_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t batches_sent_ = 0;
+    uint64_t bytes_sent_ = 0;
+    uint64_t failures_ = 0;
+    bool behind_ = false;
+    bool connected_ = false;            ///< Sender thread only
+    bool seal_requested_ = false;
+    bool stopping_ = false;
+    std::thread sender_;
+
+    /// Queue @p count entries starting at @p first_sequence (@p newline: append '\n')
+    bool accept_locked(std::unique_lock<std::mutex>& lock, std::string_view data,
+                       uint64_t first_sequence, uint64_t count, bool newline) {
+        auto out_of_order = [&] {
+            if (first_sequence > next_sequence_) behind_ = true;
+            return first_sequence + count <= next_sequence_;    // true: already queued
+        };
+        if (next_sequence_ != 0 && first_sequence != next_sequence_) return out_of_order();
+        const size_t need = data.size() + (newline ? 1 : 0);
+        auto fits = [&] {
+            return pending_bytes_ == 0 || pending_bytes_ + need <= options_.max_pending_bytes;
+        };
+        if (!fits()) {
+            if (options_.overflow == Overflow::Drop) {
+                dropped_ += count;
+                behind_ = true;
+                return false;
+            }
+            space_cv_.wait(lock, [&] { return fits() || stopping_; });
+            if (stopping_) return false;
+            // The queue may have been restarted or caught up while we waited
+            if (next_sequence_ != 0 && first_sequence != next_sequence_) return out_of_order();
+        }
+
+        if (open_.entries == 0) {
+            if (!spare_.empty()) {
+                open_.frame = std::move(spare_.back());
+                spare_.pop_back();
+            }
+            open_.frame.assign(batch_header_bytes, '\0');
+            open_.frame.reserve(batch_header_bytes + std::max(options_.max_batch_bytes, need));
+            open_.first_sequence = first_sequence;
+            open_started_ = std::chrono::steady_clock::now();
+            // First entry starts the batch timer
+            wake_sender_.notify_one();
+        }
+        open_.frame.append(data.data(), data.size());
+        if (newline) open_.frame.push_back('\n');
+        open_.entries += count;
+        open_.raw_bytes += need;
+        pending_bytes_ += need;
+        next_sequence_ = first_sequence + count;
+        behind_ = false;
+        if (open_.raw_bytes >= options_.max_batch_bytes ||
+            open_.entries >= options_.max_batch_entries) {
+            seal_locked();
+        }
+        return true;
+    }
+
+    void seal_locked() {
+        if (open_.entries == 0) return;
+        const bool first = queue_.empty();
+        queue_.push_back(std::move(open_));
+        open_ = Batch();
+        if (first) wake_sender_.notify_one();
+    }
+
+    void recycle_locked(Batch& batch) {
+        pending_bytes_ -= std::min<size_t>(pending_bytes_, batch.raw_bytes);
+        if (spare_.size() < 4) spare_.push_back(std::move(batch.frame));
+    }
+
+    /// Drop what the receiver holds; restart from its position if entries are missing
+    void resume_locked(uint64_t acknowledged) {
+        acknowledged_ = acknowledged;
+        while (!queue_.empty() && queue_.front().last_sequence() <= acknowledged) {
+            recycle_locked(queue_.front());
+            queue_.pop_front();
+        }
+        const uint64_t first_queued = !queue_.empty() ? queue_.front().first_sequence
+                                      : open_.entries ? open_.first_sequence
+                                                      : next_sequence_;
+        if (next_sequence_ != 0 && first_queued > acknowledged + 1) {
+            // The receiver lacks entries that are no longer queued here
+            for (auto& batch : queue_) recycle_locked(batch);
+            queue_.clear();
+            recycle_locked(open_);
+            open_ = Batch();
+            pending_bytes_ = 0;
+            next_sequence_ = acknowledged + 1;
+            behind_ = true;
+        }
+        space_cv_.notify_all();
+        flushed_cv_.notify_all();
+    }
+
+    /// Write the header and compress the body (sender thread, unlocked)
+    void pack(Batch& batch) {
+        const char* magic = detail::batch_magic_raw;
+        uint64_t dictionary = 0;
+        if (options_.compress) {
+            packed_.assign(batch_header_bytes, '\0');
+            compressor_.compress(std::string_view(batch.frame).substr(batch_header_bytes),
+                                 packed_);
+            if (packed_.size() < batch.frame.size()) {
+                batch.frame.swap(packed_);
+                magic = detail::batch_magic_packed;
+                dictionary = dictionary_id_;
+            }
+        }
+        std::string header(magic, 8);
+        detail::put_u64(header, batch.first_sequence);
+        detail::put_u64(header, batch.entries);
+        detail::put_u64(header, batch.raw_bytes);
+        detail::put_u64(header, batch.frame.size() - batch_header_bytes);
+        detail::put_u64(header, dictionary);
+        std::memcpy(&batch.frame[0], header.data(), batch_header_bytes);
+        batch.packed = true;
+    }
+
+    /// Count a failure and wait out the retry delay; false once stopping
+    bool failed_locked(std::unique_lock<std::mutex>& lock) {
+        ++failures_;
+        flushed_cv_.notify_all();
+        if (stopping_) return false;
+        wake_sender_.wait_for(lock, options_.retry_delay, [&] { return stopping_; });
+        return !stopping_;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_sender_.wait(lock, [&] {
+                return stopping_ || !queue_.empty() || open_.entries > 0;
+            });
+            if (queue_.empty() && open_.entries > 0 && !stopping_ && !seal_requested_) {
+                // Hold the open batch until it fills, times out, or is flushed
+                wake_sender_.wait_until(lock, open_started_ + options_.max_batch_delay, [&] {
+                    return stopping_ || seal_requested_ || !queue_.empty();
+                });
+            }
+            if (queue_.empty()) seal_locked();
+            seal_requested_ = false;
+            if (queue_.empty()) {
+                if (stopping_) break;
+                continue;
+            }
+
+            uint64_t acknowledged = 0;
+            if (!connected_) {
+                lock.unlock();
+                const bool connected = transport_->connect(acknowledged);
+                lock.lock();
+                if (!connected) {
+                    if (!failed_locked(lock)) break;
+                    continue;
+                }
+                connected_ = true;
+                resume_locked(acknowledged);
+                continue;
+            }
+
+            // Writers only append to the deque, which leaves the front in place
+            Batch& batch = queue_.front();
+            lock.unlock();
+            if (!batch.packed) pack(batch);
+            const UploadBatch upload{batch.first_sequence, batch.entries, batch.raw_bytes,
+                                     batch.frame};
+            const bool sent = transport_->send(upload, acknowledged);
+            if (!sent || acknowledged < batch.last_sequence()) transport_->disconnect();
+            lock.lock();
+
+            if (sent && acknowledged >= batch.last_sequence()) {
+                ++batches_sent_;
+                bytes_sent_ += batch.frame.size();
+                resume_locked(acknowledged);
+                continue;
+            }
+            // Down, or the receiver refused the frame: reconnect and resume from its position
+            connected_ = false;
+            if (!failed_locked(lock)) break;
+        }
+    }
+};
+
+/**
+ * @brief Re-queue entries from a local store after UploadPipeline::behind()
+ *
+ * @p reader is a SegmentedLogReader (or anything with last_sequence() and
+ * read_sequences()). Entries are read from the pipeline's next_sequence()
+ * to the end of the store. Entries logged while this runs are refused;
+ * call again with a fresh reader until the pipeline is no longer behind.
+ * @return false if the store could not be read or the queue filled up
+ */
+template <typename Reader>
+bool catch_up(UploadPipeline& pipeline, const Reader& reader) {
+    const uint64_t first = pipeline.next_sequence();
+    if (first == 0 || first > reader.last_sequence()) return true;
+    bool queued = true;
+    const bool read = reader.read_sequences(first, reader.last_sequence(),
+                                            [&](std::string_view entry, uint64_t sequence) {
+        queued = pipeline.write_entry(entry, sequence);
+        return queued;
+    });
+    return read && queued;
+}
+
+/**
+ * @brief Collector side: accepts frames that continue a chain
+ */
+class BatchReceiver {
+public:
+    /**
+     * @param start Position of the entries already held (sequence, last_hash)
+     * @param dictionary Dictionary the senders compress with, if any
+     */
+    explicit BatchReceiver(const ChainState& start = ChainState(), std::string dictionary = {})
+        : sequence_(start.sequence), last_hash_(start.last_hash),
+          dictionary_(std::move(dictionary)) {}
+
+    /**
+     * @brief Verify @p frame and append its new entries to @p lines
+     *
+     * Entries at or below acknowledged() are skipped, so a frame sent again
+     * after a lost acknowledgement is harmless. The rest must start right
+     * after acknowledged() and link to last_hash().
+     * @return false if the frame is malformed, leaves a gap, or does not
+     *         verify; the position is then unchanged (see last_result())
+     */
+    bool receive(std::string_view frame, std::string& lines) {
+        BatchHeader header;
+        scratch_.clear();
+        result_ = VerifyResult();
+        if (!unpack_batch(frame, scratch_, dictionary_, &header)) {
+            result_.status = VerifyStatus::Malformed;
+            return false;
+        }
+        if (header.first_sequence > sequence_ + 1) {
+            result_.status = VerifyStatus::BrokenLink;
+            return false;
+        }
+        if (header.last_sequence() <= sequence_) return true;
+
+        std::string_view fresh(scratch_);
+        for (uint64_t skip = sequence_ + 1 - header.first_sequence; skip > 0; --skip) {
+            const size_t end = fresh.find('\n');
+            if (end == std::string_view::npos) {
+                result_.status = VerifyStatus::Malformed;
+                return false;
+            }
+            fresh.remove_prefix(end + 1);
+        }
+        VerifyOptions options;
+        options.initial_hash = last_hash_;
+        options.recompute = recompute_;
+        result_ = verify_buffer(fresh, options);
+        if (!result_.ok()) return false;
+        if (result_.entries != header.last_sequence() - sequence_) {
+            result_.status = VerifyStatus::Malformed;
+            return false;
+        }
+        lines.append(fresh.data(), fresh.size());
+        sequence_ = header.last_sequence();
+        last_hash_ = result_.last_hash;
+        return true;
+    }
+
+    /// Last sequence number held; what the receiver acknowledges
+    uint64_t acknowledged() const { return sequence_; }
+
+    /// chain_hash of entry acknowledged()
+    const SHA256::Hash& last_hash() const { return last_hash_; }
+
+    /// Outcome of the last verification (status Malformed for undecodable frames)
+    const VerifyResult& last_result() const { return result_; }
+
+    /// Re-derive every chain_hash, not just the links
+    void set_recompute(bool recompute) { recompute_ = recompute; }
+
+private:
+    uint64_t sequence_;
+    SHA256::Hash last_hash_;
+    std::string dictionary_;
+    std::string scratch_;
+    VerifyResult result_;
+    bool recompute_ = false;
+};
+
+#if defined(DTS_POSIX_IO)
+
+namespace detail {
+
+inline bool send_all(int fd, const char* data, size_t size) {
+#if defined(MSG_NOSIGNAL)
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, data, size, flags);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+inline bool recv_all(int fd, char* data, size_t size) {
+    while (size > 0) {
+        const ssize_t got = ::recv(fd, data, size, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        data += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+inline bool send_ack(int fd, uint64_t sequence) {
+    std::string ack;
+    put_u64(ack, sequence);
+    return send_all(fd, ack.data(), ack.size());
+}
+
+inline bool recv_ack(int fd, uint64_t& sequence) {
+    char ack[8];
+    if (!recv_all(fd, ack, sizeof(ack))) return false;
+    std::string_view in(ack, sizeof(ack));
+    return get_u64(in, sequence);
+}
+
+/**
+ * @brief Read one whole frame (header, then body_bytes) into @p frame
+ * @param max_body Refuse frames whose body is larger than this
+ */
+inline bool recv_frame(int fd, std::string& frame, uint64_t max_body = 64 * 1024 * 1024) {
+    frame.resize(batch_header_bytes);
+    BatchHeader header;
+    if (!recv_all(fd, &frame[0], batch_header_bytes) || !parse_batch_header(frame, header) ||
+        header.body_bytes > max_body) {
+        return false;
+    }
+    frame.resize(batch_header_bytes + header.body_bytes);
+    return header.body_bytes == 0 ||
+           recv_all(fd, &frame[batch_header_bytes], header.body_bytes);
+}
+
+} // namespace detail
+
+/**
+ * @brief Transport over one TCP connection
+ *
+ * Protocol: after accepting, the receiver sends its acknowledged sequence
+ * as a u64 LE. For each frame the sender writes, it answers with the new
+ * acknowledged sequence the same way. Frames are written straight from the
+ * pipeline's buffer. Add TLS with a terminating proxy or a Transport of
+ * your own.
+ */
+class TcpTransport : public Transport {
+public:
+    /**
+     * @param timeout Send and receive timeout; a stalled receiver counts as a failure
+     */
+    TcpTransport(std::string host, uint16_t port,
+                 std::chrono::milliseconds timeout = std::chrono::seconds(30))
+        : host_(std::move(host)), port_(port), timeout_(timeout) {}
+
+    ~TcpTransport() override { disconnect(); }
+
+    TcpTransport(const TcpTransport&) = delete;
+    TcpTransport& operator=(const TcpTransport&) = delete;
+
+    bool connect(uint64_t& acknowledged) override {
+        disconnect();
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        const std::string service = std::to_string(port_);
+        if (::getaddrinfo(host_.c_str(), service.c_str(), &hints, &found) != 0) return false;
+        for (addrinfo* ai = found; ai && fd_ < 0; ai = ai->ai_next) {
+            fd_ = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd_ < 0) continue;
+            ::fcntl(fd_, F_SETFD, FD_CLOEXEC);
+            timeval tv;
+            tv.tv_sec = static_cast<time_t>(timeout_.count() / 1000);
+            tv.tv_usec = static_cast<suseconds_t>((timeout_.count() % 1000) * 1000);
+            ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            ::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#if defined(SO_NOSIGPIPE)
+            const int on = 1;
+            ::setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            if (::connect(fd_, ai->ai_addr, ai->ai_addrlen) != 0) disconnect();
+        }
+        ::freeaddrinfo(found);
+        if (fd_ < 0) return false;
+        const int nodelay = 1;
+        ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        if (detail::recv_ack(fd_, acknowledged)) return true;
+        disconnect();
+        return false;
+    }
+
+    bool send(const UploadBatch& batch, uint64_t& acknowledged) override {
+        return fd_ >= 0 && detail::send_all(fd_, batch.frame.data(), batch.frame.size()) &&
+               detail::recv_ack(fd_, acknowledged);
+    }
+
+    void disconnect() override {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    std::string host_;
+    uint16_t port_;
+    std::chrono::milliseconds timeout_;
+    int fd_ = -1;
+};
+
+#endif // DTS_POSIX_IO
+
+} // namespace dts
+
+#endif // DTS_UPLOAD_PIPELINE_HPP
@@ -0,0 +1,451 @@
+/**
+ * @file watermark.hpp
+ * @brief Chain-hash watermarks and verification of the entries after one
+ *
+ * A watermark names a position in a device's chain. It records the
+ * sequence number, the chain_hash and timestamp of that entry, and
+ * optionally the byte offset just past it in the log. Devices publish
+ * one periodically, made from AuditChain::state() or a sink's ChainState
+ * snapshot. A server that has verified a log up to a watermark only needs
+ * to check the entries after it. A chain hash commits to every entry
+ * before it, so those entries are linked to the accepted position and the
+ * cost is O(new entries).
+ *
+ * Watermarks travel as one JSON line:
+ *
+ * @code
+ * {"watermark":"DTSWM1","device_id":"PUMP-1","sequence":1024,
+ *  "timestamp":"2025-01-01T00:00:00.000Z","log_offset":356812,
+ *  "chain_hash":"<64 hex>","signature":"hmac-sha256:<64 hex>"}
+ * @endcode
+ *
+ * The signature is optional (sign_watermark()). It covers watermark_payload(),
+ * so a server holding the device key can tell a published watermark from one
+ * forged in transit. It does not stop a party holding the key from rewriting
+ * history; see Security Considerations in the README.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#ifndef DTS_WATERMARK_HPP
+#define DTS_WATERMARK_HPP
+
+#include "chain_state.hpp"
+#include "chain_verifier.hpp"
+#include "entry_parser.hpp"
+#include "format.hpp"
+#include "hmac.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace dts {
+
+/// How a watermark is signed
+enum class WatermarkSignature {
+    None,
+    HmacSha256      ///< HMAC-SHA256 under a per-device key shared with the server
+};
+
+/**
+ * @brief A published chain position
+ */
+struct Watermark {
+    std::string device_id;
+    uint64_t sequence = 0;                              ///< Entries covered
+    SHA256::Hash chain_hash = detail::chain_init_hash();  ///< chain_hash of entry @c sequence
+    int64_t timestamp_ms = 0;                           ///< Timestamp of entry @c sequence
+    uint64_t log_offset = 0;                            ///< Log bytes covered (0: not known)
+    WatermarkSignature scheme = WatermarkSignature::None;
+    std::string signature;                              ///< Raw signature bytes
+};
+
+/**
+ * @brief Watermark of a chain position (unsigned)
+ */
+inline Watermark make_watermark(const ChainState& state) {
+    Watermark watermark;
+    watermark.device_id = state.device_id;
+    watermark.sequence = state.sequence;
+    watermark.chain_hash = state.last_hash;
+    watermark.timestamp_ms = state.timestamp_ms;
+    watermark.log_offset = state.log_offset;
+    return watermark;
+}
+
+/**
+ * @brief The bytes a signature covers: "DTSWM1|device_id|sequence|chain_hash|timestamp|log_offset"
+ */
+inline std::string watermark_payload(const Watermark& watermark) {
+    char hex[64];
+    char timestamp[detail::timestamp_length];
+    char number[20];
+    detail::hex_encode(watermark.chain_hash.data(), watermark.chain_hash.size(), hex);
+    detail::format_timestamp_ms(watermark.timestamp_ms, timestamp);
+    std::string payload("DTSWM1|");
+    payload += watermark.device_id;
+    payload += '|';
+    payload.append(number, detail::format_uint(watermark.sequence, number));
+    payload += '|';
+    payload.append(hex, sizeof(hex));
+    payload += '|';
+    payload.append(timestamp, sizeof(timestamp));
+    payload += '|';
+    payload.append(number, detail::format_uint(watermark.log_offset, number));
+    return payload;
+}
+
+/**
+ * @brief Sign @p watermark with HMAC-SHA256 under the device's key
+ */
+inline void sign_watermark(Watermark& watermark, const HmacSha256& key) {
+    const SHA256::Hash mac = key.mac(watermark_payload(watermark));
+    watermark.scheme = WatermarkSignature::HmacSha256;
+    watermark.signature.assign(reinterpret_cast<const char*>(mac.data()), mac.size());
+}
+
+/**
+ * @brief Whether @p watermark carries a valid HMAC-SHA256 signature under @p key
+ */
+inline bool check_watermark(const Watermark& watermark, const HmacSha256& key) {
+    if (watermark.scheme != WatermarkSignature::HmacSha256 || watermark.signature.size() != 32) {
+        return false;
+    }
+    const SHA256::Hash mac = key.mac(watermark_payload(watermark));
+    // Constant time: a mismatch does not reveal how many bytes matched
+    unsigned char diff = 0;
+    for (size_t i = 0; i < mac.size(); ++i) {
+        diff |= static_cast<unsigned char>(mac[i] ^
+                                           static_cast<uint8_t>(watermark.signature[i]));
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief Append @p watermark to @p out as one JSON object (no newline)
+ */
+inline void write_watermark(const Watermark& watermark, std::string& out) {
+    char hex[64];
+    char timestamp[detail::timestamp_length];
+    char number[20];
+    const size_t device_len =
+        detail::json_escaped_length(watermark.device_id.data(), watermark.device_id.size());
+    out += "{\"watermark\":\"DTSWM1\",\"device_id\":\"";
+    const size_t device_at = out.size();
+    out.resize(device_at + device_len);
+    detail::escape_json(watermark.device_id.data(), watermark.device_id.size(), &out[device_at]);
+    out += "\",\"sequence\":";
+    out.append(number, detail::format_uint(watermark.sequence, number));
+    detail::format_timestamp_ms(watermark.timestamp_ms, timestamp);
+    out += ",\"timestamp\":\"";
+    out.append(timestamp, sizeof(timestamp));
+    out += "\",\"log_offset\":";
+    out.append(number, detail::format_uint(watermark.log_offset, number));
+    detail::hex_encode(watermark.chain_hash.data(), watermark.chain_hash.size(), hex);
+    out += ",\"chain_hash\":\"";
+    out.append(hex, sizeof(hex));
+    out += '"';
+    if (watermark.scheme == WatermarkSignature::HmacSha256) {
+        std::string signature(watermark.signature.size() * 2, '\0');
+        detail::hex_encode(reinterpret_cast<const uint8_t*>(watermark.signature.data()),
+                           watermark.signature.size(), &signature[0]);
+        out += ",\"signature\":\"hmac-sha256:";
+        out += signature;
+        out += '"';
+    }
+    out += '}';
+}
+
+/**
+ * @brief Parse a watermark written by write_watermark()
+ *
+ * Keys may come in any order; unknown keys with string or integer values
+ * are skipped.
+ * @return false if the text is malformed or a required field is missing
+ */
+inline bool parse_watermark(std::string_view text, Watermark& watermark) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    unsigned seen = 0;
+    Watermark parsed;
+
+    p = detail::skip_json_space(p, end);
+    if (p == end || *p++ != '{') return false;
+    for (;;) {
+        p = detail::skip_json_space(p, end);
+        std::string_view key;
+        p = detail::scan_json_string(p, end, key);
+        if (!p) return false;
+        p = detail::skip_json_space(p, end);
+        if (p == end || *p++ != ':') return false;
+        p = detail::skip_json_space(p, end);
+        if (p == end) return false;
+
+        if (*p == '"') {
+            std::string_view value;
+            p = detail::scan_json_string(p, end, value);
+            if (!p) return false;
+            if (key == "watermark") {
+                if (value != "DTSWM1") return false;
+                seen |= 1;
+            } else if (key == "device_id") {
+                if (!unescape_json(value, parsed.device_id)) return false;
+                seen |= 2;
+            } else if (key == "timestamp") {
+                if (!detail::parse_timestamp_ms(value.data(), value.size(), parsed.timestamp_ms)) {
+                    return false;
+                }
+                seen |= 4;
+            } else if (key == "chain_hash") {
+                if (value.size() != 64 ||
+                    !detail::hex_decode(value.data(), 32, parsed.chain_hash.data())) {
+                    return false;
+                }
+                seen |= 8;
+            } else if (key == "signature") {
+                static constexpr std::string_view hmac_prefix = "hmac-sha256:";
+                if (value.substr(0, hmac_prefix.size()) != hmac_prefix ||
+                    value.size() != hmac_prefix.size() + 64) {
+                    return false;
+                }
+                parsed.signature.resize(32);
+                if (!detail::hex_decode(value.data() + hmac_prefix.size(), 32,
+                                        reinterpret_cast<uint8_t*>(&parsed.signature[0]))) {
+                    return false;
+                }
+                parsed.scheme = WatermarkSignature::HmacSha256;
+            }
+        } else if (*p >= '0' && *p <= '9') {
+            uint64_t value = 0;
+            while (p < end && *p >= '0' && *p <= '9') {
+                value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+            }
+            if (key == "sequence") { parsed.sequence = value; seen |= 16; }
+            else if (key == "log_offset") { parsed.log_offset = value; seen |= 32; }
+        } else {
+            return false;
+        }
+
+        p = detail::skip_json_space(p, end);
+        if (p == end) return false;
+        if (*p == ',') { ++p; continue; }
+        if (*p == '}') break;
+        return false;
+    }
+    if (seen != 63) return false;
+    watermark = std::move(parsed);
+    return true;
+}
+
+/**
+ * @brief Default options for the checks after a watermark
+ *
+ * Tails are short, so every chain_hash is re-derived (recompute): links
+ * alone would accept an entry edited in place.
+ */
+inline VerifyOptions watermark_verify_options() {
+    VerifyOptions options;
+    options.recompute = true;
+    return options;
+}
+
+/**
+ * @brief Verify @p tail, the entries logged after @p accepted
+ *
+ * Counts and offsets in the result are relative to @p tail.
+ */
+inline VerifyResult verify_since(const Watermark& accepted, std::string_view tail,
+                                 VerifyOptions options = watermark_verify_options()) {
+    options.initial_hash = accepted.chain_hash;
+    return verify_buffer(tail, options);
+}
+
+namespace detail {
+
+/// Offset of the first byte of the last line of @p text (which ends in '\n')
+inline size_t last_line_start(std::string_view text) {
+    if (text.size() < 2) return 0;
+    const size_t newline = text.rfind('\n', text.size() - 2);
+    return newline == std::string_view::npos ? 0 : newline + 1;
+}
+
+/// Offset just past the entry whose chain_hash is @p hash, or npos
+inline size_t find_entry_end(std::string_view log, const SHA256::Hash& hash) {
+    std::string needle("\"chain_hash\":\"");
+    const size_t hex_at = needle.size();
+    needle.resize(hex_at + 64);
+    hex_encode(hash.data(), hash.size(), &needle[hex_at]);
+    needle += '"';
+    const size_t found = log.find(needle);
+    if (found == std::string_view::npos) return std::string_view::npos;
+    const size_t newline = log.find('\n', found + needle.size());
+    return newline == std::string_view::npos ? log.size() : newline + 1;
+}
+
+} // namespace detail
+
+/**
+ * @brief Verify the part of a whole log that follows @p accepted
+ *
+ * The log is cut at accepted.log_offset. The entry just before the cut
+ * must carry the watermark's chain_hash; otherwise the log was rewritten
+ * under the watermark, and the result is a BrokenLink at the cut. A
+ * watermark without an offset is located by searching for its chain_hash,
+ * which reads the log but hashes nothing before the cut. failed_offset is
+ * relative to @p log; entries counts only the new entries.
+ */
+inline VerifyResult verify_log_since(std::string_view log, const Watermark& accepted,
+                                     VerifyOptions options = watermark_verify_options()) {
+    if (accepted.sequence == 0) return verify_since(accepted, log, options);
+
+    size_t cut = static_cast<size_t>(accepted.log_offset);
+    bool anchored = false;
+    if (cut == 0) {
+        cut = detail::find_entry_end(log, accepted.chain_hash);
+        anchored = cut != std::string_view::npos;
+    } else if (cut <= log.size() && log[cut - 1] == '\n') {
+        const std::string_view line = log.substr(0, cut);
+        std::string_view anchor = line.substr(detail::last_line_start(line));
+        anchor.remove_suffix(anchor.size() >= 2 && anchor[anchor.size() - 2] == '\r' ? 2 : 1);
+        const char* previous_hex = nullptr;
+        const char* chain_hex = nullptr;
+        SHA256::Hash anchor_hash;
+        anchored = detail::entry_link_hashes(anchor, previous_hex, chain_hex) &&
+                   detail::hex_decode(chain_hex, 32, anchor_hash.data()) &&
+                   anchor_hash == accepted.chain_hash;
+    }
+    if (!anchored) {
+        VerifyResult result;
+        result.status = VerifyStatus::BrokenLink;
+        result.failed_entry = 1;
+        result.failed_offset = std::min(cut, log.size());
+        return result;
+    }
+    VerifyResult result = verify_since(accepted, log.substr(cut), options);
+    if (!result.ok()) result.failed_offset += cut;
+    return result;
+}
+
+/**
+ * @brief verify_log_since() over a file
+ * @param ok Set to false if the file could not be read
+ */
+inline VerifyResult verify_file_since(const std::string& path, const Watermark& accepted,
+                                      const VerifyOptions& options = watermark_verify_options(),
+                                      bool* ok = nullptr) {
+    MappedFile file(path);
+    if (ok) *ok = file.ok();
+    if (!file.ok()) {
+        VerifyResult result;
+        result.status = VerifyStatus::Malformed;
+        result.failed_entry = 1;
+        return result;
+    }
+    return verify_log_since(file.view(), accepted, options);
+}
+
+/**
+ * @brief Server-side state for one device: the last accepted watermark
+ *
+ * Each advance() verifies only the entries received since the last one,
+ * so continuous verification costs O(new entries).
+ */
+class WatermarkVerifier {
+public:
+    /**
+     * @param accepted Position already verified (default: the start of the chain)
+     * @param key Device key; when set, claimed watermarks must be signed with it
+     */
+    explicit WatermarkVerifier(Watermark accepted = Watermark(), std::string_view key = {})
+        : accepted_(std::move(accepted)), key_(key), keyed_(!key.empty()),
+          offset_known_(accepted_.sequence == 0 || accepted_.log_offset != 0) {}
+
+    /**
+     * @brief Verify the entries appended since accepted() and move past them
+     *
+     * @p tail holds whole entries only. If @p claimed is given it must name
+     * the tail's last entry. A claim at another sequence number is a
+     * BrokenLink, and one with another chain hash is a HashMismatch, both
+     * at the tail's last entry. With a key, an unsigned or badly signed
+     * claim is Malformed with failed_entry 0, as is a claim for another
+     * device. Nothing is accepted unless the whole call succeeds. The device
+     * ID (once unknown) and timestamp are taken from the last entry.
+     */
+    VerifyResult advance(std::string_view tail, const Watermark* claimed = nullptr) {
+        if (claimed && ((keyed_ && !check_watermark(*claimed, key_)) ||
+                        (!accepted_.device_id.empty() &&
+                         claimed->device_id != accepted_.device_id))) {
+            VerifyResult result;
+            result.status = VerifyStatus::Malformed;
+            return result;
+        }
+        VerifyResult result = verify_since(accepted_, tail, options_);
+        if (!result.ok()) return result;
+        const uint64_t sequence = accepted_.sequence + result.entries;
+        std::string device_id = accepted_.device_id;
+        int64_t timestamp_ms = accepted_.timestamp_ms;
+        if (result.entries > 0) {
+            std::string_view last = tail.substr(detail::last_line_start(tail));
+            while (!last.empty() && (last.back() == '\n' || last.back() == '\r')) {
+                last.remove_suffix(1);
+            }
+            EntryView view;
+            std::string entry_device;
+            if (!parse_entry(last, view) || !unescape_json(view.device_id, entry_device) ||
+                !detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                            timestamp_ms)) {
+                result.status = VerifyStatus::Malformed;
+            } else if (device_id.empty()) {
+                device_id = std::move(entry_device);
+            }
+        }
+        if (claimed && result.ok()) {
+            if (!device_id.empty() && claimed->device_id != device_id) {
+                VerifyResult refused;
+                refused.status = VerifyStatus::Malformed;
+                return refused;
+            }
+            if (claimed->sequence != sequence) {
+                result.status = VerifyStatus::BrokenLink;
+            } else if (claimed->chain_hash != result.last_hash) {
+                result.status = VerifyStatus::HashMismatch;
+            }
+        }
+        if (!result.ok()) {
+            result.failed_entry = std::max<uint64_t>(result.entries, 1);
+            result.failed_offset = detail::last_line_start(tail);
+            return result;
+        }
+        if (result.entries > 0) {
+            accepted_.sequence = sequence;
+            accepted_.chain_hash = result.last_hash;
+            if (offset_known_) accepted_.log_offset += tail.size();
+            accepted_.timestamp_ms = timestamp_ms;
+            accepted_.device_id = std::move(device_id);
+            accepted_.scheme = WatermarkSignature::None;
+            accepted_.signature.clear();
+        }
+        return result;
+    }
+
+    /// Last verified position
+    const Watermark& accepted() const { return accepted_; }
+
+    /// Options for the tail verification (initial_hash is ignored; recompute is on)
+    VerifyOptions& options() { return options_; }
+
+private:
+    Watermark accepted_;
+    HmacSha256 key_;
+    bool keyed_;
+    bool offset_known_;     ///< Whether accepted_.log_offset tracks the log
+    VerifyOptions options_ = watermark_verify_options();
+};
+
+} // namespace dts
+
+#endif // DTS_WATERMARK_HPP
@@ -0,0 +1,192 @@
+/**
+ * @file test_adapters.cpp
+ * @brief Unit tests for MessageBuilder and the domain adapters' messages
+ */
+
+#include <dts/adapters/building_automation_adapter.hpp>
+#include <dts/adapters/clinical_trial_adapter.hpp>
+#include <dts/adapters/dicom_adapter.hpp>
+#include <dts/adapters/industrial_adapter.hpp>
+#include <dts/adapters/medtech_adapter.hpp>
+#include <dts/entry_parser.hpp>
+#include <cassert>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::string message_of(const std::string& entry) {
+    dts::EntryView view;
+    std::string message;
+    assert(dts::parse_entry(entry, view));
+    assert(dts::unescape_json(view.message, message));
+    return message;
+}
+
+template <typename T>
+static std::string streamed(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+template <typename T>
+static std::string built(const T& value) {
+    dts::MessageBuilder msg;
+    msg.begin("") << value;
+    return std::string(msg.view());
+}
+
+void test_message_builder() {
+    // Numbers format exactly as a default std::ostream does
+    const double doubles[] = {0.0, -0.0, 21.5, 0.1, 1.0 / 3.0, 100.0, 123456.0, 1234567.0,
+                              1e-5, 6.02e23, -42.125, 99999.95};
+    for (double value : doubles) assert(built(value) == streamed(value));
+    assert(built(0) == "0");
+    assert(built(-17) == "-17");
+    assert(built(std::numeric_limits<int64_t>::min()) ==
+           streamed(std::numeric_limits<int64_t>::min()));
+    assert(built(std::numeric_limits<uint64_t>::max()) ==
+           streamed(std::numeric_limits<uint64_t>::max()));
+    assert(built(uint32_t{4000000000u}) == "4000000000");
+
+    dts::MessageBuilder msg;
+    msg.begin("Event").field("Key", "value").field("N", 3).field_if("Empty", "");
+    assert(msg.view() == "Event | Key:value | N:3");
+    const std::string address = "DB1.DBX0.0";
+    msg.begin("Next").field("Addr", address) << '%';
+    assert(msg.view() == "Next | Addr:DB1.DBX0.0%");
+
+    const uint8_t bytes[] = {0x00, 0x9f, 0xff};
+    msg.begin("").hex(bytes, sizeof(bytes));
+    assert(msg.view() == "009fff");
+
+    std::cout << "✓ MessageBuilder test passed\n";
+}
+
+struct ValveEvent {
+    static constexpr std::string_view name = "Valve";
+    static constexpr std::string_view fields[] = {"ID", "", "Position", "Note"};
+};
+
+enum class ValveState : uint8_t { Open = 1, Closed = 2, Fault = 200 };
+
+static constexpr dts::EnumNames<ValveState> valve_names({
+    {ValveState::Open, "Open"},
+    {ValveState::Closed, "Closed"},
+}, "Unknown");
+
+void test_event_schema() {
+    static_assert(dts::EventFormat<ValveEvent>::field_count == 4, "schema field count");
+    static_assert(valve_names[ValveState::Closed] == "Closed", "compile-time enum table");
+    static_assert(valve_names[ValveState::Fault] == "Unknown", "enum fallback");
+
+    dts::MessageBuilder msg;
+    dts::EventFormat<ValveEvent> plain;
+    dts::EventFormat<ValveEvent> tagged(dts::constant_field("Asset", "V-100"));
+    assert(dts::constant_field("Asset", "").empty());
+
+    assert(plain.render(msg, "V1", valve_names[ValveState::Open], dts::with_unit(75, "%"),
+                        dts::if_not_empty("")) == "Valve | ID:V1 | Open | Position:75%");
+    assert(tagged.render(msg, "V2", valve_names[ValveState::Fault],
+                         dts::with_unit(12.5, "mm", ' '), dts::if_not_empty("stuck")) ==
+           "Valve | ID:V2 | Unknown | Position:12.5 mm | Note:stuck | Asset:V-100");
+    assert(tagged.render_as(msg, "Valve Test", 7, "x",
+                            dts::optional_field(dts::with_unit(3, "s"), false),
+                            dts::if_not_empty("")) == "Valve Test | ID:7 | x | Asset:V-100");
+
+    std::cout << "✓ Event schema test passed\n";
+}
+
+void test_adapter_messages() {
+    dts::adapters::IndustrialAdapter plc("PLC-01", "ASSET-7", "LINE-2");
+    assert(message_of(plc.log_io_change("I0.3", "0", "1", true)) ==
+           "I/O Change | Output:I0.3 | From:0 | To:1 | Asset:ASSET-7");
+    assert(message_of(plc.log_plc_event("Main", 12, "Scan overrun")) ==
+           "PLC Event | Program:Main | Rung:12 | Scan overrun | Asset:ASSET-7");
+    assert(message_of(plc.log_protocol_event(dts::adapters::ProtocolType::OPCUA,
+                                             "10.0.0.1", "10.0.0.2", "Write", false)) ==
+           "Protocol Event | OPC UA | From:10.0.0.1 | To:10.0.0.2 | Function:Write | "
+           "Status:Failed");
+    assert(message_of(plc.log_production_event(
+               dts::adapters::ProductionEventType::BatchCompleted, "B-9", "SKU-1", 250)) ==
+           "Batch Completed | BatchID:B-9 | Product:SKU-1 | Quantity:250 | Line:LINE-2");
+    assert(message_of(plc.log_safety_interlock("IL-4", true)) ==
+           "Safety Interlock TRIGGERED | ID:IL-4 | Asset:ASSET-7");
+
+    dts::adapters::BuildingAutomationAdapter bas("BAS-01", "HQ", "Z1");
+    assert(message_of(bas.log_hvac_event("Setpoint", "Z2", 21.5, "C")) ==
+           "HVAC Event | Type:Setpoint | Zone:Z2 | Value:21.5 C | ZoneID:Z1");
+    assert(message_of(bas.log_lighting_event("Room 101", 0, 80)) ==
+           "Lighting Control | Zone:Room 101 | From:0% | To:80% | Source:manual");
+    assert(message_of(bas.log_energy_consumption("M-1", 1234567.0, 12.25)) ==
+           "Energy Consumption | Meter:M-1 | Consumption:1.23457e+06 kWh | Peak:12.25 kW | "
+           "Building:HQ");
+    assert(message_of(bas.log_knx_event("1/2/3", "ON", "1.001")) ==
+           "KNX Event | GroupAddress:1/2/3 | Value:ON | DPT:1.001");
+    assert(message_of(bas.log_bacnet_event("analog-input", 3000000000u, "present-value",
+                                           "20.1")) ==
+           "BACnet Event | ObjectType:analog-input | Instance:3000000000 | "
+           "Property:present-value | Value:20.1");
+
+    dts::adapters::DICOMAdapter dicom("PACS-01", "AE1");
+    assert(message_of(dicom.log_study_created("1.2.3", "ANON-1", "CT")) ==
+           "DICOM Study Created | StudyInstanceUID:1.2.3 | PatientID:ANON-1 | Modality:CT | "
+           "AETitle:AE1");
+    assert(message_of(dicom.log_access_event("1.2.3", dts::UserID::Operator, false,
+                                             "No consent")) ==
+           "DICOM Access Denied | StudyInstanceUID:1.2.3 | Reason:No consent");
+
+    dts::adapters::MedTechAdapter pump("PUMP-01");
+    assert(message_of(pump.log_medication_event(dts::adapters::MedicationEventType::Started,
+                                                "Insulin", "100U/mL", "", 30)) ==
+           "Infusion Started | Drug:Insulin | Concentration:100U/mL | Duration:30min");
+    assert(message_of(pump.log_safety_alarm("Occlusion", dts::adapters::AlarmPriority::High,
+                                            "Downstream")) ==
+           "Safety Alarm | Type:Occlusion | Priority:3 | Description:Downstream");
+    assert(message_of(pump.log_post_result(false, "Motor stall")) == "POST FAILED | Motor stall");
+    assert(message_of(pump.log_firmware_update("1.0", "1.1", true)) ==
+           "Firmware Update SUCCESS | From:1.0 | To:1.1");
+
+    // Default anonymizer is unchanged: ANON- + first 8 bytes of SHA-256
+    dts::adapters::ClinicalTrialAdapter trial("EDC-01", "PROT-1");
+    const auto hash = dts::SHA256::hash(std::string("PATIENT-12345"));
+    std::ostringstream anon;
+    for (size_t i = 0; i < 8; ++i) {
+        anon << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(hash[i]);
+    }
+    assert(message_of(trial.log_patient_enrolled("PATIENT-12345", "SITE-001")) ==
+           "Patient Enrolled | PatientID:ANON-" + anon.str() + " | SiteID:SITE-001 | "
+           "Protocol:PROT-1");
+
+    dts::adapters::ClinicalTrialAdapter custom(
+        "EDC-02", "", [](const std::string& id) { return "X" + id; });
+    assert(message_of(custom.log_visit_event(dts::adapters::TrialEventType::VisitStarted,
+                                             "P1", 2)) ==
+           "Visit Started | PatientID:XP1 | VisitNumber:2");
+
+    // Entries from the reused buffer still form a valid chain
+    dts::adapters::IndustrialAdapter line("PLC-02");
+    std::vector<std::string> entries;
+    for (int i = 0; i < 20; ++i) {
+        entries.push_back(line.log_io_change("I0." + std::to_string(i), "0", "1"));
+        entries.push_back(line.log_equipment_status("Press-" + std::to_string(i), "Idle", "Run"));
+    }
+    assert(dts::AuditChain::verify_chain(entries, true));
+
+    std::cout << "✓ Adapter message test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS adapter tests...\n\n";
+
+    test_message_builder();
+    test_event_schema();
+    test_adapter_messages();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file test_anonymizer.cpp
+ * @brief Unit tests for keyed pseudonyms and the anonymizer cache
+ */
+
+#include <dts/adapters/clinical_trial_adapter.hpp>
+#include <dts/anonymizer.hpp>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string hex(const dts::SHA256::Hash& hash) {
+    std::string out(64, '\0');
+    dts::detail::hex_encode(hash.data(), hash.size(), &out[0]);
+    return out;
+}
+
+static std::string message_of(const std::string& entry) {
+    dts::EntryView view;
+    std::string message;
+    assert(dts::parse_entry(entry, view));
+    assert(dts::unescape_json(view.message, message));
+    return message;
+}
+
+void test_hmac_vectors() {
+    // RFC 4231 test cases 1, 2 and 6
+    assert(hex(dts::HmacSha256(std::string(20, '\x0b')).mac("Hi There")) ==
+           "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+    assert(hex(dts::HmacSha256("Jefe").mac("what do ya want for nothing?")) ==
+           "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    assert(hex(dts::HmacSha256(std::string(131, '\xaa'))
+                   .mac("Test Using Larger Than Block-Size Key - Hash Key First")) ==
+           "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+
+    std::string a, b;
+    dts::HmacAnonymizer("site-key")("PATIENT-1", a);
+    dts::HmacAnonymizer("other-key")("PATIENT-1", b);
+    assert(a.size() == dts::anonymized_id_length && a.compare(0, 5, "ANON-") == 0);
+    assert(a != b);
+    assert(a == "ANON-" + hex(dts::HmacSha256("site-key").mac("PATIENT-1")).substr(0, 16));
+
+    std::cout << "✓ HMAC test vectors passed\n";
+}
+
+void test_lru_cache() {
+    dts::AnonymizerCache cache(3);
+    int computed = 0;
+    auto compute = [&computed](std::string_view id, std::string& out) {
+        ++computed;
+        dts::sha256_anonymize(id, out);
+    };
+    std::string out, expected;
+    for (const char* id : {"P1", "P2", "P3", "P1", "P2", "P3"}) cache.get(id, out, compute);
+    assert(computed == 3 && cache.hits() == 3 && cache.size() == 3);
+    dts::sha256_anonymize("P1", expected);
+    assert(cache.get("P1", out, compute) && out == expected);
+
+    // P2 is now least recently used and is evicted first
+    assert(!cache.get("P4", out, compute));
+    assert(cache.evictions() == 1);
+    assert(cache.get("P1", out, compute) && cache.get("P3", out, compute));
+    assert(!cache.get("P2", out, compute));
+    assert(cache.size() == 3 && cache.misses() == 5);
+
+    // A longer ID reuses an evicted node safely
+    const std::string long_id(100, 'L');
+    assert(!cache.get(long_id, out, compute));
+    dts::sha256_anonymize(long_id, expected);
+    assert(cache.get(long_id, out, compute) && out == expected);
+
+    cache.clear();
+    assert(cache.size() == 0 && !cache.get("P1", out, compute));
+
+    // Shared by several threads
+    dts::AnonymizerCache shared(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&shared] {
+            std::string local, check;
+            for (int i = 0; i < 2000; ++i) {
+                const std::string id = "PATIENT-" + std::to_string(i % 100);
+                shared.get(id, local, [](std::string_view p, std::string& o) {
+                    dts::sha256_anonymize(p, o);
+                });
+                dts::sha256_anonymize(id, check);
+                assert(local == check);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(shared.hits() + shared.misses() == 8000 && shared.size() == 64);
+
+    std::cout << "✓ LRU cache test passed\n";
+}
+
+void test_adapter_integration() {
+    dts::adapters::ClinicalTrialAdapter plain("EDC-10", "PROT-1");
+    dts::adapters::ClinicalTrialAdapter cached("EDC-11", "PROT-1");
+    cached.enable_anonymizer_cache(16);
+    for (int visit = 1; visit <= 5; ++visit) {
+        for (const char* patient : {"PATIENT-A", "PATIENT-B"}) {
+            const std::string expected = message_of(plain.log_data_collected(patient, "Vitals"));
+            assert(message_of(cached.log_data_collected(patient, "Vitals")) == expected);
+        }
+    }
+    assert(cached.anonymizer_cache()->misses() == 2 && cached.anonymizer_cache()->hits() == 8);
+
+    // Keyed pseudonyms, cached the same way; switching clears the cache
+    cached.set_anonymizer_key("trial-secret");
+    assert(cached.anonymizer_cache()->size() == 0);
+    std::string keyed;
+    dts::HmacAnonymizer("trial-secret")("PATIENT-A", keyed);
+    assert(message_of(cached.log_visit_event(dts::adapters::TrialEventType::VisitStarted,
+                                             "PATIENT-A", 1)) ==
+           "Visit Started | PatientID:" + keyed + " | VisitNumber:1");
+
+    // One cache shared by adapters of the same site
+    auto site_cache = std::make_shared<dts::AnonymizerCache>(128);
+    dts::adapters::ClinicalTrialAdapter first("EDC-12"), second("EDC-13");
+    first.set_anonymizer_cache(site_cache);
+    second.set_anonymizer_cache(site_cache);
+    first.log_adverse_event("PATIENT-C", "Rash", "Mild");
+    second.log_adverse_event("PATIENT-C", "Rash", "Mild");
+    assert(site_cache->hits() == 1 && site_cache->misses() == 1);
+
+    std::cout << "✓ Adapter integration test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS anonymizer tests...\n\n";
+
+    test_hmac_vectors();
+    test_lru_cache();
+    test_adapter_integration();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -4,11 +4,101 @@
  */
 
 #include <dts/audit_chain.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <vector>
 #include <string>
 
+// Count heap allocations so the buffer-reuse paths can be checked
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static std::string to_hex(const dts::SHA256::Hash& hash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (uint8_t byte : hash) {
+        out += digits[byte >> 4];
+        out += digits[byte & 0x0F];
+    }
+    return out;
+}
+
+void test_sha256_vectors() {
+    assert(to_hex(dts::SHA256::hash("")) ==
+           "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    assert(to_hex(dts::SHA256::hash("abc")) ==
+           "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    assert(to_hex(dts::SHA256::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+           "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    // Streaming in odd-sized chunks must match one-shot hashing
+    std::string data(1000, '\0');
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i * 31 + 7);
+    dts::SHA256 ctx;
+    for (size_t pos = 0, step = 1; pos < data.size(); pos += step, step = step % 97 + 13) {
+        size_t n = std::min(step, data.size() - pos);
+        ctx.update(reinterpret_cast<const uint8_t*>(data.data()) + pos, n);
+    }
+    assert(ctx.finalize() == dts::SHA256::hash(data));
+
+    std::cout << "✓ SHA-256 vector test passed\n";
+}
+
+void test_sha256_backends() {
+    const dts::SHA256Backend original = dts::SHA256::backend();
+
+    std::vector<std::string> messages;
+    for (size_t len = 0; len < 300; len += 7) {
+        std::string msg(len, '\0');
+        for (size_t i = 0; i < len; ++i) msg[i] = static_cast<char>(len + i);
+        messages.push_back(msg);
+    }
+
+    assert(dts::SHA256::set_backend(dts::SHA256Backend::Scalar));
+    std::vector<dts::SHA256::Hash> reference;
+    for (const auto& msg : messages) reference.push_back(dts::SHA256::hash(msg));
+
+    for (auto backend : {dts::SHA256Backend::ShaNi, dts::SHA256Backend::ArmCrypto}) {
+        if (!dts::SHA256::set_backend(backend)) continue;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            assert(dts::SHA256::hash(messages[i]) == reference[i]);
+        }
+    }
+
+    // Batch hashing, with and without the multi-buffer lanes
+    std::vector<const uint8_t*> ptrs;
+    std::vector<size_t> lens;
+    for (const auto& msg : messages) {
+        ptrs.push_back(reinterpret_cast<const uint8_t*>(msg.data()));
+        lens.push_back(msg.size());
+    }
+    assert(dts::SHA256::set_backend(dts::SHA256Backend::Scalar));
+    for (bool multibuffer : {true, false}) {
+        dts::SHA256::set_multibuffer_enabled(multibuffer);
+        std::vector<dts::SHA256::Hash> batch(messages.size());
+        dts::SHA256::hash_many(ptrs.data(), lens.data(), ptrs.size(), batch.data());
+        assert(batch == reference);
+    }
+    dts::SHA256::set_multibuffer_enabled(true);
+    dts::SHA256::set_backend(original);
+
+    std::cout << "✓ SHA-256 backend test passed ("
+              << dts::SHA256::backend_name(original) << ")\n";
+}
+
 void test_basic_logging() {
     dts::AuditChain logger("TEST-DEVICE-001");
     
@@ -31,16 +121,125 @@ void test_chain_integrity() {
     entries.push_back(logger.log("Event 3"));
     
     assert(dts::AuditChain::verify_chain(entries) == true);
+    assert(dts::AuditChain::verify_chain(entries, true) == true);
     
     // Tamper with entry
     std::string tampered = entries[1];
     tampered.replace(tampered.find("Event 2"), 7, "HACKED");
     entries[1] = tampered;
     
-    // Verification should fail (simplified - full implementation would detect hash mismatch)
+    // Links are intact, so only recomputing the hashes detects the edit
+    assert(dts::AuditChain::verify_chain(entries) == true);
+    assert(dts::AuditChain::verify_chain(entries, true) == false);
     std::cout << "✓ Chain integrity test passed\n";
 }
 
+void test_log_into_buffer() {
+    dts::AuditChain logger("TEST-DEVICE-005");
+    
+    std::string out;
+    out.reserve(logger.max_entry_length(64));
+    const std::string message = "Steady-state \"quoted\"\tevent";
+    logger.log(out, message);
+    
+    const size_t before = g_allocations.load();
+    for (int i = 0; i < 100; ++i) {
+        logger.log(out, message, dts::UserID::Operator, dts::Severity::Warning);
+    }
+    assert(g_allocations.load() == before);
+    assert(out.back() == '}');
+    assert(out.find('\0') == std::string::npos);
+    assert(out.find("\"message\":\"Steady-state \\\"quoted\\\"\\tevent\"") != std::string::npos);
+    assert(out.find(logger.get_chain_hash()) != std::string::npos);
+    
+    // Fixed buffer: too small leaves the chain untouched
+    char small[16];
+    const uint64_t seq = logger.get_sequence_number();
+    assert(logger.log(small, sizeof(small), "Does not fit") == 0);
+    assert(logger.get_sequence_number() == seq);
+    
+    char buffer[512];
+    size_t len = logger.log(buffer, sizeof(buffer), "Control char \x01");
+    assert(len > 0 && buffer[len - 1] == '}');
+    assert(std::string(buffer, len).find("\\u0001") != std::string::npos);
+    
+    std::vector<std::string> entries;
+    dts::AuditChain chain("TEST-DEVICE-005");
+    for (int i = 0; i < 3; ++i) {
+        chain.log(out, "Event");
+        entries.push_back(out);
+    }
+    assert(dts::AuditChain::verify_chain(entries));
+    
+    std::cout << "✓ Buffer logging test passed\n";
+}
+
+static std::string json_field(const std::string& entry, const std::string& key) {
+    const std::string marker = "\"" + key + "\":";
+    size_t pos = entry.find(marker) + marker.size();
+    if (entry[pos] == '"') {
+        ++pos;
+        return entry.substr(pos, entry.find('"', pos) - pos);
+    }
+    return entry.substr(pos, entry.find_first_of(",}", pos) - pos);
+}
+
+void test_payload_hash_format() {
+    dts::AuditChain logger("TEST-DEVICE-006");
+    
+    for (const std::string& message : {std::string("Short"), std::string(200, 'x')}) {
+        std::string entry = logger.log(message, dts::UserID::Service, dts::Severity::Error);
+        std::string payload = json_field(entry, "device_id") + "|" +
+                              json_field(entry, "timestamp") + "|" +
+                              json_field(entry, "user_id") + "|" +
+                              json_field(entry, "severity") + "|" +
+                              message + "|" +
+                              json_field(entry, "previous_hash");
+        assert(to_hex(dts::SHA256::hash(payload)) == json_field(entry, "chain_hash"));
+    }
+    
+    std::cout << "✓ Payload hash format test passed\n";
+}
+
+void test_timestamp_formatter() {
+    dts::TimestampFormatter formatter;
+    char cached[dts::detail::timestamp_length];
+    char direct[dts::detail::timestamp_length];
+    
+    // Sweep across second, day, month, and leap-year boundaries
+    const int64_t starts[] = {0, 951782399000, 1709251199500, 1735689599990, 4102444799999};
+    for (int64_t start : starts) {
+        for (int64_t ms = start - 1500; ms < start + 1500; ms += 7) {
+            formatter.format(ms, cached);
+            dts::detail::format_timestamp_ms(ms, direct);
+            assert(std::string(cached, sizeof(cached)) == std::string(direct, sizeof(direct)));
+            int64_t parsed = 0;
+            assert(dts::detail::parse_timestamp_ms(cached, sizeof(cached), parsed) && parsed == ms);
+        }
+    }
+    dts::detail::format_timestamp_ms(951868800123, direct);  // 2000-02-29 is a leap day
+    assert(std::string(direct, sizeof(direct)) == "2000-03-01T00:00:00.123Z");
+    dts::detail::format_timestamp_ms(951782400000, direct);
+    assert(std::string(direct, sizeof(direct)) == "2000-02-29T00:00:00.000Z");
+    
+    // Injected clocks
+    const auto t0 = std::chrono::system_clock::time_point(std::chrono::milliseconds(1735689600042));
+    dts::AuditChain fixed("TEST-DEVICE-007", dts::clocks::fixed(t0));
+    assert(json_field(fixed.log("Event"), "timestamp") == "2025-01-01T00:00:00.042Z");
+    
+    dts::AuditChain stepping("TEST-DEVICE-007",
+                             dts::clocks::stepping(t0, std::chrono::milliseconds(999)));
+    assert(json_field(stepping.log("Event"), "timestamp") == "2025-01-01T00:00:00.042Z");
+    assert(json_field(stepping.log("Event"), "timestamp") == "2025-01-01T00:00:01.041Z");
+    
+    auto monotonic = dts::clocks::monotonic_anchored();
+    auto a = monotonic();
+    auto b = monotonic();
+    assert(b >= a);
+    
+    std::cout << "✓ Timestamp formatter test passed\n";
+}
+
 void test_user_severity_levels() {
     dts::AuditChain logger("TEST-DEVICE-003");
     
@@ -55,16 +254,25 @@ void test_user_severity_levels() {
 }
 
 void test_hash_consistency() {
-    dts::AuditChain logger1("TEST-DEVICE-004");
-    dts::AuditChain logger2("TEST-DEVICE-004"); // Same device ID
+    // With the same clock, the same inputs give the same bytes
+    const auto at = std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000123));
+    dts::AuditChain logger1("TEST-DEVICE-004", dts::clocks::fixed(at));
+    dts::AuditChain logger2("TEST-DEVICE-004", dts::clocks::fixed(at)); // Same device ID
     
-    std::string entry1 = logger1.log("Identical event");
-    std::string entry2 = logger2.log("Identical event");
+    for (int i = 0; i < 3; ++i) {
+        std::string entry1 = logger1.log("Identical event", dts::UserID::Operator);
+        std::string entry2 = logger2.log("Identical event", dts::UserID::Operator);
+        assert(entry1 == entry2);
+    }
+    assert(logger1.get_chain_hash() == logger2.get_chain_hash());
     
-    // First entries should have same previous_hash (both start with DTS_INIT)
-    // Chain hashes will differ due to timestamp differences, but structure should be consistent
-    assert(entry1.find("chain_hash") != std::string::npos);
-    assert(entry2.find("chain_hash") != std::string::npos);
+    // Any differing input changes the hash
+    dts::AuditChain logger3("TEST-DEVICE-004",
+                            dts::clocks::fixed(at + std::chrono::milliseconds(1)));
+    logger3.log("Identical event", dts::UserID::Operator);
+    dts::AuditChain logger4("TEST-DEVICE-004", dts::clocks::fixed(at));
+    logger4.log("Identical event", dts::UserID::Operator);
+    assert(logger3.get_chain_hash() != logger4.get_chain_hash());
     
     std::cout << "✓ Hash consistency test passed\n";
 }
@@ -72,8 +280,13 @@ void test_hash_consistency() {
 int main() {
     std::cout << "Running DTS unit tests...\n\n";
     
+    test_sha256_vectors();
+    test_sha256_backends();
     test_basic_logging();
     test_chain_integrity();
+    test_log_into_buffer();
+    test_payload_hash_format();
+    test_timestamp_formatter();
     test_user_severity_levels();
     test_hash_consistency();
     
@@ -0,0 +1,269 @@
+/**
+ * @file test_chain_state.cpp
+ * @brief Unit tests for chain-state snapshots and boot recovery
+ */
+
+#include <dts/chain_recovery.hpp>
+#include <dts/inclusion_proof.hpp>
+#include <dts/log_sink.hpp>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+static std::string temp_path(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("dts_" + name);
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static bool same_position(const dts::ChainState& a, const dts::ChainState& b) {
+    return a.device_id == b.device_id && a.sequence == b.sequence &&
+           a.last_hash == b.last_hash && a.timestamp_ms == b.timestamp_ms &&
+           a.window_first == b.window_first && a.window.root() == b.window.root() &&
+           a.window.size() == b.window.size() && a.checkpoints.root() == b.checkpoints.root();
+}
+
+void test_encode_decode() {
+    dts::AuditChain logger("TEST-DEVICE-601");
+    logger.set_checkpoint_interval(8);
+    std::string checkpoint;
+    for (int i = 0; i < 29; ++i) {
+        logger.log("Event " + std::to_string(i));
+        logger.take_checkpoint(checkpoint);
+    }
+    auto state = logger.state();
+    state.log_offset = 12345;
+
+    const std::string data = dts::encode_chain_state(state);
+    dts::ChainState decoded;
+    assert(dts::decode_chain_state(data, decoded));
+    assert(same_position(decoded, state));
+    assert(decoded.log_offset == 12345);
+
+    // Any flipped bit or truncation is caught by the checksum
+    for (size_t i = 0; i < data.size(); ++i) {
+        std::string corrupt = data;
+        corrupt[i] ^= 0x20;
+        assert(!dts::decode_chain_state(corrupt, decoded));
+    }
+    assert(!dts::decode_chain_state(data.substr(0, data.size() - 1), decoded));
+
+    dts::AuditChain resumed(decoded);
+    assert(resumed.get_sequence_number() == logger.get_sequence_number());
+    assert(same_position(resumed.state(), logger.state()));
+
+    const std::string path = temp_path("state_roundtrip.state");
+    assert(dts::save_chain_state(path, state));
+    assert(!std::filesystem::exists(path + ".tmp"));
+    dts::ChainState loaded;
+    assert(dts::load_chain_state(path, loaded));
+    assert(same_position(loaded, state));
+    std::filesystem::remove(path);
+
+    std::cout << "✓ Chain state encode/decode test passed\n";
+}
+
+void test_resume_matches_uninterrupted() {
+    // Fixed clock so both chains hash identical payloads
+    dts::ClockSource clock = [] {
+        return std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000000));
+    };
+    dts::AuditChain straight("TEST-DEVICE-602", clock);
+    dts::AuditChain first("TEST-DEVICE-602", clock);
+    straight.set_checkpoint_interval(10);
+    first.set_checkpoint_interval(10);
+    std::string a, b;
+    for (int i = 0; i < 25; ++i) {
+        straight.log("Event " + std::to_string(i));
+        first.log("Event " + std::to_string(i));
+        straight.take_checkpoint(a);
+        first.take_checkpoint(b);
+    }
+
+    dts::AuditChain second(first.state(), clock);
+    second.set_checkpoint_interval(10);
+    for (int i = 25; i < 50; ++i) {
+        const std::string expected = straight.log("Event " + std::to_string(i));
+        assert(second.log("Event " + std::to_string(i)) == expected);
+        const bool checkpointed = straight.take_checkpoint(a);
+        assert(second.take_checkpoint(b) == checkpointed);
+        if (checkpointed) assert(a == b);
+    }
+    assert(second.checkpoint_count() == straight.checkpoint_count());
+
+    std::cout << "✓ Resume continuity test passed\n";
+}
+
+void test_sinks_write_snapshots() {
+    const std::string log_path = temp_path("state_sink.log");
+    const std::string state_path = temp_path("state_sink.state");
+
+    dts::DurabilityPolicy policy;
+    policy.state_path = state_path;
+    policy.state_interval = 64;
+    {
+        dts::AuditChain logger("TEST-DEVICE-603");
+        logger.set_checkpoint_interval(16);
+        logger.set_sink(std::make_shared<dts::AsyncFileSink>(log_path, policy));
+        for (int i = 0; i < 300; ++i) logger.log("Event " + std::to_string(i));
+    }
+    // The shutdown snapshot covers the whole log
+    dts::ChainState state;
+    assert(dts::load_chain_state(state_path, state));
+    assert(state.log_offset == std::filesystem::file_size(log_path));
+    assert(state.sequence == 300 + 300 / 16);
+    assert(state.checkpoints.size() == 300 / 16);
+
+    // FileSink snapshots on flush()
+    const std::string sync_log = temp_path("state_sync.log");
+    const std::string sync_state = temp_path("state_sync.state");
+    policy.state_path = sync_state;
+    {
+        dts::AuditChain logger("TEST-DEVICE-604");
+        auto sink = std::make_shared<dts::FileSink>(sync_log, policy);
+        logger.set_sink(sink);
+        for (int i = 0; i < 10; ++i) logger.log("Event " + std::to_string(i));
+        sink->flush();
+        dts::ChainState saved;
+        assert(dts::load_chain_state(sync_state, saved));
+        // No checkpoint interval here, so only the link position is compared
+        const auto current = logger.state();
+        assert(saved.sequence == current.sequence && saved.last_hash == current.last_hash);
+        assert(saved.log_offset == std::filesystem::file_size(sync_log));
+    }
+
+    for (const auto& path : {log_path, state_path, sync_log, sync_state}) {
+        std::filesystem::remove(path);
+    }
+    std::cout << "✓ Sink snapshot test passed\n";
+}
+
+void test_recovery_with_torn_tail() {
+    const std::string log_path = temp_path("state_recover.log");
+    const std::string state_path = temp_path("state_recover.state");
+    const std::string device = "TEST-DEVICE-605";
+
+    dts::DurabilityPolicy policy;
+    policy.state_path = state_path;
+    dts::ChainState expected;
+    {
+        dts::AuditChain logger(device);
+        logger.set_checkpoint_interval(16);
+        auto sink = std::make_shared<dts::FileSink>(log_path, policy);
+        logger.set_sink(sink);
+        for (int i = 0; i < 100; ++i) logger.log("Event " + std::to_string(i));
+        sink->flush();
+
+        // Entries after the snapshot, then a write cut short by power loss
+        for (int i = 100; i < 140; ++i) logger.log("Late event " + std::to_string(i));
+        expected = logger.state();
+    }
+    const uint64_t complete_size = std::filesystem::file_size(log_path);
+    {
+        std::ofstream out(log_path, std::ios::app | std::ios::binary);
+        out << "{\"device_id\":\"" << device << "\",\"timestamp\":\"2025-";
+    }
+
+    dts::ChainState state;
+    auto result = dts::recover_chain_state(device, state_path, log_path, state);
+    assert(result.ok());
+    assert(result.snapshot_used);
+    assert(result.replayed_entries == 40 + 2);    // two checkpoints fall in the tail
+    assert(result.torn_bytes > 0);
+    assert(std::filesystem::file_size(log_path) == complete_size);
+    assert(same_position(state, expected));
+    assert(state.log_offset == complete_size);
+
+    // Resume logging; the combined log verifies end to end
+    {
+        dts::AuditChain logger(state);
+        logger.set_checkpoint_interval(16);
+        auto sink = std::make_shared<dts::FileSink>(log_path, policy);
+        sink->seed_state(state);
+        logger.set_sink(sink);
+        for (int i = 140; i < 200; ++i) logger.log("Resumed event " + std::to_string(i));
+        sink->flush();
+    }
+    dts::VerifyOptions options;
+    options.recompute = true;
+    bool readable = false;
+    auto verified = dts::verify_file(log_path, options, &readable);
+    assert(readable && verified.ok());
+    assert(verified.entries == 200 + 200 / 16);
+
+    // Checkpoint windows continued across the restart
+    const std::string log = read_file(log_path);
+    dts::InclusionProof proof;
+    assert(dts::build_inclusion_proof(log, 150, proof));
+
+    // The snapshot written after resuming covers the whole file
+    dts::ChainState resumed;
+    assert(dts::load_chain_state(state_path, resumed));
+    assert(resumed.log_offset == std::filesystem::file_size(log_path));
+    assert(resumed.sequence == verified.entries);
+
+    // Without a snapshot the whole log is replayed
+    std::filesystem::remove(state_path);
+    result = dts::recover_chain_state(device, state_path, log_path, state);
+    assert(result.ok() && !result.snapshot_used);
+    assert(result.replayed_entries == verified.entries);
+    assert(same_position(state, resumed));
+
+    // A bounded tail refuses a full replay; other devices are rejected
+    dts::RecoveryOptions bounded;
+    bounded.max_tail_bytes = 1024;
+    result = dts::recover_chain_state(device, state_path, log_path, state, bounded);
+    assert(result.status == dts::RecoveryStatus::TailTooLong);
+    assert(dts::save_chain_state(state_path, resumed));
+    result = dts::recover_chain_state("OTHER-DEVICE", state_path, log_path, state);
+    assert(result.status == dts::RecoveryStatus::DeviceMismatch);
+
+    // An edited entry after the snapshot is not silently accepted
+    dts::ChainState early = resumed;
+    std::filesystem::remove(state_path);
+    std::string tampered = log;
+    const size_t pos = tampered.find("Resumed event 150");
+    tampered[pos] = 'r';
+    {
+        std::ofstream out(log_path, std::ios::trunc | std::ios::binary);
+        out << tampered;
+    }
+    result = dts::recover_chain_state(device, state_path, log_path, early);
+    assert(result.status == dts::RecoveryStatus::Corrupt);
+    assert(early.sequence < resumed.sequence);
+
+    // Entries of a device whose ID merely starts with ours are not ours
+    {
+        dts::AuditChain logger(device + "|B");
+        std::ofstream out(log_path, std::ios::trunc | std::ios::binary);
+        for (int i = 0; i < 3; ++i) out << logger.log("Event " + std::to_string(i)) << "\n";
+    }
+    result = dts::recover_chain_state(device, state_path, log_path, state);
+    assert(result.status == dts::RecoveryStatus::Corrupt && state.sequence == 0);
+
+    std::filesystem::remove(log_path);
+    std::filesystem::remove(state_path);
+    std::cout << "✓ Torn-tail recovery test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS chain state tests...\n\n";
+
+    test_encode_decode();
+    test_resume_matches_uninterrupted();
+    test_sinks_write_snapshots();
+    test_recovery_with_torn_tail();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
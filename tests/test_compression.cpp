@@ -0,0 +1,272 @@
+/**
+ * @file test_compression.cpp
+ * @brief Unit tests for the block codec and compressed log segments
+ */
+
+#include <dts/adapters/dicom_adapter.hpp>
+#include <dts/compression.hpp>
+#include <dts/segmented_log.hpp>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string temp_dir(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("dts_" + name);
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+static std::string round_trip(const std::string& input, std::string_view dictionary = {}) {
+    std::string packed = "prefix";
+    dts::compress_block(input, packed, dictionary);
+    std::string decoded = "kept";
+    const bool ok = dts::decompress_block(std::string_view(packed).substr(6), decoded, dictionary);
+    assert(ok && decoded.compare(0, 4, "kept") == 0);
+    return decoded.substr(4);
+}
+
+static std::vector<std::string> dicom_entries(const std::string& device, int count) {
+    dts::adapters::DICOMAdapter adapter(device, "PACS_AE");
+    std::vector<std::string> entries;
+    for (int i = 0; i < count; ++i) {
+        entries.push_back(adapter.log_instance_stored(
+            "1.2.840.113619.2.55." + std::to_string(i / 40), "1.2.3.4." + std::to_string(i),
+            "1.2.840.10008.5.1.4.1.1.2"));
+    }
+    return entries;
+}
+
+void test_round_trips() {
+    assert(round_trip("").empty());
+    assert(round_trip("abc") == "abc");
+    // Runs decode through overlapping matches
+    assert(round_trip(std::string(100000, 'a')) == std::string(100000, 'a'));
+    const std::string pattern = "0123456789abcdefghij";
+    std::string repeated;
+    for (int i = 0; i < 500; ++i) repeated += pattern.substr(0, static_cast<size_t>(i % 20) + 1);
+    assert(round_trip(repeated) == repeated);
+
+    std::mt19937 rng(7);
+    std::string noise(70000, '\0');
+    for (char& c : noise) c = static_cast<char>(rng());
+    assert(round_trip(noise) == noise);     // long literal runs, no matches
+    std::string packed;
+    dts::compress_block(noise, packed);
+    assert(packed.size() < noise.size() + noise.size() / 200 + 16);
+
+    std::string json;
+    for (const auto& entry : dicom_entries("PACS-01", 200)) json += entry + "\n";
+    assert(round_trip(json) == json);
+    packed.clear();
+    dts::compress_block(json, packed);
+    assert(packed.size() * 3 < json.size());
+
+    // A compressor reused across blocks gives the same output as a fresh one
+    dts::BlockCompressor compressor;
+    std::string first, second;
+    compressor.compress(repeated, first);
+    compressor.compress(json, second);
+    std::string fresh;
+    dts::compress_block(json, fresh);
+    assert(second == fresh);
+
+    std::cout << "✓ Round trip test passed\n";
+}
+
+void test_malformed_input() {
+    std::string json;
+    for (const auto& entry : dicom_entries("PACS-02", 50)) json += entry + "\n";
+    std::string packed;
+    dts::compress_block(json, packed);
+
+    std::string out;
+    assert(!dts::decompress_block("", out));                     // no final sequence
+    // A cut right after literals parses; callers check the decoded size
+    for (size_t cut = 1; cut < packed.size(); ++cut) {
+        out.clear();
+        assert(!dts::decompress_block(std::string_view(packed).substr(0, cut), out) ||
+               out.size() < json.size());
+    }
+    out.clear();
+    assert(!dts::decompress_block(std::string("\x00\x00\x00", 3), out));  // zero offset
+    assert(!dts::decompress_block(std::string("\x10" "a" "\x05\x00", 4), out));  // before start
+    assert(!dts::decompress_block(std::string("\xf0", 1), out));  // length runs off the end
+    out.clear();
+    assert(!dts::decompress_block(packed, out, {}, json.size() - 1));  // over the size limit
+    out.clear();
+    assert(dts::decompress_block(packed, out, {}, json.size()) && out == json);
+
+    std::cout << "✓ Malformed input test passed\n";
+}
+
+void test_dictionary() {
+    std::vector<std::string> samples;
+    for (const auto& entry : dicom_entries("PACS-03", 300)) samples.push_back(entry + "\n");
+    const std::string dictionary = dts::train_dictionary(samples, 4096);
+    assert(!dictionary.empty() && dictionary.size() <= 4096);
+    assert(dictionary.find("\"device_id\":\"") != std::string::npos);
+    assert(dictionary.find("1.2.840.10008.5.1.4.1.1.2") != std::string::npos);
+    // Hash digits are never common enough to be picked
+    for (const auto& sample : samples) {
+        const std::string line = sample.substr(0, sample.size() - 1);
+        dts::EntryView view;
+        assert(dts::parse_entry(line, view));
+        assert(dictionary.find(view.chain_hash.substr(0, 12)) == std::string::npos);
+    }
+    assert(dts::dictionary_id(dictionary) != 0 && dts::dictionary_id("") == 0);
+    assert(dts::dictionary_id(dictionary) != dts::dictionary_id(dictionary + " "));
+
+    // Small blocks of a new chain benefit the most
+    const auto fresh = dicom_entries("PACS-03", 8);
+    std::string block;
+    for (const auto& entry : fresh) block += entry + "\n";
+    std::string plain, primed;
+    dts::compress_block(block, plain);
+    dts::compress_block(block, primed, dictionary);
+    assert(primed.size() < plain.size() * 9 / 10);
+    assert(round_trip(block, dictionary) == block);
+
+    // The wrong dictionary cannot produce the original text
+    std::string decoded;
+    const std::string other(dictionary.size(), 'x');
+    assert(!dts::decompress_block(primed, decoded, other) || decoded != block);
+
+    assert(dts::train_dictionary({}).empty());
+    std::cout << "✓ Dictionary test passed\n";
+}
+
+void test_sealed_segments() {
+    const std::string dir = temp_dir("sealed_segments");
+    std::vector<std::string> samples;
+    for (const auto& entry : dicom_entries("PACS-04", 100)) samples.push_back(entry + "\n");
+    dts::SegmentOptions options;
+    options.max_segment_bytes = 32 * 1024;
+    options.index_interval = 16;
+    options.compress_sealed = true;
+    options.dictionary = dts::train_dictionary(samples);
+
+    std::vector<std::string> entries;
+    uint64_t raw_bytes = 0;
+    {
+        auto sink = std::make_shared<dts::SegmentedLogSink>(dir, options);
+        dts::adapters::DICOMAdapter adapter("PACS-04", "PACS_AE");
+        adapter.get_chain().set_sink(sink);
+        for (int i = 0; i < 1000; ++i) {
+            entries.push_back(adapter.log_instance_stored(
+                "1.2.840.113619.2.55." + std::to_string(i / 40), "1.2.3.4." + std::to_string(i),
+                "1.2.840.10008.5.1.4.1.1.2"));
+            raw_bytes += entries.back().size() + 1;
+        }
+        assert(sink->ok() && sink->segment_count() > 4);
+    }
+
+    dts::SegmentedLogReader reader(dir);
+    const auto& segments = reader.segments();
+    uint64_t packed_bytes = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const bool last = i + 1 == segments.size();
+        assert(segments[i].packed == !last);
+        assert(std::filesystem::exists(segments[i].log_path) == last);
+        if (!last) packed_bytes += std::filesystem::file_size(segments[i].packed_path);
+        else packed_bytes += segments[i].size;
+    }
+    assert(packed_bytes * 3 < raw_bytes);
+    assert(std::filesystem::exists(
+        dts::detail::dictionary_path(dir, dts::dictionary_id(options.dictionary))));
+
+    const auto result = reader.verify();
+    assert(result.ok() && result.entries == 1000);
+    size_t count = 0;
+    assert(reader.read_sequences(100, 700, [&](std::string_view entry, uint64_t sequence) {
+        assert(entry == entries[sequence - 1]);
+        return ++count > 0;
+    }));
+    assert(count == 601);
+
+    // A tampered packed block is caught by decoding or by the hash chain
+    const std::string packed_path = segments[1].packed_path;
+    {
+        std::fstream file(packed_path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(segments[1].blocks[0].packed_offset + 40));
+        file.put('#');
+    }
+    size_t failed_segment = 0;
+    assert(!dts::SegmentedLogReader(dir).verify(dts::VerifyOptions(), &failed_segment).ok());
+    assert(failed_segment == 1);
+
+    // Without its dictionary a sealed segment cannot be read
+    std::filesystem::remove(dts::detail::dictionary_path(dir, dts::dictionary_id(options.dictionary)));
+    assert(!dts::SegmentedLogReader(dir).read_sequences(1, 1, [](std::string_view, uint64_t) {
+        return true;
+    }));
+
+    std::filesystem::remove_all(dir);
+    std::cout << "✓ Sealed segments test passed\n";
+}
+
+void test_seal_on_reopen() {
+    const std::string dir = temp_dir("sealed_reopen");
+    dts::SegmentOptions options;
+    options.max_segment_bytes = 16 * 1024;
+    dts::ChainState state;
+    {
+        // Written uncompressed
+        auto sink = std::make_shared<dts::SegmentedLogSink>(dir, options);
+        dts::AuditChain chain("PUMP-LZ");
+        chain.set_sink(sink);
+        for (int i = 0; i < 300; ++i) chain.log("Infusion rate " + std::to_string(i % 7));
+        state = chain.state();
+        assert(sink->segment_count() > 2);
+    }
+    // A leftover from an interrupted seal is ignored and replaced
+    const auto before = dts::SegmentedLogReader(dir).segments();
+    {
+        std::ofstream stale(before[0].packed_path, std::ios::binary);
+        stale << "partial";
+    }
+    assert(!dts::SegmentedLogReader(dir).segments()[0].packed);
+
+    options.compress_sealed = true;
+    {
+        auto sink = std::make_shared<dts::SegmentedLogSink>(dir, options);
+        assert(sink->ok());
+        dts::AuditChain chain(state);
+        chain.set_sink(sink);
+        for (int i = 0; i < 10; ++i) chain.log("After restart");
+    }
+    dts::SegmentedLogReader reader(dir);
+    assert(reader.segments().size() == before.size());
+    for (size_t i = 0; i + 1 < reader.segments().size(); ++i) {
+        assert(reader.segments()[i].packed && reader.segments()[i].dictionary_id == 0);
+    }
+    assert(!reader.segments().back().packed);
+    const auto result = reader.verify();
+    assert(result.ok() && result.entries == 310);
+    std::vector<uint64_t> sequences;
+    reader.read_sequences(1, 3, [&](std::string_view, uint64_t sequence) {
+        sequences.push_back(sequence);
+        return true;
+    });
+    assert((sequences == std::vector<uint64_t>{1, 2, 3}));
+
+    std::filesystem::remove_all(dir);
+    std::cout << "✓ Seal on reopen test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS compression tests...\n\n";
+
+    test_round_trips();
+    test_malformed_input();
+    test_dictionary();
+    test_sealed_segments();
+    test_seal_on_reopen();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file test_concurrent_audit_chain.cpp
+ * @brief Unit tests for the multi-producer audit chain front end
+ */
+
+#include <dts/concurrent_audit_chain.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+void test_multi_producer_chain() {
+    std::vector<std::string> entries;
+    dts::ConcurrentAuditChain logger("TEST-DEVICE-101",
+        [&entries](std::string_view entry) { entries.emplace_back(entry); });
+    
+    const int threads = 4;
+    const int per_thread = 500;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([&logger, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                logger.log("Producer " + std::to_string(t) + " event " + std::to_string(i),
+                           dts::UserID::System, dts::Severity::Info);
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    logger.flush();
+    
+    assert(logger.get_sequence_number() == threads * per_thread);
+    assert(entries.size() == static_cast<size_t>(threads * per_thread));
+    assert(dts::AuditChain::verify_chain(entries));
+    assert(entries.back().find(logger.get_chain_hash()) != std::string::npos);
+    
+    // Per-producer order is preserved
+    for (int t = 0; t < threads; ++t) {
+        int expected = 0;
+        const std::string prefix = "Producer " + std::to_string(t) + " event ";
+        for (const auto& entry : entries) {
+            size_t pos = entry.find(prefix);
+            if (pos == std::string::npos) continue;
+            assert(std::stoi(entry.substr(pos + prefix.size())) == expected);
+            ++expected;
+        }
+        assert(expected == per_thread);
+    }
+    
+    std::cout << "✓ Multi-producer chain test passed\n";
+}
+
+void test_oversized_messages() {
+    std::vector<std::string> entries;
+    dts::ConcurrentAuditChain::Options options;
+    options.queue_capacity = 8;
+    options.inline_message_size = 16;
+    dts::ConcurrentAuditChain logger("TEST-DEVICE-102",
+        [&entries](std::string_view entry) { entries.emplace_back(entry); }, options);
+    
+    const std::string long_message(1000, 'L');
+    for (int i = 0; i < 50; ++i) {
+        logger.log(i % 2 ? long_message : "short");
+    }
+    logger.flush();
+    
+    assert(entries.size() == 50);
+    assert(entries[1].find(long_message) != std::string::npos);
+    assert(dts::AuditChain::verify_chain(entries));
+    
+    std::cout << "✓ Oversized message test passed\n";
+}
+
+class CountingSink : public dts::LogSink {
+public:
+    void write(std::string_view, const dts::EntryInfo&) override { ++writes; }
+    void flush() override { ++flushes; }
+    
+    std::atomic<int> writes{0};
+    std::atomic<int> flushes{0};
+};
+
+void test_priority_lanes() {
+    std::vector<std::string> entries;
+    std::atomic<bool> released{false};
+    auto sink = std::make_shared<CountingSink>();
+    dts::ConcurrentAuditChain::Options options;
+    options.queue_capacity = 64;
+    options.priority_queue_capacity = 8;
+    options.sink = sink;
+    // The handler parks the sequencer so that the bulk lane saturates
+    dts::ConcurrentAuditChain logger("TEST-DEVICE-103",
+        [&](std::string_view entry) {
+            while (!released.load()) std::this_thread::yield();
+            entries.emplace_back(entry);
+        }, options);
+    
+    int accepted = 0;
+    while (logger.try_log("Telemetry " + std::to_string(accepted))) ++accepted;
+    assert(accepted >= 64);
+    assert(logger.lane_metrics(dts::Lane::Bulk).rejected == 1);
+    
+    // Priority lanes still accept while bulk traffic is refused
+    assert(logger.try_log("Interlock IL-1 TRIGGERED", dts::UserID::System,
+                          dts::Severity::Critical));
+    assert(logger.try_log("Drive fault", dts::UserID::System, dts::Severity::Error));
+    assert(!logger.try_log("Telemetry overflow"));
+    assert(logger.rejected_count() == 2);
+    released = true;
+    logger.flush();
+    
+    // Critical, then Error, preempt everything still queued in the bulk lane
+    assert(entries.size() == static_cast<size_t>(accepted + 2));
+    auto position = [&entries](const std::string& text) {
+        return std::find_if(entries.begin(), entries.end(), [&text](const std::string& entry) {
+            return entry.find(text) != std::string::npos;
+        }) - entries.begin();
+    };
+    const auto critical = position("Interlock IL-1");
+    assert(critical <= 1);
+    assert(position("Drive fault") == critical + 1);
+    assert(dts::AuditChain::verify_chain(entries));
+    
+    // Each priority entry was flushed on its own
+    assert(sink->writes == accepted + 2);
+    assert(sink->flushes == 2);
+    
+    const auto bulk = logger.lane_metrics(dts::Lane::Bulk);
+    const auto urgent = logger.lane_metrics(dts::Lane::Critical);
+    assert(bulk.chained == static_cast<uint64_t>(accepted) && bulk.depth == 0);
+    assert(urgent.chained == 1 && urgent.rejected == 0);
+    assert(logger.lane_metrics(dts::Lane::Error).chained == 1);
+    assert(urgent.max_latency_ns > 0 && urgent.mean_latency_ns() == urgent.max_latency_ns);
+    assert(bulk.mean_latency_ns() <= bulk.max_latency_ns);
+    assert(dts::lane_of(dts::Severity::Warning) == dts::Lane::Bulk);
+    
+    std::cout << "✓ Priority lane test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS concurrent chain tests...\n\n";
+    
+    test_multi_producer_chain();
+    test_oversized_messages();
+    test_priority_lanes();
+    
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file test_epoch_chain.cpp
+ * @brief Unit tests for per-epoch parallel chain construction
+ */
+
+#include <dts/epoch_chain.hpp>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const auto fixed_time =
+    std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000123));
+
+/// Records whole batches with their metadata
+class BatchSink : public dts::LogSink {
+public:
+    void write(std::string_view, const dts::EntryInfo&) override { ++singles; }
+
+    void write_batch(std::string_view entries, const dts::EntryInfo* infos,
+                     size_t count) override {
+        ++batches;
+        buffer.append(entries.data(), entries.size());
+        for (size_t i = 0; i < count; ++i) {
+            sequences.push_back(infos[i].sequence);
+            messages.emplace_back(infos[i].message);
+            hashes.push_back(infos[i].chain_hash);
+        }
+    }
+
+    size_t singles = 0;
+    size_t batches = 0;
+    std::string buffer;
+    std::vector<uint64_t> sequences;
+    std::vector<std::string> messages;
+    std::vector<dts::SHA256::Hash> hashes;
+};
+
+static std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> lines;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const size_t end = text.find('\n', pos);
+        assert(end != std::string::npos);
+        lines.push_back(text.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return lines;
+}
+
+static std::string join_lines(const std::vector<std::string>& lines) {
+    std::string text;
+    for (const auto& line : lines) text += line + "\n";
+    return text;
+}
+
+static std::vector<dts::LogEvent> make_events(std::vector<std::string>& storage, size_t count) {
+    storage.clear();
+    for (size_t i = 0; i < count; ++i) storage.push_back("Instance stored " + std::to_string(i));
+    std::vector<dts::LogEvent> events;
+    for (size_t i = 0; i < count; ++i) {
+        events.push_back({storage[i], dts::UserID::System,
+                          i % 97 == 0 ? dts::Severity::Warning : dts::Severity::Info});
+    }
+    return events;
+}
+
+static dts::EpochOptions lanes_of(unsigned threads, size_t min_lane_events = 16) {
+    dts::EpochOptions options;
+    options.threads = threads;
+    options.min_lane_events = min_lane_events;
+    return options;
+}
+
+void test_epochs_verify() {
+    std::vector<std::string> storage;
+    const auto events = make_events(storage, 1000);
+    dts::EpochChain chain("PACS-EPOCH-1", lanes_of(4), dts::clocks::fixed(fixed_time));
+    std::string out, log;
+    for (int epoch = 0; epoch < 3; ++epoch) {
+        assert(chain.log_epoch(out, events) == 1001);
+        log += out;
+    }
+    assert(chain.epoch_count() == 3 && chain.get_sequence_number() == 3003);
+    const dts::EpochSeal& seal = chain.last_seal();
+    assert(seal.index == 2 && seal.first_sequence == 2003 && seal.count == 1000 && seal.lanes == 4);
+
+    // Events keep their order; the seal comes last
+    const auto lines = split_lines(out);
+    assert(lines.size() == 1001);
+    for (size_t i = 0; i < 1000; ++i) {
+        dts::EntryView view;
+        assert(dts::parse_entry(lines[i], view));
+        assert(view.message == storage[i]);
+    }
+    dts::EntryView view;
+    assert(dts::parse_entry(lines.back(), view));
+    dts::EpochSeal parsed;
+    assert(dts::parse_epoch_seal_message(view.message, parsed));
+    assert(parsed.index == seal.index && parsed.root == seal.root);
+    assert(view.chain_hash == chain.get_chain_hash());
+
+    for (bool recompute : {false, true}) {
+        dts::VerifyOptions options;
+        options.recompute = recompute;
+        const auto result = dts::verify_epoch_buffer(log, options);
+        assert(result.ok() && result.entries == 3003);
+        assert(result.last_hash == chain.state().last_hash);
+    }
+    // A plain chain verifier stops at the first lane boundary
+    assert(dts::verify_buffer(log).status == dts::VerifyStatus::BrokenLink);
+
+    // Lanes are deterministic for a given lane count
+    dts::EpochChain again("PACS-EPOCH-1", lanes_of(4), dts::clocks::fixed(fixed_time));
+    std::string replay;
+    for (int epoch = 0; epoch < 3; ++epoch) {
+        again.log_epoch(out, events);
+        replay += out;
+    }
+    assert(replay == log);
+
+    // Small epochs use fewer lanes; one lane is a single sub-chain
+    dts::EpochChain small("PACS-EPOCH-1", lanes_of(8, 256));
+    small.log_epoch(out, std::vector<dts::LogEvent>(events.begin(), events.begin() + 600));
+    assert(small.last_seal().lanes == 2);
+    small.log_epoch(out, std::vector<dts::LogEvent>(events.begin(), events.begin() + 3));
+    assert(small.last_seal().lanes == 1 && small.last_seal().count == 3);
+    assert(small.log_epoch(out, nullptr, 0) == 0 && out.empty() && small.epoch_count() == 2);
+
+    std::cout << "✓ Epochs verify test passed\n";
+}
+
+void test_sink_and_resume() {
+    std::vector<std::string> storage;
+    const auto events = make_events(storage, 300);
+    auto sink = std::make_shared<BatchSink>();
+    dts::EpochChain chain("PUMP-EPOCH-2", lanes_of(3),
+                          dts::clocks::stepping(fixed_time, std::chrono::milliseconds(5)));
+    chain.set_sink(sink);
+    std::string out, log;
+    for (int epoch = 0; epoch < 2; ++epoch) {
+        chain.log_epoch(out, events);
+        log += out;
+    }
+    assert(sink->batches == 2 && sink->singles == 0 && sink->buffer == log);
+    assert(sink->sequences.size() == 602);
+    for (size_t i = 0; i < sink->sequences.size(); ++i) assert(sink->sequences[i] == i + 1);
+    assert(sink->messages[0] == storage[0]);
+    assert(sink->messages[300].find("Epoch Seal | index=0") == 0);
+    assert(sink->hashes.back() == chain.state().last_hash);
+    const auto lines = split_lines(log);
+    dts::EntryView first, second;
+    assert(dts::parse_entry(lines[0], first) && dts::parse_entry(lines[301], second));
+    assert(first.timestamp != second.timestamp);    // one clock read per epoch
+
+    // Resume from the state of the last seal
+    dts::EpochChain resumed(chain.state(), lanes_of(2));
+    resumed.log_epoch(out, events);
+    log += out;
+    assert(resumed.get_sequence_number() == 903 && resumed.last_seal().index == 0);
+    auto result = dts::verify_epoch_buffer(log);
+    assert(result.ok() && result.entries == 903);
+
+    // Epochs may follow a plain chain; verify each part from its anchor
+    dts::AuditChain plain("PUMP-EPOCH-3");
+    std::string head;
+    for (int i = 0; i < 5; ++i) head += plain.log("Boot step " + std::to_string(i)) + "\n";
+    dts::EpochChain continued(plain.state(), lanes_of(2));
+    continued.log_epoch(out, events);
+    assert(dts::verify_buffer(head).ok());
+    dts::VerifyOptions options;
+    options.initial_hash = plain.state().last_hash;
+    assert(dts::verify_epoch_buffer(out, options).ok());
+    assert(!dts::verify_epoch_buffer(out).ok());
+
+    std::cout << "✓ Sink and resume test passed\n";
+}
+
+void test_tamper_detection() {
+    std::vector<std::string> storage;
+    const auto events = make_events(storage, 400);
+    dts::EpochChain chain("PACS-EPOCH-4", lanes_of(4), dts::clocks::fixed(fixed_time));
+    std::vector<std::string> lines;
+    std::string out;
+    for (int epoch = 0; epoch < 3; ++epoch) {
+        chain.log_epoch(out, events);
+        for (auto& line : split_lines(out)) lines.push_back(line);
+    }
+    assert(lines.size() == 1203);
+    assert(dts::verify_epoch_buffer(join_lines(lines)).ok());
+    const size_t epoch = 401;       // second epoch starts here; lanes of 100
+
+    auto status_without = [&](size_t index) {
+        auto copy = lines;
+        copy.erase(copy.begin() + static_cast<std::ptrdiff_t>(index));
+        return dts::verify_epoch_buffer(join_lines(copy));
+    };
+    // Inside a lane the link breaks
+    auto result = status_without(epoch + 150);
+    assert(result.status == dts::VerifyStatus::BrokenLink && result.failed_entry == epoch + 151);
+    // The last entry of a lane no longer matches the sealed root
+    assert(status_without(epoch + 99).status == dts::VerifyStatus::HashMismatch);
+    // A whole lane is missing
+    {
+        auto copy = lines;
+        copy.erase(copy.begin() + epoch + 300, copy.begin() + epoch + 400);
+        assert(!dts::verify_epoch_buffer(join_lines(copy)).ok());
+    }
+    // The seal is missing
+    assert(status_without(epoch + 400).status == dts::VerifyStatus::BrokenLink);
+
+    // Swapped lanes have the wrong seeds
+    {
+        auto copy = lines;
+        std::swap_ranges(copy.begin() + epoch, copy.begin() + epoch + 100,
+                         copy.begin() + epoch + 100);
+        assert(dts::verify_epoch_buffer(join_lines(copy)).status ==
+               dts::VerifyStatus::BrokenLink);
+    }
+    // Epochs cannot be reordered
+    {
+        auto copy = lines;
+        std::swap_ranges(copy.begin(), copy.begin() + 401, copy.begin() + 401);
+        assert(!dts::verify_epoch_buffer(join_lines(copy)).ok());
+    }
+    // A torn epoch without its seal
+    {
+        std::vector<std::string> torn(lines.begin(), lines.begin() + epoch + 250);
+        result = dts::verify_epoch_buffer(join_lines(torn));
+        assert(result.status == dts::VerifyStatus::BrokenLink);
+        assert(result.entries == 401 && result.failed_entry == 402);
+    }
+    // Edited contents are found by recomputing the hashes
+    {
+        auto copy = lines;
+        const size_t at = copy[epoch + 42].find("Instance stored");
+        copy[epoch + 42][at] = 'i';
+        assert(dts::verify_epoch_buffer(join_lines(copy)).ok());
+        dts::VerifyOptions options;
+        options.recompute = true;
+        result = dts::verify_epoch_buffer(join_lines(copy), options);
+        assert(result.status == dts::VerifyStatus::HashMismatch && result.failed_entry == epoch + 43);
+    }
+    // A forged seal root
+    {
+        auto copy = lines;
+        const size_t at = copy[epoch + 400].find("root=") + 5;
+        copy[epoch + 400][at] = copy[epoch + 400][at] == '0' ? '1' : '0';
+        assert(dts::verify_epoch_buffer(join_lines(copy)).status ==
+               dts::VerifyStatus::HashMismatch);
+    }
+
+    std::cout << "✓ Tamper detection test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS epoch chain tests...\n\n";
+
+    test_epochs_verify();
+    test_sink_and_resume();
+    test_tamper_detection();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file test_event_coalescer.cpp
+ * @brief Unit tests for windowed telemetry coalescing
+ */
+
+#include <dts/adapters/building_automation_adapter.hpp>
+#include <dts/adapters/industrial_adapter.hpp>
+#include <dts/event_coalescer.hpp>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CollectingSink : public dts::LogSink {
+public:
+    void write(std::string_view entry, const dts::EntryInfo&) override {
+        entries.emplace_back(entry);
+    }
+
+    std::vector<std::string> entries;
+};
+
+static std::string message_of(const std::string& entry) {
+    dts::EntryView view;
+    std::string message;
+    assert(dts::parse_entry(entry, view));
+    assert(dts::unescape_json(view.message, message));
+    return message;
+}
+
+static int64_t now_ms = 1700000000000;
+
+static dts::ClockSource test_clock() {
+    return [] { return std::chrono::system_clock::time_point(std::chrono::milliseconds(now_ms)); };
+}
+
+void test_window_summary() {
+    dts::AuditChain chain("TEST-DEVICE-701", test_clock());
+    auto sink = std::make_shared<CollectingSink>();
+    chain.set_sink(sink);
+
+    dts::EventCoalescer::Options options;
+    options.window = std::chrono::milliseconds(1000);
+    options.clock = test_clock();
+    dts::EventCoalescer coalescer(options);
+
+    std::string out;
+    const double readings[] = {20.5, 19.0, 23.25, 21.0};
+    for (double value : readings) {
+        assert(!coalescer.submit(chain, out, "Temp", "T1", value, "Temp | T1", dts::UserID::System,
+                                 dts::Severity::Info));
+        assert(out.empty());
+        now_ms += 100;
+    }
+    assert(!coalescer.submit(chain, out, "Temp", "T2", 5.0, "Temp | T2:5", dts::UserID::System,
+                             dts::Severity::Warning));
+    assert(coalescer.pending() == 2);
+    assert(sink->entries.empty());
+
+    // The next event after the window closes both windows first
+    now_ms += 1000;
+    assert(!coalescer.submit(chain, out, "Temp", "T1", 22.0, "Temp | T1", dts::UserID::System,
+                             dts::Severity::Info));
+    assert(sink->entries.size() == 2);
+    assert(message_of(sink->entries[0]) ==
+           "Coalesced Events | Event:Temp | Key:T1 | Count:4 | First:20.5 | Last:21 | "
+           "Min:19 | Max:23.25 | Span:300ms");
+    // A lone event is chained unchanged, with its own time and severity
+    assert(message_of(sink->entries[1]) == "Temp | T2:5");
+    dts::EntryView view;
+    assert(dts::parse_entry(sink->entries[1], view) && view.severity == 2);
+    assert(coalescer.coalesced_count() == 4);
+
+    // Text values: Min/Max only while every value is numeric
+    for (const char* value : {"ON", "OFF", "ON"}) {
+        coalescer.submit(chain, out, "Switch", "S1", std::string_view(value), "Switch",
+                         dts::UserID::System, dts::Severity::Info);
+    }
+    assert(coalescer.flush(chain) == 2);
+    assert(coalescer.pending() == 0);
+    assert(message_of(sink->entries[2]) == "Temp | T1");
+    assert(message_of(sink->entries[3]) ==
+           "Coalesced Events | Event:Switch | Key:S1 | Count:3 | First:ON | Last:ON | Span:0ms");
+
+    // poll() closes only expired windows
+    coalescer.submit(chain, out, "Temp", "T3", 1.0, "Temp | T3", dts::UserID::System,
+                     dts::Severity::Info);
+    assert(coalescer.poll(chain) == 0);
+    now_ms += 1000;
+    assert(coalescer.poll(chain) == 1);
+
+    assert(dts::AuditChain::verify_chain(sink->entries, true));
+    std::cout << "✓ Window summary test passed\n";
+}
+
+void test_critical_passthrough() {
+    dts::AuditChain chain("TEST-DEVICE-702", test_clock());
+    auto sink = std::make_shared<CollectingSink>();
+    chain.set_sink(sink);
+    dts::EventCoalescer::Options options;
+    options.clock = test_clock();
+    options.max_keys = 2;
+    dts::EventCoalescer coalescer(options);
+
+    std::string out;
+    coalescer.submit(chain, out, "Door", "D1", std::string_view("open"), "Door | D1 open",
+                     dts::UserID::System, dts::Severity::Info);
+    coalescer.submit(chain, out, "Door", "D1", std::string_view("closed"), "Door | D1 closed",
+                     dts::UserID::System, dts::Severity::Info);
+
+    // Critical events are never held; the pending window for the key goes first
+    assert(coalescer.submit(chain, out, "Door", "D1", std::string_view("forced"),
+                            "Door | D1 forced", dts::UserID::System, dts::Severity::Critical));
+    assert(sink->entries.size() == 2);
+    assert(message_of(sink->entries[0]).find("Count:2") != std::string::npos);
+    assert(out == sink->entries[1] && message_of(out) == "Door | D1 forced");
+
+    // Once the key table is full, new keys pass straight through
+    coalescer.submit(chain, out, "Door", "D2", std::string_view("open"), "D2",
+                     dts::UserID::System, dts::Severity::Info);
+    coalescer.submit(chain, out, "Door", "D3", std::string_view("open"), "D3",
+                     dts::UserID::System, dts::Severity::Info);
+    assert(out.empty());
+    assert(coalescer.submit(chain, out, "Door", "D4", std::string_view("open"), "D4",
+                            dts::UserID::System, dts::Severity::Info));
+    assert(message_of(out) == "D4");
+
+    std::cout << "✓ Critical passthrough test passed\n";
+}
+
+void test_adapter_coalescing() {
+    auto sink = std::make_shared<CollectingSink>();
+    dts::EventCoalescer::Options options;
+    options.clock = test_clock();
+    {
+        dts::adapters::IndustrialAdapter plc("PLC-07", "ASSET-1");
+        plc.get_chain().set_sink(sink);
+        plc.enable_coalescing(options);
+        for (int i = 0; i < 1000; ++i) {
+            assert(plc.log_io_change("I0.3", i % 2 ? "1" : "0", i % 2 ? "0" : "1").empty());
+        }
+        // Safety events are Critical and never held
+        assert(!plc.log_safety_interlock("IL-1", true).empty());
+        assert(!plc.log_plc_event("Main").empty());
+    }
+    // The destructor chained the held window
+    assert(sink->entries.size() == 3);
+    assert(message_of(sink->entries[2]) ==
+           "Coalesced Events | Event:I/O Change | Key:I0.3 | Count:1000 | First:1 | Last:0 | "
+           "Min:0 | Max:1 | Span:0ms");
+    assert(dts::AuditChain::verify_chain(sink->entries, true));
+
+    auto bas_sink = std::make_shared<CollectingSink>();
+    dts::adapters::BuildingAutomationAdapter bas("BAS-07", "HQ");
+    bas.get_chain().set_sink(bas_sink);
+    bas.enable_coalescing(options);
+    for (int i = 0; i < 50; ++i) {
+        bas.log_energy_consumption("M-1", 100.0 + i);
+        bas.log_bacnet_event("analog-input", 3, "present-value", std::to_string(i));
+        bas.log_knx_event("1/2/3", "ON");
+    }
+    assert(bas_sink->entries.empty());
+    assert(!bas.log_fire_safety_event("Smoke", "3F").empty());
+    bas.flush_coalesced();
+    assert(bas_sink->entries.size() == 4);
+    assert(message_of(bas_sink->entries[1]) ==
+           "Coalesced Events | Event:Energy Consumption | Key:M-1 | Count:50 | First:100 | "
+           "Last:149 | Min:100 | Max:149 | Span:0ms");
+    assert(message_of(bas_sink->entries[2]) ==
+           "Coalesced Events | Event:BACnet Event | Key:analog-input:3:present-value | "
+           "Count:50 | First:0 | Last:49 | Min:0 | Max:49 | Span:0ms");
+
+    // Re-enabling chains what the old coalescer still held
+    for (int i = 0; i < 5; ++i) bas.log_knx_event("1/2/4", "OFF");
+    bas.enable_coalescing(options);
+    assert(bas_sink->entries.size() == 5);
+    assert(message_of(bas_sink->entries[4]) ==
+           "Coalesced Events | Event:KNX Event | Key:1/2/4 | Count:5 | First:OFF | Last:OFF | "
+           "Span:0ms");
+    assert(dts::AuditChain::verify_chain(bas_sink->entries, true));
+    {
+        auto plc_sink = std::make_shared<CollectingSink>();
+        dts::adapters::IndustrialAdapter plc("PLC-08", "ASSET-2");
+        plc.get_chain().set_sink(plc_sink);
+        plc.enable_coalescing(options);
+        for (int i = 0; i < 10; ++i) plc.log_io_change("I0.4", "0", "1");
+        plc.enable_coalescing(options);
+        assert(plc_sink->entries.size() == 1);
+    }
+
+    // Without coalescing enabled, behaviour is unchanged
+    dts::adapters::BuildingAutomationAdapter plain("BAS-08");
+    assert(message_of(plain.log_knx_event("1/2/3", "ON")) == "KNX Event | GroupAddress:1/2/3 | Value:ON");
+
+    std::cout << "✓ Adapter coalescing test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS event coalescer tests...\n\n";
+
+    test_window_summary();
+    test_critical_passthrough();
+    test_adapter_coalescing();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
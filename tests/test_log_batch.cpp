@@ -0,0 +1,265 @@
+/**
+ * @file test_log_batch.cpp
+ * @brief Unit tests for batch logging and the bulk adapter methods
+ */
+
+#include <dts/adapters/dicom_adapter.hpp>
+#include <dts/adapters/industrial_adapter.hpp>
+#include <dts/chain_verifier.hpp>
+#include <dts/log_sink.hpp>
+#include <dts/segmented_log.hpp>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const auto fixed_time =
+    std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000123));
+
+/// Records entries; relies on the default write_batch()
+class CollectingSink : public dts::LogSink {
+public:
+    void write(std::string_view entry, const dts::EntryInfo& info) override {
+        entries.emplace_back(entry);
+        sequences.push_back(info.sequence);
+        messages.emplace_back(info.message);
+    }
+
+    std::vector<std::string> entries;
+    std::vector<uint64_t> sequences;
+    std::vector<std::string> messages;
+};
+
+/// Records whole batches
+class BatchSink : public CollectingSink {
+public:
+    void write_batch(std::string_view batch, const dts::EntryInfo* infos, size_t count) override {
+        ++batches;
+        buffer.append(batch.data(), batch.size());
+        CollectingSink::write_batch(batch, infos, count);
+    }
+
+    size_t batches = 0;
+    std::string buffer;
+};
+
+static std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> lines;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const size_t end = text.find('\n', pos);
+        assert(end != std::string::npos);       // every entry is newline-terminated
+        lines.push_back(text.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return lines;
+}
+
+void test_batch_matches_single_entries() {
+    const std::vector<dts::LogEvent> events = {
+        {"Pump started"},
+        {"Rate \"5 mL/h\"\n", dts::UserID::Operator, dts::Severity::Warning},
+        {"Occlusion", dts::UserID::System, dts::Severity::Critical},
+        {""},
+    };
+    dts::AuditChain single("BATCH-DEVICE-1", dts::clocks::fixed(fixed_time));
+    dts::AuditChain batched("BATCH-DEVICE-1", dts::clocks::fixed(fixed_time));
+    for (int round = 0; round < 3; ++round) {
+        std::string expected, entry;
+        for (const auto& event : events) {
+            single.log(entry, event.message, event.user_id, event.severity);
+            expected += entry + "\n";
+        }
+        std::string out = "stale";
+        assert(batched.log_batch(out, events) == events.size());
+        assert(out == expected);
+        assert(batched.get_chain_hash() == single.get_chain_hash());
+        assert(batched.get_sequence_number() == single.get_sequence_number());
+    }
+
+    // Single and batch calls interleave on one chain
+    std::vector<std::string> entries;
+    std::string out;
+    entries.push_back(batched.log("Before"));
+    dts::EventBatch batch;
+    for (int i = 0; i < 50; ++i) batch.add("Reading " + std::to_string(i));
+    assert(batch.size() == 50);
+    batched.log_batch(out, batch);
+    for (auto& line : split_lines(out)) entries.push_back(line);
+    entries.push_back(batched.log("After"));
+    assert(entries.size() == 52);
+
+    dts::AuditChain fresh("BATCH-DEVICE-1");
+    std::vector<std::string> chain;
+    chain.push_back(fresh.log("First"));
+    fresh.log_batch(out, batch);
+    for (auto& line : split_lines(out)) chain.push_back(line);
+    assert(dts::AuditChain::verify_chain(chain, true));
+
+    assert(batched.log_batch(out, nullptr, 0) == 0 && out.empty());
+    batch.clear();
+    assert(batch.empty());
+
+    std::cout << "✓ Batch matches single entries test passed\n";
+}
+
+void test_batch_sinks_and_checkpoints() {
+    std::vector<dts::LogEvent> events;
+    for (int i = 0; i < 12; ++i) events.push_back({"Event"});
+
+    dts::AuditChain single("BATCH-DEVICE-2", dts::clocks::fixed(fixed_time));
+    dts::AuditChain batched("BATCH-DEVICE-2", dts::clocks::fixed(fixed_time));
+    single.set_checkpoint_interval(5);
+    batched.set_checkpoint_interval(5);
+    auto single_sink = std::make_shared<CollectingSink>();
+    auto batch_sink = std::make_shared<BatchSink>();
+    single.set_sink(single_sink);
+    batched.set_sink(batch_sink);
+    for (const auto& event : events) single.log(event.message);
+
+    std::string out;
+    // Checkpoints follow entries 5 and 11 (the checkpoint itself is entry 6)
+    assert(batched.log_batch(out, events) == 14);
+    assert(batch_sink->batches == 1 && batch_sink->buffer == out);
+    assert(batch_sink->entries == single_sink->entries);
+    assert(batch_sink->sequences == single_sink->sequences);
+    assert(batch_sink->messages == single_sink->messages);
+    assert(batch_sink->messages[5].find("Merkle Checkpoint") == 0);
+    assert(batched.checkpoint_count() == 2);
+    std::string checkpoint;
+    assert(!batched.take_checkpoint(checkpoint));   // already in the batch
+
+    // A sink without write_batch() receives the entries one by one
+    auto plain = std::make_shared<CollectingSink>();
+    batched.set_sink(plain);
+    batched.log_batch(out, events);
+    assert(plain->entries == split_lines(out));
+    assert(plain->sequences.front() == 15 && plain->sequences.back() == 28);
+
+    std::cout << "✓ Batch sinks and checkpoints test passed\n";
+}
+
+void test_file_sinks() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string sync_path = (dir / "dts_batch_sync.log").string();
+    const std::string async_path = (dir / "dts_batch_async.log").string();
+    const std::string state_path = (dir / "dts_batch.state").string();
+    for (const auto& path : {sync_path, async_path, state_path}) std::filesystem::remove(path);
+
+    dts::EventBatch batch;
+    for (int i = 0; i < 300; ++i) {
+        batch.add("Sample " + std::to_string(i), dts::UserID::System,
+                  i == 150 ? dts::Severity::Critical : dts::Severity::Info);
+    }
+
+    std::string expected, out;
+    {
+        dts::DurabilityPolicy policy;
+        policy.state_path = state_path;
+        auto sink = std::make_shared<dts::FileSink>(sync_path, policy);
+        dts::AuditChain chain("BATCH-DEVICE-3");
+        chain.set_sink(sink);
+        for (int i = 0; i < 3; ++i) {
+            chain.log_batch(out, batch);
+            expected += out;
+        }
+        // The Critical entry synced the batch and wrote a snapshot
+        dts::ChainState state;
+        assert(dts::load_chain_state(state_path, state));
+        assert(state.sequence == 900 && state.log_offset == expected.size());
+        assert(state.last_hash == chain.state().last_hash);
+    }
+    assert(dts::verify_file(sync_path).ok() && dts::verify_file(sync_path).entries == 900);
+
+    {
+        auto sink = std::make_shared<dts::AsyncFileSink>(async_path);
+        dts::AuditChain chain("BATCH-DEVICE-3");
+        chain.set_sink(sink);
+        for (int i = 0; i < 3; ++i) chain.log_batch(out, batch);
+        sink->flush();
+        assert(sink->appended_count() == 900 && sink->durable_count() == 900);
+    }
+    const auto result = dts::verify_file(async_path);
+    assert(result.ok() && result.entries == 900);
+
+    // Batches split across segments and index blocks
+    const std::string segment_dir = (dir / "dts_batch_segments").string();
+    std::filesystem::remove_all(segment_dir);
+    {
+        dts::SegmentOptions options;
+        options.max_segment_bytes = 16 * 1024;
+        options.index_interval = 7;
+        auto sink = std::make_shared<dts::SegmentedLogSink>(segment_dir, options);
+        dts::AuditChain chain("BATCH-DEVICE-3");
+        chain.set_sink(sink);
+        for (int i = 0; i < 3; ++i) chain.log_batch(out, batch);
+        assert(sink->ok() && sink->segment_count() > 3);
+    }
+    dts::SegmentedLogReader reader(segment_dir);
+    assert(reader.verify().ok() && reader.last_sequence() == 900);
+    size_t found = 0;
+    reader.read_sequences(295, 305, [&](std::string_view entry, uint64_t) {
+        return entry.find("\"message\":\"Sample ") != std::string_view::npos && ++found;
+    });
+    assert(found == 11);
+
+    std::filesystem::remove_all(segment_dir);
+    for (const auto& path : {sync_path, async_path, state_path}) std::filesystem::remove(path);
+    std::cout << "✓ File sinks test passed\n";
+}
+
+void test_bulk_adapters() {
+    std::vector<dts::adapters::StoredInstance> instances;
+    std::vector<std::string> uids;
+    for (int i = 0; i < 2000; ++i) uids.push_back("1.2.826.0.1.3680043.8." + std::to_string(i));
+    for (const auto& uid : uids) instances.push_back({uid, "1.2.840.10008.5.1.4.1.1.2"});
+
+    dts::adapters::DICOMAdapter single("CT-SCANNER-01", "CT_AE");
+    dts::adapters::DICOMAdapter bulk("CT-SCANNER-01", "CT_AE");
+    single.get_chain().set_clock(dts::clocks::fixed(fixed_time));
+    bulk.get_chain().set_clock(dts::clocks::fixed(fixed_time));
+    std::string expected;
+    for (const auto& instance : instances) {
+        expected += single.log_instance_stored("1.2.3.4.5", instance.sop_instance_uid,
+                                               instance.sop_class_uid) + "\n";
+    }
+    assert(bulk.log_instances_stored("1.2.3.4.5", instances) == expected);
+    assert(bulk.get_chain_hash() == single.get_chain_hash());
+
+    const std::vector<dts::adapters::IoChange> changes = {
+        {"I:1/0", "0", "1"}, {"O:2/3", "1", "0", true}, {"I:1/1", "0", "1"}};
+    dts::adapters::IndustrialAdapter plc_single("PLC-BATCH", "ASSET-7");
+    dts::adapters::IndustrialAdapter plc_bulk("PLC-BATCH", "ASSET-7");
+    plc_single.get_chain().set_clock(dts::clocks::fixed(fixed_time));
+    plc_bulk.get_chain().set_clock(dts::clocks::fixed(fixed_time));
+    expected.clear();
+    for (const auto& change : changes) {
+        expected += plc_single.log_io_change(change.io_address, change.old_value,
+                                             change.new_value, change.is_output) + "\n";
+    }
+    assert(plc_bulk.log_io_changes(changes) == expected);
+
+    // Coalesced changes are held; nothing is returned for them
+    plc_bulk.enable_coalescing();
+    const uint64_t before = plc_bulk.get_chain().get_sequence_number();
+    assert(plc_bulk.log_io_changes(changes).empty());
+    plc_bulk.flush_coalesced();
+    assert(plc_bulk.get_chain().get_sequence_number() > before);
+
+    std::cout << "✓ Bulk adapters test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS batch logging tests...\n\n";
+
+    test_batch_matches_single_entries();
+    test_batch_sinks_and_checkpoints();
+    test_file_sinks();
+    test_bulk_adapters();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_log_sink.cpp
+ * @brief Unit tests for DTS file sinks
+ */
+
+#include <dts/log_sink.hpp>
+#include <dts/concurrent_audit_chain.hpp>
+#include <cassert>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+static std::string temp_path(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("dts_" + name);
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+static std::vector<std::string> read_lines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);) lines.push_back(line);
+    return lines;
+}
+
+void test_file_sink() {
+    const std::string path = temp_path("file_sink.log");
+    {
+        dts::AuditChain logger("TEST-DEVICE-201");
+        logger.set_sink(std::make_shared<dts::FileSink>(path));
+        for (int i = 0; i < 10; ++i) logger.log("Event " + std::to_string(i));
+    }
+    auto lines = read_lines(path);
+    assert(lines.size() == 10);
+    assert(dts::AuditChain::verify_chain(lines));
+    std::filesystem::remove(path);
+    
+    std::cout << "✓ File sink test passed\n";
+}
+
+void test_async_group_commit() {
+    const std::string path = temp_path("async_sink.log");
+    dts::DurabilityPolicy policy;
+    policy.max_batch_delay = std::chrono::milliseconds(200);
+    auto sink = std::make_shared<dts::AsyncFileSink>(path, policy);
+    assert(sink->ok());
+    
+    dts::AuditChain logger("TEST-DEVICE-202");
+    logger.set_sink(sink);
+    for (int i = 0; i < 500; ++i) logger.log("Telemetry " + std::to_string(i));
+    
+    // A critical entry commits everything before it and returns only once durable
+    logger.log("Safety interlock tripped", dts::UserID::System, dts::Severity::Critical);
+    assert(sink->durable_count() == 501);
+    
+    for (int i = 0; i < 100; ++i) logger.log("Telemetry tail " + std::to_string(i));
+    sink->flush();
+    assert(sink->durable_count() == 601);
+    assert(sink->sync_count() < 20);
+    
+    auto lines = read_lines(path);
+    assert(lines.size() == 601);
+    assert(dts::AuditChain::verify_chain(lines));
+    assert(lines[500].find("Safety interlock tripped") != std::string::npos);
+    std::filesystem::remove(path);
+    
+    std::cout << "✓ Async group-commit test passed\n";
+}
+
+void test_async_write_failure() {
+    // Every write to /dev/full fails with ENOSPC
+    if (!std::filesystem::exists("/dev/full")) return;
+    const std::string state_path = temp_path("async_full.state");
+    dts::DurabilityPolicy policy;
+    policy.max_batch_delay = std::chrono::milliseconds(200);
+    policy.state_path = state_path;
+    auto sink = std::make_shared<dts::AsyncFileSink>("/dev/full", policy);
+    if (!sink->ok()) return;
+
+    {
+        dts::AuditChain logger("TEST-DEVICE-203");
+        logger.set_sink(sink);
+        for (int i = 0; i < 10; ++i) logger.log("Telemetry " + std::to_string(i));
+        logger.log("Safety interlock tripped", dts::UserID::System, dts::Severity::Critical);
+        sink->flush();
+        // Lost data is never reported as durable
+        assert(!sink->ok());
+        assert(sink->durable_count() == 0);
+        assert(sink->sync_count() == 0);
+
+        // Nor by a later sync request: the file has a gap
+        for (int i = 0; i < 10; ++i) logger.log("After failure " + std::to_string(i));
+        sink->flush();
+        assert(sink->durable_count() == 0 && sink->sync_count() == 0);
+        assert(sink->appended_count() == 21);
+    }
+    // Nor by the final sync on shutdown, whose snapshot would claim the entries
+    sink.reset();
+    dts::ChainState saved;
+    assert(!dts::load_chain_state(state_path, saved));
+    std::filesystem::remove(state_path);
+
+#if defined(__unix__) || defined(__APPLE__)
+    // A write cut off by the file size limit, on a file that still syncs
+    const std::string path = temp_path("async_limit.log");
+    std::filesystem::remove(state_path);
+    rlimit previous;
+    getrlimit(RLIMIT_FSIZE, &previous);
+    void (*previous_handler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = previous;
+    limited.rlim_cur = 4096;
+    setrlimit(RLIMIT_FSIZE, &limited);
+    {
+        policy.state_interval = 1;
+        auto limited_sink = std::make_shared<dts::AsyncFileSink>(path, policy);
+        dts::AuditChain logger("TEST-DEVICE-204");
+        logger.set_sink(limited_sink);
+        logger.log("Before the limit");
+        limited_sink->flush();
+        assert(limited_sink->ok() && limited_sink->durable_count() == 1);
+        for (int i = 0; i < 100; ++i) logger.log("Telemetry " + std::to_string(i));
+        limited_sink->flush();
+        assert(!limited_sink->ok() && limited_sink->durable_count() == 1);
+    }
+    setrlimit(RLIMIT_FSIZE, &previous);
+    std::signal(SIGXFSZ, previous_handler);
+    // The shutdown sync succeeds, but the snapshot still ends at the failure
+    assert(dts::load_chain_state(state_path, saved) && saved.sequence == 1);
+    std::filesystem::remove(path);
+    std::filesystem::remove(state_path);
+#endif
+
+    std::cout << "✓ Async write failure test passed\n";
+}
+
+void test_concurrent_chain_sink() {
+    const std::string path = temp_path("concurrent_sink.log");
+    {
+        dts::ConcurrentAuditChain::Options options;
+        options.sink = std::make_shared<dts::AsyncFileSink>(path);
+        dts::ConcurrentAuditChain logger("TEST-DEVICE-203", nullptr, options);
+        for (int i = 0; i < 200; ++i) logger.log("Queued " + std::to_string(i));
+        logger.flush();
+    }
+    auto lines = read_lines(path);
+    assert(lines.size() == 200);
+    assert(dts::AuditChain::verify_chain(lines));
+    std::filesystem::remove(path);
+    
+    std::cout << "✓ Concurrent chain sink test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS sink tests...\n\n";
+    
+    test_file_sink();
+    test_async_group_commit();
+    test_async_write_failure();
+    test_concurrent_chain_sink();
+    
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
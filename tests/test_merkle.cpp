@@ -0,0 +1,168 @@
+/**
+ * @file test_merkle.cpp
+ * @brief Unit tests for Merkle checkpoints and inclusion proofs
+ */
+
+#include <dts/inclusion_proof.hpp>
+#include <dts/chain_verifier.hpp>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static dts::SHA256::Hash value(uint32_t i) {
+    return dts::SHA256::hash("leaf " + std::to_string(i));
+}
+
+void test_tree_and_accumulator() {
+    // RFC 6962 shapes for every size up to 40 leaves
+    for (uint32_t size = 1; size <= 40; ++size) {
+        dts::merkle::Tree tree;
+        dts::merkle::Accumulator accumulator;
+        for (uint32_t i = 0; i < size; ++i) {
+            tree.append(value(i));
+            accumulator.append(value(i));
+        }
+        assert(tree.root() == accumulator.root());
+        for (uint32_t i = 0; i < size; ++i) {
+            auto path = tree.inclusion_proof(i);
+            assert(path.size() <= 6);
+            assert(dts::merkle::verify_inclusion(value(i), i, size, path, tree.root()));
+            assert(!dts::merkle::verify_inclusion(value(i + 1), i, size, path, tree.root()));
+            if (size > 1) {
+                assert(!dts::merkle::verify_inclusion(value(i), (i + 1) % size, size, path,
+                                                      tree.root()));
+            }
+        }
+    }
+
+    // Two leaves: root = node(leaf(a), leaf(b))
+    dts::merkle::Tree pair({value(0), value(1)});
+    assert(pair.root() == dts::merkle::node_hash(dts::merkle::leaf_hash(value(0)),
+                                                 dts::merkle::leaf_hash(value(1))));
+
+    std::cout << "✓ Merkle tree test passed\n";
+}
+
+void test_checkpoint_entries() {
+    dts::AuditChain logger("TEST-DEVICE-501");
+    logger.set_checkpoint_interval(16);
+
+    std::vector<std::string> entries;
+    std::string checkpoint;
+    for (int i = 0; i < 100; ++i) {
+        entries.push_back(logger.log("Event " + std::to_string(i)));
+        if (logger.take_checkpoint(checkpoint)) entries.push_back(checkpoint);
+    }
+    assert(logger.checkpoint_count() == 6);
+    assert(entries.size() == 106);
+    assert(logger.get_sequence_number() == 106);
+    assert(!logger.take_checkpoint(checkpoint));
+
+    // Checkpoints are chained like any other entry
+    assert(dts::AuditChain::verify_chain(entries, true));
+
+    dts::EntryView view;
+    assert(dts::parse_entry(entries[16], view));
+    dts::Checkpoint parsed;
+    assert(dts::parse_checkpoint_message(view.message, parsed));
+    assert(parsed.index == 0 && parsed.first_sequence == 1 && parsed.count == 16);
+    assert(logger.last_checkpoint().index == 5);
+    assert(logger.last_checkpoint().first_sequence == 86);
+
+    std::cout << "✓ Checkpoint entry test passed\n";
+}
+
+void test_inclusion_proofs() {
+    dts::AuditChain logger("TEST-DEVICE-502");
+    logger.set_checkpoint_interval(32);
+
+    std::string log;
+    std::vector<std::string> entries;
+    std::string checkpoint;
+    for (int i = 0; i < 1000; ++i) {
+        entries.push_back(logger.log("Dose event " + std::to_string(i)));
+        log += entries.back() + "\n";
+        if (logger.take_checkpoint(checkpoint)) {
+            entries.push_back(checkpoint);
+            log += checkpoint + "\n";
+        }
+    }
+    const dts::SHA256::Hash trusted = logger.last_checkpoint().roots_root;
+
+    for (uint64_t sequence : {1u, 2u, 32u, 34u, 500u, 989u}) {
+        dts::InclusionProof proof;
+        assert(dts::build_inclusion_proof(log, sequence, proof));
+        assert(proof.leaf_path.size() <= 5 && proof.checkpoint_path.size() <= 5);
+        assert(dts::verify_entry_inclusion(entries[sequence - 1], proof, trusted));
+
+        // Wrong entry, edited entry, or untrusted root all fail
+        assert(!dts::verify_entry_inclusion(entries[sequence], proof, trusted));
+        std::string edited = entries[sequence - 1];
+        edited.replace(edited.find("Dose"), 4, "Dosf");
+        assert(!dts::verify_entry_inclusion(edited, proof, trusted));
+        assert(!dts::verify_inclusion_proof(proof, dts::SHA256::hash("other")));
+    }
+
+    dts::InclusionProof proof;
+    assert(!dts::build_inclusion_proof(log, 33, proof));              // a checkpoint entry
+    assert(!dts::build_inclusion_proof(log, entries.size(), proof));  // after the last checkpoint
+
+    std::cout << "✓ Inclusion proof test passed\n";
+}
+
+void test_reserved_messages() {
+    dts::AuditChain logger("TEST-DEVICE-503");
+    logger.set_checkpoint_interval(4);
+
+    std::string log, entry, checkpoint;
+    for (int i = 0; i < 4; ++i) {
+        log += logger.log("Event " + std::to_string(i)) + "\n";
+        assert(logger.take_checkpoint(checkpoint) == (i == 3));
+    }
+    log += checkpoint + "\n";
+    dts::EntryView view;
+    assert(dts::parse_entry(checkpoint, view));
+    const std::string forged(view.message);
+
+    // A System message that reads as a checkpoint is refused on every path
+    const uint64_t sequence = logger.get_sequence_number();
+    assert(dts::AuditChain::is_reserved(forged, dts::UserID::System));
+    assert(logger.log(forged).empty());
+    entry = "stale";
+    assert(logger.log(entry, forged) == 0 && entry.empty());
+    assert(logger.log_at(entry, 1700000000000, forged) == 0);
+    char buffer[512];
+    assert(logger.log(buffer, sizeof(buffer), forged) == 0);
+    std::vector<dts::LogEvent> events = {{"Before"}, {forged}, {"After"}};
+    assert(logger.log_batch(entry, events) == 0 && entry.empty());
+    assert(logger.get_sequence_number() == sequence);
+
+    // Other users may quote one; it is counted as an ordinary entry
+    assert(!dts::AuditChain::is_reserved(forged, dts::UserID::Operator));
+    log += logger.log(forged, dts::UserID::Operator) + "\n";
+    for (int i = 0; i < 3; ++i) {
+        log += logger.log("Event " + std::to_string(i + 4)) + "\n";
+        assert(logger.take_checkpoint(checkpoint) == (i == 2));
+    }
+    log += checkpoint + "\n";
+    assert(logger.checkpoint_count() == 2);
+
+    dts::InclusionProof proof;
+    assert(dts::build_inclusion_proof(log, 6, proof));
+    assert(dts::verify_inclusion_proof(proof, logger.last_checkpoint().roots_root));
+
+    std::cout << "✓ Reserved message test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS Merkle checkpoint tests...\n\n";
+
+    test_tree_and_accumulator();
+    test_checkpoint_entries();
+    test_inclusion_proofs();
+    test_reserved_messages();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Unit tests for hot-path metrics and their exporters
+ *
+ * Built with DTS_ENABLE_METRICS=1 regardless of the CMake option.
+ */
+
+#include <dts/chain_verifier.hpp>
+#include <dts/concurrent_audit_chain.hpp>
+#include <dts/log_sink.hpp>
+#include <dts/metrics.hpp>
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static_assert(DTS_ENABLE_METRICS, "this test needs the instrumentation compiled in");
+
+using dts::metrics::Counter;
+using dts::metrics::Timer;
+
+void test_histogram_buckets() {
+    using dts::metrics::Buckets;
+    // Buckets tile the value range without gaps, with bounded relative width
+    assert(Buckets::index(0) == 0 && Buckets::index(7) == 7 && Buckets::index(8) == 8);
+    for (size_t i = 0; i + 1 < Buckets::count; ++i) {
+        assert(Buckets::upper(i) + 1 == Buckets::lower(i + 1));
+        assert(Buckets::index(Buckets::lower(i)) == i);
+        assert(Buckets::index(Buckets::upper(i)) == i);
+        if (i >= Buckets::sub_count) {
+            assert(Buckets::upper(i) - Buckets::lower(i) < Buckets::lower(i) / 8 + 1);
+        }
+    }
+    assert(Buckets::index(~uint64_t{0}) == Buckets::count - 1);
+
+    dts::metrics::HistogramSnapshot histogram;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        ++histogram.buckets[Buckets::index(v)];
+        ++histogram.count;
+        histogram.sum_ns += v;
+        histogram.max_ns = v;
+    }
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        const double exact = q * 100000;
+        const double reported = static_cast<double>(histogram.percentile_ns(q));
+        assert(reported >= exact && reported <= exact * 1.125 + 1);
+    }
+    assert(histogram.percentile_ns(1.0) == 100000);
+    assert(histogram.mean_ns() == 50000);
+    assert(dts::metrics::HistogramSnapshot().percentile_ns(0.5) == 0);
+
+    std::cout << "✓ Histogram bucket test passed\n";
+}
+
+void test_logging_counters() {
+    const auto path = (std::filesystem::temp_directory_path() / "dts_metrics.log").string();
+    std::filesystem::remove(path);
+
+    const auto before = dts::metrics::snapshot();
+    std::vector<std::string> entries;
+    size_t bytes = 0;
+    {
+        dts::AuditChain chain("TEST-DEVICE-801");
+        auto sink = std::make_shared<dts::FileSink>(path);
+        chain.set_sink(sink);
+        for (int i = 0; i < 500; ++i) {
+            entries.push_back(chain.log("Event \"" + std::to_string(i) + "\""));
+            bytes += entries.back().size();
+        }
+        sink->flush();
+    }
+    const auto delta = dts::metrics::snapshot().since(before);
+
+    assert(delta.counter(Counter::EntriesLogged) == 500);
+    assert(delta.counter(Counter::BytesLogged) == bytes);
+    assert(delta.counter(Counter::SinkWrites) == 500);
+    assert(delta.counter(Counter::SinkBytes) == bytes + 500);     // plus newlines
+    assert(delta.counter(Counter::SinkBytes) == std::filesystem::file_size(path));
+    assert(delta.counter(Counter::SinkSyncs) >= 1);
+    assert(delta.timer(Timer::Log).count == 500);
+    assert(delta.timer(Timer::SinkWrite).count == 500);
+    assert(delta.timer(Timer::SinkSync).count == delta.counter(Counter::SinkSyncs));
+    assert(delta.timer(Timer::Log).percentile_ns(0.5) > 0);
+    assert(delta.timer(Timer::Log).percentile_ns(0.99) <= delta.timer(Timer::Log).max_ns);
+
+    // Every verification entry point feeds the same counters
+    const auto verify_before = dts::metrics::snapshot();
+    assert(dts::AuditChain::verify_chain(entries, true));
+    assert(dts::verify_file(path).ok());
+    entries[10][entries[10].find("Event")] = 'X';
+    assert(!dts::AuditChain::verify_chain(entries, true));
+    const auto verified = dts::metrics::snapshot().since(verify_before);
+    assert(verified.counter(Counter::EntriesVerified) == 1000);
+    assert(verified.counter(Counter::VerifyFailures) == 1);
+    assert(verified.timer(Timer::Verify).count == 3);
+
+    std::filesystem::remove(path);
+    std::cout << "✓ Logging counters test passed\n";
+}
+
+void test_threads_and_gauges() {
+    const auto before = dts::metrics::snapshot();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            dts::AuditChain chain("TEST-DEVICE-81" + std::to_string(t));
+            for (int i = 0; i < 250; ++i) chain.log("Reading " + std::to_string(i));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    // Counts of exited threads are kept
+    auto delta = dts::metrics::snapshot().since(before);
+    assert(delta.counter(Counter::EntriesLogged) == 1000);
+    assert(delta.timer(Timer::Log).count == 1000);
+
+    {
+        dts::ConcurrentAuditChain chain("TEST-DEVICE-820");
+        for (int i = 0; i < 100; ++i) chain.log("Queued");
+        chain.flush();
+        const auto snapshot = dts::metrics::snapshot();
+        assert(snapshot.gauges.size() == 1);
+        assert(snapshot.gauges[0].name == "queue_depth");
+        assert(snapshot.gauges[0].device == "TEST-DEVICE-820");
+        assert(snapshot.gauges[0].value == 0.0);
+    }
+    assert(dts::metrics::snapshot().gauges.empty());
+
+    std::cout << "✓ Threads and gauges test passed\n";
+}
+
+void test_exporters() {
+    dts::metrics::Snapshot previous;
+    dts::metrics::Snapshot current;
+    current.counters[static_cast<size_t>(Counter::EntriesLogged)] = 1200;
+    previous.counters[static_cast<size_t>(Counter::EntriesLogged)] = 200;
+    auto& log = current.timers[static_cast<size_t>(Timer::Log)];
+    for (uint64_t ns : {1000, 2000, 3000, 4000}) {
+        ++log.buckets[dts::metrics::Buckets::index(ns)];
+        ++log.count;
+        log.sum_ns += ns;
+        log.max_ns = ns;
+    }
+    current.gauges.push_back({"queue_depth", "PLC-\"7\"", 12});
+
+    std::string text;
+    dts::metrics::write_prometheus(current, text);
+    assert(text.find("# TYPE dts_entries_logged_total counter\ndts_entries_logged_total 1200\n") !=
+           std::string::npos);
+    assert(text.find("# TYPE dts_log_latency_seconds summary\n") != std::string::npos);
+    assert(text.find("dts_log_latency_seconds{quantile=\"0.5\"} 2.047e-06\n") != std::string::npos);
+    assert(text.find("dts_log_latency_seconds{quantile=\"0.999\"} 4e-06\n") != std::string::npos);
+    assert(text.find("dts_log_latency_seconds_sum 1e-05\n") != std::string::npos);
+    assert(text.find("dts_log_latency_seconds_count 4\n") != std::string::npos);
+    assert(text.find("dts_queue_depth{device=\"PLC-\\\"7\\\"\"} 12\n") != std::string::npos);
+
+    std::string lines;
+    dts::metrics::write_statsd(current, previous, lines, "plant");
+    assert(lines.find("plant.entries_logged:1000|c\n") != std::string::npos);
+    assert(lines.find("plant.sink_writes:0|c\n") != std::string::npos);
+    assert(lines.find("plant.log_latency_us.p50:2.047|g\n") != std::string::npos);
+    assert(lines.find("plant.log_latency_us.p999:4|g\n") != std::string::npos);
+    assert(lines.find("plant.verify_latency_us") == std::string::npos);  // idle interval
+    assert(lines.find("plant.queue_depth.PLC-\"7\":12|g\n") != std::string::npos);
+
+    std::cout << "✓ Exporters test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS metrics tests...\n\n";
+
+    test_histogram_buckets();
+    test_logging_counters();
+    test_threads_and_gauges();
+    test_exporters();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
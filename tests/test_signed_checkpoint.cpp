@@ -0,0 +1,360 @@
+/**
+ * @file test_signed_checkpoint.cpp
+ * @brief Unit tests for Ed25519 and signed checkpoint entries
+ */
+
+#include <dts/chain_recovery.hpp>
+#include <dts/log_sink.hpp>
+#include <dts/signed_checkpoint.hpp>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+template <size_t N>
+static std::array<uint8_t, N> from_hex(const char* hex) {
+    std::array<uint8_t, N> bytes{};
+    bool ok = dts::detail::hex_decode(hex, N, bytes.data());
+    assert(ok);
+    (void)ok;
+    return bytes;
+}
+
+static dts::ClockSource test_clock() {
+    return dts::clocks::stepping(
+        std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000000)),
+        std::chrono::milliseconds(10));
+}
+
+static dts::ed25519::Seed test_seed(uint8_t fill) {
+    dts::ed25519::Seed seed;
+    seed.fill(fill);
+    return seed;
+}
+
+/// 1-based line @p number of @p text, without its newline
+static std::string_view line_at(std::string_view text, uint64_t number) {
+    size_t start = 0;
+    while (--number > 0) start = text.find('\n', start) + 1;
+    return text.substr(start, text.find('\n', start) - start);
+}
+
+/// Appends every entry it receives, one per line
+class StringSink : public dts::LogSink {
+public:
+    void write(std::string_view entry, const dts::EntryInfo&) override {
+        log.append(entry.data(), entry.size()).push_back('\n');
+    }
+
+    std::string log;
+};
+
+void test_ed25519_vectors() {
+    // SHA-512("abc") from FIPS 180-2
+    const auto abc = dts::SHA512::hash("abc");
+    assert(abc == from_hex<64>("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                               "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"));
+
+    // RFC 8032, section 7.1, tests 1 to 3
+    struct Vector {
+        const char* seed;
+        const char* public_key;
+        const char* message;
+        const char* signature;
+    };
+    const Vector vectors[] = {
+        {"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+         "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "",
+         "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+         "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"},
+        {"4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+         "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72",
+         "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+         "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"},
+        {"c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+         "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025", "af82",
+         "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+         "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"},
+    };
+    for (const Vector& vector : vectors) {
+        const dts::ed25519::SigningKey key(from_hex<32>(vector.seed));
+        assert(key.public_key() == from_hex<32>(vector.public_key));
+        std::string message(std::strlen(vector.message) / 2, '\0');
+        dts::detail::hex_decode(vector.message, message.size(),
+                                reinterpret_cast<uint8_t*>(&message[0]));
+        const auto signature = key.sign(message);
+        assert(signature == from_hex<64>(vector.signature));
+        assert(dts::ed25519::verify(key.public_key(), message, signature));
+
+        auto forged = signature;
+        forged[0] ^= 1;
+        assert(!dts::ed25519::verify(key.public_key(), message, forged));
+        assert(!dts::ed25519::verify(key.public_key(), message + "x", signature));
+    }
+
+    // S must be reduced: S + L is the same scalar but not accepted
+    const dts::ed25519::SigningKey key(test_seed(7));
+    auto signature = key.sign("reduced");
+    int carry = 0;
+    for (int i = 0; i < 32; ++i) {
+        const int sum = signature[32 + i] +
+                        static_cast<int>(dts::ed25519::detail::group_order[i]) + carry;
+        signature[32 + i] = static_cast<uint8_t>(sum);
+        carry = sum >> 8;
+    }
+    assert(!dts::ed25519::verify(key.public_key(), "reduced", signature));
+
+    std::cout << "✓ Ed25519 vectors test passed\n";
+}
+
+void test_batch_verification() {
+    const dts::ed25519::SigningKey keys[] = {dts::ed25519::SigningKey(test_seed(1)),
+                                             dts::ed25519::SigningKey(test_seed(2)),
+                                             dts::ed25519::SigningKey(test_seed(3))};
+    std::vector<std::string> messages;
+    for (int i = 0; i < 100; ++i) messages.push_back("checkpoint " + std::to_string(i));
+    std::vector<dts::ed25519::SignedMessage> items;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        const auto& key = keys[i % 3];
+        items.push_back({key.public_key(), key.sign(messages[i]), messages[i]});
+    }
+    assert(dts::ed25519::verify_batch(items) == items.size());
+    assert(dts::ed25519::verify_batch(items.data(), 1) == 1);
+    assert(dts::ed25519::verify_batch(items.data(), 0) == 0);
+
+    // The first bad signature is located, whatever is wrong with it
+    items[61].signature[40] ^= 1;
+    items[80].signature[2] ^= 1;
+    assert(dts::ed25519::verify_batch(items) == 61);
+    items[61].signature[40] ^= 1;
+    assert(dts::ed25519::verify_batch(items) == 80);
+    items[80].signature[2] ^= 1;
+    items[17].message = messages[18];
+    assert(dts::ed25519::verify_batch(items) == 17);
+    items[17].message = messages[17];
+    items[33].public_key = keys[1].public_key();
+    assert(dts::ed25519::verify_batch(items) == 33);
+    items[33].public_key = keys[0].public_key();
+    assert(dts::ed25519::verify_batch(items) == items.size());
+
+    std::cout << "✓ Batch verification test passed\n";
+}
+
+void test_message_format() {
+    const dts::ed25519::SigningKey key(test_seed(9));
+    const auto hash = dts::SHA256::hash("entry 42");
+    const dts::SignedCheckpoint checkpoint = dts::sign_checkpoint(key, "PUMP-SIG", 42, hash);
+
+    char text[dts::detail::signed_checkpoint_message_capacity];
+    const std::string message(text, dts::detail::format_signed_checkpoint_message(checkpoint, text));
+    assert(message.rfind("Signed Checkpoint | seq=42 | hash=", 0) == 0);
+
+    dts::SignedCheckpoint parsed;
+    assert(dts::parse_signed_checkpoint_message(message, parsed));
+    assert(parsed.sequence == 42 && parsed.chain_hash == hash);
+    assert(parsed.key_id == checkpoint.key_id && parsed.signature == checkpoint.signature);
+
+    std::string payload;
+    dts::detail::signed_checkpoint_payload("PUMP-SIG", 42, hash, payload);
+    assert(dts::ed25519::verify(key.public_key(), payload, parsed.signature));
+
+    assert(!dts::parse_signed_checkpoint_message(message.substr(0, message.size() - 1), parsed));
+    assert(!dts::parse_signed_checkpoint_message(message + " ", parsed));
+    dts::Checkpoint merkle;
+    assert(!dts::parse_checkpoint_message(message, merkle));
+
+    std::cout << "✓ Message format test passed\n";
+}
+
+void test_chain_signing() {
+    auto signer = std::make_shared<dts::Ed25519CheckpointSigner>(test_seed(5), false);
+    auto sink = std::make_shared<StringSink>();
+    dts::AuditChain chain("PUMP-SIG-1", test_clock());
+    chain.set_sink(sink);
+    chain.set_checkpoint_interval(64);
+    chain.set_checkpoint_signer(signer, 100);
+
+    for (int i = 0; i < 1000; ++i) {
+        chain.log("Dose " + std::to_string(i), dts::UserID::Operator);
+    }
+    // A signature every 100 entries, logged right after the one that requested it
+    assert(signer->signed_count() >= 9);
+    const std::string& log = sink->log;
+    auto result = dts::verify_signed_checkpoints(log, signer->public_key());
+    assert(result.ok() && result.entries == chain.get_sequence_number());
+    assert(result.signatures == signer->signed_count());
+    assert(result.signed_sequence > chain.get_sequence_number() - 120);
+
+    // Signed entries count as ordinary entries in Merkle windows
+    const std::string path = (std::filesystem::temp_directory_path() / "dts_signed.log").string();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << log;
+    }
+    dts::ChainState recovered;
+    assert(dts::recover_chain_state("PUMP-SIG-1", path + ".none", path, recovered).ok());
+    const dts::ChainState state = chain.state();
+    assert(recovered.sequence == state.sequence && recovered.window_first == state.window_first);
+    assert(recovered.window.root() == state.window.root());
+    assert(recovered.checkpoints.root() == state.checkpoints.root());
+    std::filesystem::remove(path);
+
+    // Another key
+    const dts::ed25519::SigningKey other(test_seed(6));
+    result = dts::verify_signed_checkpoints(log, other.public_key());
+    assert(result.status == dts::VerifyStatus::BadSignature);
+
+    // A log rewritten from scratch with recomputed hashes: the chain is
+    // valid, but the signed hashes stop matching at the edit
+    std::string rewritten;
+    uint64_t edited = 0;
+    {
+        dts::AuditChain forger("PUMP-SIG-1");
+        size_t pos = 0;
+        std::string line, message, entry;
+        while (pos < log.size()) {
+            const size_t end = log.find('\n', pos);
+            line = log.substr(pos, end - pos);
+            dts::EntryView view;
+            int64_t timestamp_ms = 0;
+            assert(dts::parse_entry(line, view));
+            assert(dts::detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                                   timestamp_ms));
+            message.clear();
+            dts::unescape_json(view.message, message);
+            if (message == "Dose 500") {
+                message = "Dose 5000";
+                edited = forger.get_sequence_number() + 1;
+            }
+            forger.replay_at(entry, timestamp_ms, message, static_cast<dts::UserID>(view.user_id));
+            rewritten += entry + "\n";
+            pos = end + 1;
+        }
+    }
+    assert(dts::verify_buffer(rewritten).ok());
+    result = dts::verify_signed_checkpoints(rewritten, signer->public_key());
+    assert(result.status == dts::VerifyStatus::HashMismatch && result.failed_entry > edited);
+    assert(rewritten.compare(result.failed_offset, 1, "{") == 0);
+    dts::EntryView failed;
+    dts::SignedCheckpoint claim;
+    std::string message;
+    assert(dts::parse_entry(line_at(rewritten, result.failed_entry), failed));
+    assert(dts::unescape_json(failed.message, message));
+    assert(dts::parse_signed_checkpoint_message(message, claim) && claim.sequence >= edited);
+    assert(result.signatures > 0 && result.signatures < signer->signed_count());
+
+    // A signature edited in place: links do not cover the message, the signature does
+    std::string forged = log;
+    const size_t sig = forged.find("sig=", forged.find("Signed Checkpoint | seq=3"));
+    forged[sig + 4] = forged[sig + 4] == '0' ? '1' : '0';
+    result = dts::verify_signed_checkpoints(forged, signer->public_key());
+    assert(result.status == dts::VerifyStatus::BadSignature);
+    assert(result.failed_offset == forged.rfind('\n', sig) + 1);
+
+    std::cout << "✓ Chain signing test passed\n";
+}
+
+void test_blank_lines_and_lookalikes() {
+    auto signer = std::make_shared<dts::Ed25519CheckpointSigner>(test_seed(8), false);
+    auto sink = std::make_shared<StringSink>();
+    dts::AuditChain chain("PUMP-SIG-3", test_clock());
+    chain.set_sink(sink);
+    chain.set_checkpoint_signer(signer, 50);
+    for (int i = 0; i < 1200; ++i) {
+        chain.log("Dose " + std::to_string(i), dts::UserID::Operator);
+        if (i == 300) {
+            // Messages that only look like signed checkpoints are ordinary entries
+            chain.log("Signed Checkpoint | requested from the service menu");
+            const std::string claim = sink->log.substr(sink->log.find("Signed Checkpoint | seq="));
+            chain.log(claim.substr(0, claim.find('"')), dts::UserID::Operator);
+        }
+    }
+    std::string log = sink->log;
+    auto result = dts::verify_signed_checkpoints(log, signer->public_key());
+    assert(result.ok() && result.signatures == signer->signed_count());
+
+    // Blank lines are not entries, so they do not shift the signed sequences
+    for (uint64_t line : {900, 400, 120, 2}) {
+        size_t pos = 0;
+        for (uint64_t n = 1; n < line; ++n) pos = log.find('\n', pos) + 1;
+        log.insert(pos, line % 2 ? "\r\n" : "\n\n");
+    }
+    result = dts::verify_signed_checkpoints(log, signer->public_key());
+    assert(result.ok() && result.entries == chain.get_sequence_number());
+    assert(result.signatures == signer->signed_count());
+
+    // The same across segments, with lookups that start in earlier segments
+    dts::SignatureOptions options;
+    options.verify.threads = 5;
+    options.verify.min_segment_bytes = 1;
+    options.batch_size = 4;
+    result = dts::verify_signed_checkpoints(log, signer->public_key(), options);
+    assert(result.ok() && result.signatures == signer->signed_count());
+    assert(result.signed_sequence > chain.get_sequence_number() - 60);
+
+    std::cout << "✓ Blank lines and lookalike messages test passed\n";
+}
+
+void test_background_signer_and_batches() {
+    auto signer = std::make_shared<dts::Ed25519CheckpointSigner>(test_seed(11));
+    auto sink = std::make_shared<StringSink>();
+    dts::AuditChain chain("PUMP-SIG-2", test_clock());
+    chain.set_sink(sink);
+    chain.set_checkpoint_signer(signer, 50);
+
+    dts::EventBatch batch;
+    std::string out;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 30; ++i) chain.log("Reading " + std::to_string(round * 30 + i));
+        batch.clear();
+        for (int i = 0; i < 30; ++i) batch.add("Batched " + std::to_string(i));
+        chain.log_batch(out, batch);
+        signer->flush();
+    }
+    // Nothing left unsigned but the last checkpoint itself
+    assert(chain.log_signed_checkpoint(out) == out.size() && !out.empty());
+    const uint64_t head = chain.get_sequence_number();
+
+    dts::SignatureOptions options;
+    options.batch_size = 8;
+    options.verify.threads = 2;
+    auto result = dts::verify_signed_checkpoints(sink->log, signer->public_key(), options);
+    assert(result.ok() && result.entries == head);
+    assert(result.signatures >= 10 && result.signed_sequence == head - 1);
+
+    // A tail starting mid-chain: checkpoints over earlier entries are skipped
+    const std::string& log = sink->log;
+    size_t cut = 0;
+    for (int i = 0; i < 400; ++i) cut = log.find('\n', cut) + 1;
+    dts::EntryView view;
+    assert(dts::parse_entry(line_at(log, 400), view));
+    dts::SignatureOptions tail = options;
+    tail.first_sequence = 400;
+    dts::detail::hex_decode(view.chain_hash.data(), 32, tail.verify.initial_hash.data());
+    const auto tail_result = dts::verify_signed_checkpoints(log.substr(cut), signer->public_key(),
+                                                            tail);
+    assert(tail_result.ok() && tail_result.entries == head - 400);
+    assert(tail_result.signatures > 0 && tail_result.signatures < result.signatures);
+    assert(tail_result.signed_sequence == head - 1);
+
+    std::cout << "✓ Background signer and batches test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS signed checkpoint tests...\n\n";
+
+    test_ed25519_vectors();
+    test_batch_verification();
+    test_message_format();
+    test_chain_signing();
+    test_blank_lines_and_lookalikes();
+    test_background_signer_and_batches();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
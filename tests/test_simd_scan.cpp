@@ -0,0 +1,118 @@
+/**
+ * @file test_simd_scan.cpp
+ * @brief Unit tests for the vectorized JSON scans and the parsing built on them
+ */
+
+#include <dts/audit_chain.hpp>
+#include <dts/binary_record.hpp>
+#include <dts/entry_parser.hpp>
+#include <dts/simd_scan.hpp>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char* reference_quote_or_backslash(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        if (*p == '"' || *p == '\\') return p;
+    }
+    return end;
+}
+
+static const char* reference_json_escape(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\' || c < 0x20) return p;
+    }
+    return end;
+}
+
+void test_scans_match_reference() {
+    std::mt19937 rng(25);
+    // Mostly plain text, with high bytes that a signed compare would misread
+    const std::string alphabet = "abcdefghijklmnopqrstuvwxyz0123456789 .:-|\x7f\x80\xc3\xa9\xff";
+    for (int round = 0; round < 2000; ++round) {
+        std::string text(rng() % 80, 'x');
+        for (char& c : text) c = alphabet[rng() % alphabet.size()];
+        // Zero or one special byte at a random position
+        const int special = static_cast<int>(rng() % 6);
+        if (!text.empty() && special < 5) {
+            static const char specials[] = {'"', '\\', '\n', '\x01', '\x1f'};
+            text[rng() % text.size()] = specials[special];
+        }
+        for (size_t start = 0; start <= std::min<size_t>(text.size(), 17); ++start) {
+            const char* begin = text.data() + start;
+            const char* end = text.data() + text.size();
+            assert(dts::detail::find_quote_or_backslash(begin, end) ==
+                   reference_quote_or_backslash(begin, end));
+            assert(dts::detail::find_json_escape(begin, end) == reference_json_escape(begin, end));
+        }
+    }
+    const char empty[] = "";
+    assert(dts::detail::find_json_escape(empty, empty) == empty);
+    std::cout << "✓ Scans match reference test passed\n";
+}
+
+void test_escaping() {
+    // Escapes on and around 16-byte boundaries
+    for (size_t at = 0; at < 40; ++at) {
+        for (const char special : {'"', '\\', '\n', '\x02', '\t'}) {
+            std::string message(40, 'm');
+            message[at] = special;
+            const size_t expected = special == '\x02' ? 45 : 41;
+            assert(dts::detail::json_escaped_length(message.data(), message.size()) == expected);
+            std::string escaped(expected, '\0');
+            assert(dts::detail::escape_json(message.data(), message.size(), &escaped[0]) == expected);
+            std::string decoded;
+            assert(dts::unescape_json(escaped, decoded) && decoded == message);
+        }
+    }
+    assert(dts::detail::json_escaped_length("", 0) == 0);
+    std::cout << "✓ Escaping test passed\n";
+}
+
+void test_entries_round_trip() {
+    dts::AuditChain chain("SCAN-DEVICE");
+    std::vector<std::string> messages = {
+        "", "plain", std::string(100, 'a'), "quote \" inside a long enough message here",
+        "escaped backslash \\\" then more text after the escape", "tab\tand\nnewline\r",
+        "\x01 control", std::string(15, 'b') + "\\", std::string(16, 'c') + "\"",
+        "unicode \xc3\xa9\xe2\x82\xac"};
+    std::vector<std::string> entries;
+    for (const auto& message : messages) entries.push_back(chain.log(message));
+    assert(dts::AuditChain::verify_chain(entries, true));
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        dts::EntryView view;
+        assert(dts::parse_entry(entries[i], view));
+        std::string message;
+        assert(dts::unescape_json(view.message, message) && message == messages[i]);
+        assert(view.device_id == "SCAN-DEVICE");
+    }
+
+    // An unterminated string or a trailing backslash does not parse
+    std::string broken = entries[1];
+    broken.resize(broken.find("plain") + 3);
+    dts::EntryView view;
+    assert(!dts::parse_entry(broken, view));
+    assert(!dts::parse_entry("{\"device_id\":\"abc\\", view));
+
+    // Binary conversion keeps escaped messages intact
+    std::string json_lines, binary, back;
+    for (const auto& entry : entries) json_lines += entry + "\n";
+    assert(dts::json_to_binary(json_lines, binary));
+    assert(dts::binary_to_json(binary, back) && back == json_lines);
+    std::cout << "✓ Entries round trip test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS SIMD scan tests...\n\n";
+
+    test_scans_match_reference();
+    test_escaping();
+    test_entries_round_trip();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
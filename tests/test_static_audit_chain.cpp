@@ -0,0 +1,180 @@
+/**
+ * @file test_static_audit_chain.cpp
+ * @brief Unit tests for the fixed-capacity (no-heap) build profile
+ */
+
+// The static profile first, alone: it must not pull in heap-based headers
+#include <dts/static_audit_chain.hpp>
+#include <dts/adapters/static_medtech_adapter.hpp>
+
+#if defined(__GLIBCXX__) && (defined(_GLIBCXX_STRING) || defined(_GLIBCXX_VECTOR) ||          \
+                             defined(_GLIBCXX_SSTREAM) || defined(_GLIBCXX_IOMANIP) ||         \
+                             defined(_GLIBCXX_FUNCTIONAL) || defined(_GLIBCXX_MEMORY) ||       \
+                             defined(_GLIBCXX_CHRONO))
+#error "the static profile includes a heap-based standard header"
+#endif
+
+#include <dts/adapters/medtech_adapter.hpp>
+#include <dts/audit_chain.hpp>
+#include <dts/chain_verifier.hpp>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+// Count heap allocations so the static paths can be checked
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static int64_t g_now_ms = 1700000000123;
+
+static int64_t board_clock() { return g_now_ms; }
+
+static const auto fixed_time =
+    std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000123));
+
+/// Drain the ring into a JSON-lines log
+template <typename Chain>
+static void drain(Chain& chain, std::string& log) {
+    for (std::string_view entry = chain.front(); !entry.empty(); entry = chain.front()) {
+        log.append(entry.data(), entry.size()).push_back('\n');
+        chain.pop();
+    }
+}
+
+void test_matches_audit_chain() {
+    dts::StaticAuditChain<512, 4> fixed("PUMP-STATIC-1", board_clock);
+    dts::AuditChain reference("PUMP-STATIC-1", dts::clocks::fixed(fixed_time));
+    assert(fixed.valid());
+
+    const char* messages[] = {"Boot complete", "Dose \"bolus\"\tconfirmed", "", "\x01 raw"};
+    std::string log, drained;
+    for (int round = 0; round < 3; ++round) {
+        for (const char* message : messages) {
+            const size_t length = fixed.log(message, dts::UserID::Operator, dts::Severity::Warning);
+            const std::string expected =
+                reference.log(message, dts::UserID::Operator, dts::Severity::Warning);
+            assert(length == expected.size());
+            log += expected + "\n";
+        }
+        drain(fixed, drained);
+    }
+    assert(drained == log);
+    assert(fixed.get_sequence_number() == 12 && fixed.pending() == 0);
+    assert(fixed.chain_hash_hex() == reference.get_chain_hash());
+    assert(dts::verify_buffer(log, dts::VerifyOptions()).ok());
+
+    // Resume after a reboot from the persisted sequence and hash
+    dts::StaticAuditChain<512, 4> resumed("PUMP-STATIC-1", fixed.get_sequence_number(),
+                                          fixed.last_hash(), board_clock);
+    resumed.log("Resumed");
+    drain(resumed, log);
+    dts::VerifyOptions recompute;
+    recompute.recompute = true;
+    const auto result = dts::verify_buffer(log, recompute);
+    assert(result.ok() && result.entries == 13);
+    assert(resumed.get_sequence_number() == 13);
+
+    std::cout << "✓ Matches AuditChain test passed\n";
+}
+
+void test_ring_and_limits() {
+    dts::StaticAuditChain<300, 2> chain("PUMP-STATIC-2");
+    assert(chain.log_at(1700000000000, "one") > 0);
+    assert(chain.log_at(1700000000001, "two") > 0);
+    assert(chain.full());
+    // A full ring refuses the entry without advancing the chain
+    const std::string hash(chain.chain_hash_hex());
+    assert(chain.log_at(1700000000002, "three") == 0);
+    assert(chain.rejected() == 1 && chain.get_sequence_number() == 2);
+    assert(chain.chain_hash_hex() == hash);
+
+    assert(chain.front().find("\"message\":\"one\"") != std::string_view::npos);
+    chain.pop();
+    assert(chain.log_at(1700000000002, "three") > 0);
+    std::string log;
+    drain(chain, log);
+    assert(log.find("two") < log.find("three"));
+    chain.pop();    // popping an empty ring is harmless
+    assert(chain.front().empty() && chain.pending() == 0);
+
+    // An entry larger than a slot is refused
+    assert(chain.log_at(1700000000003, std::string(200, 'x')) == 0);
+    assert(chain.rejected() == 2 && chain.get_sequence_number() == 3);
+    const size_t fits = 300 - dts::detail::json_entry_length(13, 0, dts::UserID::System,
+                                                              dts::Severity::Info);
+    assert(chain.log_at(1700000000003, std::string(fits, 'x')) == 300);
+
+    // Device IDs longer than max_device_id_bytes make the chain invalid
+    dts::StaticAuditChain<300, 2> invalid(std::string(65, 'D'));
+    assert(!invalid.valid() && invalid.log("event") == 0);
+
+    // The compression bound covers the longest message that fits
+    static_assert(dts::StaticAuditChain<512, 1>::max_compressions(0) >= 2, "");
+    assert((dts::StaticAuditChain<512, 1>::max_compressions(fits) <= 8));
+
+    std::cout << "✓ Ring and limits test passed\n";
+}
+
+void test_medtech_adapter() {
+    dts::adapters::StaticMedTechAdapter<512, 16> fixed("PUMP-STATIC-3", board_clock);
+    dts::adapters::MedTechAdapter reference("PUMP-STATIC-3");
+    reference.get_chain().set_clock(dts::clocks::fixed(fixed_time));
+
+    const size_t before = g_allocations.load();
+    fixed.log_post_result(true);
+    fixed.log_post_result(false, "Motor stall");
+    fixed.log_medication_event(dts::adapters::MedicationEventType::Started, "Heparin",
+                               "100U/mL", "2.5 mL/hr", 30);
+    fixed.log_medication_event(dts::adapters::MedicationEventType::Error, "Insulin");
+    fixed.log_safety_alarm("OCCLUSION", dts::adapters::AlarmPriority::High,
+                           "Downstream occlusion", "Infusion stopped");
+    fixed.log_calibration("Pressure", "TECH-7", false);
+    fixed.log_firmware_update("2.1.0", "2.2.0", true);
+    fixed.log_maintenance("Battery", "TECH-7");
+    assert(g_allocations.load() == before);
+
+    reference.log_post_result(true);
+    reference.log_post_result(false, "Motor stall");
+    reference.log_medication_event(dts::adapters::MedicationEventType::Started, "Heparin",
+                                   "100U/mL", "2.5 mL/hr", 30);
+    reference.log_medication_event(dts::adapters::MedicationEventType::Error, "Insulin");
+    reference.log_safety_alarm("OCCLUSION", dts::adapters::AlarmPriority::High,
+                               "Downstream occlusion", "Infusion stopped");
+    reference.log_calibration("Pressure", "TECH-7", false);
+    reference.log_firmware_update("2.1.0", "2.2.0", true);
+    reference.log_maintenance("Battery", "TECH-7");
+
+    assert(fixed.get_chain().pending() == 8);
+    assert(fixed.get_chain().chain_hash_hex() == reference.get_chain_hash());
+
+    // A message that overflows its buffer is refused, not cut short
+    dts::adapters::StaticMedTechAdapter<512, 4, 32> small("PUMP-STATIC-4");
+    assert(small.log_maintenance("Battery replacement", "TECH-1234567890") == 0);
+    assert(small.rejected() == 1 && small.get_chain().get_sequence_number() == 0);
+    assert(small.log_post_result(true) > 0);
+
+    std::cout << "✓ MedTech adapter test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS static audit chain tests...\n\n";
+
+    test_matches_audit_chain();
+    test_ring_and_limits();
+    test_medtech_adapter();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
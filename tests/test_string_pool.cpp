@@ -0,0 +1,135 @@
+/**
+ * @file test_string_pool.cpp
+ * @brief Unit tests for string interning and pooled device IDs
+ */
+
+#include <dts/adapters/building_automation_adapter.hpp>
+#include <dts/adapters/clinical_trial_adapter.hpp>
+#include <dts/binary_record.hpp>
+#include <dts/chain_registry.hpp>
+#include <dts/string_pool.hpp>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CollectingSink : public dts::LogSink {
+public:
+    void write(std::string_view entry, const dts::EntryInfo& info) override {
+        entries.emplace_back(entry);
+        devices.emplace_back(info.device_id);
+    }
+
+    std::vector<std::string> entries;
+    std::vector<std::string> devices;
+};
+
+void test_interning() {
+    dts::StringPool pool(64);
+    const dts::PooledString& a = pool.intern("PLC-01");
+    std::string copy = "PLC-01";
+    assert(&pool.intern(copy) == &a);
+    assert(a.text == "PLC-01" && a.text.data() != copy.data());
+    // Nothing to escape: the JSON form shares the text bytes
+    assert(a.json.data() == a.text.data());
+
+    const dts::PooledString& quoted = pool.intern("Line \"A\"\\7\n");
+    assert(quoted.text == "Line \"A\"\\7\n");
+    assert(quoted.json == "Line \\\"A\\\"\\\\7\\n");
+    assert(pool.find("PLC-01") == &a);
+    assert(pool.find("PLC-02") == nullptr);
+    assert(pool.intern("").text.empty() && pool.size() == 3);
+
+    // Strings larger than a block get their own block; earlier views stay valid
+    const std::string big(200, 'x');
+    assert(pool.intern(big).text == big);
+    assert(a.text == "PLC-01");
+    assert(pool.bytes() >= 200 + 64);
+
+    // Concurrent interning of the same strings yields one copy each
+    std::vector<std::thread> threads;
+    std::vector<const dts::PooledString*> seen(4);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, &seen, t] {
+            for (int i = 0; i < 500; ++i) pool.intern("DEV-" + std::to_string(i));
+            seen[t] = &pool.intern("DEV-42");
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(pool.size() == 4 + 500);
+    for (auto* pooled : seen) assert(pooled == seen[0]);
+
+    assert(dts::intern("Shared-Zone").data() == dts::intern(std::string("Shared-Zone")).data());
+    std::cout << "✓ Interning test passed\n";
+}
+
+void test_escaped_device_id() {
+    const std::string device_id = "GW \"north\"\\1";
+    dts::AuditChain chain(device_id);
+    auto sink = std::make_shared<CollectingSink>();
+    chain.set_sink(sink);
+    std::vector<std::string> entries;
+    for (int i = 0; i < 5; ++i) entries.push_back(chain.log("Event " + std::to_string(i)));
+
+    // The JSON carries the escaped ID; the hash and sink see the raw one
+    assert(entries[0].find("{\"device_id\":\"GW \\\"north\\\"\\\\1\",") == 0);
+    assert(sink->devices[0] == device_id);
+    dts::EntryView view;
+    std::string parsed;
+    assert(dts::parse_entry(entries[0], view) && dts::unescape_json(view.device_id, parsed));
+    assert(parsed == device_id);
+    assert(chain.state().device_id == device_id);
+    assert(dts::AuditChain::verify_chain(entries, true));
+
+    // Binary records and the registry produce the same bytes
+    std::string json_lines;
+    for (const auto& entry : entries) json_lines += entry + "\n";
+    std::string binary, restored;
+    assert(dts::json_to_binary(json_lines, binary));
+    assert(dts::binary_to_json(binary, restored));
+    assert(restored == json_lines);
+
+    auto shard_sink = std::make_shared<CollectingSink>();
+    dts::ChainRegistry::Options options;
+    options.shards = 1;
+    options.sink_factory = [&shard_sink](size_t) { return shard_sink; };
+    dts::ChainRegistry registry(options);
+    const auto device = registry.add_device(device_id);
+    registry.log(device, "Event 0");
+    registry.flush();
+    const size_t id_end = entries[0].find("\"timestamp\"");
+    assert(shard_sink->entries[0].compare(0, id_end, entries[0], 0, id_end) == 0);
+    assert(registry.state(device).device_id == device_id);
+
+    std::cout << "✓ Escaped device ID test passed\n";
+}
+
+void test_adapter_metadata() {
+    const size_t before = dts::StringPool::shared().size();
+    std::vector<dts::adapters::BuildingAutomationAdapter> adapters;
+    for (int i = 0; i < 100; ++i) {
+        adapters.emplace_back("BAS-" + std::to_string(i % 10), "HQ-Tower", "Zone-7");
+    }
+    // Ten device IDs plus the zone read per event, however many adapters
+    assert(dts::StringPool::shared().size() - before == 11);
+    assert(adapters[99].log_hvac_event("Setpoint", "Zone-3", 21.5, "C").find("Zone-7") !=
+           std::string::npos);
+
+    dts::adapters::ClinicalTrialAdapter trial("TRIAL-DEV-1", "PROTO-9");
+    assert(trial.log_patient_enrolled("P-1", "SITE-1").find("PROTO-9") != std::string::npos);
+
+    std::cout << "✓ Adapter metadata test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS string pool tests...\n\n";
+
+    test_interning();
+    test_escaped_device_id();
+    test_adapter_metadata();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,398 @@
+/**
+ * @file test_upload_pipeline.cpp
+ * @brief Unit tests for batched upload, back-pressure and resume
+ */
+
+#include <dts/segmented_log.hpp>
+#include <dts/upload_pipeline.hpp>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#endif
+
+static std::string temp_dir(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("dts_" + name);
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+static dts::ClockSource test_clock() {
+    return dts::clocks::stepping(
+        std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000000)),
+        std::chrono::milliseconds(5));
+}
+
+/// In-process collector; can be taken down and can lose acknowledgements
+class MemoryTransport : public dts::Transport {
+public:
+    std::atomic<bool> up{true};
+    std::atomic<int> lose_acks{0};      ///< Store the next frames but report failure
+
+    bool connect(uint64_t& acknowledged) override {
+        if (!up) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++connects_;
+        acknowledged = receiver_.acknowledged();
+        return true;
+    }
+
+    bool send(const dts::UploadBatch& batch, uint64_t& acknowledged) override {
+        if (!up) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        dts::BatchHeader header;
+        assert(dts::parse_batch_header(batch.frame, header));
+        assert(header.first_sequence == batch.first_sequence && header.entries == batch.entries);
+        if (header.compressed) ++compressed_;
+        ++frames_;
+        const bool stored = receiver_.receive(batch.frame, lines_);
+        assert(stored);
+        acknowledged = receiver_.acknowledged();
+        if (lose_acks > 0) {
+            --lose_acks;
+            return false;
+        }
+        return true;
+    }
+
+    std::string lines() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+
+    uint64_t acknowledged() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return receiver_.acknowledged();
+    }
+
+    int frames() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_;
+    }
+
+    int compressed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return compressed_;
+    }
+
+    int connects() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return connects_;
+    }
+
+private:
+    std::mutex mutex_;
+    dts::BatchReceiver receiver_;
+    std::string lines_;
+    int frames_ = 0;
+    int compressed_ = 0;
+    int connects_ = 0;
+};
+
+void test_batches_and_compression() {
+    auto transport = std::make_shared<MemoryTransport>();
+    dts::UploadOptions options;
+    options.max_batch_entries = 500;
+    options.max_batch_delay = std::chrono::milliseconds(500);
+    auto pipeline = std::make_shared<dts::UploadPipeline>(transport, options);
+    dts::AuditChain chain("GATEWAY-PUMP-1", test_clock());
+    chain.set_sink(pipeline);
+
+    std::string log;
+    for (int i = 0; i < 2000; ++i) {
+        log += chain.log("Infusion rate " + std::to_string(i % 40) + " mL/hr",
+                         dts::UserID::Operator) + "\n";
+    }
+    dts::EventBatch batch;
+    for (int i = 0; i < 300; ++i) batch.add("Batched reading " + std::to_string(i));
+    std::string out;
+    chain.log_batch(out, batch);
+    log += out;
+    pipeline->flush();
+
+    assert(transport->lines() == log);
+    assert(pipeline->acknowledged() == 2300 && pipeline->pending_bytes() == 0);
+    // One frame per 500 entries (the 300-entry batch fills the fifth), not one per entry
+    assert(transport->frames() == 5 && pipeline->batches_sent() == 5);
+    assert(transport->compressed() == 5);
+    assert(pipeline->bytes_sent() * 3 < log.size());
+
+    // A part-filled batch goes out after max_batch_delay without a flush
+    chain.log("Idle");
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (transport->acknowledged() < 2301 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(transport->acknowledged() == 2301);
+
+    // Uncompressed frames carry the JSON lines as they are
+    dts::UploadOptions raw;
+    raw.compress = false;
+    auto plain = std::make_shared<MemoryTransport>();
+    auto uncompressed = std::make_shared<dts::UploadPipeline>(plain, raw);
+    dts::AuditChain second("GATEWAY-PUMP-1B", test_clock());
+    second.set_sink(uncompressed);
+    std::string plain_log;
+    for (int i = 0; i < 10; ++i) plain_log += second.log("Bolus " + std::to_string(i)) + "\n";
+    uncompressed->flush();
+    assert(plain->lines() == plain_log && plain->frames() == 1 && plain->compressed() == 0);
+    assert(uncompressed->bytes_sent() == dts::batch_header_bytes + plain_log.size());
+
+    std::cout << "✓ Batches and compression test passed\n";
+}
+
+void test_outage_and_lost_acks() {
+    auto transport = std::make_shared<MemoryTransport>();
+    transport->up = false;
+    dts::UploadOptions options;
+    options.max_batch_entries = 100;
+    options.retry_delay = std::chrono::milliseconds(5);
+    auto pipeline = std::make_shared<dts::UploadPipeline>(transport, options);
+    dts::AuditChain chain("GATEWAY-PUMP-2", test_clock());
+    chain.set_sink(pipeline);
+
+    std::string log;
+    for (int i = 0; i < 450; ++i) log += chain.log("Reading " + std::to_string(i)) + "\n";
+    pipeline->flush();      // returns after a failed attempt
+    assert(pipeline->failures() > 0 && pipeline->acknowledged() == 0);
+    assert(transport->lines().empty());
+
+    // Back up, but the first two acknowledgements go missing: the pipeline
+    // reconnects and learns from the receiver's position that they arrived
+    transport->lose_acks = 2;
+    transport->up = true;
+    for (int i = 0; i < 50; ++i) log += chain.log("Reading " + std::to_string(450 + i)) + "\n";
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (pipeline->acknowledged() < 500 && std::chrono::steady_clock::now() < deadline) {
+        pipeline->flush();
+    }
+    assert(transport->lines() == log);
+    assert(pipeline->acknowledged() == 500 && transport->connects() >= 3);
+
+    std::cout << "✓ Outage and lost acknowledgements test passed\n";
+}
+
+void test_drop_and_catch_up() {
+    const std::string dir = temp_dir("upload_store");
+    auto transport = std::make_shared<MemoryTransport>();
+    transport->up = false;
+    dts::SegmentOptions segments;
+    segments.max_segment_bytes = 64 * 1024;
+    auto store = std::make_shared<dts::SegmentedLogSink>(dir, segments);
+
+    dts::UploadOptions options;
+    options.max_batch_bytes = 4096;
+    options.max_pending_bytes = 16 * 1024;
+    options.overflow = dts::Overflow::Drop;
+    options.retry_delay = std::chrono::milliseconds(5);
+    auto pipeline = std::make_shared<dts::UploadPipeline>(transport, options, store);
+    dts::AuditChain chain("GATEWAY-PUMP-3", test_clock());
+    chain.set_sink(pipeline);
+
+    // The collector is unreachable: logging never blocks, the store keeps everything
+    std::string log;
+    for (int i = 0; i < 1000; ++i) log += chain.log("Pressure " + std::to_string(i)) + "\n";
+    assert(pipeline->dropped() > 0 && pipeline->behind());
+    assert(pipeline->pending_bytes() <= options.max_pending_bytes);
+    const uint64_t missing = pipeline->next_sequence();
+    assert(missing > 1 && missing < 1000);
+
+    transport->up = true;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (pipeline->acknowledged() < missing - 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // Re-queue the dropped entries from the store, a queue-full at a time
+    store->flush();
+    while (!dts::catch_up(*pipeline, dts::SegmentedLogReader(dir)) &&
+           std::chrono::steady_clock::now() < deadline) {
+        pipeline->flush();
+    }
+    assert(pipeline->next_sequence() == 1001);
+    pipeline->flush();
+    log += chain.log("Live again") + "\n";
+    assert(!pipeline->behind());
+    pipeline->flush();
+    assert(transport->lines() == log);
+
+    // A fresh pipeline after a restart learns the receiver's position first
+    dts::ChainState position;
+    position.device_id = "GATEWAY-PUMP-3";
+    position.sequence = 1001;
+    position.last_hash = chain.state().last_hash;
+    dts::AuditChain resumed(position);
+    auto restarted = std::make_shared<dts::UploadPipeline>(transport, options, store);
+    resumed.set_sink(restarted);
+    log += resumed.log("After restart") + "\n";
+    restarted->flush();
+    assert(transport->lines() == log && transport->acknowledged() == 1002);
+
+    std::cout << "✓ Drop and catch-up test passed\n";
+}
+
+void test_drop_batch() {
+    auto transport = std::make_shared<MemoryTransport>();
+    transport->up = false;
+    dts::UploadOptions options;
+    options.max_pending_bytes = 4096;
+    options.overflow = dts::Overflow::Drop;
+    options.retry_delay = std::chrono::milliseconds(5);
+    auto pipeline = std::make_shared<dts::UploadPipeline>(transport, options);
+    dts::AuditChain chain("GATEWAY-PUMP-4", test_clock());
+    chain.set_sink(pipeline);
+    chain.log("Queued");
+
+    // The first entries would fit, but the batch is refused whole and counted once
+    dts::EventBatch batch;
+    for (int i = 0; i < 40; ++i) batch.add("Flow " + std::to_string(i));
+    std::string out;
+    assert(chain.log_batch(out, batch) == 40);
+    assert(out.size() > options.max_pending_bytes);
+    assert(pipeline->dropped() == 40 && pipeline->behind());
+    assert(pipeline->next_sequence() == 2);
+
+    // Entries after the gap are refused as missing their predecessors, not as drops
+    chain.log("After the gap");
+    assert(pipeline->dropped() == 40 && pipeline->next_sequence() == 2);
+
+    std::cout << "✓ Batch drop test passed\n";
+}
+
+void test_receiver_checks() {
+    dts::AuditChain chain("GATEWAY-PUMP-4", test_clock());
+    std::string lines;
+    std::vector<std::string> samples;
+    for (int i = 0; i < 10; ++i) {
+        samples.push_back(chain.log("Event " + std::to_string(i)));
+        lines += samples.back() + "\n";
+    }
+
+    auto frame = [](const std::string& body, uint64_t first, uint64_t entries) {
+        std::string out(dts::detail::batch_magic_raw, 8);
+        dts::detail::put_u64(out, first);
+        dts::detail::put_u64(out, entries);
+        dts::detail::put_u64(out, body.size());
+        dts::detail::put_u64(out, body.size());
+        dts::detail::put_u64(out, 0);
+        return out + body;
+    };
+    size_t half = 0;
+    for (int i = 0; i < 5; ++i) half = lines.find('\n', half) + 1;
+    const std::string head = lines.substr(0, half);
+    const std::string tail = lines.substr(half);
+    const uint64_t head_entries = 5;
+
+    dts::BatchReceiver receiver;
+    std::string stored;
+    // A gap is refused
+    assert(!receiver.receive(frame(tail, head_entries + 1, 5), stored));
+    assert(receiver.last_result().status == dts::VerifyStatus::BrokenLink);
+    assert(receiver.receive(frame(head, 1, head_entries), stored));
+    // So are a tampered body and a truncated frame
+    std::string forged = tail;
+    forged[forged.find("Event")] = 'e';
+    receiver.set_recompute(true);
+    assert(!receiver.receive(frame(forged, head_entries + 1, 5), stored));
+    assert(!receiver.receive(frame(tail, head_entries + 1, 5).substr(0, 100), stored));
+    assert(receiver.acknowledged() == head_entries && stored == head);
+    // An overlapping resend only adds what is new
+    assert(receiver.receive(frame(lines, 1, 10), stored));
+    assert(stored == lines && receiver.acknowledged() == 10);
+    assert(receiver.receive(frame(head, 1, head_entries), stored) && stored == lines);
+
+    // Compressed frames need the sender's dictionary
+    const std::string dictionary = dts::train_dictionary(samples);
+    std::string block;
+    dts::compress_block(lines, block, dictionary);
+    std::string packed(dts::detail::batch_magic_packed, 8);
+    dts::detail::put_u64(packed, 1);
+    dts::detail::put_u64(packed, 10);
+    dts::detail::put_u64(packed, lines.size());
+    dts::detail::put_u64(packed, block.size());
+    dts::detail::put_u64(packed, dts::dictionary_id(dictionary));
+    packed += block;
+    std::string decoded;
+    assert(!dts::unpack_batch(packed, decoded) && decoded.empty());
+    assert(dts::unpack_batch(packed, decoded, dictionary) && decoded == lines);
+
+    std::cout << "✓ Receiver checks test passed\n";
+}
+
+#if defined(DTS_POSIX_IO)
+void test_tcp_transport() {
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    assert(listener >= 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    assert(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    assert(::listen(listener, 4) == 0);
+    socklen_t length = sizeof(address);
+    assert(::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+    const uint16_t port = ntohs(address.sin_port);
+
+    // Collector: the first connection is dropped after one frame, unanswered
+    std::string received;
+    std::thread server([&] {
+        dts::BatchReceiver receiver;
+        std::string frame;
+        for (int connection = 0; connection < 2; ++connection) {
+            const int fd = ::accept(listener, nullptr, nullptr);
+            assert(fd >= 0);
+            assert(dts::detail::send_ack(fd, receiver.acknowledged()));
+            while (dts::detail::recv_frame(fd, frame)) {
+                assert(receiver.receive(frame, received));
+                if (connection == 0) break;
+                assert(dts::detail::send_ack(fd, receiver.acknowledged()));
+                if (receiver.acknowledged() == 1000) break;
+            }
+            ::close(fd);
+        }
+    });
+
+    std::string log;
+    {
+        dts::UploadOptions options;
+        options.max_batch_entries = 200;
+        options.retry_delay = std::chrono::milliseconds(5);
+        auto pipeline = std::make_shared<dts::UploadPipeline>(
+            std::make_shared<dts::TcpTransport>("127.0.0.1", port), options);
+        dts::AuditChain chain("GATEWAY-PUMP-5", test_clock());
+        chain.set_sink(pipeline);
+        for (int i = 0; i < 1000; ++i) log += chain.log("Flow " + std::to_string(i)) + "\n";
+        while (pipeline->acknowledged() < 1000) pipeline->flush();
+        assert(pipeline->failures() >= 1);
+    }
+    server.join();
+    ::close(listener);
+    assert(received == log);
+
+    std::cout << "✓ TCP transport test passed\n";
+}
+#endif
+
+int main() {
+    std::cout << "Running DTS upload pipeline tests...\n\n";
+
+    test_batches_and_compression();
+    test_outage_and_lost_acks();
+    test_drop_and_catch_up();
+    test_drop_batch();
+    test_receiver_checks();
+#if defined(DTS_POSIX_IO)
+    test_tcp_transport();
+#endif
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
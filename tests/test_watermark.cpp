@@ -0,0 +1,212 @@
+/**
+ * @file test_watermark.cpp
+ * @brief Unit tests for chain-hash watermarks and tail verification
+ */
+
+#include <dts/log_sink.hpp>
+#include <dts/watermark.hpp>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+
+static std::string temp_path(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("dts_" + name);
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+static dts::ClockSource test_clock() {
+    return dts::clocks::stepping(
+        std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000000)),
+        std::chrono::milliseconds(250));
+}
+
+static std::string log_entries(dts::AuditChain& chain, int first, int count) {
+    std::string text;
+    for (int i = first; i < first + count; ++i) {
+        text += chain.log("Reading " + std::to_string(i), dts::UserID::Operator) + "\n";
+    }
+    return text;
+}
+
+void test_format_and_signature() {
+    dts::AuditChain chain("PUMP \"WM\"\t1", test_clock());
+    log_entries(chain, 0, 5);
+    dts::Watermark watermark = dts::make_watermark(chain.state());
+    watermark.log_offset = 4321;
+    assert(watermark.sequence == 5 && watermark.timestamp_ms == 1700000001000);
+
+    std::string text;
+    dts::write_watermark(watermark, text);
+    dts::Watermark parsed;
+    assert(dts::parse_watermark(text, parsed));
+    assert(parsed.device_id == watermark.device_id && parsed.sequence == 5);
+    assert(parsed.chain_hash == watermark.chain_hash && parsed.log_offset == 4321);
+    assert(parsed.timestamp_ms == watermark.timestamp_ms);
+    assert(parsed.scheme == dts::WatermarkSignature::None && parsed.signature.empty());
+
+    const dts::HmacSha256 key("device-key-1");
+    dts::sign_watermark(watermark, key);
+    assert(dts::check_watermark(watermark, key));
+    assert(!dts::check_watermark(watermark, dts::HmacSha256("device-key-2")));
+    text.clear();
+    dts::write_watermark(watermark, text);
+    assert(text.find("\"signature\":\"hmac-sha256:") != std::string::npos);
+    assert(dts::parse_watermark(text, parsed) && dts::check_watermark(parsed, key));
+
+    // The signature covers every field
+    parsed.sequence += 1;
+    assert(!dts::check_watermark(parsed, key));
+    assert(!dts::check_watermark(make_watermark(chain.state()), key));   // unsigned
+
+    assert(!dts::parse_watermark("{\"watermark\":\"DTSWM1\"}", parsed));
+    assert(!dts::parse_watermark(text.substr(0, text.size() - 1), parsed));
+    std::string other = text;
+    other.replace(other.find("DTSWM1"), 6, "DTSWM9");
+    assert(!dts::parse_watermark(other, parsed));
+
+    std::cout << "✓ Format and signature test passed\n";
+}
+
+void test_verify_log_since() {
+    const std::string path = temp_path("watermark.log");
+    const std::string state_path = temp_path("watermark.state");
+    dts::AuditChain chain("PUMP-WM-2", test_clock());
+    dts::DurabilityPolicy policy;
+    policy.state_path = state_path;
+    auto sink = std::make_shared<dts::FileSink>(path, policy);
+    chain.set_sink(sink);
+
+    std::string log = log_entries(chain, 0, 500);
+    sink->flush();
+    // The device publishes the position its sink last made durable
+    dts::ChainState durable;
+    assert(dts::load_chain_state(state_path, durable));
+    const dts::Watermark watermark = dts::make_watermark(durable);
+    assert(watermark.sequence == 500 && watermark.log_offset == log.size());
+
+    log += log_entries(chain, 500, 40);
+    sink->flush();
+    bool readable = false;
+    auto result = dts::verify_file_since(path, watermark, dts::watermark_verify_options(),
+                                         &readable);
+    assert(readable && result.ok() && result.entries == 40);
+    assert(result.last_hash == dts::verify_buffer(log).last_hash);
+
+    // Without an offset the watermark is found by its chain hash
+    dts::Watermark unplaced = watermark;
+    unplaced.log_offset = 0;
+    result = dts::verify_log_since(log, unplaced);
+    assert(result.ok() && result.entries == 40);
+
+    // Nothing new is fine too
+    result = dts::verify_log_since(log.substr(0, watermark.log_offset), watermark);
+    assert(result.ok() && result.entries == 0);
+
+    // A new entry edited in place keeps its links; hashes are re-derived by
+    // default, and it is reported at its offset in the whole log
+    std::string tampered = log;
+    const size_t target = tampered.find("Reading 520");
+    tampered[target] = 'r';
+    dts::VerifyOptions links_only;
+    links_only.recompute = false;
+    assert(dts::verify_log_since(tampered, watermark, links_only).ok());
+    result = dts::verify_log_since(tampered, watermark);
+    assert(result.status == dts::VerifyStatus::HashMismatch && result.failed_entry == 21);
+    assert(result.failed_offset == tampered.rfind('\n', target) + 1);
+
+    // A log rewritten under the watermark no longer holds its hash at the cut
+    std::string rewritten = log;
+    rewritten.insert(0, "x");
+    result = dts::verify_log_since(rewritten, watermark);
+    assert(result.status == dts::VerifyStatus::BrokenLink && result.failed_entry == 1);
+    const std::string shortened = log.substr(0, 1000);
+    assert(dts::verify_log_since(shortened, watermark).status == dts::VerifyStatus::BrokenLink);
+    assert(dts::verify_log_since(shortened, unplaced).status == dts::VerifyStatus::BrokenLink);
+
+    // Sequence 0 is the start of the chain
+    assert(dts::verify_log_since(log, dts::Watermark()).entries == 540);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(state_path);
+    std::cout << "✓ Verify log since watermark test passed\n";
+}
+
+void test_watermark_verifier() {
+    const std::string key = "fleet-key-PUMP-WM-3";
+    const dts::HmacSha256 device_key(key);
+    dts::AuditChain chain("PUMP-WM-3", test_clock());
+    dts::WatermarkVerifier server(dts::Watermark(), key);
+
+    // The device ships entries and a signed watermark every round; the
+    // server only verifies what arrived since the last one
+    uint64_t offset = 0;
+    for (int round = 0; round < 5; ++round) {
+        const std::string tail = log_entries(chain, round * 100, 100);
+        offset += tail.size();
+        dts::Watermark claimed = dts::make_watermark(chain.state());
+        claimed.log_offset = offset;
+        dts::sign_watermark(claimed, device_key);
+        const auto result = server.advance(tail, &claimed);
+        assert(result.ok() && result.entries == 100);
+        assert(server.accepted().sequence == claimed.sequence);
+        assert(server.accepted().chain_hash == claimed.chain_hash);
+        assert(server.accepted().log_offset == offset);
+    }
+    assert(server.accepted().device_id == "PUMP-WM-3");
+
+    const std::string tail = log_entries(chain, 500, 10);
+    dts::Watermark claimed = dts::make_watermark(chain.state());
+    // Unsigned, or signed under another key
+    assert(server.advance(tail, &claimed).status == dts::VerifyStatus::Malformed);
+    dts::sign_watermark(claimed, dts::HmacSha256("other-key"));
+    assert(server.advance(tail, &claimed).status == dts::VerifyStatus::Malformed);
+    // Correctly signed, but for another device
+    claimed.device_id = "PUMP-WM-4";
+    dts::sign_watermark(claimed, device_key);
+    assert(server.advance(tail, &claimed).status == dts::VerifyStatus::Malformed);
+    claimed.device_id = "PUMP-WM-3";
+    // A claim for a position the tail does not reach
+    claimed.sequence += 1;
+    dts::sign_watermark(claimed, device_key);
+    auto result = server.advance(tail, &claimed);
+    assert(result.status == dts::VerifyStatus::BrokenLink && result.failed_entry == 10);
+    assert(result.failed_offset == tail.rfind('\n', tail.size() - 2) + 1);
+    // A tail with an entry missing does not link to the accepted position
+    result = server.advance(tail.substr(tail.find('\n') + 1));
+    assert(result.status == dts::VerifyStatus::BrokenLink && result.failed_entry == 1);
+    assert(server.accepted().sequence == 500);
+
+    // An entry edited in place after the last watermark keeps its links,
+    // but its hash is re-derived by default
+    std::string edited = tail;
+    edited[edited.find("Reading 503")] = 'r';
+    result = server.advance(edited);
+    assert(result.status == dts::VerifyStatus::HashMismatch && result.failed_entry == 4);
+    assert(server.accepted().sequence == 500);
+    assert(server.advance(tail).ok() && server.accepted().sequence == 510);
+
+    // The timestamp comes from the verified entry, not from the claim
+    const std::string late = log_entries(chain, 510, 5);
+    claimed = dts::make_watermark(chain.state());
+    claimed.timestamp_ms += 3600 * 1000;
+    dts::sign_watermark(claimed, device_key);
+    assert(server.advance(late, &claimed).ok());
+    assert(server.accepted().timestamp_ms == chain.state().timestamp_ms);
+
+    std::cout << "✓ Watermark verifier test passed\n";
+}
+
+int main() {
+    std::cout << "Running DTS watermark tests...\n\n";
+
+    test_format_and_signature();
+    test_verify_log_since();
+    test_watermark_verifier();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,773 @@
+/**
+ * @file dts_tool.cpp
+ * @brief Command-line tool for bulk verification, conversion and migration of audit logs
+ *
+ * Usage: dts_tool <command> [options] <paths>
+ *
+ *   verify    [--threads N] [--recompute] [--epochs] LOG|DIR
+ *   verify    [--threads N] --since WATERMARK [--key-file KEY] LOG
+ *   verify    [--threads N] [--recompute] --public-key KEY LOG
+ *   watermark [--threads N] [--since WATERMARK] [--key-file KEY] LOG
+ *   keygen    SEED_FILE
+ *   replay    [--threads N] [--checkpoint N] LOG
+ *   to-binary [--threads N] IN.jsonl OUT.dtsb
+ *   to-json   IN.dtsb OUT.jsonl
+ *   reindex   [--segment-bytes N] [--index-interval N] [--compress] LOG DIR
+ *   reseal    [--device ID] [--checkpoint N] [--state PATH] IN OUT.jsonl
+ *
+ * verify accepts a segmented store directory as well as a single log.
+ * With --since it checks only the entries after a published watermark
+ * (dts/watermark.hpp), re-deriving each of their chain hashes, and with
+ * --key-file the watermark's HMAC signature too. watermark verifies a log the same way and prints the watermark of
+ * its last entry, signed if a key is given. With --public-key (64 hex
+ * digits, as printed by keygen) verify also checks every Ed25519 signed
+ * checkpoint in the log (dts/signed_checkpoint.hpp) and reports the last
+ * entry a valid signature covers.
+ * keygen writes a new signing seed to SEED_FILE, which must not exist, and
+ * prints its public key.
+ * replay regenerates every entry from its recorded inputs and requires the
+ * same bytes; with --checkpoint it re-derives the checkpoints as well.
+ * Inputs are memory-mapped, and outputs are written through large buffers,
+ * so archives larger than RAM stream through at a bounded footprint.
+ * verify, replay and to-binary spread the parsing over all cores, except
+ * replay with --checkpoint. reindex, to-json and reseal are sequential:
+ * reindex and to-json by format, and reseal because a chain is hashed one
+ * entry at a time.
+ *
+ * reseal imports legacy logs into a fresh chain. Lines that parse as DTS
+ * entries keep their timestamp, user, severity and message, and are
+ * prefixed with their device ID if it is not the new chain's. Any other
+ * line becomes the message of a System/Info entry stamped with the import
+ * time.
+ *
+ * Exit status: 0 on success, 1 if the input failed verification or did not
+ * parse, 2 on usage or I/O errors.
+ *
+ * @copyright Copyright (c) 2025 Big Data Plumbing
+ * @license MIT License
+ */
+
+#include <dts/audit_chain.hpp>
+#include <dts/binary_record.hpp>
+#include <dts/chain_state.hpp>
+#include <dts/chain_verifier.hpp>
+#include <dts/epoch_chain.hpp>
+#include <dts/replay.hpp>
+#include <dts/segmented_log.hpp>
+#include <dts/signed_checkpoint.hpp>
+#include <dts/watermark.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr int exit_ok = 0;
+constexpr int exit_invalid = 1;
+constexpr int exit_error = 2;
+
+/// Bytes of input each worker parses per round of to-binary
+constexpr size_t chunk_bytes = 16 * 1024 * 1024;
+
+/// Output buffer flushed to disk whenever it grows past this
+constexpr size_t output_buffer_bytes = 4 * 1024 * 1024;
+
+struct Args {
+    std::vector<std::string> paths;
+    unsigned threads = 0;
+    bool recompute = false;
+    bool epochs = false;
+    bool compress = false;
+    uint64_t segment_bytes = dts::SegmentOptions().max_segment_bytes;
+    uint32_t index_interval = dts::SegmentOptions().index_interval;
+    uint64_t checkpoint = 0;
+    std::string device;
+    std::string state_path;
+    std::string since;          ///< Watermark file
+    std::string key_file;
+    std::string public_key;     ///< Ed25519 public key file
+};
+
+/// Buffered file writer
+class Output {
+public:
+    explicit Output(const std::string& path) : file_(std::fopen(path.c_str(), "wb")) {
+        buffer_.reserve(output_buffer_bytes + 64 * 1024);
+    }
+
+    ~Output() { close(); }
+
+    bool ok() const { return file_ && ok_; }
+
+    std::string& buffer() { return buffer_; }
+
+    /// Write the buffer out if it has grown past the threshold
+    void maybe_flush() {
+        if (buffer_.size() >= output_buffer_bytes) flush();
+    }
+
+    void flush() {
+        if (file_ && !buffer_.empty() &&
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+            ok_ = false;
+        }
+        buffer_.clear();
+    }
+
+    bool close() {
+        if (!file_) return false;
+        flush();
+        ok_ = std::fclose(file_) == 0 && ok_;
+        file_ = nullptr;
+        return ok_;
+    }
+
+private:
+    std::FILE* file_;
+    std::string buffer_;
+    bool ok_ = true;
+};
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: dts_tool <command> [options] <paths>\n"
+                 "  verify    [--threads N] [--recompute] [--epochs] LOG|DIR\n"
+                 "  verify    [--threads N] --since WATERMARK [--key-file KEY] LOG\n"
+                 "  verify    [--threads N] [--recompute] --public-key KEY LOG\n"
+                 "  watermark [--threads N] [--since WATERMARK] [--key-file KEY] LOG\n"
+                 "  keygen    SEED_FILE\n"
+                 "  replay    [--threads N] [--checkpoint N] LOG\n"
+                 "  to-binary [--threads N] IN.jsonl OUT.dtsb\n"
+                 "  to-json   IN.dtsb OUT.jsonl\n"
+                 "  reindex   [--segment-bytes N] [--index-interval N] [--compress] LOG DIR\n"
+                 "  reseal    [--device ID] [--checkpoint N] [--state PATH] IN OUT.jsonl\n");
+    return exit_error;
+}
+
+bool parse_args(int argc, char** argv, Args& args) {
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value = [&](const char*& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        const char* text = nullptr;
+        if (arg == "--recompute") {
+            args.recompute = true;
+        } else if (arg == "--epochs") {
+            args.epochs = true;
+        } else if (arg == "--compress") {
+            args.compress = true;
+        } else if (arg == "--threads" && value(text)) {
+            args.threads = static_cast<unsigned>(std::strtoul(text, nullptr, 10));
+        } else if (arg == "--segment-bytes" && value(text)) {
+            args.segment_bytes = std::strtoull(text, nullptr, 10);
+        } else if (arg == "--index-interval" && value(text)) {
+            args.index_interval = static_cast<uint32_t>(std::strtoul(text, nullptr, 10));
+        } else if (arg == "--checkpoint" && value(text)) {
+            args.checkpoint = std::strtoull(text, nullptr, 10);
+        } else if (arg == "--device" && value(text)) {
+            args.device = text;
+        } else if (arg == "--state" && value(text)) {
+            args.state_path = text;
+        } else if (arg == "--since" && value(text)) {
+            args.since = text;
+        } else if (arg == "--key-file" && value(text)) {
+            args.key_file = text;
+        } else if (arg == "--public-key" && value(text)) {
+            args.public_key = text;
+        } else if (arg.size() > 2 && arg.substr(0, 2) == "--") {
+            return false;
+        } else {
+            args.paths.emplace_back(arg);
+        }
+    }
+    return true;
+}
+
+unsigned thread_count(const Args& args) {
+    return args.threads ? args.threads : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/// Call visit(line, offset) for every non-blank line; stops when visit returns false
+template <typename Visit>
+bool for_each_line(std::string_view text, size_t base, Visit&& visit) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(
+            std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!line_end) line_end = end;
+        const char* text_end = line_end;
+        if (text_end > p && text_end[-1] == '\r') --text_end;
+        const std::string_view line(p, static_cast<size_t>(text_end - p));
+        if (line.find_first_not_of(" \t") != std::string_view::npos &&
+            !visit(line, base + static_cast<size_t>(p - text.data()))) {
+            return false;
+        }
+        p = line_end + 1;
+    }
+    return true;
+}
+
+/// End of the chunk that starts at @p begin: just past a newline, or the end of @p log
+size_t chunk_end(std::string_view log, size_t begin, size_t bytes) {
+    if (log.size() - begin <= bytes) return log.size();
+    const size_t newline = log.find('\n', begin + bytes);
+    return newline == std::string_view::npos ? log.size() : newline + 1;
+}
+
+void report(const char* what, const dts::VerifyResult& result) {
+    static const char* const names[] = {"ok", "malformed entry", "broken link", "hash mismatch",
+                                         "bad signature"};
+    std::fprintf(stderr, "%s: %s at entry %llu (byte offset %zu); %llu entries verified\n",
+                 what, names[static_cast<int>(result.status)],
+                 static_cast<unsigned long long>(result.failed_entry), result.failed_offset,
+                 static_cast<unsigned long long>(result.entries));
+}
+
+/// Whole contents of a small file, without a trailing line break
+bool read_small_file(const std::string& path, std::string& out) {
+    dts::MappedFile file(path);
+    if (!file.ok()) return false;
+    out.assign(file.view());
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r')) out.pop_back();
+    return true;
+}
+
+/**
+ * @brief Verify args.paths[0] after the --since watermark (or from the start)
+ * @return exit_ok, or the exit status to stop with after reporting the problem
+ */
+int verify_since_watermark(const Args& args, const char* what, dts::Watermark& accepted,
+                           dts::VerifyResult& result, std::string& key) {
+    if (!args.key_file.empty() && !read_small_file(args.key_file, key)) {
+        std::fprintf(stderr, "%s: cannot read %s\n", what, args.key_file.c_str());
+        return exit_error;
+    }
+    if (!args.since.empty()) {
+        std::string text;
+        if (!read_small_file(args.since, text)) {
+            std::fprintf(stderr, "%s: cannot read %s\n", what, args.since.c_str());
+            return exit_error;
+        }
+        if (!dts::parse_watermark(text, accepted)) {
+            std::fprintf(stderr, "%s: %s is not a watermark\n", what, args.since.c_str());
+            return exit_invalid;
+        }
+        if (!key.empty() && !dts::check_watermark(accepted, dts::HmacSha256(key))) {
+            std::fprintf(stderr, "%s: watermark signature does not verify\n", what);
+            return exit_invalid;
+        }
+    }
+    dts::VerifyOptions options = dts::watermark_verify_options();
+    options.threads = thread_count(args);
+    bool readable = false;
+    result = dts::verify_file_since(args.paths[0], accepted, options, &readable);
+    if (!readable) {
+        std::fprintf(stderr, "%s: cannot read %s\n", what, args.paths[0].c_str());
+        return exit_error;
+    }
+    if (!result.ok()) {
+        report(what, result);
+        return exit_invalid;
+    }
+    return exit_ok;
+}
+
+/// Read a public key file of 64 hex digits
+bool read_public_key(const std::string& path, dts::ed25519::PublicKey& key) {
+    std::string text;
+    return read_small_file(path, text) && text.size() == 2 * key.size() &&
+           dts::detail::hex_decode(text.data(), key.size(), key.data());
+}
+
+int verify_signatures(const Args& args) {
+    if (args.epochs || !args.since.empty()) return usage();
+    dts::ed25519::PublicKey key;
+    if (!read_public_key(args.public_key, key)) {
+        std::fprintf(stderr, "verify: cannot read a public key from %s\n",
+                     args.public_key.c_str());
+        return exit_error;
+    }
+    dts::SignatureOptions options;
+    options.verify.threads = thread_count(args);
+    options.verify.recompute = args.recompute;
+    bool readable = false;
+    const dts::SignedVerifyResult result =
+        dts::verify_signed_file(args.paths[0], key, options, &readable);
+    if (!readable) {
+        std::fprintf(stderr, "verify: cannot read %s\n", args.paths[0].c_str());
+        return exit_error;
+    }
+    if (!result.ok()) {
+        report("verify", result);
+        return exit_invalid;
+    }
+    char hex[65] = {0};
+    dts::detail::hex_encode(result.last_hash.data(), result.last_hash.size(), hex);
+    std::printf("ok: %llu entries, %llu signed checkpoints through entry %llu, "
+                "last chain_hash %s\n",
+                static_cast<unsigned long long>(result.entries),
+                static_cast<unsigned long long>(result.signatures),
+                static_cast<unsigned long long>(result.signed_sequence), hex);
+    return exit_ok;
+}
+
+int cmd_verify(const Args& args) {
+    if (args.paths.size() != 1) return usage();
+    if (!args.public_key.empty()) return verify_signatures(args);
+    if (!args.since.empty()) {
+        if (args.epochs) return usage();
+        dts::Watermark accepted;
+        dts::VerifyResult result;
+        std::string key;
+        const int status = verify_since_watermark(args, "verify", accepted, result, key);
+        if (status != exit_ok) return status;
+        char hex[65] = {0};
+        dts::detail::hex_encode(result.last_hash.data(), result.last_hash.size(), hex);
+        std::printf("ok: %llu new entries after sequence %llu, last chain_hash %s\n",
+                    static_cast<unsigned long long>(result.entries),
+                    static_cast<unsigned long long>(accepted.sequence),
+                    result.entries ? hex : "unchanged");
+        return exit_ok;
+    }
+    dts::VerifyOptions options;
+    options.threads = thread_count(args);
+    options.recompute = args.recompute;
+    bool readable = false;
+    if (std::filesystem::is_directory(args.paths[0])) {
+        // A segmented store (for example the output of reindex)
+        dts::SegmentedLogReader reader(args.paths[0]);
+        size_t failed_segment = 0;
+        const dts::VerifyResult result = reader.verify(options, &failed_segment);
+        if (!result.ok()) {
+            report("verify", result);
+            std::fprintf(stderr, "verify: in segment %zu of %zu\n", failed_segment + 1,
+                         reader.segments().size());
+            return exit_invalid;
+        }
+        std::printf("ok: %llu entries in %zu segments\n",
+                    static_cast<unsigned long long>(result.entries), reader.segments().size());
+        return exit_ok;
+    }
+    const dts::VerifyResult result =
+        args.epochs ? dts::verify_epoch_file(args.paths[0], options, &readable)
+                    : dts::verify_file(args.paths[0], options, &readable);
+    if (!readable) {
+        std::fprintf(stderr, "verify: cannot read %s\n", args.paths[0].c_str());
+        return exit_error;
+    }
+    if (!result.ok()) {
+        report("verify", result);
+        return exit_invalid;
+    }
+    char hex[65] = {0};
+    dts::detail::hex_encode(result.last_hash.data(), result.last_hash.size(), hex);
+    std::printf("ok: %llu entries, last chain_hash %s\n",
+                static_cast<unsigned long long>(result.entries), hex);
+    return exit_ok;
+}
+
+int cmd_replay(const Args& args) {
+    if (args.paths.size() != 1) return usage();
+    dts::ReplayOptions options;
+    options.threads = thread_count(args);
+    options.checkpoint_interval = args.checkpoint;
+    bool readable = false;
+    const dts::VerifyResult result = dts::replay_file(args.paths[0], options, &readable);
+    if (!readable) {
+        std::fprintf(stderr, "replay: cannot read %s\n", args.paths[0].c_str());
+        return exit_error;
+    }
+    if (!result.ok()) {
+        report("replay", result);
+        return exit_invalid;
+    }
+    std::printf("ok: %llu entries reproduced\n", static_cast<unsigned long long>(result.entries));
+    return exit_ok;
+}
+
+int cmd_watermark(const Args& args) {
+    if (args.paths.size() != 1) return usage();
+    dts::Watermark watermark;
+    dts::VerifyResult result;
+    std::string key;
+    const int status = verify_since_watermark(args, "watermark", watermark, result, key);
+    if (status != exit_ok) return status;
+
+    if (result.entries > 0) {
+        // The position after the last entry, named by its own fields
+        dts::MappedFile file(args.paths[0]);
+        std::string_view log = file.view();
+        while (!log.empty() && (log.back() == '\n' || log.back() == '\r')) log.remove_suffix(1);
+        const size_t last_line = log.rfind('\n');
+        dts::EntryView view;
+        watermark.device_id.clear();
+        if (!file.ok() ||
+            !dts::parse_entry(log.substr(last_line == std::string_view::npos ? 0 : last_line + 1),
+                              view) ||
+            !dts::unescape_json(view.device_id, watermark.device_id) ||
+            !dts::detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                             watermark.timestamp_ms)) {
+            std::fprintf(stderr, "watermark: cannot read the last entry of %s\n",
+                         args.paths[0].c_str());
+            return exit_error;
+        }
+        watermark.sequence += result.entries;
+        watermark.chain_hash = result.last_hash;
+        watermark.log_offset = file.view().size();
+    }
+    watermark.scheme = dts::WatermarkSignature::None;
+    watermark.signature.clear();
+    if (!key.empty()) dts::sign_watermark(watermark, dts::HmacSha256(key));
+    std::string text;
+    dts::write_watermark(watermark, text);
+    std::printf("%s\n", text.c_str());
+    return exit_ok;
+}
+
+int cmd_keygen(const Args& args) {
+    if (args.paths.size() != 1) return usage();
+    const std::string& path = args.paths[0];
+    if (std::filesystem::exists(path)) {
+        std::fprintf(stderr, "keygen: %s already exists\n", path.c_str());
+        return exit_error;
+    }
+    dts::ed25519::Seed seed;
+    std::random_device random;
+    for (size_t i = 0; i < seed.size(); i += 4) {
+        const uint32_t word = random();
+        std::memcpy(seed.data() + i, &word, 4);
+    }
+    char hex[65] = {0};
+    dts::detail::hex_encode(seed.data(), seed.size(), hex);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    std::error_code error;
+    // Owner-only before the secret goes in
+    std::filesystem::permissions(
+        path, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write, error);
+    file << hex << '\n';
+    file.close();
+    if (!file || error) {
+        std::fprintf(stderr, "keygen: cannot write %s\n", path.c_str());
+        return exit_error;
+    }
+    const dts::ed25519::PublicKey key = dts::ed25519::public_key(seed);
+    dts::detail::hex_encode(key.data(), key.size(), hex);
+    std::printf("%s\n", hex);
+    return exit_ok;
+}
+
+/// Entries of one to-binary chunk; views point into the input or into unescaped
+struct ParsedChunk {
+    std::vector<dts::EntryInfo> entries;
+    std::deque<std::string> unescaped;      ///< Stable storage for fields with escapes
+    size_t failed_offset = 0;
+    bool ok = true;
+};
+
+bool field_text(std::string_view escaped, std::string_view& out, ParsedChunk& chunk) {
+    if (escaped.find('\\') == std::string_view::npos) {
+        out = escaped;
+        return true;
+    }
+    chunk.unescaped.emplace_back();
+    if (!dts::unescape_json(escaped, chunk.unescaped.back())) return false;
+    out = chunk.unescaped.back();
+    return true;
+}
+
+void parse_chunk(std::string_view text, size_t base, ParsedChunk& chunk) {
+    chunk.entries.clear();
+    chunk.unescaped.clear();
+    chunk.ok = true;
+    chunk.ok = for_each_line(text, base, [&chunk](std::string_view line, size_t offset) {
+        dts::EntryView view;
+        dts::EntryInfo entry{};
+        if (!dts::parse_entry(line, view) ||
+            !dts::detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                             entry.timestamp_ms) ||
+            !dts::detail::hex_decode(view.previous_hash.data(), 32, entry.previous_hash.data()) ||
+            !dts::detail::hex_decode(view.chain_hash.data(), 32, entry.chain_hash.data()) ||
+            view.user_id > 0xFF || view.severity > 0xFF ||
+            !field_text(view.device_id, entry.device_id, chunk) ||
+            !field_text(view.message, entry.message, chunk)) {
+            chunk.failed_offset = offset;
+            return false;
+        }
+        entry.user_id = static_cast<dts::UserID>(view.user_id);
+        entry.severity = static_cast<dts::Severity>(view.severity);
+        chunk.entries.push_back(entry);
+        return true;
+    });
+}
+
+int cmd_to_binary(const Args& args) {
+    if (args.paths.size() != 2) return usage();
+    dts::MappedFile input(args.paths[0]);
+    Output output(args.paths[1]);
+    if (!input.ok() || !output.ok()) {
+        std::fprintf(stderr, "to-binary: cannot open input or output\n");
+        return exit_error;
+    }
+    const std::string_view log = input.view();
+    const unsigned threads = thread_count(args);
+    std::vector<ParsedChunk> chunks(threads);
+    dts::BinaryRecordEncoder encoder;
+    std::unordered_map<std::string, uint64_t> sequences;    // per device, as encode_json() numbers
+    std::string last_device;
+    uint64_t* last_sequence = nullptr;
+    uint64_t total = 0;
+
+    // Rounds of one chunk per thread: parse in parallel, then encode in order
+    for (size_t begin = 0; begin < log.size();) {
+        std::vector<size_t> bounds{begin};
+        while (bounds.size() <= threads && bounds.back() < log.size()) {
+            bounds.push_back(chunk_end(log, bounds.back(), chunk_bytes));
+        }
+        const size_t used = bounds.size() - 1;
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < used; ++i) {
+            workers.emplace_back([&, i] {
+                parse_chunk(log.substr(bounds[i], bounds[i + 1] - bounds[i]), bounds[i], chunks[i]);
+            });
+        }
+        parse_chunk(log.substr(bounds[0], bounds[1] - bounds[0]), bounds[0], chunks[0]);
+        for (auto& worker : workers) worker.join();
+
+        for (size_t i = 0; i < used; ++i) {
+            if (!chunks[i].ok) {
+                std::fprintf(stderr, "to-binary: malformed entry at byte offset %zu\n",
+                             chunks[i].failed_offset);
+                return exit_invalid;
+            }
+            for (auto& entry : chunks[i].entries) {
+                if (!last_sequence || entry.device_id != last_device) {
+                    last_device.assign(entry.device_id.data(), entry.device_id.size());
+                    last_sequence = &sequences[last_device];
+                }
+                entry.sequence = ++*last_sequence;
+                encoder.encode(entry, output.buffer());
+                output.maybe_flush();
+            }
+            total += chunks[i].entries.size();
+        }
+        begin = bounds[used];
+    }
+    if (!output.close()) {
+        std::fprintf(stderr, "to-binary: write failed\n");
+        return exit_error;
+    }
+    std::printf("ok: %llu entries\n", static_cast<unsigned long long>(total));
+    return exit_ok;
+}
+
+int cmd_to_json(const Args& args) {
+    if (args.paths.size() != 2) return usage();
+    dts::MappedFile input(args.paths[0]);
+    Output output(args.paths[1]);
+    if (!input.ok() || !output.ok()) {
+        std::fprintf(stderr, "to-json: cannot open input or output\n");
+        return exit_error;
+    }
+    dts::BinaryRecordReader reader(input.view());
+    dts::EntryInfo entry;
+    uint64_t total = 0;
+    while (reader.next(entry)) {
+        dts::append_json(entry, output.buffer());
+        output.buffer().push_back('\n');
+        output.maybe_flush();
+        ++total;
+    }
+    const bool written = output.close();
+    if (reader.error()) {
+        std::fprintf(stderr, "to-json: malformed record after %llu entries\n",
+                     static_cast<unsigned long long>(total));
+        return exit_invalid;
+    }
+    if (!written) {
+        std::fprintf(stderr, "to-json: write failed\n");
+        return exit_error;
+    }
+    std::printf("ok: %llu entries\n", static_cast<unsigned long long>(total));
+    return exit_ok;
+}
+
+int cmd_reindex(const Args& args) {
+    if (args.paths.size() != 2) return usage();
+    dts::MappedFile input(args.paths[0]);
+    if (!input.ok()) {
+        std::fprintf(stderr, "reindex: cannot read %s\n", args.paths[0].c_str());
+        return exit_error;
+    }
+    dts::SegmentOptions options;
+    options.max_segment_bytes = args.segment_bytes;
+    options.index_interval = std::max<uint32_t>(args.index_interval, 1);
+    options.compress_sealed = args.compress;
+    dts::SegmentedLogSink sink(args.paths[1], options);
+    if (!sink.ok()) {
+        std::fprintf(stderr, "reindex: cannot open %s\n", args.paths[1].c_str());
+        return exit_error;
+    }
+
+    // Clean lines are handed over in contiguous runs, as log_batch() would
+    const std::string_view log = input.view();
+    std::vector<dts::EntryInfo> infos;
+    size_t run_begin = 0;
+    size_t run_end = 0;
+    auto flush_run = [&] {
+        if (!infos.empty()) {
+            sink.write_batch(log.substr(run_begin, run_end - run_begin), infos.data(), infos.size());
+        }
+        infos.clear();
+    };
+    uint64_t sequence = 0;
+    size_t failed_offset = 0;
+    const bool parsed = for_each_line(log, 0, [&](std::string_view line, size_t offset) {
+        dts::EntryView view;
+        dts::EntryInfo info{};
+        if (!dts::parse_entry(line, view) ||
+            !dts::detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                             info.timestamp_ms) ||
+            !dts::detail::hex_decode(view.previous_hash.data(), 32, info.previous_hash.data()) ||
+            !dts::detail::hex_decode(view.chain_hash.data(), 32, info.chain_hash.data()) ||
+            view.severity > 0xFF || view.user_id > 0xFF) {
+            failed_offset = offset;
+            return false;
+        }
+        info.sequence = ++sequence;
+        info.user_id = static_cast<dts::UserID>(view.user_id);
+        info.severity = static_cast<dts::Severity>(view.severity);
+        info.device_id = view.device_id;
+        info.message = view.message;
+        const size_t line_end = offset + line.size();
+        if (!infos.empty() && offset != run_end) flush_run();
+        if (line_end == log.size() || log[line_end] != '\n') {
+            flush_run();
+            sink.write(line, info);     // "\r\n" or a final line without a newline
+            return sink.ok();
+        }
+        if (infos.empty()) run_begin = offset;
+        infos.push_back(info);
+        run_end = line_end + 1;
+        if (infos.size() >= 4096) flush_run();
+        return sink.ok();
+    });
+    flush_run();
+    sink.flush();
+    if (!sink.ok()) {
+        std::fprintf(stderr, "reindex: write failed\n");
+        return exit_error;
+    }
+    if (!parsed) {
+        std::fprintf(stderr, "reindex: malformed entry at byte offset %zu\n", failed_offset);
+        return exit_invalid;
+    }
+    std::printf("ok: %llu entries in %zu segments\n", static_cast<unsigned long long>(sequence),
+                sink.segment_count());
+    return exit_ok;
+}
+
+int cmd_reseal(const Args& args) {
+    if (args.paths.size() != 2) return usage();
+    dts::MappedFile input(args.paths[0]);
+    Output output(args.paths[1]);
+    if (!input.ok() || !output.ok()) {
+        std::fprintf(stderr, "reseal: cannot open input or output\n");
+        return exit_error;
+    }
+    const std::string_view log = input.view();
+
+    // The new chain's device: --device, else that of the first DTS entry
+    std::string device = args.device;
+    if (device.empty()) {
+        for_each_line(log, 0, [&device](std::string_view line, size_t) {
+            dts::EntryView view;
+            if (!dts::parse_entry(line, view)) return true;
+            dts::unescape_json(view.device_id, device);
+            return false;
+        });
+    }
+    if (device.empty()) device = "LEGACY";
+
+    dts::AuditChain chain(device);
+    chain.set_checkpoint_interval(args.checkpoint);
+    const int64_t import_ms = dts::to_epoch_ms(std::chrono::system_clock::now());
+    std::string entry, checkpoint, message, original_device;
+    uint64_t imported = 0;
+    uint64_t legacy = 0;
+    for_each_line(log, 0, [&](std::string_view line, size_t) {
+        dts::EntryView view;
+        int64_t timestamp_ms = 0;
+        message.clear();
+        original_device.clear();
+        if (dts::parse_entry(line, view) && view.user_id <= 0xFF && view.severity <= 0xFF &&
+            dts::detail::parse_timestamp_ms(view.timestamp.data(), view.timestamp.size(),
+                                            timestamp_ms) &&
+            dts::unescape_json(view.device_id, original_device)) {
+            if (original_device != device) message.append("[").append(original_device).append("] ");
+            // Old checkpoints do not cover the new chain; they come over as legacy lines
+            if (dts::unescape_json(view.message, message) &&
+                chain.log_at(entry, timestamp_ms, message, static_cast<dts::UserID>(view.user_id),
+                             static_cast<dts::Severity>(view.severity))) {
+                ++imported;
+            } else {
+                chain.log_at(entry, import_ms, line);
+                ++legacy;
+            }
+        } else {
+            chain.log_at(entry, import_ms, line);
+            ++legacy;
+        }
+        output.buffer().append(entry).push_back('\n');
+        if (chain.take_checkpoint(checkpoint)) output.buffer().append(checkpoint).push_back('\n');
+        output.maybe_flush();
+        return true;
+    });
+    if (!output.close()) {
+        std::fprintf(stderr, "reseal: write failed\n");
+        return exit_error;
+    }
+    if (!args.state_path.empty() && !dts::save_chain_state(args.state_path, chain.state())) {
+        std::fprintf(stderr, "reseal: cannot write %s\n", args.state_path.c_str());
+        return exit_error;
+    }
+    std::printf("ok: %llu entries re-chained, %llu legacy lines, chain_hash %s\n",
+                static_cast<unsigned long long>(imported), static_cast<unsigned long long>(legacy),
+                chain.get_chain_hash().c_str());
+    return exit_ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    Args args;
+    if (!parse_args(argc, argv, args)) return usage();
+    const std::string_view command = argv[1];
+    if (command == "verify") return cmd_verify(args);
+    if (command == "replay") return cmd_replay(args);
+    if (command == "watermark") return cmd_watermark(args);
+    if (command == "keygen") return cmd_keygen(args);
+    if (command == "to-binary") return cmd_to_binary(args);
+    if (command == "to-json") return cmd_to_json(args);
+    if (command == "reindex") return cmd_reindex(args);
+    if (command == "reseal") return cmd_reseal(args);
+    return usage();
+}